@@ -59,6 +59,12 @@ RGLogBook :: ~RGLogBook () {
 }
 
 
+RGTextOutput* RGLogBook :: CreateSpool (RGFile* spoolFile) const {
+
+	return new RGLogBook (spoolFile, Level, FALSE);
+}
+
+
 void RGLogBook :: SetOutputLevel (int level) {
 
 	mLevels.push_front (CurrentOutputLevel);
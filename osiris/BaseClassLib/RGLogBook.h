@@ -52,6 +52,8 @@ public:
 	RGLogBook (RGFile* ofile, int level, Boolean echo = FALSE);
 	virtual ~RGLogBook ();
 
+	virtual RGTextOutput* CreateSpool (RGFile* spoolFile) const;
+
 	virtual void SetOutputLevel (int level);
 	virtual void ResetOutputLevel ();
 
@@ -74,6 +76,7 @@ public:
 	virtual RGTextOutput& operator<<(const PLevel& plevel);
 
 	virtual Boolean TestCurrentLevel () const;
+	void CopyOutputLevels (const RGLogBook& book) { CurrentOutputLevel = book.CurrentOutputLevel; mLevels = book.mLevels; }
 
 private:
 	int Level;
@@ -38,6 +38,7 @@
 using namespace std;
 
 int RGTextOutput::Resolution = 10;
+const char RGTextOutput::NumberMark = '\x01';
 
 
 Endl :: Endl () : NumEndlines (1) {
@@ -62,13 +63,15 @@ PLevel :: PLevel () {
 }
 
 
-RGTextOutput :: RGTextOutput (const RGString& fileName, Boolean echo) : Echo (echo), CreatedFile (TRUE) {
+RGTextOutput :: RGTextOutput (const RGString& fileName, Boolean echo) : Echo (echo), CreatedFile (TRUE), FirstMarked (1),
+LastMarked (0) {
 
 	file = new RGFile (fileName, "wt");
 }
 
 
-RGTextOutput :: RGTextOutput (RGFile* ofile, Boolean echo) : Echo (echo), CreatedFile (FALSE) {
+RGTextOutput :: RGTextOutput (RGFile* ofile, Boolean echo) : Echo (echo), CreatedFile (FALSE), FirstMarked (1),
+LastMarked (0) {
 
 	file = ofile;
 }
@@ -92,6 +95,12 @@ Boolean RGTextOutput :: FileIsValid () const {
 }
 
 
+RGTextOutput* RGTextOutput :: CreateSpool (RGFile* spoolFile) const {
+
+	return new RGTextOutput (spoolFile, FALSE);
+}
+
+
 Boolean RGTextOutput :: Write (const RGString& s) {
 
 	file->Write (s.GetData ());
@@ -316,7 +325,18 @@ void RGTextOutput :: EndLine () {
 
 
 void RGTextOutput :: GetString (long l) {
-	_ltoa (l, buffer, 10);
+
+	if ((l < FirstMarked) || (l > LastMarked)) {
+
+		_ltoa (l, buffer, 10);
+		return;
+	}
+
+	buffer [0] = NumberMark;
+	_ltoa (l, buffer + 1, 10);
+	size_t n = strlen (buffer);
+	buffer [n] = NumberMark;
+	buffer [n+1] = '\0';
 }
 
 
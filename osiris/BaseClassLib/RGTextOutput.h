@@ -28,7 +28,9 @@
 *
 */
 //
-//  class RGTextOutput automates the outputting of text strings and numbers, simultaneously writing to a file and echoing to a console
+//  class RGTextOutput automates the outputting of text strings and numbers, simultaneously writing to a file and echoing to a console.
+//  Integers in a range given by MarkNumbers are written between NumberMarks, so that they can be found in the output and replaced
+//  without being confused with numbers in the text.
 //
 
 #ifndef _TEXTOUTPUT_H_
@@ -71,10 +73,14 @@ public:
 	virtual ~RGTextOutput ();
 
 	Boolean FileIsValid () const;
+	virtual RGTextOutput* CreateSpool (RGFile* spoolFile) const;	// writes to spoolFile as this writes to its file, without echo
 
 	static void SetResolution (int res) { Resolution = res; }
 	static int GetResolution () { return Resolution; }
 
+	void MarkNumbers (long first, long last) { FirstMarked = first; LastMarked = last; }	// integers from first to last
+	static const char NumberMark;	// a control character, which does not occur in text
+
 	Boolean Write (const RGString& s);
 	Boolean Write (const char* s);
 
@@ -108,6 +114,8 @@ private:
 	Boolean Echo;
 	Boolean CreatedFile;
 	char buffer [51];
+	long FirstMarked;
+	long LastMarked;
 
 	static int Resolution;
 
@@ -0,0 +1,169 @@
+/*
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+*  FileName: rgarena.cpp
+*  Author:   Robert Goor
+*
+*/
+//
+//  class RGArena allocates the objects created during one piece of work from blocks that are returned to the heap together,
+//  and class RGArenaScope makes an arena current in the calling thread
+//
+
+#include "rgarena.h"
+
+
+RG_THREAD_LOCAL RGArena* RGArena::Current = NULL;
+volatile long RGArena::Requests = 0;
+volatile long RGArena::Blocks = 0;
+volatile long RGArena::Arenas = 0;
+
+
+RGArena :: RGArena () : mBlock (NULL), mUsed (0), mAllocated (0), mBalance (0) {
+
+	RGAtomicIncrement (&Arenas);
+}
+
+
+RGArena :: ~RGArena () {
+
+	char* previous;
+
+	while (mBlock != NULL) {
+
+		previous = *(char**) mBlock;
+		::operator delete (mBlock);
+		mBlock = previous;
+	}
+}
+
+
+void* RGArena :: Allocate (size_t size) {
+
+	//  Each object is preceded by HeaderSize bytes holding its arena, or NULL if it came from the heap
+
+#ifdef RG_NO_POOLED_ALLOCATION
+	return ::operator new (size);
+#else
+	RGArena* arena = Current;
+	char* p;
+
+	if ((arena != NULL) && (size <= LargestObject))
+		p = (char*) arena->Carve (size);
+
+	else {
+
+		p = (char*) ::operator new (size + HeaderSize);
+		arena = NULL;
+	}
+
+	*(RGArena**) p = arena;
+	return p + HeaderSize;
+#endif
+}
+
+
+void RGArena :: Free (void* p) {
+
+#ifdef RG_NO_POOLED_ALLOCATION
+	::operator delete (p);
+#else
+	if (p == NULL)
+		return;
+
+	char* header = (char*) p - HeaderSize;
+	RGArena* arena = *(RGArena**) header;
+
+	if (arena == NULL)
+		::operator delete (header);
+
+	else
+		arena->ObjectFreed ();
+#endif
+}
+
+
+void* RGArena :: Carve (size_t size) {
+
+	//  Sizes are rounded up to a multiple of HeaderSize, so that every object is aligned as the heap would align it
+
+	size_t n = HeaderSize + ((size + HeaderSize - 1) / HeaderSize) * HeaderSize;
+
+	if ((mBlock == NULL) || (mUsed + n > BlockSize)) {
+
+		char* block = (char*) ::operator new (BlockSize);
+		*(char**) block = mBlock;
+		mBlock = block;
+		mUsed = HeaderSize;
+		RGAtomicIncrement (&Blocks);
+	}
+
+	void* p = mBlock + mUsed;
+	mUsed += n;
+	mAllocated++;
+	return p;
+}
+
+
+void RGArena :: Release () {
+
+	//
+	//  Until the arena is released, mBalance is less than zero once any object has been freed, so only the release, or the
+	//  last object freed after it, can bring it to zero
+	//
+
+	RGAtomicAdd (&Requests, mAllocated);
+
+	if (RGAtomicAdd (&mBalance, mAllocated) == 0)
+		delete this;
+}
+
+
+void RGArena :: ObjectFreed () {
+
+	if (RGAtomicDecrement (&mBalance) == 0)
+		delete this;
+}
+
+
+RGArenaScope :: RGArenaScope (bool useArena) : mArena (NULL), mPrevious (RGArena::Current) {
+
+#ifndef RG_NO_POOLED_ALLOCATION
+	if (useArena) {
+
+		mArena = new RGArena;
+		RGArena::Current = mArena;
+	}
+#endif
+}
+
+
+RGArenaScope :: ~RGArenaScope () {
+
+	RGArena::Current = mPrevious;
+
+	if (mArena != NULL)
+		mArena->Release ();
+}
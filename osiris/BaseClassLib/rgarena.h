@@ -0,0 +1,106 @@
+/*
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+*  FileName: rgarena.h
+*  Author:   Robert Goor
+*
+*/
+//
+//  class RGArena allocates the objects created during one piece of work, such as the analysis of a sample, by carving them
+//  in sequence from blocks of BlockSize bytes.  Freeing an object only counts it.  The blocks go back to the heap together,
+//  once the arena has been released and every object carved from it has been freed, so an object that outlives the work
+//  keeps its arena's blocks until it is deleted.  Only the thread that created an arena allocates from it, but its objects
+//  may be freed by any thread.
+//
+//  A class opts in by defining operator new and delete on Allocate and Free.  Requests go to the arena of the innermost
+//  RGArenaScope of the calling thread, or to the heap if there is none, and each object records which, so that it is freed
+//  correctly wherever it is deleted.  Objects larger than LargestObject also go to the heap.  Defining
+//  RG_NO_POOLED_ALLOCATION sends all requests to the heap.
+//
+
+#ifndef _RGARENA_H_
+#define _RGARENA_H_
+
+#include "rgthread.h"
+#include <new>
+
+
+class RGArena {
+
+public:
+	enum { BlockSize = 65536, HeaderSize = 16, LargestObject = BlockSize / 16 };
+
+	static void* Allocate (size_t size);
+	static void Free (void* p);
+
+	static RGArena* GetCurrent () { return Current; }	// NULL unless the calling thread is in an RGArenaScope
+
+	static long GetNumberOfRequests () { return RGAtomicGet (&Requests); }	// objects carved from released arenas
+	static long GetNumberOfBlocks () { return RGAtomicGet (&Blocks); }	// each a single heap allocation
+	static long GetNumberOfArenas () { return RGAtomicGet (&Arenas); }
+
+protected:
+	RGArena ();
+	~RGArena ();
+
+	char* mBlock;	// the block being carved; each block begins with a pointer to the one before it
+	size_t mUsed;	// bytes of mBlock carved
+	long mAllocated;	// changed only by the thread that created the arena
+	volatile long mBalance;	// less the number of objects freed; mAllocated is added when the arena is released
+
+	void* Carve (size_t size);
+	void Release ();	// by the thread that created the arena, which allocates no more from it
+	void ObjectFreed ();
+
+	static RG_THREAD_LOCAL RGArena* Current;
+	static volatile long Requests;
+	static volatile long Blocks;
+	static volatile long Arenas;
+
+	friend class RGArenaScope;
+
+private:
+	RGArena (const RGArena&);
+	RGArena& operator= (const RGArena&);
+};
+
+
+class RGArenaScope {
+
+public:
+	RGArenaScope (bool useArena = true);	// a new arena is current in the calling thread until the scope ends, if useArena
+	~RGArenaScope ();
+
+protected:
+	RGArena* mArena;
+	RGArena* mPrevious;
+
+private:
+	RGArenaScope (const RGArenaScope&);
+	RGArenaScope& operator= (const RGArenaScope&);
+};
+
+
+#endif  /*  _RGARENA_H_  */
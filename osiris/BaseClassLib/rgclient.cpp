@@ -41,10 +41,23 @@
 #include "rgclient.h"
 #include "rgcommdefs.h"
 
+#if !defined (_WINDOWS) && !defined (WIN32)
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <string.h>
+
+#endif
+
 
 int RGClient::ReplyBufferSize = 10240;
 
 
+#if defined (_WINDOWS) || defined (WIN32)
+
+
 RGServerPort :: RGServerPort () : OKToReadHandle (0), OKToWriteHandle (0), ContinuationHandle (0), ImTryingToContactYouHandle (0),
 ServerPidHandle (0), BufferHandle (0), HotLineHandle (0), LastError (RGOK), FirstTime (TRUE), Connected (FALSE), ClientId (0),
 Parent (NULL) {}
@@ -719,3 +732,228 @@ int RGClient :: WaitForReadAccess (HANDLE* HandleArray) {
 
 	return 0;
 }
+
+#else
+
+
+RGServerPort :: RGServerPort (const RGString& name) : Name (name), Socket (-1), LastError (RGOK) {}
+
+
+RGServerPort :: ~RGServerPort () {
+
+	Disconnect ();
+}
+
+
+int RGServerPort :: Connect () {
+
+	struct sockaddr_un address;
+	LastError = RGOK;
+
+	if (Name.Length () >= sizeof (address.sun_path)) {
+
+		LastError = RGCHANNELPROBLEM;
+		return -1;
+	}
+
+	memset (&address, 0, sizeof (address));
+	address.sun_family = AF_UNIX;
+	strcpy (address.sun_path, Name.GetData ());
+	Socket = socket (AF_UNIX, SOCK_STREAM, 0);
+
+	if (Socket < 0) {
+
+		LastError = RGNOHANDLE;
+		return -1;
+	}
+
+#ifdef SO_NOSIGPIPE
+	int on = 1;
+	setsockopt (Socket, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof (on));
+#endif
+
+	if (connect (Socket, (struct sockaddr*) &address, sizeof (address)) < 0) {
+
+		close (Socket);
+		Socket = -1;
+		LastError = RGSERVERNULL;
+		return -1;
+	}
+
+	return 0;
+}
+
+
+int RGServerPort :: Disconnect () {
+
+	if (Socket >= 0) {
+
+		close (Socket);
+		Socket = -1;
+	}
+
+	return 0;
+}
+
+
+int RGServerPort :: Send (int len, unsigned char* data) {
+
+	LastError = RGOK;
+
+	if (Socket < 0) {
+
+		LastError = RGCLIENTNOTCONNECTEDTOSERVER;
+		return -1;
+	}
+
+	if (RGWriteMessage (Socket, RGBLOCKINGSEND, len, data) < 0) {
+
+		LastError = RGSERVERTERMINATED;
+		return -1;
+	}
+
+	return 0;
+}
+
+
+Boolean RGServerPort :: isEqual (const RGServerPort* port) {
+
+	return Name == (port->Name);
+}
+
+
+Boolean operator==(const RGServerPort& sp1, const RGServerPort& sp2) {
+
+	return sp1.Name == sp2.Name;
+}
+
+
+RGClient :: RGClient (const RGString& name) : Name (name), NextServerId (1), BufferSize (0), DataBegin (NULL), LastError (RGOK),
+Initialized (TRUE) {
+
+	BufferSize = ReplyBufferSize;
+	DataBegin = new unsigned char [BufferSize];
+}
+
+
+RGClient :: ~RGClient () {
+
+	ServerPortList.ClearAndDestroy ();
+	UnusedServerIds.clearAndDestroy ();
+	delete[] DataBegin;
+}
+
+
+void RGClient :: ResetReplyBufferSize (int newSize) {
+
+	if (newSize > 0)
+		ReplyBufferSize = newSize;
+}
+
+
+int RGClient :: LocateServer (const RGString& name) {
+
+	// use the output of this method as server id to call Send
+
+	RGServerPort* port = new RGServerPort (name);
+	int status = port->Connect ();
+	int id;
+	int* first;
+
+	if (status < 0) {
+
+		LastError = port->GetLastError ();
+		delete port;
+		return -1;
+	}
+
+	first = UnusedServerIds.RemoveFirst ();
+
+	if (first != NULL) {
+
+		id = *first;
+		delete first;
+	}
+
+	else {
+
+		id = NextServerId;
+		NextServerId++;
+	}
+
+	ServerPortList.ReplaceElementAt (id, port);
+	return id;
+}
+
+
+int RGClient :: Send (int serverId, unsigned char* sendBuffer, unsigned char*& replyBuffer, int sendLength, int& replyMax) {
+
+	LastError = RGOK;
+
+	if (serverId <= 0) {
+
+		LastError = RGILLEGALSERVERID;
+		return -1;
+	}
+
+	RGServerPort* port = ServerPortList.GetElementAt (serverId);
+
+	if (port == NULL) {
+
+		LastError = RGSERVERNULL;
+		return -1;
+	}
+
+	if (port->Send (sendLength, sendBuffer) < 0) {
+
+		LastError = port->GetLastError ();
+		RemoveServer (serverId);
+		return -1;
+	}
+
+	return ReceiveReply (serverId, replyBuffer, replyMax);
+}
+
+
+int RGClient :: ReceiveReply (int serverId, unsigned char*& replyBuffer, int& replyMax) {
+
+	unsigned long type;
+	LastError = RGOK;
+	RGServerPort* port = ServerPortList.GetElementAt (serverId);
+
+	if (port == NULL) {
+
+		LastError = RGSERVERNULL;
+		return -1;
+	}
+
+	if (RGReadMessage (port->GetSocket (), type, DataBegin, BufferSize, replyMax) < 0) {
+
+		LastError = RGSERVERTERMINATED;
+		RemoveServer (serverId);
+		return -1;
+	}
+
+	replyBuffer = DataBegin;
+
+	if (type == RGREPLYWITHCONTINUATION)
+		return RGREPLYWITHCONTINUATION;
+
+	return RGREPLY;
+}
+
+
+void RGClient :: RemoveServer (int id) {
+
+	RGServerPort* port = ServerPortList.RemoveElementAt (id);
+
+	if (port == NULL)
+		return;
+
+	delete port;
+	int* newInt = new int;
+	*newInt = id;
+	UnusedServerIds.append (newInt);
+}
+
+#endif
@@ -36,11 +36,16 @@
 // of the client functions.  To Send to a server requires that an RGClient object work through an RGServerPort object.
 // Each RGClient object maintains a list of servers with which it has communicated.
 //
+//  On other platforms, the server is a Unix-domain socket whose path is the server name (see rgserver.h).  A Send returns the
+// first reply, and ReceiveReply returns each further reply when the server replies with continuation.
+//
 
 #ifndef _RGCLIENT_H_
 #define _RGCLIENT_H_
 
+#if defined (_WINDOWS) || defined (WIN32)
 #include <windows.h>
+#endif
 
 #include "rgstring.h"
 #include "rgcommlist.h"
@@ -49,6 +54,9 @@
 class RGClient;
 
 
+#if defined (_WINDOWS) || defined (WIN32)
+
+
 class RGServerPort {
 
 public:
@@ -145,5 +153,66 @@ protected:
 	static int ReplyBufferSize;
 };
 
+#else
+
+
+class RGServerPort {
+
+public:
+	RGServerPort (const RGString& name);
+	~RGServerPort ();
+
+	int Connect ();
+	int Disconnect ();
+	int Send (int len, unsigned char* data);
+	int GetSocket () const { return Socket; }
+	Boolean isEqual (const RGServerPort* port);
+
+	int GetLastError () const { return LastError; }
+	friend Boolean operator==(const RGServerPort& sp1, const RGServerPort& sp2);
+
+protected:
+	RGString Name;
+	int Socket;
+	int LastError;
+};
+
+
+class RGClient {
+
+public:
+	RGClient (const RGString& name);
+	~RGClient ();
+
+	static void ResetReplyBufferSize (int newSize);
+
+	Boolean IsActive () const { return Initialized; }
+
+	const char* GetName () const { return Name.GetData (); }
+	unsigned long GetNameLength () const { return (unsigned long) Name.Length (); }
+	int GetLastError () const { return LastError; }
+
+	int LocateServer (const RGString& name);  // name is the path of the server's socket; use the output as server id to call Send
+	int Send (int serverId, unsigned char* sendBuffer, unsigned char*& replyBuffer, int sendLength, int& replyMax);	// returns RGREPLYWITHCONTINUATION if more replies follow
+	int ReceiveReply (int serverId, unsigned char*& replyBuffer, int& replyMax);	// the next reply, after RGREPLYWITHCONTINUATION
+
+	void RemoveServer (int id);
+
+protected:
+	RGString Name;
+	RGTarray<RGServerPort> ServerPortList;
+	CommDataList<int> UnusedServerIds;
+	int NextServerId;
+
+	int BufferSize;
+	unsigned char* DataBegin;	// reply buffer, returned by Send and ReceiveReply and valid until the next of these
+	int LastError;
+	Boolean Initialized;
+
+	static int ReplyBufferSize;
+};
+
+#endif
+
 
 #endif  /*  _RGCLIENT_H_  */
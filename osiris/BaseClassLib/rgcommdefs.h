@@ -55,5 +55,17 @@ const unsigned long RGSERVERPROBLEM = 100;
 
 #define DATAMAPOFFSET 24
 
+#if !defined (_WINDOWS) && !defined (WIN32)
+
+//  Over a Unix-domain socket, each message is its type and its length, as 32 bit integers, followed by its data
+
+#define RGMESSAGEHEADERSIZE 8
+#define RGMAXMESSAGESIZE 16777216	// longer messages are refused, so that a peer cannot make the reader allocate any amount
+
+int RGWriteMessage (int socket, unsigned long type, int len, const unsigned char* data);	// returns 0 or -1
+int RGReadMessage (int socket, unsigned long& type, unsigned char*& buffer, int& bufferSize, int& len);	// buffer is enlarged as needed; -1 at end of file
+
+#endif
+
 
 #endif   /*  _RGCOMMDEFS_H_  */
@@ -38,6 +38,7 @@
 #include <float.h>
 #ifndef _WINDOWS
 #include <sys/types.h>
+#include <stdint.h>
 #endif
 
 #ifndef _WINDOWS
@@ -131,8 +132,10 @@ typedef unsigned char UINT8;
 
 #ifdef _WIN32
 typedef __int64 INT64;
+typedef unsigned __int64 UINT64;
 #else
 typedef int64_t INT64;
+typedef uint64_t UINT64;
 #endif
 
 // the following 3 lines were commented out because
@@ -408,6 +408,12 @@ Boolean RGDirectory :: MakeDirectory (const char* fullName) {
 }
 
 
+Boolean RGDirectory :: RemoveEmptyDirectory (const RGString& fullName) {
+
+	return RemoveDirectoryW (fullName.GetWData ());
+}
+
+
 Boolean RGDirectory :: MoveDirectory (const RGString& oldName, const RGString& suffix, int MaxLevels) {
 
 	int i = 0;
@@ -452,6 +458,7 @@ Boolean RGDirectory::FileOrDirectoryExists(const RGString& fullPathName) {
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <dirent.h>
+#include <unistd.h>
 
 RGDirectory :: RGDirectory (const RGString& fullName) {
 
@@ -557,4 +564,9 @@ Boolean RGDirectory :: MakeDirectory (const RGString& fullName)
   return MakeDirectory(fullName.GetData());
 }
 
+Boolean RGDirectory :: RemoveEmptyDirectory (const RGString& fullName)
+{
+  return (rmdir (fullName.GetData ()) == 0);
+}
+
 #endif
@@ -57,6 +57,7 @@ public:
 
 	static Boolean MakeDirectory (const RGString& fullName);
 	static Boolean MakeDirectory (const char* fullName);
+	static Boolean RemoveEmptyDirectory (const RGString& fullName);
 #ifdef _WINDOWS
 	static Boolean MoveDirectory (const RGString& oldName, const RGString& suffix, int MaxLevels);
 	static Boolean MoveDirectory (const RGString& oldName, const RGString& newName);
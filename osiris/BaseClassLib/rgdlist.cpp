@@ -34,6 +34,7 @@
 #include "rgdlist.h"
 #include "rgfile.h"
 #include "rgvstream.h"
+#include "rgpool.h"
 
 PERSISTENT_DEFINITION (RGDList, _RGDLIST_, "List")
 
@@ -53,10 +54,24 @@ PersistentLink :: ~PersistentLink () {
 }
 
 
+void* PersistentLink :: operator new (size_t nbytes) {
+
+	return RGPool<PersistentLink>::Allocate (nbytes);
+}
+
+
+void PersistentLink :: operator delete (void* p, size_t nbytes) {
+
+	RGPool<PersistentLink>::Free (p, nbytes);
+}
+
+
 RGDList :: RGDList () : RGPersistent (), 
 	NumberOfEntries (0),
 	FirstLink (NULL),
-	LastLink (NULL) {
+	LastLink (NULL),
+	Modifications (0),
+	Additions (0) {
 
 }
 
@@ -64,7 +79,9 @@ RGDList :: RGDList () : RGPersistent (),
 RGDList :: RGDList (const RGDList& clone) : RGPersistent ((RGPersistent&) clone),
 NumberOfEntries (0),
 FirstLink (NULL),
-LastLink (NULL) {
+LastLink (NULL),
+Modifications (0),
+Additions (0) {
 
 	RGDListIterator it ((RGDList&)clone);
 	RGPersistent* nextItem;
@@ -85,6 +102,46 @@ RGDList :: ~RGDList () {
 }
 
 
+void* RGDList :: operator new (size_t nbytes) {
+
+	//  Derived classes are larger, so they go to the heap
+
+	return RGPool<RGDList>::Allocate (nbytes);
+}
+
+
+void RGDList :: operator delete (void* p, size_t nbytes) {
+
+	RGPool<RGDList>::Free (p, nbytes);
+}
+
+
+long RGDList :: GetNumberOfLinkRequests () {
+
+	RGPool<PersistentLink>::FlushCounts ();
+	return RGPool<PersistentLink>::GetNumberOfRequests ();
+}
+
+
+long RGDList :: GetNumberOfLinkBlocks () {
+
+	return RGPool<PersistentLink>::GetNumberOfBlocks ();
+}
+
+
+long RGDList :: GetNumberOfListRequests () {
+
+	RGPool<RGDList>::FlushCounts ();
+	return RGPool<RGDList>::GetNumberOfRequests ();
+}
+
+
+long RGDList :: GetNumberOfListBlocks () {
+
+	return RGPool<RGDList>::GetNumberOfBlocks ();
+}
+
+
 size_t RGDList :: StoreSize () const {
 
 	PersistentLink* CurrentLink = FirstLink;
@@ -293,6 +350,8 @@ RGPersistent* RGDList :: Append (RGPersistent* NewItem) {
 
 	PersistentLink* NewLink = new PersistentLink;
 	NewLink->Item = NewItem;
+	Modifications++;
+	Additions++;
 
 	if (NumberOfEntries == 0) {
 
@@ -318,6 +377,8 @@ RGPersistent* RGDList :: Prepend (RGPersistent* NewItem) {
 
 	PersistentLink* NewLink = new PersistentLink;
 	NewLink->Item = NewItem;
+	Modifications++;
+	Additions++;
 
 	if (NumberOfEntries == 0) {
 
@@ -420,6 +481,8 @@ RGPersistent* RGDList :: GetFirst () {
 	if (NumberOfEntries == 0)
 		return NULL;
 
+	Modifications++;
+
 	if (NumberOfEntries == 1) {
 
 		FirstItem = FirstLink->Item;
@@ -450,6 +513,8 @@ RGPersistent* RGDList :: GetLast () {
 	if (NumberOfEntries == 0)
 		return NULL;
 
+	Modifications++;
+
 	if (NumberOfEntries == 1) {
 
 		LastItem = LastLink->Item;
@@ -483,6 +548,7 @@ int RGDList :: Clear () {
 
 	NumberOfEntries = 0;
 	FirstLink = LastLink = NULL;
+	Modifications++;
 	return 0;
 }
 
@@ -505,6 +571,7 @@ int RGDList :: ClearAndDelete () {
 
 	NumberOfEntries = 0;
 	FirstLink = LastLink = NULL;
+	Modifications++;
 	return 0;
 }
 
@@ -572,6 +639,8 @@ RGPersistent* RGDList :: Insert (RGPersistent* target) {
 		NewLink->Item = target;
 		FirstLink = LastLink = NewLink;
 		NumberOfEntries = 1;
+		Modifications++;
+		Additions++;
 	}
 
 	else if (target->CompareTo (FirstLink->Item) <= 0)
@@ -596,6 +665,8 @@ RGPersistent* RGDList :: Insert (RGPersistent* target) {
 				NewLink->Previous = PreviousLink;
 				NewLink->Next = NextLink;
 				NumberOfEntries++;
+				Modifications++;
+				Additions++;
 				return target;
 			}
 
@@ -623,6 +694,8 @@ RGPersistent* RGDList :: InsertWithNoDuplication (RGPersistent* target) {
 		NewLink->Item = target;
 		FirstLink = LastLink = NewLink;
 		NumberOfEntries = 1;
+		Modifications++;
+		Additions++;
 	}
 
 	else if (target->CompareTo (FirstLink->Item) == 0)
@@ -655,6 +728,8 @@ RGPersistent* RGDList :: InsertWithNoDuplication (RGPersistent* target) {
 				NewLink->Previous = PreviousLink;
 				NewLink->Next = NextLink;
 				NumberOfEntries++;
+				Modifications++;
+				Additions++;
 				return target;
 			}
 
@@ -686,6 +761,8 @@ RGPersistent* RGDList :: InsertWithNoReferenceDuplication (RGPersistent* target)
 		NewLink->Item = target;
 		FirstLink = LastLink = NewLink;
 		NumberOfEntries = 1;
+		Modifications++;
+		Additions++;
 	}
 
 	else if (target == FirstLink->Item)
@@ -727,6 +804,8 @@ RGPersistent* RGDList :: InsertWithNoReferenceDuplication (RGPersistent* target)
 				NewLink->Previous = PreviousLink;
 				NewLink->Next = NextLink;
 				NumberOfEntries++;
+				Modifications++;
+				Additions++;
 				return target;
 			}
 
@@ -1057,6 +1136,8 @@ RGPersistent* RGDListIterator :: InsertAfterCurrentItem (RGPersistent* target) {
 	NewLink->Previous = Current;
 	Current = NewLink;
 	List->NumberOfEntries++;
+	List->Modifications++;
+	List->Additions++;
 	return target;
 }
 
@@ -1093,6 +1174,7 @@ RGPersistent* RGDListIterator :: RemoveCurrentItem () {
 		Prev->Next = Next;
 		Next->Previous = Prev;
 		List->NumberOfEntries--;
+		List->Modifications++;
 		delete Current;
 		Current = Prev;
 	}
@@ -1142,6 +1224,7 @@ RGPersistent* RGDListIterator :: RemoveNext (const RGPersistent* target) {
 				Next->Previous = Prev;
 
 			List->NumberOfEntries--;
+			List->Modifications++;
 			delete NextLink;
 			return NextItem;
 		}
@@ -1194,6 +1277,7 @@ RGPersistent* RGDListIterator :: RemoveNextReference (const RGPersistent* target
 				Next->Previous = Prev;
 
 			List->NumberOfEntries--;
+			List->Modifications++;
 			delete NextLink;
 			return NextItem;
 		}
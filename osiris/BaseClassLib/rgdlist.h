@@ -28,7 +28,8 @@
 *
 */
 //
-//	class RGDList - doubly linked list class that is persistent.  It stores other RGPersistent objects
+//	class RGDList - doubly linked list class that is persistent.  It stores other RGPersistent objects.  Links, and lists
+//	allocated with new, come from an RGPool, because so many are created and destroyed.
 //
 
 #ifndef _RGDLIST_H_
@@ -48,6 +49,9 @@ struct PersistentLink {
 
 	PersistentLink ();
 	~PersistentLink ();
+
+	void* operator new (size_t);
+	void operator delete (void*, size_t);
 };
 
 
@@ -65,6 +69,14 @@ public:
 	RGDList (const RGDList&);  // deep copy constructor - makes copies of links
 	virtual ~RGDList ();
 
+	void* operator new (size_t);
+	void operator delete (void*, size_t);
+
+	static long GetNumberOfLinkRequests ();
+	static long GetNumberOfLinkBlocks ();
+	static long GetNumberOfListRequests ();
+	static long GetNumberOfListBlocks ();
+
 	virtual size_t StoreSize () const;
 	virtual int CompareTo (const RGPersistent*) const;
 	virtual unsigned HashNumber (unsigned long Base) const;
@@ -112,6 +124,8 @@ protected:
 	int NumberOfEntries;
 	PersistentLink* FirstLink;
 	PersistentLink* LastLink;
+	unsigned long Modifications;	// changes whenever a link is added or removed, so that derived classes can tell when an index is stale
+	unsigned long Additions;	// changes whenever a link is added, so that derived classes can tell when only links were removed
 
 };
 
@@ -32,18 +32,25 @@
 //
 
 #include <stdio.h>
+#include <string.h>
 
 #ifdef _WINDOWS
 
 #include <process.h>
 #include <io.h>
 #include <time.h>
+#include <fcntl.h>
+#include <string>
+#include <vector>
 
 #elif defined WIN32
 
 #include <process.h>
 #include <io.h>
 #include <time.h>
+#include <fcntl.h>
+#include <string>
+#include <vector>
 
 #else
 
@@ -52,6 +59,7 @@
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <errno.h>
+#include <signal.h>
 
 #endif
 
@@ -68,6 +76,160 @@ int RGExec :: System (const char* cmd) {
 	return system (cmd);
 }
 
+
+#if defined (_WINDOWS) || defined (WIN32)
+
+int RGExec :: RunWithInput (const char* const* args, const char* input) {
+
+	//
+	//	Returns the exit status of the program, or -1 if it could not be started.  The arguments are quoted, because the
+	//	spawn functions join them into one command line
+	//
+
+	std::vector<std::string> quoted;
+	std::vector<const char*> quotedArgs;
+	int i;
+
+	for (i=0; args [i] != NULL; i++)
+		quoted.push_back (std::string ("\"") + args [i] + "\"");
+
+	for (i=0; i<(int)quoted.size (); i++)
+		quotedArgs.push_back (quoted [i].c_str ());
+
+	quotedArgs.push_back (NULL);
+	int fds [2];
+
+	if (_pipe (fds, 4096, _O_BINARY | _O_NOINHERIT) != 0)
+		return -1;
+
+	//  The child inherits standard in, so the read end of the pipe stands in for it while the child is started
+
+	_flushall ();
+	int savedInput = _dup (0);
+	_dup2 (fds [0], 0);
+	intptr_t child = _spawnvp (_P_NOWAIT, args [0], &quotedArgs [0]);
+	_dup2 (savedInput, 0);
+	_close (savedInput);
+	_close (fds [0]);
+
+	if (child == -1) {
+
+		_close (fds [1]);
+		return -1;
+	}
+
+	unsigned int left = (unsigned int) strlen (input);
+	int written;
+
+	while (left > 0) {
+
+		written = _write (fds [1], input, left);
+
+		if (written <= 0)
+			break;
+
+		input += written;
+		left -= written;
+	}
+
+	_close (fds [1]);
+	int status;
+
+	if (_cwait (&status, child, 0) == -1)
+		return -1;
+
+	return status;
+}
+
+#else
+
+int RGExec :: RunWithInput (const char* const* args, const char* input) {
+
+	//
+	//	Returns the exit status of the program, or -1 if it could not be started or did not exit normally.  No shell is
+	//	involved, so the arguments are passed exactly as they are.  The child keeps only standard in, out and error open
+	//
+
+	int fds [2];
+
+	if (pipe (fds) != 0)
+		return -1;
+
+	long maxDescriptors = sysconf (_SC_OPEN_MAX);
+
+	if ((maxDescriptors < 0) || (maxDescriptors > 65536))
+		maxDescriptors = 65536;
+
+	fflush (NULL);
+	pid_t child = fork ();
+
+	if (child == 0) {
+
+		//  only async-signal-safe calls between fork and exec
+
+		if (fds [0] != 0) {
+
+			dup2 (fds [0], 0);
+			close (fds [0]);
+		}
+
+		close (fds [1]);
+
+		for (int fd=3; fd<maxDescriptors; fd++)
+			close (fd);
+
+		execvp (args [0], (char* const*) args);
+		_exit (127);
+	}
+
+	close (fds [0]);
+
+	if (child < 0) {
+
+		close (fds [1]);
+		return -1;
+	}
+
+	//  A child that exits without reading all of its input must not end this process with SIGPIPE
+
+	void (*oldHandler) (int) = signal (SIGPIPE, SIG_IGN);
+	size_t left = strlen (input);
+	ssize_t written;
+
+	while (left > 0) {
+
+		written = write (fds [1], input, left);
+
+		if (written < 0) {
+
+			if (errno == EINTR)
+				continue;
+
+			break;
+		}
+
+		input += written;
+		left -= written;
+	}
+
+	close (fds [1]);
+	signal (SIGPIPE, oldHandler);
+	int status;
+
+	while (waitpid (child, &status, 0) < 0) {
+
+		if (errno != EINTR)
+			return -1;
+	}
+
+	if (!WIFEXITED (status))
+		return -1;
+
+	return WEXITSTATUS (status);
+}
+
+#endif
+
 #ifdef _WINDOWS
 
 long int RGExec :: FileModificationTime (const char* file) {
@@ -41,6 +41,7 @@ public:
 	~RGExec ();
 
 	static int System (const char* cmd);
+	static int RunWithInput (const char* const* args, const char* input);  // args as for execvp, NULL terminated; input is piped to standard in
 	static long int FileModificationTime (const char* file);
 	static long int FileSize (const char* file);
 };
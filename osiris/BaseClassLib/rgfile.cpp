@@ -99,6 +99,23 @@ RGFile :: RGFile(const char* name, const char* mode) :
   strcpy (Mode, mode);
 }
 
+RGFile :: RGFile () : FileName (NULL), FilePtr (NULL), Mode (NULL) {
+
+}
+
+
+RGFile* RGFile :: CreateTemporaryFile () {
+
+	RGFile* temp = new RGFile;
+	temp->FilePtr = tmpfile ();
+	temp->FileName = new char [1];
+	temp->FileName [0] = '\0';
+	temp->Mode = new char [strlen (NewMode) + 1];
+	strcpy (temp->Mode, NewMode);
+	return temp;
+}
+
+
 RGFile :: ~RGFile()
 {
 	Close();
@@ -46,6 +46,8 @@ public:
   RGFile (const char* name, const char* mode = NULL);  // Assumes a binary file; under Windows, 
 		// may have to use mode = "wb+"
   virtual ~RGFile ();
+
+  static RGFile* CreateTemporaryFile ();  // opened for update; removed by the system when closed
        
   const char* Access() const;
   const char* GetName ()   const { return FileName; }
@@ -116,6 +118,7 @@ public:
   Boolean good () {return (isValid () && !Error() && !Eof());}
 
 protected:
+  RGFile ();
 #ifdef  _WINDOWS
   static FILE *_Fopen(const char *psFileName, const char *pMode);
 #else
@@ -36,65 +36,68 @@
 #include "rgfile.h"
 #include "rgvstream.h"
 
+
 int RGHashTable::RGDefaultNumberOfHashLists = 257;  // This is a prime number:  see rghashtable.h
 
 PERSISTENT_DEFINITION (RGHashTable, _RGHASHTABLE_, "HashTable")
 
 
-RGHashTable :: RGHashTable () : RGPersistent (), NumberOfEntries (0), 
-NumberOfLists (RGHashTable::RGDefaultNumberOfHashLists) {
+//
+//  Slot values other than entry indices, and the smallest sizes allocated.  The number of slots must be a power of 2
+//
+
+static const int EmptySlot = -1;
+static const int RemovedSlot = -2;
+static const unsigned long MinimumNumberOfSlots = 8;
+static const int MinimumNumberOfEntries = 4;
 
-	ListArray = new RGDList* [NumberOfLists];
 
-	for (int i=0; i<NumberOfLists; i++)
-		ListArray [i] = new RGDList;
+RGHashTable :: RGHashTable () : RGPersistent (), EntryArray (NULL), EntryCapacity (0), FreeEntry (-1),
+SlotArray (NULL), SlotMask (0), NumberOfRemovedSlots (0), ListFirst (NULL), ListLast (NULL), NumberOfEntries (0), 
+NumberOfLists (RGHashTable::RGDefaultNumberOfHashLists) {
+
 }
 
-RGHashTable :: RGHashTable (int nTables) : RGPersistent (), NumberOfEntries (0),
+RGHashTable :: RGHashTable (int nTables) : RGPersistent (), EntryArray (NULL), EntryCapacity (0), FreeEntry (-1),
+SlotArray (NULL), SlotMask (0), NumberOfRemovedSlots (0), ListFirst (NULL), ListLast (NULL), NumberOfEntries (0),
 NumberOfLists (nTables) {
 
-	if (NumberOfLists <= 0)
+	if (nTables <= 0)
 		NumberOfLists = RGHashTable::RGDefaultNumberOfHashLists;
-
-	ListArray = new RGDList* [NumberOfLists];
-
-	for (int i=0; i<NumberOfLists; i++)
-		ListArray [i] = new RGDList;
 }
 
 
-RGHashTable :: RGHashTable (const RGHashTable& hTable) : RGPersistent ((RGPersistent&) hTable), 
-NumberOfEntries (hTable.NumberOfEntries), NumberOfLists (hTable.NumberOfLists) {
+RGHashTable :: RGHashTable (const RGHashTable& hTable) : RGPersistent ((RGPersistent&) hTable), EntryArray (NULL), 
+EntryCapacity (0), FreeEntry (-1), SlotArray (NULL), SlotMask (0), NumberOfRemovedSlots (0), ListFirst (NULL),
+ListLast (NULL), NumberOfEntries (0), NumberOfLists (hTable.NumberOfLists) {
 	
 	//
 	// deep copy constructor - makes copies of links
 	//
 
-	ListArray = new RGDList* [NumberOfLists];
-
-	for (int i=0; i<NumberOfLists; i++)
-		ListArray [i] = new RGDList (*hTable.ListArray [i]);
+	CopyEntries (hTable);
 }
 
 
 RGHashTable :: ~RGHashTable () {
 
-	for (int i=0; i<NumberOfLists; i++) {
-
-		ListArray [i]->ClearAndDelete ();
-		delete ListArray [i];
-	}
-
-	delete[] ListArray;
+	ClearAndDelete ();
 }
 
 
 size_t RGHashTable :: StoreSize () const {
 
-	size_t size = 0;
+	//
+	//  Each list is stored as an RGDList would be
+	//
+
+	size_t size = NumberOfLists * (RGPersistent::StoreSize () + sizeof (int));
 
-	for (int i=0; i<NumberOfLists; i++)
-		size += ListArray [i]->StoreSize ();
+	for (int i=0; i<EntryCapacity; i++) {
+
+		if (EntryArray [i].Item != NULL)
+			size += EntryArray [i].Item->StoreSize ();
+	}
 
 	size += 2 * sizeof (int);
 	return size;
@@ -124,50 +127,32 @@ void RGHashTable :: RestoreAll (RGFile& f) {
 	RGPersistent::RestoreAll (f);
 	ClearAndDelete ();
 	int TempNumberOfLists;
+	int TempNumberOfEntries;
 	f.Read (TempNumberOfLists);
-	RGDList** TempArray;
-
-	if (TempNumberOfLists < NumberOfLists) {
 
-		TempArray = new RGDList* [TempNumberOfLists];
-		
-		for (int i=0; i<NumberOfLists; i++) {
-
-			if (i >= TempNumberOfLists)
-				delete ListArray [i];
+	if (TempNumberOfLists > 0)
+		NumberOfLists = TempNumberOfLists;
 
-			else
-				TempArray [i] = ListArray [i];
-		}
+	f.Read (TempNumberOfEntries);
 
-		delete[] ListArray;
-		ListArray = TempArray;
-		NumberOfLists = TempNumberOfLists;
-	}
+	//
+	//  The items of each stored list go back into the same list, in order, without being rehashed
+	//
 
-	else if (TempNumberOfLists > NumberOfLists) {
+	RGDList list;
+	RGPersistent* next;
+	int entry;
 
-		TempArray = new RGDList* [TempNumberOfLists];
+	for (int i=0; i<NumberOfLists; i++) {
 
-		for (int i=0; i<TempNumberOfLists; i++) {
+		list.RestoreAll (f);
 
-			if (i < NumberOfLists)
-				TempArray [i] = ListArray [i];
+		while (next = list.GetFirst ()) {
 
-			else
-				TempArray [i] = new RGDList;
+			entry = AddEntry (next, i);
+			LinkAfter (entry, ListLast [i]);
 		}
-
-		delete[] ListArray;
-		ListArray = TempArray;
-		NumberOfLists = TempNumberOfLists;
 	}
-
-	f.Read (NumberOfEntries);
-
-	for (int i=0; i<NumberOfLists; i++)
-		ListArray [i]->RestoreAll (f);
-
 }
 
 
@@ -176,49 +161,28 @@ void RGHashTable :: RestoreAll (RGVInStream& f) {
 	RGPersistent::RestoreAll (f);
 	ClearAndDelete ();
 	int TempNumberOfLists;
+	int TempNumberOfEntries;
 	f >> TempNumberOfLists;
-	RGDList** TempArray;
-
-	if (TempNumberOfLists < NumberOfLists) {
-
-		TempArray = new RGDList* [TempNumberOfLists];
-		
-		for (int i=0; i<NumberOfLists; i++) {
-
-			if (i >= TempNumberOfLists)
-				delete ListArray [i];
-
-			else
-				TempArray [i] = ListArray [i];
-		}
 
-		delete[] ListArray;
-		ListArray = TempArray;
+	if (TempNumberOfLists > 0)
 		NumberOfLists = TempNumberOfLists;
-	}
 
-	else if (TempNumberOfLists > NumberOfLists) {
+	f >> TempNumberOfEntries;
+
+	RGDList list;
+	RGPersistent* next;
+	int entry;
 
-		TempArray = new RGDList* [TempNumberOfLists];
+	for (int i=0; i<NumberOfLists; i++) {
 
-		for (int i=0; i<TempNumberOfLists; i++) {
+		list.RestoreAll (f);
 
-			if (i < NumberOfLists)
-				TempArray [i] = ListArray [i];
+		while (next = list.GetFirst ()) {
 
-			else
-				TempArray [i] = new RGDList;
+			entry = AddEntry (next, i);
+			LinkAfter (entry, ListLast [i]);
 		}
-
-		delete[] ListArray;
-		ListArray = TempArray;
-		NumberOfLists = TempNumberOfLists;
 	}
-
-	f >> NumberOfEntries;
-
-	for (int i=0; i<NumberOfLists; i++)
-		ListArray [i]->RestoreAll (f);
 }
 
 
@@ -227,9 +191,19 @@ void RGHashTable :: SaveAll (RGFile& f) const {
 	RGPersistent::SaveAll (f);
 	f.Write (NumberOfLists);
 	f.Write (NumberOfEntries);
+	RGDList list;
+
+	for (int i=0; i<NumberOfLists; i++) {
+
+		if (ListFirst != NULL) {
 
-	for (int i=0; i<NumberOfLists; i++)
-		ListArray [i]->SaveAll (f);
+			for (int entry=ListFirst [i]; entry>=0; entry=EntryArray [entry].Next)
+				list.Append (EntryArray [entry].Item);
+		}
+
+		list.SaveAll (f);
+		list.Clear ();
+	}
 }
 
 
@@ -238,9 +212,19 @@ void RGHashTable :: SaveAll (RGVOutStream& f) const {
 	RGPersistent::SaveAll (f);
 	f << NumberOfLists;
 	f << NumberOfEntries;
+	RGDList list;
+
+	for (int i=0; i<NumberOfLists; i++) {
 
-	for (int i=0; i<NumberOfLists; i++)
-		ListArray [i]->SaveAll (f);
+		if (ListFirst != NULL) {
+
+			for (int entry=ListFirst [i]; entry>=0; entry=EntryArray [entry].Next)
+				list.Append (EntryArray [entry].Item);
+		}
+
+		list.SaveAll (f);
+		list.Clear ();
+	}
 }
 
 
@@ -255,22 +239,9 @@ RGHashTable& RGHashTable :: operator=(const RGHashTable& hTable) {
 	if (this == &hTable)
 		return *this;
 
-	for (int i=0; i<NumberOfLists; i++) {
-
-		ListArray [i]->ClearAndDelete ();
-		delete ListArray [i];
-	}
-
-	delete[] ListArray;
-
+	ClearAndDelete ();
 	NumberOfLists = hTable.NumberOfLists;
-	NumberOfEntries = hTable.NumberOfEntries;
-
-	ListArray = new RGDList* [NumberOfLists];
-
-	for (int i=0; i<NumberOfLists; i++)
-		ListArray [i] = new RGDList (*hTable.ListArray [i]);
-
+	CopyEntries (hTable);
 	return *this;
 }
 
@@ -278,87 +249,67 @@ RGHashTable& RGHashTable :: operator=(const RGHashTable& hTable) {
 
 void RGHashTable :: ResizeTable (int size) {
 
-	RGPersistent* next;
-	unsigned hash;
-	unsigned index;
-	int i;
-	if (NumberOfLists < size) {
-
-		RGDList** NewArray = new RGDList* [size];
-
-		for (i=0; i<size; i++) {
-
-			if (i < NumberOfLists)
-				NewArray [i] = ListArray [i];
-
-			else
-				NewArray [i] = new RGDList;
-		}
-
-		delete[] ListArray;
-		ListArray = NewArray;
-
-		for (i=0; i<NumberOfLists; i++) {
+	//
+	//  Moves the items whose list changes, in the same order and to the same positions as when the lists were
+	//  RGDLists.  The index of slots does not depend on the number of lists.
+	//
 
-			if (ListArray [i]->Entries() > 0) {
+	if ((size <= 0) || (size == NumberOfLists))
+		return;
 
-				RGDListIterator* it = new RGDListIterator (*ListArray [i]);
+	if (ListFirst == NULL) {
 
-				while (next = (*it)()) {
+		NumberOfLists = size;
+		return;
+	}
 
-					hash = next->HashNumber (size);
-					index = hash%size;
+	unsigned long nLists = (size > NumberOfLists) ? size : NumberOfLists;
+	int* NewFirst = new int [nLists];
+	int* NewLast = new int [nLists];
+	unsigned long i;
+	unsigned long index;
+	int entry;
+	int next;
 
-					if (index != i) {
+	for (i=0; i<nLists; i++) {
 
-						it->RemoveCurrentItem ();
-						ListArray [index]->Insert (next);
-					}
-				}
+		if (i < NumberOfLists) {
 
-				delete it;
-			}
+			NewFirst [i] = ListFirst [i];
+			NewLast [i] = ListLast [i];
 		}
 
-		NumberOfLists = size;
+		else
+			NewFirst [i] = NewLast [i] = -1;
 	}
 
-	else if ((NumberOfLists > size) && (size > 0)) {
-
-		RGDList** NewArray = new RGDList* [size];
-
-		for (int i=0; i<NumberOfLists; i++) {
-
-			if (i < size)
-				NewArray [i] = ListArray [i];
+	delete[] ListFirst;
+	delete[] ListLast;
+	ListFirst = NewFirst;
+	ListLast = NewLast;
 
-			if (ListArray [i]->Entries() > 0) {
+	for (i=0; i<NumberOfLists; i++) {
 
-				RGDListIterator* it = new RGDListIterator (*ListArray [i]);
+		entry = ListFirst [i];
 
-				while (next = (*it)()) {
+		while (entry >= 0) {
 
-					hash = next->HashNumber (size);
-					index = hash%size;
+			next = EntryArray [entry].Next;
+			index = EntryArray [entry].Item->HashNumber (size);
+			index = index%size;
 
-					if (index != i) {
+			if (index != i) {
 
-						it->RemoveCurrentItem ();
-						ListArray [index]->Insert (next);
-					}
-				}
-
-				delete it;
+				UnlinkEntry (entry);
+				EntryArray [entry].List = index;
+				LinkInOrder (entry);
 			}
 
-			if (i >= size)
-				delete ListArray [i];
+			entry = next;
 		}
-
-		delete[] ListArray;
-		ListArray = NewArray;
-		NumberOfLists = size;
 	}
+
+	NumberOfLists = size;
 }
 
 
@@ -372,63 +323,84 @@ void RGHashTable :: ResetDefaultSize (int size) {
 
 RGPersistent* RGHashTable :: Append (RGPersistent* p) {
 
-	RGDList* list = SelectList (p);
-	NumberOfEntries++;
-	return list->Append (p);
+	unsigned long list = SelectList (p);
+	int entry = AddEntry (p, list);
+	LinkAfter (entry, ListLast [list]);
+	return p;
 }
 
 
 
 RGPersistent* RGHashTable :: Prepend (RGPersistent* p) {
 
-	RGDList* list = SelectList (p);
-	NumberOfEntries++;
-	return list->Prepend (p);
+	int entry = AddEntry (p, SelectList (p));
+	LinkAfter (entry, -1);
+	return p;
 }
 
 
 Boolean RGHashTable :: Contains (const RGPersistent* p) const {
 
-	RGDList* list = SelectList (p);
-	return list->Contains (p);
+	return (FindEntry (p, FALSE) >= 0);
 }
 
 
 RGPersistent* RGHashTable :: Remove (const RGPersistent* target) {
 
-	RGDList* list = SelectList (target);
-	RGPersistent* q = list->Remove (target);
+	int entry = FindEntry (target, FALSE);
 
-	if (q != NULL)
-		NumberOfEntries--;
+	if (entry < 0)
+		return NULL;
 
+	RGPersistent* q = EntryArray [entry].Item;
+	RemoveEntry (entry);
 	return q;
 }
 
 
 RGPersistent* RGHashTable :: Find (const RGPersistent* target) const {
 
-	RGDList* list = SelectList (target);
-	return list->Find (target);
+	int entry = FindEntry (target, FALSE);
+
+	if (entry < 0)
+		return NULL;
+
+	return EntryArray [entry].Item;
 }
 
 
 int RGHashTable :: Clear () {
 
-	for (int i=0; i<NumberOfLists; i++)
-		ListArray[i]->Clear ();
-
-	NumberOfEntries = 0;
+	ReleaseAll ();
 	return 0;
 }
 
 
 int RGHashTable :: ClearAndDelete () {
 
-	for (int i=0; i<NumberOfLists; i++)
-		ListArray[i]->ClearAndDelete ();
+	//
+	//  Items are deleted in list order
+	//
 
-	NumberOfEntries = 0;
+	int entry;
+	int next;
+
+	if (ListFirst != NULL) {
+
+		for (int i=0; i<NumberOfLists; i++) {
+
+			entry = ListFirst [i];
+
+			while (entry >= 0) {
+
+				next = EntryArray [entry].Next;
+				delete EntryArray [entry].Item;
+				entry = next;
+			}
+		}
+	}
+
+	ReleaseAll ();
 	return 0;
 }
 
@@ -447,113 +419,463 @@ int RGHashTable :: Entries () const {
 
 int RGHashTable :: OccurrencesOf (const RGPersistent* p) const {
 
-	RGDList* list = SelectList (p);
-	return list->OccurrencesOf (p);
+	return CountEntries (p, FALSE);
 }
 
 
 
 RGPersistent* RGHashTable :: Insert (RGPersistent* p) {
 
-	RGDList* list = SelectList (p);
-	NumberOfEntries++;
-	return list->Insert (p);
+	int entry = AddEntry (p, SelectList (p));
+	LinkInOrder (entry);
+	return p;
 }
 
 Boolean RGHashTable :: ContainsReference (const RGPersistent* p) const {
 	
 	// contains pointer
 
-	RGDList* list = SelectList (p);
-	return list->ContainsReference (p);
+	return (FindEntry (p, TRUE) >= 0);
 }
 
 
 RGPersistent* RGHashTable :: FindReference (const RGPersistent* p) {
 
-	RGDList* list = SelectList (p);
-	return list->FindReference (p);
+	int entry = FindEntry (p, TRUE);
+
+	if (entry < 0)
+		return NULL;
+
+	return EntryArray [entry].Item;
 }
 
 
 int RGHashTable :: OccurrencesOfReference (const RGPersistent* p) const {
 
-	RGDList* list = SelectList (p);
-	return list->OccurrencesOfReference (p);
+	return CountEntries (p, TRUE);
 }
 
 
 
 RGPersistent* RGHashTable :: RemoveReference (const RGPersistent* p) {
 
-	RGDList* list = SelectList (p);
-	RGPersistent* q = list->RemoveReference (p);
+	int entry = FindEntry (p, TRUE);
 
-	if (q != NULL)
-		NumberOfEntries--;
+	if (entry < 0)
+		return NULL;
 
+	RGPersistent* q = EntryArray [entry].Item;
+	RemoveEntry (entry);
 	return q;
 }
 
 
 RGPersistent* RGHashTable :: RemoveAllReferences (const RGPersistent* p) {
 
-	RGDList* list = SelectList (p);
-	int NEntriesStart = list->Entries ();
-	int NEntriesEnd;
-	RGPersistent* q = list->RemoveAllReferences (p);
-	NEntriesEnd = list->Entries ();
-	NumberOfEntries -= (NEntriesStart - NEntriesEnd);
-	return q;
+	int entry;
+	int n = 0;
+
+	while ((entry = FindEntry (p, TRUE)) >= 0) {
+
+		RemoveEntry (entry);
+		n++;
+	}
+
+	if (n == 0)
+		return NULL;
+
+	return (RGPersistent*) p;
 }
 
 
-RGDList* RGHashTable :: SelectList (const RGPersistent* p) const {
+unsigned long RGHashTable :: SelectList (const RGPersistent* p) const {
 
-	unsigned hash = p->HashNumber (NumberOfLists);
+	unsigned long hash = p->HashNumber (NumberOfLists);
 
 	if (hash >= NumberOfLists)
 		hash = hash%NumberOfLists;
 
-	return ListArray [hash];
+	return hash;
 }
 
 
+int RGHashTable :: AddEntry (RGPersistent* p, unsigned long list) {
+
+	//
+	//  Returns the index of a new entry for p that is in the index of slots but not yet linked into its list.  The
+	//  slots are rebuilt before more than half of them are in use, counting those of removed entries.
+	//
 
-RGHashTableIterator :: RGHashTableIterator (RGHashTable& ht) : List (&ht), CurrentListIndex (0), 
-NumberOfLists (ht.NumberOfLists) {
+	unsigned long hash = MixHash (p->FullHashNumber ());
+	int i;
+
+	if ((SlotArray == NULL) || (2 * (unsigned long)(NumberOfEntries + NumberOfRemovedSlots + 1) > SlotMask + 1)) {
+
+		unsigned long nSlots = MinimumNumberOfSlots;
+
+		while (nSlots < 4 * (unsigned long)(NumberOfEntries + 1))
+			nSlots *= 2;
+
+		RebuildSlots (nSlots);
+	}
 
-	ListIteratorArray = new RGDListIterator* [NumberOfLists];
+	if (FreeEntry < 0) {
 
-	for (int i=0; i<NumberOfLists; i++)
-		ListIteratorArray [i] = new RGDListIterator (*List->ListArray [i]);
+		int NewCapacity = (EntryCapacity > 0) ? 2 * EntryCapacity : MinimumNumberOfEntries;
+		RGHashTableEntry* NewArray = new RGHashTableEntry [NewCapacity];
+
+		for (i=0; i<EntryCapacity; i++)
+			NewArray [i] = EntryArray [i];
+
+		for (i=EntryCapacity; i<NewCapacity; i++) {
+
+			NewArray [i].Item = NULL;
+			NewArray [i].Next = (i < NewCapacity - 1) ? i + 1 : -1;
+		}
+
+		delete[] EntryArray;
+		EntryArray = NewArray;
+		FreeEntry = EntryCapacity;
+		EntryCapacity = NewCapacity;
+	}
+
+	if (ListFirst == NULL) {
+
+		ListFirst = new int [NumberOfLists];
+		ListLast = new int [NumberOfLists];
+
+		for (i=0; i<NumberOfLists; i++)
+			ListFirst [i] = ListLast [i] = -1;
+	}
 
-	CurrentIterator = ListIteratorArray [0];
+	int entry = FreeEntry;
+	RGHashTableEntry& newEntry = EntryArray [entry];
+	FreeEntry = newEntry.Next;
+	newEntry.Item = p;
+	newEntry.Hash = hash;
+	newEntry.List = list;
+	newEntry.Previous = newEntry.Next = -1;
+	InsertSlot (entry);
+	NumberOfEntries++;
+	return entry;
 }
 
 
-RGHashTableIterator :: ~RGHashTableIterator () {
+void RGHashTable :: LinkAfter (int entry, int previous) {
+
+	RGHashTableEntry& e = EntryArray [entry];
+	unsigned long list = e.List;
+	e.Previous = previous;
+
+	if (previous < 0) {
+
+		e.Next = ListFirst [list];
+		ListFirst [list] = entry;
+	}
+
+	else {
 
-	for (int i=0; i<NumberOfLists; i++)
-		delete ListIteratorArray [i];
+		e.Next = EntryArray [previous].Next;
+		EntryArray [previous].Next = entry;
+	}
+
+	if (e.Next < 0)
+		ListLast [list] = entry;
+
+	else
+		EntryArray [e.Next].Previous = entry;
+}
+
+
+void RGHashTable :: LinkInOrder (int entry) {
+
+	//
+	//  Before the first item that is not less than this one, except that an item not less than the last goes at the end
+	//
+
+	RGPersistent* p = EntryArray [entry].Item;
+	unsigned long list = EntryArray [entry].List;
+	int first = ListFirst [list];
+	int previous;
+	int next;
+
+	if ((first < 0) || (p->CompareTo (EntryArray [first].Item) <= 0)) {
+
+		LinkAfter (entry, -1);
+		return;
+	}
+
+	if (p->CompareTo (EntryArray [ListLast [list]].Item) >= 0) {
+
+		LinkAfter (entry, ListLast [list]);
+		return;
+	}
+
+	previous = first;
+	next = EntryArray [first].Next;
+
+	while (next >= 0) {
+
+		if (p->CompareTo (EntryArray [next].Item) <= 0)
+			break;
+
+		previous = next;
+		next = EntryArray [next].Next;
+	}
+
+	LinkAfter (entry, previous);
+}
+
+
+void RGHashTable :: UnlinkEntry (int entry) {
+
+	RGHashTableEntry& e = EntryArray [entry];
+
+	if (e.Previous < 0)
+		ListFirst [e.List] = e.Next;
+
+	else
+		EntryArray [e.Previous].Next = e.Next;
+
+	if (e.Next < 0)
+		ListLast [e.List] = e.Previous;
+
+	else
+		EntryArray [e.Next].Previous = e.Previous;
+
+	e.Previous = e.Next = -1;
+}
+
+
+void RGHashTable :: RemoveEntry (int entry) {
+
+	//
+	//  A removed slot must stay marked so that probes continue past it, unless the next slot has never been used
+	//
+
+	int slot = FindSlot (entry);
+
+	if (SlotArray [(slot + 1) & SlotMask] == EmptySlot)
+		SlotArray [slot] = EmptySlot;
+
+	else {
+
+		SlotArray [slot] = RemovedSlot;
+		NumberOfRemovedSlots++;
+	}
+
+	UnlinkEntry (entry);
+	EntryArray [entry].Item = NULL;
+	EntryArray [entry].Next = FreeEntry;
+	FreeEntry = entry;
+	NumberOfEntries--;
+}
+
+
+int RGHashTable :: FindEntry (const RGPersistent* target, Boolean byReference) const {
+
+	//
+	//  Equal items are in the same list, so if there is more than one, the list gives the one that comes first
+	//
+
+	if (NumberOfEntries == 0)
+		return -1;
+
+	unsigned long hash = MixHash (target->FullHashNumber ());
+	unsigned long i = hash & SlotMask;
+	int found = -1;
+	int entry;
+
+	while ((entry = SlotArray [i]) != EmptySlot) {
+
+		if ((entry >= 0) && (EntryArray [entry].Hash == hash)) {
+
+			RGPersistent* item = EntryArray [entry].Item;
+
+			if (byReference ? (item == target) : item->IsEqualTo (target)) {
+
+				if (found >= 0)
+					break;
+
+				found = entry;
+			}
+		}
+
+		i = (i + 1) & SlotMask;
+	}
+
+	if ((found < 0) || (entry == EmptySlot))
+		return found;
+
+	for (entry=ListFirst [EntryArray [found].List]; entry>=0; entry=EntryArray [entry].Next) {
+
+		if (EntryArray [entry].Hash == hash) {
+
+			RGPersistent* item = EntryArray [entry].Item;
+
+			if (byReference ? (item == target) : item->IsEqualTo (target))
+				return entry;
+		}
+	}
+
+	return found;
+}
+
+
+int RGHashTable :: CountEntries (const RGPersistent* target, Boolean byReference) const {
+
+	if (NumberOfEntries == 0)
+		return 0;
+
+	unsigned long hash = MixHash (target->FullHashNumber ());
+	unsigned long i = hash & SlotMask;
+	int n = 0;
+	int entry;
+
+	while ((entry = SlotArray [i]) != EmptySlot) {
+
+		if ((entry >= 0) && (EntryArray [entry].Hash == hash)) {
+
+			RGPersistent* item = EntryArray [entry].Item;
+
+			if (byReference ? (item == target) : item->IsEqualTo (target))
+				n++;
+		}
+
+		i = (i + 1) & SlotMask;
+	}
+
+	return n;
+}
+
+
+int RGHashTable :: FindSlot (int entry) const {
+
+	unsigned long i = EntryArray [entry].Hash & SlotMask;
+
+	while (SlotArray [i] != entry)
+		i = (i + 1) & SlotMask;
+
+	return i;
+}
+
+
+void RGHashTable :: InsertSlot (int entry) {
+
+	unsigned long i = EntryArray [entry].Hash & SlotMask;
+
+	while (SlotArray [i] >= 0)
+		i = (i + 1) & SlotMask;
+
+	if (SlotArray [i] == RemovedSlot)
+		NumberOfRemovedSlots--;
+
+	SlotArray [i] = entry;
+}
+
+
+void RGHashTable :: RebuildSlots (unsigned long nSlots) {
+
+	delete[] SlotArray;
+	SlotArray = new int [nSlots];
+	SlotMask = nSlots - 1;
+	NumberOfRemovedSlots = 0;
+	unsigned long i;
+
+	for (i=0; i<nSlots; i++)
+		SlotArray [i] = EmptySlot;
+
+	for (i=0; i<EntryCapacity; i++) {
+
+		if (EntryArray [i].Item != NULL)
+			InsertSlot (i);
+	}
+}
+
+
+void RGHashTable :: CopyEntries (const RGHashTable& hTable) {
+
+	//
+	//  Appends copies of the items of hTable, list by list, assuming the same number of lists
+	//
+
+	int entry;
+	int next;
+
+	if (hTable.ListFirst == NULL)
+		return;
+
+	for (int i=0; i<NumberOfLists; i++) {
+
+		for (next=hTable.ListFirst [i]; next>=0; next=hTable.EntryArray [next].Next) {
+
+			entry = AddEntry (hTable.EntryArray [next].Item->Copy (), i);
+			LinkAfter (entry, ListLast [i]);
+		}
+	}
+}
+
+
+void RGHashTable :: ReleaseAll () {
+
+	delete[] EntryArray;
+	delete[] SlotArray;
+	delete[] ListFirst;
+	delete[] ListLast;
+	EntryArray = NULL;
+	SlotArray = NULL;
+	ListFirst = ListLast = NULL;
+	EntryCapacity = 0;
+	FreeEntry = -1;
+	SlotMask = 0;
+	NumberOfRemovedSlots = 0;
+	NumberOfEntries = 0;
+}
+
+
+unsigned long RGHashTable :: MixHash (unsigned long hash) {
+
+	//
+	//  Spreads the bits of FullHashNumber, which for many classes is a small integer, over 32 bits
+	//
+
+	hash &= 0xffffffffUL;
+	hash ^= hash >> 16;
+	hash = (hash * 0x85ebca6bUL) & 0xffffffffUL;
+	hash ^= hash >> 13;
+	hash = (hash * 0xc2b2ae35UL) & 0xffffffffUL;
+	hash ^= hash >> 16;
+	return hash;
+}
+
+
+
+RGHashTableIterator :: RGHashTableIterator (RGHashTable& ht) : List (&ht), CurrentListIndex (0), CurrentEntry (-1) {
+
+}
+
+
+RGHashTableIterator :: ~RGHashTableIterator () {
 
-	delete[] ListIteratorArray;
 }
 
 RGPersistent* RGHashTableIterator :: FindNext (const RGPersistent* target) {
 
-	unsigned hash = FindHashNumber (target);
+	int entry = FindNextEntry (target, FALSE);
 
-	if (hash < CurrentListIndex)
+	if (entry < 0)
 		return NULL;
 
-	return ListIteratorArray [hash]->FindNext (target);
+	return List->EntryArray [entry].Item;
 }
 
 
 RGPersistent* RGHashTableIterator :: CurrentItem () {
 
-	return CurrentIterator->CurrentItem ();
+	if (CurrentEntry < 0)
+		return NULL;
+
+	return List->EntryArray [CurrentEntry].Item;
 }
 
 
@@ -561,26 +883,30 @@ RGPersistent* RGHashTableIterator :: operator()() {
 	
 	// Advances iterator to next item and returns it; at tail, stays and returns NULL
 
-	RGPersistent* Next = (*CurrentIterator) ();
+	int next;
 
-	if (Next)
-		return Next;
-
-	if (CurrentListIndex == NumberOfLists - 1)
+	if ((List->NumberOfEntries == 0) || (CurrentListIndex >= List->NumberOfLists))
 		return NULL;
 
-	while (CurrentListIndex < NumberOfLists - 1) {
+	if (CurrentEntry < 0)
+		next = List->ListFirst [CurrentListIndex];
+
+	else
+		next = List->EntryArray [CurrentEntry].Next;
+
+	for (int i=CurrentListIndex+1; (next < 0) && (i<List->NumberOfLists); i++) {
 
-		CurrentListIndex++;
-		CurrentIterator = ListIteratorArray [CurrentListIndex];
-		Next = (*CurrentIterator) ();
+		next = List->ListFirst [i];
 
-		if (Next)
-			return Next;
+		if (next >= 0)
+			CurrentListIndex = i;
 	}
 
-	return NULL;
+	if (next < 0)
+		return NULL;
 
+	CurrentEntry = next;
+	return List->EntryArray [next].Item;
 }
 
 
@@ -588,25 +914,31 @@ RGPersistent* RGHashTableIterator :: operator--() {
 	
 	// Goes back one and returns it; at head, returns NULL and Current goes to NULL
 
-	RGPersistent* Previous = --(*CurrentIterator);
-
-	if (Previous)
-		return Previous;
+	int previous = -1;
 
-	if (CurrentListIndex == 0)
+	if ((List->NumberOfEntries == 0) || (CurrentListIndex >= List->NumberOfLists))
 		return NULL;
 
-	while (CurrentListIndex > 0) {
+	if (CurrentEntry >= 0)
+		previous = List->EntryArray [CurrentEntry].Previous;
+
+	for (int i=CurrentListIndex-1; (previous < 0) && (i>=0); i--) {
 
-		CurrentListIndex--;
-		CurrentIterator = ListIteratorArray [CurrentListIndex];
-		Previous = --(*CurrentIterator);
+		previous = List->ListLast [i];
 
-		if (Previous)
-			return Previous;
+		if (previous >= 0)
+			CurrentListIndex = i;
 	}
 
-	return NULL;
+	if (previous < 0) {
+
+		CurrentListIndex = 0;
+		CurrentEntry = -1;
+		return NULL;
+	}
+
+	CurrentEntry = previous;
+	return List->EntryArray [previous].Item;
 }
 
 
@@ -614,25 +946,7 @@ RGPersistent* RGHashTableIterator :: operator++() {
 	
 	// Goes forward one and returns it; at tail, stays and returns NULL
 
-	RGPersistent* Next = ++(*CurrentIterator);
-
-	if (Next)
-		return Next;
-
-	if (CurrentListIndex == NumberOfLists - 1)
-		return NULL;
-
-	while (CurrentListIndex < NumberOfLists - 1) {
-
-		CurrentListIndex++;
-		CurrentIterator = ListIteratorArray [CurrentListIndex];
-		Next = ++(*CurrentIterator);
-
-		if (Next)
-			return Next;
-	}
-
-	return NULL;
+	return (*this) ();
 }
 
 
@@ -641,10 +955,7 @@ void RGHashTableIterator :: Reset () {
 	// Resets iterator to beginning - needed also whenever underlying list changes; Current set to NULL
 
 	CurrentListIndex = 0;
-	CurrentIterator = ListIteratorArray [0];
-
-	for (int i=0; i<NumberOfLists; i++)
-		ListIteratorArray [i]->Reset ();
+	CurrentEntry = -1;
 }
 
 
@@ -653,35 +964,68 @@ RGPersistent* RGHashTableIterator :: FindNextReference (const RGPersistent* targ
 	
 	// finds next matching pointer
 
-	unsigned hash = FindHashNumber (target);
+	int entry = FindNextEntry (target, TRUE);
 
-	if (hash < CurrentListIndex)
+	if (entry < 0)
 		return NULL;
 
-	return ListIteratorArray [hash]->FindNextReference (target);
+	return List->EntryArray [entry].Item;
 }
 
 
 RGPersistent* RGHashTableIterator :: RemoveCurrentItem () {
 
-	RGPersistent* current = CurrentIterator->RemoveCurrentItem ();
+	//
+	//  Current goes back to the previous item, so the next call to operator() returns the item after the one removed
+	//
 
-	if (current == NULL)
+	if (CurrentEntry < 0)
 		return NULL;
 
-	if (CurrentIterator->CurrentItem () == NULL) {
+	RGPersistent* current = List->EntryArray [CurrentEntry].Item;
+	int previous = List->EntryArray [CurrentEntry].Previous;
+	List->RemoveEntry (CurrentEntry);
+	CurrentEntry = previous;
 
+	if (previous < 0)
 		--(*this);
-	}
 
 	return current;
 }
 
 
-unsigned RGHashTableIterator :: FindHashNumber (const RGPersistent* target) {
+int RGHashTableIterator :: FindNextEntry (const RGPersistent* target, Boolean byReference) {
 
-	unsigned hash = target->HashNumber (NumberOfLists);
-	hash = hash%NumberOfLists;
-	return hash;
-}
+	//
+	//  Searches the list of target beyond the current item, without moving the iterator
+	//
+
+	if (List->NumberOfEntries == 0)
+		return -1;
+
+	unsigned long list = List->SelectList (target);
 
+	if (list < CurrentListIndex)
+		return -1;
+
+	int entry;
+	RGPersistent* item;
+
+	if ((list == CurrentListIndex) && (CurrentEntry >= 0))
+		entry = List->EntryArray [CurrentEntry].Next;
+
+	else
+		entry = List->ListFirst [list];
+
+	while (entry >= 0) {
+
+		item = List->EntryArray [entry].Item;
+
+		if (byReference ? (item == target) : item->IsEqualTo (target))
+			return entry;
+
+		entry = List->EntryArray [entry].Next;
+	}
+
+	return -1;
+}
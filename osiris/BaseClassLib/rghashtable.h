@@ -31,6 +31,12 @@
 //	class RGHashTable - hash table of doubly linked lists that is persistent.  It stores other 
 //    RGPersistent objects that have defined a hash function (all, we hope)
 //
+//	Lookups go through an open-addressing index of slots with linear probing.  Each entry caches its
+//		FullHashNumber, the slot count is a power of two and the index doubles when it is half full, so
+//		finding an item normally takes one or two comparisons of cached hashes and one call to IsEqualTo.
+//		The entries are also chained into the lists selected by HashNumber (NumberOfLists), which fix the
+//		order of iteration, persistence and duplicate matches exactly as when each list was an RGDList.
+//
 //	The number of lists in the hash table determines the hash function parameter as well and this number
 //		should be a prime for best (most even) distribution of the range of hash numbers over the number of 
 //		tables.  To this end, a list of the primes between 500 and 1050 appear in the comment below:
@@ -62,6 +68,16 @@ const int _RGHASHTABLE_ = 32;
 PERSISTENT_PREDECLARATION (RGHashTable)
 
 
+struct RGHashTableEntry {
+
+	RGPersistent* Item;		// NULL when the entry is unused
+	unsigned long Hash;		// mixed FullHashNumber of Item
+	unsigned long List;		// HashNumber (NumberOfLists) of Item, as reduced when it was added
+	int Previous;
+	int Next;
+};
+
+
 class RGHashTable : public RGPersistent {
 
 friend class RGHashTableIterator;
@@ -112,11 +128,32 @@ public:
 	RGPersistent* RemoveAllReferences (const RGPersistent*);
 
 protected:
-	RGDList** ListArray;
+	RGHashTableEntry* EntryArray;
+	int EntryCapacity;
+	int FreeEntry;		// head of the chain of unused entries
+	int* SlotArray;		// entry index, or -1 if never used, or -2 if its entry was removed
+	unsigned long SlotMask;		// number of slots - 1
+	int NumberOfRemovedSlots;
+	int* ListFirst;
+	int* ListLast;
 	int NumberOfEntries;
 	unsigned long NumberOfLists;
 
-	RGDList* SelectList (const RGPersistent*) const;
+	unsigned long SelectList (const RGPersistent*) const;
+	int AddEntry (RGPersistent* p, unsigned long list);
+	void LinkAfter (int entry, int previous);  // previous < 0 means at the head of the list
+	void LinkInOrder (int entry);  // same position as RGDList::Insert
+	void UnlinkEntry (int entry);
+	void RemoveEntry (int entry);
+	int FindEntry (const RGPersistent* target, Boolean byReference) const;  // first match in list order
+	int CountEntries (const RGPersistent* target, Boolean byReference) const;
+	int FindSlot (int entry) const;
+	void InsertSlot (int entry);
+	void RebuildSlots (unsigned long nSlots);
+	void CopyEntries (const RGHashTable& hTable);
+	void ReleaseAll ();
+
+	static unsigned long MixHash (unsigned long hash);
 
 	static int RGDefaultNumberOfHashLists;
 };
@@ -142,12 +179,10 @@ public:
 protected:
 
 	RGHashTable* List;
-	RGDListIterator** ListIteratorArray;
 	int CurrentListIndex;
-	int NumberOfLists;
-	RGDListIterator* CurrentIterator;
+	int CurrentEntry;		// -1 means before the first item of CurrentListIndex
 
-	unsigned FindHashNumber (const RGPersistent* p);
+	int FindNextEntry (const RGPersistent* target, Boolean byReference);
 };
 
 
@@ -38,7 +38,7 @@
 
 
 
-RGINDEXEDCOMPARISON RGIndexedLabel::Comparison = RGINDEX;
+RGThreadStatic<RGINDEXEDCOMPARISON> RGIndexedLabel::Comparison (RGINDEX);
 
 PERSISTENT_DEFINITION (RGIndexedLabel, _RGINDEXEDLABEL_, "IndexedLabel")
 
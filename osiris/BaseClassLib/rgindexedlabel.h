@@ -39,6 +39,7 @@
 #include "rgstring.h"
 #include "rgdefs.h"
 #include "rgtree.h"
+#include "rgthread.h"
 
 class RGFile;
 class RGVInStream;
@@ -95,7 +96,7 @@ protected:
 	RGString Label;
 	RGString Text;
 
-	static RGINDEXEDCOMPARISON Comparison;
+	static RGThreadStatic<RGINDEXEDCOMPARISON> Comparison;
 };
 
 #endif  /*  _RGINDEXEDLABEL_H_  */
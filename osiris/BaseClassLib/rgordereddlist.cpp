@@ -0,0 +1,439 @@
+/*
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+*  FileName: rgordereddlist.cpp
+*  Author:   Robert Goor
+*
+*/
+//
+//	class RGOrderedDList - an RGDList with an index for binary search insertion and reference tests
+//
+
+#include "rgordereddlist.h"
+
+#ifdef _DEBUG
+#include <assert.h>
+#endif
+
+
+RGOrderedDList :: RGOrderedDList () : RGDList (),
+mIndexedModifications (0),
+mIndexedAdditions (0),
+mOrder (InOrder) {
+
+}
+
+
+RGOrderedDList :: RGOrderedDList (const RGOrderedDList& clone) : RGDList (clone),
+mIndexedModifications (Modifications - 1),
+mIndexedAdditions (Additions - 1),
+mOrder (OrderUnknown) {
+
+}
+
+
+RGOrderedDList :: ~RGOrderedDList () {
+
+}
+
+
+RGOrderedDList& RGOrderedDList :: operator=(const RGOrderedDList& target) {
+
+	RGDList::operator= (target);
+	return *this;
+}
+
+
+RGOrderedDList& RGOrderedDList :: operator=(const RGDList& target) {
+
+	RGDList::operator= (target);
+	return *this;
+}
+
+
+RGPersistent* RGOrderedDList :: Append (RGPersistent* NewItem) {
+
+	UpdateIndex ();
+
+	if ((mOrder == InOrder) && (NumberOfEntries > 0) && (NewItem->CompareTo (LastLink->Item) < 0))
+		mOrder = OutOfOrder;
+
+	return LinkAt (NumberOfEntries, NewItem);
+}
+
+
+RGPersistent* RGOrderedDList :: Prepend (RGPersistent* NewItem) {
+
+	UpdateIndex ();
+
+	if ((mOrder == InOrder) && (NumberOfEntries > 0) && (NewItem->CompareTo (FirstLink->Item) > 0))
+		mOrder = OutOfOrder;
+
+	return LinkAt (0, NewItem);
+}
+
+
+RGPersistent* RGOrderedDList :: Insert (RGPersistent* target) {
+
+	//
+	//	Same placement as RGDList::Insert:  before the first item that target does not exceed, but after the last item if target
+	//	is not less than it
+	//
+
+	if (!IsInOrder ())
+		return RGDList::Insert (target);
+
+	if (NumberOfEntries == 0)
+		return LinkAt (0, target);
+
+	if (target->CompareTo (FirstLink->Item) <= 0)
+		return LinkAt (0, target);
+
+	if (target->CompareTo (LastLink->Item) >= 0)
+		return LinkAt (NumberOfEntries, target);
+
+	return LinkAt (LowerBound (target, 1, NumberOfEntries - 1), target);
+}
+
+
+RGPersistent* RGOrderedDList :: InsertWithNoDuplication (RGPersistent* target) {
+
+	if (!IsInOrder ())
+		return RGDList::InsertWithNoDuplication (target);
+
+	if (NumberOfEntries == 0)
+		return LinkAt (0, target);
+
+	int compareFirst = target->CompareTo (FirstLink->Item);
+
+	if (compareFirst == 0)
+		return NULL;
+
+	int compareLast = target->CompareTo (LastLink->Item);
+
+	if (compareLast == 0)
+		return NULL;
+
+	if (compareFirst < 0)
+		return LinkAt (0, target);
+
+	if (compareLast > 0)
+		return LinkAt (NumberOfEntries, target);
+
+	int position = LowerBound (target, 1, NumberOfEntries - 1);
+
+	if (target->CompareTo (mIndex [position]->Item) == 0)
+		return NULL;
+
+	return LinkAt (position, target);
+}
+
+
+RGPersistent* RGOrderedDList :: InsertWithNoReferenceDuplication (RGPersistent* target) {
+
+	//
+	//	Like RGDList::InsertWithNoReferenceDuplication, this only finds target if it is first, last or where target would be inserted
+	//
+
+	if (!IsInOrder ())
+		return RGDList::InsertWithNoReferenceDuplication (target);
+
+	if (NumberOfEntries == 0)
+		return LinkAt (0, target);
+
+	if ((target == FirstLink->Item) || (target == LastLink->Item))
+		return NULL;
+
+	int compareFirst = target->CompareTo (FirstLink->Item);
+
+	if (compareFirst == 0)
+		return LinkAt (0, target);
+
+	int compareLast = target->CompareTo (LastLink->Item);
+
+	if (compareLast == 0)
+		return LinkAt (NumberOfEntries, target);
+
+	if (compareFirst < 0)
+		return LinkAt (0, target);
+
+	if (compareLast > 0)
+		return LinkAt (NumberOfEntries, target);
+
+	int position = LowerBound (target, 1, NumberOfEntries - 1);
+
+	if (target == mIndex [position]->Item)
+		return NULL;
+
+	return LinkAt (position, target);
+}
+
+
+Boolean RGOrderedDList :: ContainsReference (const RGPersistent* target) const {
+
+	//
+	//	The const functions do not rebuild the index, so that, as for RGDList, any number of threads can read the list at once
+	//
+
+	if (!IsIndexedInOrder ())
+		return RGDList::ContainsReference (target);
+
+	return (FindReferencePosition (target) >= 0);
+}
+
+
+RGPersistent* RGOrderedDList :: FindReference (const RGPersistent* target) {
+
+	if (!IsInOrder ())
+		return RGDList::FindReference (target);
+
+	if (FindReferencePosition (target) >= 0)
+		return (RGPersistent*) target;
+
+	return NULL;
+}
+
+
+int RGOrderedDList :: OccurrencesOfReference (const RGPersistent* target) const {
+
+	if (!IsIndexedInOrder ())
+		return RGDList::OccurrencesOfReference (target);
+
+	return CountReferences (target);
+}
+
+
+RGPersistent* RGOrderedDList :: RemoveReference (const RGPersistent* target) {
+
+	IsInOrder ();
+	int position = FindReferencePosition (target);
+
+	if (position < 0)
+		return NULL;
+
+	return UnlinkAt (position);
+}
+
+
+void RGOrderedDList :: UpdateIndex () const {
+
+	//
+	//	Removing links leaves the rest in the same order, so the order is still known if nothing was added since the last index
+	//
+
+	if (mIndexedModifications == Modifications)
+		return;
+
+	PersistentLink* nextLink;
+	mIndex.clear ();
+	mIndex.reserve (NumberOfEntries);
+
+	for (nextLink=FirstLink; nextLink!=NULL; nextLink=nextLink->Next)
+		mIndex.push_back (nextLink);
+
+	if ((mIndexedAdditions != Additions) || (mOrder == OutOfOrder))
+		mOrder = OrderUnknown;
+
+	mIndexedModifications = Modifications;
+	mIndexedAdditions = Additions;
+}
+
+
+bool RGOrderedDList :: IsInOrder () const {
+
+	UpdateIndex ();
+
+	if (mOrder == OrderUnknown) {
+
+		mOrder = InOrder;
+
+		for (int i=1; i<NumberOfEntries; i++) {
+
+			if (mIndex [i]->Item->CompareTo (mIndex [i - 1]->Item) < 0) {
+
+				mOrder = OutOfOrder;
+				break;
+			}
+		}
+	}
+
+	else if (mOrder == InOrder)
+		CheckOrder ();
+
+	return (mOrder == InOrder);
+}
+
+
+int RGOrderedDList :: LowerBound (const RGPersistent* target, int low, int high) const {
+
+	int middle;
+
+	while (low < high) {
+
+		middle = low + (high - low) / 2;
+
+		if (target->CompareTo (mIndex [middle]->Item) <= 0)
+			high = middle;
+
+		else
+			low = middle + 1;
+	}
+
+	return low;
+}
+
+
+int RGOrderedDList :: FindReferencePosition (const RGPersistent* target) const {
+
+	//
+	//	In order, target is among the items equal to it, because the items do not change while they are in the list
+	//
+
+	int i;
+
+	if (mOrder == InOrder) {
+
+		for (i=LowerBound (target, 0, NumberOfEntries); i<NumberOfEntries; i++) {
+
+			if (mIndex [i]->Item == target)
+				return i;
+
+			if (target->CompareTo (mIndex [i]->Item) != 0)
+				break;
+		}
+
+#ifdef _DEBUG
+		for (i=0; i<NumberOfEntries; i++)
+			assert (mIndex [i]->Item != target);
+#endif
+
+		return -1;
+	}
+
+	for (i=0; i<NumberOfEntries; i++) {
+
+		if (mIndex [i]->Item == target)
+			return i;
+	}
+
+	return -1;
+}
+
+
+int RGOrderedDList :: CountReferences (const RGPersistent* target) const {
+
+	int n = 0;
+
+	for (int i=LowerBound (target, 0, NumberOfEntries); i<NumberOfEntries; i++) {
+
+		if (mIndex [i]->Item == target)
+			n++;
+
+		else if (target->CompareTo (mIndex [i]->Item) != 0)
+			break;
+	}
+
+	return n;
+}
+
+
+void RGOrderedDList :: CheckOrder () const {
+
+	//  in debug builds, fails if an item has changed its place in the order since it was added
+
+#ifdef _DEBUG
+	for (int i=1; i<NumberOfEntries; i++)
+		assert (mIndex [i]->Item->CompareTo (mIndex [i - 1]->Item) >= 0);
+#endif
+}
+
+
+RGPersistent* RGOrderedDList :: LinkAt (int position, RGPersistent* target) {
+
+	//
+	//	Inserts target before the link at position, or at the end if position is NumberOfEntries; the caller keeps mOrder current
+	//
+
+	UpdateIndex ();
+	PersistentLink* NewLink = new PersistentLink;
+	PersistentLink* NextLink = (position < NumberOfEntries) ? mIndex [position] : NULL;
+	PersistentLink* PreviousLink = (position > 0) ? mIndex [position - 1] : NULL;
+	NewLink->Item = target;
+	NewLink->Next = NextLink;
+	NewLink->Previous = PreviousLink;
+
+	if (PreviousLink == NULL)
+		FirstLink = NewLink;
+
+	else
+		PreviousLink->Next = NewLink;
+
+	if (NextLink == NULL)
+		LastLink = NewLink;
+
+	else
+		NextLink->Previous = NewLink;
+
+	NumberOfEntries++;
+	Modifications++;
+	Additions++;
+	mIndex.insert (mIndex.begin () + position, NewLink);
+	mIndexedModifications = Modifications;
+	mIndexedAdditions = Additions;
+	return target;
+}
+
+
+RGPersistent* RGOrderedDList :: UnlinkAt (int position) {
+
+	UpdateIndex ();
+	PersistentLink* OldLink = mIndex [position];
+	PersistentLink* NextLink = OldLink->Next;
+	PersistentLink* PreviousLink = OldLink->Previous;
+	RGPersistent* Item = OldLink->Item;
+
+	if (PreviousLink == NULL)
+		FirstLink = NextLink;
+
+	else
+		PreviousLink->Next = NextLink;
+
+	if (NextLink == NULL)
+		LastLink = PreviousLink;
+
+	else
+		NextLink->Previous = PreviousLink;
+
+	delete OldLink;
+	NumberOfEntries--;
+	Modifications++;
+	mIndex.erase (mIndex.begin () + position);
+	mIndexedModifications = Modifications;
+
+	if (mOrder == OutOfOrder)
+		mOrder = OrderUnknown;
+
+	return Item;
+}
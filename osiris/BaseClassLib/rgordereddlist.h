@@ -0,0 +1,93 @@
+/*
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+*  FileName: rgordereddlist.h
+*  Author:   Robert Goor
+*
+*/
+//
+//	class RGOrderedDList - an RGDList that keeps an index of its links, so that sorted insertion and the reference tests and
+//	removals take a binary search instead of a walk down the list.  It has the RGDList interface and works with RGDListIterator,
+//	so a list can be changed to an RGOrderedDList without changing its users.  Changes made through RGDList functions or
+//	iterators are allowed; the index is rebuilt, in one walk down the list, the next time it is needed, and if the changes only
+//	removed links, the list is known to be in the same order as before.  The binary search is used only while the list is in
+//	order, so the results are always those of RGDList.
+//	The items must not change in any way that changes CompareTo while they are in the list, or the order known for the list
+//	would be wrong; debug builds check the order whenever it is used.
+//	It is saved and restored as an RGDList.
+//
+
+#ifndef _RGORDEREDDLIST_H_
+#define _RGORDEREDDLIST_H_
+
+#include "rgdlist.h"
+#include <vector>
+
+
+class RGOrderedDList : public RGDList {
+
+public:
+
+	RGOrderedDList ();
+	RGOrderedDList (const RGOrderedDList&);  // deep copy constructor - makes copies of links
+	virtual ~RGOrderedDList ();
+
+	RGOrderedDList& operator=(const RGOrderedDList&);
+	RGOrderedDList& operator=(const RGDList&);
+
+	RGPersistent* Append (RGPersistent*);
+	RGPersistent* Prepend (RGPersistent*);
+
+	RGPersistent* Insert (RGPersistent*);
+	RGPersistent* InsertWithNoDuplication (RGPersistent*);
+	RGPersistent* InsertWithNoReferenceDuplication (RGPersistent*);
+
+	Boolean ContainsReference (const RGPersistent*) const;  // contains pointer
+	RGPersistent* FindReference (const RGPersistent*);
+	int OccurrencesOfReference (const RGPersistent*) const;
+	RGPersistent* RemoveReference (const RGPersistent*);
+
+protected:
+
+	enum Order { OrderUnknown, InOrder, OutOfOrder };
+
+	mutable std::vector<PersistentLink*> mIndex;  // the links, in list order
+	mutable unsigned long mIndexedModifications;  // Modifications when mIndex was last current
+	mutable unsigned long mIndexedAdditions;  // Additions when mIndex was last current
+	mutable Order mOrder;
+
+	void UpdateIndex () const;
+	bool IsInOrder () const;
+	bool IsIndexedInOrder () const { return (mIndexedModifications == Modifications) && (mOrder == InOrder); }
+	int LowerBound (const RGPersistent* target, int low, int high) const;  // first i in [low, high) with target <= mIndex [i], or high
+	int FindReferencePosition (const RGPersistent* target) const;  // first i with mIndex [i] == target, or -1
+	int CountReferences (const RGPersistent* target) const;  // in order only
+	void CheckOrder () const;  // debug builds only
+	RGPersistent* LinkAt (int position, RGPersistent* target);
+	RGPersistent* UnlinkAt (int position);
+};
+
+
+#endif   /*  _RGORDEREDDLIST_H_  */
@@ -73,6 +73,18 @@ unsigned RGPersistent :: HashNumber (unsigned long Base) const {
 
 
 
+unsigned long RGPersistent :: FullHashNumber () const {
+
+	//
+	//  By default, the hash number with the largest prime base that fits in 32 bits.  Subclasses whose
+	//  HashNumber discards information (e.g., RGString) should override this
+	//
+
+	return HashNumber (2147483647UL);
+}
+
+
+
 Boolean RGPersistent :: IsEqualTo (const RGPersistent* target) const {
 
 	return FALSE;
@@ -197,6 +197,7 @@ public:
 	virtual size_t StoreSize () const;
 	virtual int CompareTo (const RGPersistent*) const;
 	virtual unsigned HashNumber (unsigned long Base) const;
+	virtual unsigned long FullHashNumber () const;  // unreduced hash for RGHashTable; must agree whenever IsEqualTo does
 	virtual Boolean IsEqualTo (const RGPersistent*) const;
 
 	virtual void RestoreAll (RGFile&);
@@ -0,0 +1,267 @@
+/*
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+*  FileName: rgpool.h
+*  Author:   Robert Goor
+*
+*/
+//
+//  class template RGPool allocates objects of class T from a free list kept by each thread, so that the small objects created
+//  and destroyed in great numbers, such as list links, do not go to the heap each time.  Free objects are carved from blocks
+//  of BlockSize objects.  A thread with more than 2 * BlockSize free objects moves BlockSize of them to a depot shared by all
+//  threads, and a thread with none takes them from the depot before allocating another block, so objects freed by one thread
+//  are reused by the others.  When an RGThread finishes, its free objects go to the depot, in lists of BlockSize, with any
+//  remainder kept in one partial list that is completed by the next thread to finish.  Blocks are never returned to the heap.  Requests for any other size, as from a derived class,
+//  go to the heap.  Defining RG_NO_POOLED_ALLOCATION sends all requests to the heap.
+//
+//  The numbers of requests are counted by each thread and added to the totals every FlushInterval requests, so the totals
+//  lag by less than FlushInterval per thread.
+//
+
+#ifndef _RGPOOL_H_
+#define _RGPOOL_H_
+
+#include "rgthread.h"
+#include <new>
+
+
+struct RGPoolNode {
+
+	RGPoolNode* mNext;	// the next free object
+	RGPoolNode* mNextList;	// the next list of BlockSize free objects in the depot
+};
+
+
+template <class T> class RGPool {
+
+public:
+	enum { BlockSize = 256, FlushInterval = 1024 };
+
+	static void* Allocate (size_t size);
+	static void Free (void* p, size_t size);
+
+	static long GetNumberOfRequests () { return RGAtomicGet (&Requests); }
+	static long GetNumberOfBlocks () { return RGAtomicGet (&Blocks); }	// each a single heap allocation
+	static void FlushCounts ();	// adds the calling thread's count to the totals
+
+protected:
+	static RG_THREAD_LOCAL RGPoolNode* ThreadList;
+	static RG_THREAD_LOCAL int ThreadListSize;
+	static RG_THREAD_LOCAL long ThreadRequests;
+
+	static RGPoolNode* Depot;
+	static RGPoolNode* PartialList;	// fewer than BlockSize objects, from threads that have finished
+	static int PartialListSize;
+	static volatile long DepotLock;
+	static volatile long ExitFunctionAdded;
+	static volatile long Requests;
+	static volatile long Blocks;
+
+	static void Refill ();
+	static void ReturnList ();
+	static void ReturnAll ();	// called as each RGThread finishes
+	static void AddExitFunction ();
+	static void LockDepot () { RGAcquireSpinLock (&DepotLock); }
+	static void UnlockDepot () { RGReleaseSpinLock (&DepotLock); }
+};
+
+
+template <class T> RG_THREAD_LOCAL RGPoolNode* RGPool<T>::ThreadList = NULL;
+template <class T> RG_THREAD_LOCAL int RGPool<T>::ThreadListSize = 0;
+template <class T> RG_THREAD_LOCAL long RGPool<T>::ThreadRequests = 0;
+template <class T> RGPoolNode* RGPool<T>::Depot = NULL;
+template <class T> RGPoolNode* RGPool<T>::PartialList = NULL;
+template <class T> int RGPool<T>::PartialListSize = 0;
+template <class T> volatile long RGPool<T>::DepotLock = 0;
+template <class T> volatile long RGPool<T>::ExitFunctionAdded = 0;
+template <class T> volatile long RGPool<T>::Requests = 0;
+template <class T> volatile long RGPool<T>::Blocks = 0;
+
+
+template <class T> void* RGPool<T> :: Allocate (size_t size) {
+
+#ifdef RG_NO_POOLED_ALLOCATION
+	return ::operator new (size);
+#else
+	if (size != sizeof (T))
+		return ::operator new (size);
+
+	if (ThreadList == NULL)
+		Refill ();
+
+	RGPoolNode* node = ThreadList;
+	ThreadList = node->mNext;
+	ThreadListSize--;
+
+	if (++ThreadRequests >= FlushInterval)
+		FlushCounts ();
+
+	return node;
+#endif
+}
+
+
+template <class T> void RGPool<T> :: Free (void* p, size_t size) {
+
+#ifdef RG_NO_POOLED_ALLOCATION
+	::operator delete (p);
+#else
+	if (p == NULL)
+		return;
+
+	if (size != sizeof (T)) {
+
+		::operator delete (p);
+		return;
+	}
+
+	if (ThreadList == NULL)
+		AddExitFunction ();
+
+	RGPoolNode* node = (RGPoolNode*) p;
+	node->mNext = ThreadList;
+	ThreadList = node;
+	ThreadListSize++;
+
+	if (ThreadListSize >= 2 * BlockSize)
+		ReturnList ();
+#endif
+}
+
+
+template <class T> void RGPool<T> :: FlushCounts () {
+
+	RGAtomicAdd (&Requests, ThreadRequests);
+	ThreadRequests = 0;
+}
+
+
+template <class T> void RGPool<T> :: Refill () {
+
+	int listSize = BlockSize;
+	AddExitFunction ();
+	LockDepot ();
+	RGPoolNode* list = Depot;
+
+	if (list != NULL)
+		Depot = list->mNextList;
+
+	else if (PartialList != NULL) {
+
+		list = PartialList;
+		listSize = PartialListSize;
+		PartialList = NULL;
+		PartialListSize = 0;
+	}
+
+	UnlockDepot ();
+
+	if (list == NULL) {
+
+		//  a new block, linked in address order
+
+		char* block = (char*) ::operator new (BlockSize * sizeof (T));
+		RGPoolNode* node;
+
+		for (int i=0; i<BlockSize; i++) {
+
+			node = (RGPoolNode*) (block + i * sizeof (T));
+			node->mNext = (i < BlockSize - 1) ? (RGPoolNode*) (block + (i + 1) * sizeof (T)) : NULL;
+		}
+
+		list = (RGPoolNode*) block;
+		RGAtomicIncrement (&Blocks);
+	}
+
+	ThreadList = list;
+	ThreadListSize = listSize;
+}
+
+
+template <class T> void RGPool<T> :: ReturnList () {
+
+	RGPoolNode* first = ThreadList;
+	RGPoolNode* last = first;
+
+	for (int i=1; i<BlockSize; i++)
+		last = last->mNext;
+
+	ThreadList = last->mNext;
+	ThreadListSize -= BlockSize;
+	last->mNext = NULL;
+
+	LockDepot ();
+	first->mNextList = Depot;
+	Depot = first;
+	UnlockDepot ();
+}
+
+
+template <class T> void RGPool<T> :: ReturnAll () {
+
+	RGPoolNode* node;
+
+	FlushCounts ();
+
+	while (ThreadListSize >= BlockSize)
+		ReturnList ();
+
+	if (ThreadList == NULL)
+		return;
+
+	LockDepot ();
+
+	while (ThreadList != NULL) {
+
+		node = ThreadList;
+		ThreadList = node->mNext;
+		node->mNext = PartialList;
+		PartialList = node;
+		PartialListSize++;
+
+		if (PartialListSize == BlockSize) {
+
+			PartialList->mNextList = Depot;
+			Depot = PartialList;
+			PartialList = NULL;
+			PartialListSize = 0;
+		}
+	}
+
+	UnlockDepot ();
+	ThreadListSize = 0;
+}
+
+
+template <class T> void RGPool<T> :: AddExitFunction () {
+
+	//  once for each pool, by whichever thread first keeps a free list
+
+	if ((RGAtomicGet (&ExitFunctionAdded) == 0) && (RGAtomicCompareExchange (&ExitFunctionAdded, 1, 0) == 0))
+		RGThread::AddExitFunction (ReturnAll);
+}
+
+
+#endif  /*  _RGPOOL_H_  */
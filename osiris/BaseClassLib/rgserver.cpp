@@ -40,10 +40,30 @@
 #include "rgserver.h"
 #include "rgcommdefs.h"
 
+#if !defined (_WINDOWS) && !defined (WIN32)
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+#endif
+
 
 int RGServer::ReceiveBufferSize = 10240;
 
 
+#if defined (_WINDOWS) || defined (WIN32)
+
+
 RGClientPort :: RGClientPort () : OKToReadHandle (0), OKToWriteHandle (0), ContinuationHandle (0), 
 ClientPidHandle (0), HotLineHandle (0), BufferHandle (0), LastError (RGOK), FirstTime (TRUE), Connected (FALSE), ServerId (0),
 Parent (NULL) {}
@@ -889,3 +909,508 @@ int RGServer :: WaitForReadAccess (HANDLE* HandleArray) {
 
 	return 0;
 }
+
+
+#else
+
+
+int RGWriteMessage (int socket, unsigned long type, int len, const unsigned char* data) {
+
+	if ((len < 0) || (len > RGMAXMESSAGESIZE))
+		return -1;
+
+	unsigned int header [2];
+	header [0] = (unsigned int) type;
+	header [1] = (unsigned int) len;
+	const unsigned char* next = (const unsigned char*) header;
+	size_t left = RGMESSAGEHEADERSIZE;
+	ssize_t written;
+	bool sendingHeader = true;
+
+	while (true) {
+
+		if (left == 0) {
+
+			if (!sendingHeader || (len <= 0))
+				return 0;
+
+			sendingHeader = false;
+			next = data;
+			left = len;
+		}
+
+		written = send (socket, next, left, MSG_NOSIGNAL);
+
+		if (written < 0) {
+
+			if (errno == EINTR)
+				continue;
+
+			return -1;
+		}
+
+		next += written;
+		left -= written;
+	}
+}
+
+
+static int ReadFromSocket (int socket, unsigned char* data, size_t len) {
+
+	ssize_t nRead;
+
+	while (len > 0) {
+
+		nRead = recv (socket, data, len, 0);
+
+		if (nRead < 0) {
+
+			if (errno == EINTR)
+				continue;
+
+			return -1;
+		}
+
+		if (nRead == 0)
+			return -1;
+
+		data += nRead;
+		len -= nRead;
+	}
+
+	return 0;
+}
+
+
+int RGReadMessage (int socket, unsigned long& type, unsigned char*& buffer, int& bufferSize, int& len) {
+
+	unsigned int header [2];
+
+	if (ReadFromSocket (socket, (unsigned char*) header, RGMESSAGEHEADERSIZE) < 0)
+		return -1;
+
+	type = header [0];
+	len = (int) header [1];
+
+	if ((len < 0) || (len > RGMAXMESSAGESIZE))
+		return -1;
+
+	if (len >= bufferSize) {
+
+		delete[] buffer;
+		bufferSize = len + 1;
+		buffer = new unsigned char [bufferSize];
+	}
+
+	if ((len > 0) && (ReadFromSocket (socket, buffer, len) < 0))
+		return -1;
+
+	buffer [len] = '\0';	// so that text messages can be used as strings
+	return 0;
+}
+
+
+RGClientPort :: RGClientPort (int socket) : Socket (socket), LastError (RGOK) {
+
+#ifdef SO_NOSIGPIPE
+	int on = 1;
+	setsockopt (Socket, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof (on));
+#endif
+}
+
+
+RGClientPort :: ~RGClientPort () {
+
+	close (Socket);
+}
+
+
+int RGClientPort :: Reply (int len, unsigned char* data, unsigned long type) {
+
+	LastError = RGOK;
+
+	if (RGWriteMessage (Socket, type, len, data) < 0) {
+
+		LastError = RGCLIENTTERMINATED;
+		return -1;
+	}
+
+	return 0;
+}
+
+
+RGServer :: RGServer (const RGString& name) : Name (name), NextClientId (1), ListenSocket (-1), BufferSize (0), DataBegin (NULL),
+LastError (RGOK), Initialized (FALSE) {
+
+	RegisterName ();
+}
+
+
+RGServer :: ~RGServer () {
+
+	if (Initialized) {
+
+		close (ListenSocket);
+		unlink (Name.GetData ());
+	}
+
+	ClientPortList.ClearAndDestroy ();
+	UnusedClientIds.clearAndDestroy ();
+	delete[] DataBegin;
+}
+
+
+void RGServer :: ResetReceiveBufferSize (int newSize) {
+
+	if (newSize > 0)
+		ReceiveBufferSize = newSize;
+}
+
+
+int RGServer :: Receive (int clientId, unsigned char*& receiveBuffer, int& receiveLength) {
+
+	//
+	//  returns Id of client
+	//
+
+	LastError = RGOK;
+
+	if (!Initialized) {
+
+		LastError = RGCHANNELNOTOPEN;
+		return -1;
+	}
+
+	while (true) {
+
+		int Id = WaitForMessage (clientId, -1);
+
+		if (Id < 0)
+			return -1;
+
+		if (Id == 0)
+			continue;
+
+		if (ReceiveFrom (Id, receiveBuffer, receiveLength) == 0)
+			return Id;
+
+		//
+		//  The client has gone:  wait for another unless a specific client was wanted
+		//
+
+		if (clientId != 0)
+			return -1;
+	}
+}
+
+
+int RGServer :: TestReceive (int clientId, unsigned char*& receiveBuffer, int& receiveLength) {
+
+	//
+	//  returns Id of client, or 0 if there is no message waiting
+	//
+
+	LastError = RGOK;
+
+	if (!Initialized) {
+
+		LastError = RGCHANNELNOTOPEN;
+		return -1;
+	}
+
+	int Id = WaitForMessage (clientId, 0);
+
+	if (Id <= 0)
+		return Id;
+
+	if (ReceiveFrom (Id, receiveBuffer, receiveLength) < 0) {
+
+		if (clientId != 0)
+			return -1;
+
+		return 0;
+	}
+
+	return Id;
+}
+
+
+int RGServer :: Reply (int clientId, unsigned char* replyBuffer, int replyLength) {
+
+	return ReplyWithType (clientId, replyBuffer, replyLength, RGREPLY);
+}
+
+
+int RGServer :: ReplyWithContinuation (int clientId, unsigned char* replyBuffer, int replyLength) {
+
+	return ReplyWithType (clientId, replyBuffer, replyLength, RGREPLYWITHCONTINUATION);
+}
+
+
+void RGServer :: RemoveClient (int id) {
+
+	RGClientPort* port = ClientPortList.RemoveElementAt (id);
+
+	if (port == NULL)
+		return;
+
+	delete port;
+	int* newInt = new int;
+	*newInt = id;
+	UnusedClientIds.append (newInt);
+}
+
+
+int RGServer :: RegisterName () {
+
+	struct sockaddr_un address;
+
+	if (Name.Length () >= sizeof (address.sun_path)) {
+
+		LastError = RGCHANNELPROBLEM;
+		return -1;
+	}
+
+	memset (&address, 0, sizeof (address));
+	address.sun_family = AF_UNIX;
+	strcpy (address.sun_path, Name.GetData ());
+
+	//
+	//  A socket left by a server that has ended is replaced; one that answers belongs to a server that is still running.  Anything
+	//  else at the path is left alone.
+	//
+
+	struct stat status;
+
+	if (lstat (Name.GetData (), &status) == 0) {
+
+		if (!S_ISSOCK (status.st_mode)) {
+
+			LastError = RGSERVERNAMEALREADYEXISTS;
+			return -1;
+		}
+
+		int probe = socket (AF_UNIX, SOCK_STREAM, 0);
+
+		if (probe < 0) {
+
+			LastError = RGNOHANDLE;
+			return -1;
+		}
+
+		if (connect (probe, (struct sockaddr*) &address, sizeof (address)) == 0) {
+
+			close (probe);
+			LastError = RGSERVERNAMEALREADYEXISTS;
+			return -1;
+		}
+
+		close (probe);
+		unlink (Name.GetData ());
+	}
+
+	ListenSocket = socket (AF_UNIX, SOCK_STREAM, 0);
+
+	if (ListenSocket < 0) {
+
+		LastError = RGNOHANDLE;
+		return -1;
+	}
+
+	//  Only the owner may connect, so the socket is created without permissions for anyone else
+
+	mode_t oldMask = umask (077);
+	int bindStatus = bind (ListenSocket, (struct sockaddr*) &address, sizeof (address));
+	umask (oldMask);
+
+	if ((bindStatus < 0) || (listen (ListenSocket, 16) < 0)) {
+
+		close (ListenSocket);
+		ListenSocket = -1;
+		LastError = RGCHANNELPROBLEM;
+		return -1;
+	}
+
+	BufferSize = ReceiveBufferSize;
+	DataBegin = new unsigned char [BufferSize];
+	Initialized = TRUE;
+	return 0;
+}
+
+
+int RGServer :: AddClient (int socket) {
+
+	int Id;
+	int* first = UnusedClientIds.RemoveFirst ();
+
+	if (first == NULL) {
+
+		Id = NextClientId;
+		NextClientId++;
+	}
+
+	else {
+
+		Id = *first;
+		delete first;
+	}
+
+	ClientPortList.ReplaceElementAt (Id, new RGClientPort (socket));
+	return Id;
+}
+
+
+int RGServer :: WaitForMessage (int clientId, int timeout) {
+
+	//
+	//  Accepts clients as they connect.  Returns the Id of a client with a message waiting, 0 if there is none before
+	//  timeout (in milliseconds; negative to wait indefinitely), or -1
+	//
+
+	struct pollfd* fds;
+	int* ids;
+	int nFds;
+	int i;
+	int status;
+	int newSocket;
+	RGClientPort* port;
+	int Id = 0;
+
+	if (clientId != 0) {
+
+		port = ClientPortList.GetElementAt (clientId);
+
+		if (port == NULL) {
+
+			LastError = RGCLIENTNULL;
+			return -1;
+		}
+	}
+
+	while (Id == 0) {
+
+		fds = new struct pollfd [ClientPortList.Length () + 1];
+		ids = new int [ClientPortList.Length () + 1];
+		nFds = 0;
+
+		if (clientId == 0) {
+
+			fds [0].fd = ListenSocket;
+			fds [0].events = POLLIN;
+			ids [0] = 0;
+			nFds = 1;
+
+			for (i=1; i<(int)ClientPortList.Length (); i++) {
+
+				port = ClientPortList.GetElementAt (i);
+
+				if (port != NULL) {
+
+					fds [nFds].fd = port->GetSocket ();
+					fds [nFds].events = POLLIN;
+					ids [nFds] = i;
+					nFds++;
+				}
+			}
+		}
+
+		else {
+
+			fds [0].fd = ClientPortList.GetElementAt (clientId)->GetSocket ();
+			fds [0].events = POLLIN;
+			ids [0] = clientId;
+			nFds = 1;
+		}
+
+		status = poll (fds, nFds, timeout);
+
+		if (status < 0) {
+
+			delete[] fds;
+			delete[] ids;
+
+			if (errno == EINTR)
+				continue;
+
+			LastError = RGWAITFAILED;
+			return -1;
+		}
+
+		if (status == 0) {
+
+			delete[] fds;
+			delete[] ids;
+			return 0;
+		}
+
+		for (i=0; i<nFds; i++) {
+
+			if (fds [i].revents == 0)
+				continue;
+
+			if (ids [i] == 0) {
+
+				newSocket = accept (ListenSocket, NULL, NULL);
+
+				if (newSocket >= 0)
+					AddClient (newSocket);
+			}
+
+			else if (Id == 0)
+				Id = ids [i];
+		}
+
+		delete[] fds;
+		delete[] ids;
+	}
+
+	return Id;
+}
+
+
+int RGServer :: ReceiveFrom (int clientId, unsigned char*& receiveBuffer, int& receiveLength) {
+
+	unsigned long type;
+	RGClientPort* port = ClientPortList.GetElementAt (clientId);
+
+	if (port == NULL) {
+
+		LastError = RGCLIENTNULL;
+		return -1;
+	}
+
+	if (RGReadMessage (port->GetSocket (), type, DataBegin, BufferSize, receiveLength) < 0) {
+
+		LastError = RGCLIENTTERMINATED;
+		RemoveClient (clientId);
+		return -1;
+	}
+
+	receiveBuffer = DataBegin;
+	return 0;
+}
+
+
+int RGServer :: ReplyWithType (int clientId, unsigned char* replyBuffer, int replyLength, unsigned long type) {
+
+	RGClientPort* port = ClientPortList.GetElementAt (clientId);
+
+	if (port == NULL) {
+
+		LastError = RGCLIENTNULL;
+		return -1;
+	}
+
+	int status = port->Reply (replyLength, replyBuffer, type);
+
+	if (status < 0) {
+
+		LastError = port->GetLastError ();
+		RemoveClient (clientId);
+		return -1;
+	}
+
+	return 0;
+}
+
+#endif
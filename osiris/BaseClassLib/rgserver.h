@@ -36,11 +36,17 @@
 // of the server functions.  To Receive from and Reply to a client requires that an RGServer object work through an RGClientPort object.
 // Each RGServer object maintains a list of clients with which it has communicated.
 //
+//  On other platforms, the server is a Unix-domain socket whose path is the server name.  Each message is preceded by its
+// type and its length.  A server may answer one message with several replies, all but the last of which are sent with
+// ReplyWithContinuation.
+//
 
 #ifndef _RGSERVER_H_
 #define _RGSERVER_H_
 
+#if defined (_WINDOWS) || defined (WIN32)
 #include <windows.h>
+#endif
 
 #include "rgstring.h"
 #include "rgcommlist.h"
@@ -49,6 +55,9 @@
 class RGServer;
 
 
+#if defined (_WINDOWS) || defined (WIN32)
+
+
 class RGClientPort {
 
 public:
@@ -149,5 +158,68 @@ protected:
 	static int ReceiveBufferSize;
 };
 
+#else
+
+
+class RGClientPort {
+
+public:
+	RGClientPort (int socket);
+	~RGClientPort ();
+
+	int Reply (int len, unsigned char* data, unsigned long type);
+	int GetSocket () const { return Socket; }
+	int GetLastError () const { return LastError; }
+
+protected:
+	int Socket;
+	int LastError;
+};
+
+
+class RGServer {
+
+public:
+	RGServer (const RGString& name);	// name is the path of the socket
+	~RGServer ();
+
+	static void ResetReceiveBufferSize (int newSize);
+
+	Boolean IsActive () const { return Initialized; }
+
+	const char* GetName () const { return Name.GetData (); }
+	unsigned long GetNameLength () const { return (unsigned long) Name.Length (); }
+	int GetLastError () const { return LastError; }
+
+	int Receive (int clientId, unsigned char*& receiveBuffer, int& receiveLength);	// clientId 0 for any client; returns id of client
+	int TestReceive (int clientId, unsigned char*& receiveBuffer, int& receiveLength);	// returns 0 if no message is waiting
+	int Reply (int clientId, unsigned char* replyBuffer, int replyLength);
+	int ReplyWithContinuation (int clientId, unsigned char* replyBuffer, int replyLength);	// more replies follow
+
+	void RemoveClient (int id);
+
+protected:
+	RGString Name;
+	RGTarray<RGClientPort> ClientPortList;
+	CommDataList<int> UnusedClientIds;
+	int NextClientId;
+
+	int ListenSocket;
+	int BufferSize;
+	unsigned char* DataBegin;	// receive buffer, returned by Receive and valid until the next Receive
+	int LastError;
+	Boolean Initialized;
+
+	int RegisterName ();
+	int AddClient (int socket);
+	int WaitForMessage (int clientId, int timeout);	// returns id of client with a message waiting, 0 on timeout or -1
+	int ReceiveFrom (int clientId, unsigned char*& receiveBuffer, int& receiveLength);
+	int ReplyWithType (int clientId, unsigned char* replyBuffer, int replyLength, unsigned long type);
+
+	static int ReceiveBufferSize;
+};
+
+#endif
+
 
 #endif  /*  _RGSERVER_H_  */
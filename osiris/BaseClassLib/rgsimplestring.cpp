@@ -76,14 +76,14 @@ RGSimpleString :: RGSimpleString (size_t size) : StringLength (0) {
 
 RGSimpleString :: ~RGSimpleString () {
 
-	delete Data;
+	Data->Release ();
 }
 
 
 void RGSimpleString :: ResizeLength (size_t size) {
 
 	RGStringData* NewData = new RGStringData (*Data, size);
-	delete Data;
+	Data->Release ();
 	Data = NewData;
 }
 
@@ -96,7 +96,7 @@ RGSimpleString& RGSimpleString :: operator=(const char* str) {
 	
 	else {
 
-		delete Data;
+		Data->Release ();
 		Data = new RGStringData (str);
 	}
 
@@ -111,7 +111,7 @@ RGSimpleString& RGSimpleString :: operator=(const RGSimpleString& str) {
 	if (Data == str.Data)
 		return *this;
 	
-	delete Data;
+	Data->Release ();
 	Data = (str.Data)->MakeCopy ();
 	StringLength = str.StringLength;
 	return *this;
@@ -123,7 +123,7 @@ RGSimpleString& RGSimpleString :: operator=(const RGString& str) {
 	if (Data == str.Data)
 		return *this;
 	
-	delete Data;
+	Data->Release ();
 	Data = (str.Data)->MakeCopy ();
 	StringLength = str.StringLength;
 	return *this;
@@ -210,7 +210,7 @@ void RGSimpleString :: RestoreAll (RGFile& f) {
 	if (Data->GetReferenceCount () > 1) {
 
 		NewData = new RGStringData (StringLength + 1);
-		delete Data;
+		Data->Release ();
 		Data = NewData;
 	}
 
@@ -238,7 +238,7 @@ void RGSimpleString :: RestoreAll (RGVInStream& vin) {
 	if (Data->GetReferenceCount () > 1) {
 
 		NewData = new RGStringData (StringLength + 1);
-		delete Data;
+		Data->Release ();
 		Data = NewData;
 	}
 
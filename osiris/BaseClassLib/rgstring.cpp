@@ -98,7 +98,7 @@ RGString :: RGString (size_t size) : RGPersistent (), StringLength (0) {
 
 RGString :: ~RGString() {
 
-  delete Data;
+  Data->Release ();
 #ifdef _WINDOWS
   if (WData != NULL)
   {
@@ -150,7 +150,7 @@ const wchar_t* RGString::GetWData() const
 void RGString :: ResizeLength (size_t size) {
 
 	RGStringData* NewData = new RGStringData (*Data, size);
-	delete Data;
+	Data->Release ();
 	Data = NewData;
 }
 
@@ -181,7 +181,7 @@ void RGString :: SetCharacter (char c, size_t i) { // with bounds checking
 	if (Data->GetReferenceCount () > 1) {
 
 		NewData = new RGStringData (*Data);
-		delete Data;
+		Data->Release ();
 		Data = NewData;
 	}
 	
@@ -267,7 +267,7 @@ RGString RGString :: ExtractAndRemoveLastCharacters (size_t nChars) {
 	if (Data->GetReferenceCount () > 1)	{
 
 		RGStringData* NewData = new RGStringData (*Data);
-		delete Data;
+		Data->Release ();
 		Data = NewData;
 	}
 	
@@ -335,7 +335,7 @@ char RGString :: RemoveLastCharacter () {
 	if (Data->GetReferenceCount () > 1)	{
 
 		RGStringData* NewData = new RGStringData (*Data);
-		delete Data;
+		Data->Release ();
 		Data = NewData;
 	}
 
@@ -355,7 +355,7 @@ RGString& RGString :: operator=(const char* str) {
 	
 	else {
 
-		delete Data;
+		Data->Release ();
 		Data = new RGStringData (str);
 	}
 
@@ -370,7 +370,7 @@ RGString& RGString :: operator=(const RGString& str) {
 	if (Data == str.Data)
 		return *this;
 	
-	delete Data;
+	Data->Release ();
 	Data = (str.Data)->MakeCopy ();
 	StringLength = str.StringLength;
 	return *this;
@@ -382,7 +382,7 @@ RGString& RGString :: operator=(const RGSimpleString& str) {
 	if (Data == str.Data)
 		return *this;
 	
-	delete Data;
+	Data->Release ();
 	Data = (str.Data)->MakeCopy ();
 	StringLength = str.StringLength;
 	return *this;
@@ -497,7 +497,7 @@ RGString& RGString :: Append (const char* str) {
 	else {
 
 		NewData = new RGStringData (*Data, N);
-		delete Data;
+		Data->Release ();
 		Data = NewData;
 	}
 
@@ -521,7 +521,7 @@ RGString& RGString :: Append (const RGString& str) {
 	else {
 
 		NewData = new RGStringData (*Data, N);
-		delete Data;
+		Data->Release ();
 		Data = NewData;
 	}
 
@@ -542,7 +542,7 @@ RGString& RGString :: Append (char c) {
 	else {
 
 		NewData = new RGStringData (*Data, N);
-		delete Data;
+		Data->Release ();
 		Data = NewData;
 	}
 
@@ -612,7 +612,7 @@ void RGString :: ResetData () {
 	if (Data->GetReferenceCount () > 1) {
 
 		NewData = new RGStringData;
-		delete Data;
+		Data->Release ();
 		Data = NewData;
 	}
 
@@ -630,7 +630,7 @@ void RGString :: ToUpper () {
 	if (Data->GetReferenceCount () > 1) {
 
 		NewData = new RGStringData (*Data);
-		delete Data;
+		Data->Release ();
 		Data = NewData;
 	}
 	
@@ -650,7 +650,7 @@ void RGString :: ToLower () {
 	if (Data->GetReferenceCount () > 1) {
 
 		NewData = new RGStringData (*Data);
-		delete Data;
+		Data->Release ();
 		Data = NewData;
 	}
 	
@@ -1092,7 +1092,7 @@ RGString RGString :: ExtractAndRemoveSubstring (size_t first, size_t last) {
 	if (Data->GetReferenceCount () > 1)	{
 
 		RGStringData* NewData = new RGStringData (*Data);
-		delete Data;
+		Data->Release ();
 		Data = NewData;
 	}
 	
@@ -1167,7 +1167,7 @@ Boolean RGString :: FindAndReplaceNextSubstring (const RGString& target, const R
 	else {
 
 		NewData = new RGStringData (*Data, N);
-		delete Data;
+		Data->Release ();
 		Data = NewData;
 	}
 	
@@ -1279,7 +1279,7 @@ Boolean RGString :: ReplaceSubstring (size_t startPosn, size_t& endPosn, const R
 	else {
 
 		NewData = new RGStringData (*Data, N);
-		delete Data;
+		Data->Release ();
 		Data = NewData;
 	}
 	
@@ -1497,20 +1497,22 @@ RGFile& RGString :: ReadToEndOfFile (RGFile& f) {
 
 RGFile& RGString :: ReadTextToDelimiter (RGFile& f, char delimiter) {
 	
-	// Read to EOF or delimiter
+	// Read to EOF or delimiter.  Characters are taken straight from the stdio buffer, because a whole file, such as the
+	// message book, is read this way
 
-	char c;
+	FILE* file = f.GetFile ();
+	int c;
 
 	ResetData ();
 
 	while (TRUE) {
 
-		f.Read (c);
+		c = getc (file);
 
-		if ((f.Eof ()) || (c == delimiter))
+		if ((c == EOF) || ((char)c == delimiter))
 			break;
 
-		Data->AppendCharacter (c, StringLength);
+		Data->AppendCharacter ((char)c, StringLength);
 		StringLength++;
 	}
 
@@ -1613,6 +1615,27 @@ unsigned RGString :: HashNumber (unsigned long Base) const {
 
 
 
+unsigned long RGString :: FullHashNumber () const {
+
+	//
+	//  HashNumber depends only on the last character, so use FNV-1a over all characters up to the null,
+	//  which is what IsEqualTo compares
+	//
+
+	unsigned long Total = 2166136261UL;
+	unsigned char* MyData = (unsigned char*)Data->GetData ();
+
+	while (*MyData) {
+
+		Total = ((Total ^ *MyData) * 16777619UL) & 0xffffffffUL;
+		MyData++;
+	}
+
+	return Total;
+}
+
+
+
 Boolean RGString :: IsEqualTo (const RGPersistent* s) const {
 
 	const RGString* str = (const RGString*) s;
@@ -1636,7 +1659,7 @@ void RGString :: RestoreAll (RGFile& f) {
 	if (Data->GetReferenceCount () > 1) {
 
 		NewData = new RGStringData (StringLength + 1);
-		delete Data;
+		Data->Release ();
 		Data = NewData;
 	}
 
@@ -1665,7 +1688,7 @@ void RGString :: RestoreAll (RGVInStream& vin) {
 	if (Data->GetReferenceCount () > 1) {
 
 		NewData = new RGStringData (StringLength + 1);
-		delete Data;
+		Data->Release ();
 		Data = NewData;
 	}
 
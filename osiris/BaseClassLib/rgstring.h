@@ -184,6 +184,7 @@ public:
 	virtual size_t StoreSize () const;
 	virtual int CompareTo (const RGPersistent*) const;
 	virtual unsigned HashNumber (unsigned long Base) const;
+	virtual unsigned long FullHashNumber () const;
 	virtual Boolean IsEqualTo (const RGPersistent*) const;
 
 	virtual void RestoreAll (RGFile&);
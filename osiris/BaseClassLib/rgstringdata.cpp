@@ -106,12 +106,16 @@ RGStringData :: RGStringData (const RGStringData& str, size_t size) : ReferenceC
 
 RGStringData :: ~RGStringData () {
 
-	ReferenceCount--;
+	delete [] Data;
+}
 
-	if (ReferenceCount <= 0) {
 
-		delete [] Data;
-	}
+void RGStringData :: Release () {
+
+	// The count is tested only through the result of the decrement:  once it is released, another thread may delete this
+
+	if (DecrementReferenceCount () <= 0)
+		delete this;
 }
 
 
@@ -123,19 +127,14 @@ void* RGStringData :: operator new (size_t nbytes) {
  
 void RGStringData :: operator delete (void* p)
 {
-  RGStringData* d = (RGStringData*) p;
-
-  if (d->GetReferenceCount () <= 0) {
-		
-		free (p);
-  }
+	free (p);
  }
 
 
 RGStringData* RGStringData :: MakeCopy () {
 
 	RGStringData* NewData = (RGStringData*) this;
-	ReferenceCount++;
+	IncrementReferenceCount ();
 	return NewData;
 }
 
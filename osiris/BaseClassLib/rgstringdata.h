@@ -35,6 +35,7 @@
 #define _STRINGDATA_H_
 
 #include <cctype>
+#include "rgthread.h"
 
 const int RGDEFAULT_SIZE = 17 * sizeof (unsigned long);   // should be multiple of sizeof(unsigned long)
 const int RGDEFAULT_INCREMENT = 6 * sizeof (unsigned long);   // should be multiple of sizeof(unsigned long)
@@ -59,9 +60,10 @@ public:
 	operator char*() const { return Data; }  // gets data
 	char* GetData() const { return Data; }
 
-	int IncrementReferenceCount () { ReferenceCount++; return ReferenceCount;}
-	int DecrementReferenceCount () { ReferenceCount--; return ReferenceCount;}
-	int GetReferenceCount () const { return ReferenceCount; }
+	int IncrementReferenceCount () { return (int) RGAtomicIncrement (&ReferenceCount); }
+	int DecrementReferenceCount () { return (int) RGAtomicDecrement (&ReferenceCount); }
+	int GetReferenceCount () const { return (int) RGAtomicGet (&ReferenceCount); }
+	void Release ();	// drops one reference; deletes this when it was the last one
 
 	size_t GetDataLength () const { return DataLength; }
 	size_t WithoutCopyIncreaseSizeTo (size_t size);
@@ -78,7 +80,7 @@ public:
 
 protected:
 	char* Data;
-	int ReferenceCount;
+	mutable volatile long ReferenceCount;	// shared by strings in different threads, so always changed atomically
 	size_t DataLength;
 
 	size_t ComputeNewLength (size_t size);
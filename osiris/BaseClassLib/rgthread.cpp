@@ -0,0 +1,434 @@
+/*
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+*  FileName: rgthread.cpp
+*  Author:   Robert Goor
+*
+*/
+//
+//  classes RGMutex, RGLock, RGCondition and RGThread, which provide the minimal, portable thread support used to analyze
+//  samples concurrently, and class template RGThreadStatic, which gives a class static a separate value in each thread
+//
+
+#include <string.h>
+#include <stdlib.h>
+
+#ifdef _WINDOWS
+
+#include <windows.h>
+#include <process.h>
+
+#elif defined WIN32
+
+#include <windows.h>
+#include <process.h>
+
+#else
+
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#endif
+
+#include "rgthread.h"
+
+
+//  Exit functions may be added during static initialization, so the registry is plain data guarded by a spin lock
+
+typedef void (*RGThreadExitFunction) ();
+
+static RGThreadExitFunction ExitFunctions [RGThread::MaxExitFunctions];
+static volatile long NumberOfExitFunctions = 0;
+static volatile long ExitFunctionsLock = 0;
+
+RG_THREAD_LOCAL char* RGThreadStaticBase :: ThreadBlock = NULL;
+RGThreadStaticBase* RGThreadStaticBase :: First = NULL;
+size_t RGThreadStaticBase :: BlockSize = 0;
+
+
+#if defined (_WINDOWS) || defined (WIN32)
+
+RGMutex :: RGMutex () {
+
+	CRITICAL_SECTION* cs = new CRITICAL_SECTION;
+	InitializeCriticalSection (cs);
+	mHandle = (void*) cs;
+}
+
+
+RGMutex :: ~RGMutex () {
+
+	CRITICAL_SECTION* cs = (CRITICAL_SECTION*) mHandle;
+	DeleteCriticalSection (cs);
+	delete cs;
+}
+
+
+void RGMutex :: Lock () {
+
+	EnterCriticalSection ((CRITICAL_SECTION*) mHandle);
+}
+
+
+void RGMutex :: Unlock () {
+
+	LeaveCriticalSection ((CRITICAL_SECTION*) mHandle);
+}
+
+
+RGCondition :: RGCondition () {
+
+	CONDITION_VARIABLE* cv = new CONDITION_VARIABLE;
+	InitializeConditionVariable (cv);
+	mHandle = (void*) cv;
+}
+
+
+RGCondition :: ~RGCondition () {
+
+	delete (CONDITION_VARIABLE*) mHandle;
+}
+
+
+void RGCondition :: Wait (RGMutex& mutex) {
+
+	SleepConditionVariableCS ((CONDITION_VARIABLE*) mHandle, (CRITICAL_SECTION*) mutex.mHandle, INFINITE);
+}
+
+
+void RGCondition :: Signal () {
+
+	WakeConditionVariable ((CONDITION_VARIABLE*) mHandle);
+}
+
+
+void RGCondition :: Broadcast () {
+
+	WakeAllConditionVariable ((CONDITION_VARIABLE*) mHandle);
+}
+
+
+static unsigned __stdcall RGThreadEntry (void* arg) {
+
+	RGThread::Execute ((RGThread*) arg);
+	return 0;
+}
+
+
+bool RGThread :: Start () {
+
+	if (mHandle != NULL)
+		return false;
+
+	mThreadStatics = RGThreadStaticBase::SaveValues ();
+	uintptr_t handle = _beginthreadex (NULL, 0, RGThreadEntry, (void*) this, 0, NULL);
+
+	if (handle == 0) {
+
+		RGThreadStaticBase::DeleteValues (mThreadStatics);
+		mThreadStatics = NULL;
+		return false;
+	}
+
+	mHandle = (void*) handle;
+	return true;
+}
+
+
+void RGThread :: Join () {
+
+	if (mHandle == NULL)
+		return;
+
+	WaitForSingleObject ((HANDLE) mHandle, INFINITE);
+	CloseHandle ((HANDLE) mHandle);
+	mHandle = NULL;
+}
+
+
+int RGThread :: GetNumberOfProcessors () {
+
+	SYSTEM_INFO info;
+	GetSystemInfo (&info);
+	return (int) info.dwNumberOfProcessors;
+}
+
+
+void RGThread :: YieldThread () {
+
+	SwitchToThread ();
+}
+
+#else
+
+RGMutex :: RGMutex () {
+
+	pthread_mutex_t* mutex = new pthread_mutex_t;
+	pthread_mutex_init (mutex, NULL);
+	mHandle = (void*) mutex;
+}
+
+
+RGMutex :: ~RGMutex () {
+
+	pthread_mutex_t* mutex = (pthread_mutex_t*) mHandle;
+	pthread_mutex_destroy (mutex);
+	delete mutex;
+}
+
+
+void RGMutex :: Lock () {
+
+	pthread_mutex_lock ((pthread_mutex_t*) mHandle);
+}
+
+
+void RGMutex :: Unlock () {
+
+	pthread_mutex_unlock ((pthread_mutex_t*) mHandle);
+}
+
+
+RGCondition :: RGCondition () {
+
+	pthread_cond_t* cv = new pthread_cond_t;
+	pthread_cond_init (cv, NULL);
+	mHandle = (void*) cv;
+}
+
+
+RGCondition :: ~RGCondition () {
+
+	pthread_cond_t* cv = (pthread_cond_t*) mHandle;
+	pthread_cond_destroy (cv);
+	delete cv;
+}
+
+
+void RGCondition :: Wait (RGMutex& mutex) {
+
+	pthread_cond_wait ((pthread_cond_t*) mHandle, (pthread_mutex_t*) mutex.mHandle);
+}
+
+
+void RGCondition :: Signal () {
+
+	pthread_cond_signal ((pthread_cond_t*) mHandle);
+}
+
+
+void RGCondition :: Broadcast () {
+
+	pthread_cond_broadcast ((pthread_cond_t*) mHandle);
+}
+
+
+extern "C" {
+
+	static void* RGThreadEntry (void* arg) {
+
+		RGThread::Execute ((RGThread*) arg);
+		return NULL;
+	}
+}
+
+
+bool RGThread :: Start () {
+
+	if (mHandle != NULL)
+		return false;
+
+	pthread_t* thread = new pthread_t;
+	mThreadStatics = RGThreadStaticBase::SaveValues ();
+
+	if (pthread_create (thread, NULL, RGThreadEntry, (void*) this) != 0) {
+
+		delete thread;
+		RGThreadStaticBase::DeleteValues (mThreadStatics);
+		mThreadStatics = NULL;
+		return false;
+	}
+
+	mHandle = (void*) thread;
+	return true;
+}
+
+
+void RGThread :: Join () {
+
+	if (mHandle == NULL)
+		return;
+
+	pthread_t* thread = (pthread_t*) mHandle;
+	pthread_join (*thread, NULL);
+	delete thread;
+	mHandle = NULL;
+}
+
+
+int RGThread :: GetNumberOfProcessors () {
+
+	long n = sysconf (_SC_NPROCESSORS_ONLN);
+
+	if (n < 1)
+		return 1;
+
+	return (int) n;
+}
+
+
+void RGThread :: YieldThread () {
+
+	sched_yield ();
+}
+
+#endif
+
+
+RGThread :: RGThread () : mHandle (NULL), mThreadStatics (NULL) {
+
+}
+
+
+RGThread :: ~RGThread () {
+
+	Join ();
+}
+
+
+bool RGThread :: AddExitFunction (void (*function) ()) {
+
+	bool added = false;
+	RGAcquireSpinLock (&ExitFunctionsLock);
+
+	if (NumberOfExitFunctions < MaxExitFunctions) {
+
+		ExitFunctions [NumberOfExitFunctions] = function;
+		NumberOfExitFunctions++;
+		added = true;
+	}
+
+	RGReleaseSpinLock (&ExitFunctionsLock);
+	return added;
+}
+
+
+void RGThread :: Execute (RGThread* thread) {
+
+	// The block of thread static values was copied from the starting thread in Start ()
+
+	RGThreadExitFunction functions [MaxExitFunctions];
+	int n;
+	int i;
+
+	RGThreadStaticBase::SetThreadBlock (thread->mThreadStatics);
+	thread->Run ();
+
+	RGAcquireSpinLock (&ExitFunctionsLock);
+	n = (int) NumberOfExitFunctions;
+
+	for (i=0; i<n; i++)
+		functions [i] = ExitFunctions [i];
+
+	RGReleaseSpinLock (&ExitFunctionsLock);
+
+	for (i=0; i<n; i++)
+		functions [i] ();
+
+	RGThreadStaticBase::SetThreadBlock (NULL);
+	RGThreadStaticBase::DeleteValues (thread->mThreadStatics);
+	thread->mThreadStatics = NULL;
+}
+
+
+RGThreadStaticBase :: RGThreadStaticBase (void* masterValue, size_t size) : mMasterValue (masterValue), mSize (size) {
+
+	// Registration happens during static initialization, before any thread other than the main thread exists
+
+	size_t alignment = sizeof (double);
+	mOffset = ((BlockSize + alignment - 1) / alignment) * alignment;
+	BlockSize = mOffset + size;
+	mNext = First;
+	First = this;
+}
+
+
+char* RGThreadStaticBase :: SaveValues () {
+
+	char* savedValues = new char [BlockSize + 1];
+	RGThreadStaticBase* next;
+	char* block = ThreadBlock;
+
+	for (next = First; next != NULL; next = next->mNext) {
+
+		if (block == NULL)
+			memcpy (savedValues + next->mOffset, next->mMasterValue, next->mSize);
+
+		else
+			memcpy (savedValues + next->mOffset, block + next->mOffset, next->mSize);
+	}
+
+	return savedValues;
+}
+
+
+void RGThreadStaticBase :: RestoreValues (const char* savedValues) {
+
+	RGThreadStaticBase* next;
+	char* block = ThreadBlock;
+
+	if (savedValues == NULL)
+		return;
+
+	if (block != NULL) {
+
+		if (block != savedValues)
+			memcpy (block, savedValues, BlockSize);
+
+		return;
+	}
+
+	for (next = First; next != NULL; next = next->mNext)
+		memcpy (next->mMasterValue, savedValues + next->mOffset, next->mSize);
+}
+
+
+char* RGThreadStaticBase :: CopyValues (const char* savedValues) {
+
+	if (savedValues == NULL)
+		return NULL;
+
+	char* copy = new char [BlockSize + 1];
+	memcpy (copy, savedValues, BlockSize);
+	return copy;
+}
+
+
+void RGThreadStaticBase :: DeleteValues (char* savedValues) {
+
+	delete[] savedValues;
+}
+
@@ -0,0 +1,262 @@
+/*
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+*  FileName: rgthread.h
+*  Author:   Robert Goor
+*
+*/
+//
+//  classes RGMutex, RGLock, RGCondition and RGThread, which provide the minimal, portable thread support used to analyze
+//  samples concurrently, and class template RGThreadStatic, which gives a class static a separate value in each thread.
+//  A new thread starts with a copy of the RGThreadStatic values of the thread that started it.
+//
+
+#ifndef _RGTHREAD_H_
+#define _RGTHREAD_H_
+
+#include <stddef.h>
+
+#if defined (_WINDOWS) || defined (WIN32)
+
+#include <intrin.h>
+
+#define RG_THREAD_LOCAL __declspec(thread)
+
+inline long RGAtomicIncrement (volatile long* p) { return _InterlockedIncrement (p); }
+inline long RGAtomicDecrement (volatile long* p) { return _InterlockedDecrement (p); }
+inline long RGAtomicAdd (volatile long* p, long n) { return _InterlockedExchangeAdd (p, n) + n; }
+inline long RGAtomicGet (volatile long* p) { return *p; }	// volatile reads have acquire semantics under Visual C++
+inline long RGAtomicCompareExchange (volatile long* p, long exchange, long comparand) { return _InterlockedCompareExchange (p, exchange, comparand); }
+
+#if defined (_M_IX86) || defined (_M_X64)
+inline void RGSpinPause () { _mm_pause (); }
+#else
+inline void RGSpinPause () {}
+#endif
+
+#else
+
+#define RG_THREAD_LOCAL __thread
+
+inline long RGAtomicIncrement (volatile long* p) { return __atomic_add_fetch (p, 1, __ATOMIC_ACQ_REL); }
+inline long RGAtomicDecrement (volatile long* p) { return __atomic_sub_fetch (p, 1, __ATOMIC_ACQ_REL); }
+inline long RGAtomicAdd (volatile long* p, long n) { return __atomic_add_fetch (p, n, __ATOMIC_ACQ_REL); }
+inline long RGAtomicGet (volatile long* p) { return __atomic_load_n (p, __ATOMIC_ACQUIRE); }
+inline long RGAtomicCompareExchange (volatile long* p, long exchange, long comparand) { __atomic_compare_exchange_n (p, &comparand, exchange, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE); return comparand; }
+
+#if defined (__i386__) || defined (__x86_64__)
+inline void RGSpinPause () { __builtin_ia32_pause (); }
+#elif defined (__aarch64__)
+inline void RGSpinPause () { __asm__ __volatile__ ("yield"); }
+#else
+inline void RGSpinPause () {}
+#endif
+
+#endif
+
+
+class RGMutex {
+
+public:
+	RGMutex ();
+	~RGMutex ();
+
+	void Lock ();
+	void Unlock ();
+
+protected:
+	void* mHandle;
+
+	friend class RGCondition;
+
+private:
+	RGMutex (const RGMutex&);
+	RGMutex& operator= (const RGMutex&);
+};
+
+
+class RGLock {
+
+public:
+	RGLock (RGMutex& mutex) : mMutex (mutex) { mMutex.Lock (); }
+	~RGLock () { mMutex.Unlock (); }
+
+protected:
+	RGMutex& mMutex;
+
+private:
+	RGLock (const RGLock&);
+	RGLock& operator= (const RGLock&);
+};
+
+
+class RGCondition {
+
+public:
+	RGCondition ();
+	~RGCondition ();
+
+	void Wait (RGMutex& mutex);	// mutex must be locked by caller; it is locked again on return
+	void Signal ();
+	void Broadcast ();
+
+protected:
+	void* mHandle;
+
+private:
+	RGCondition (const RGCondition&);
+	RGCondition& operator= (const RGCondition&);
+};
+
+
+class RGThread {
+
+public:
+	RGThread ();
+	virtual ~RGThread ();
+
+	bool Start ();
+	void Join ();
+	bool IsRunning () const { return mHandle != NULL; }
+
+	enum { MaxExitFunctions = 32 };
+
+	static int GetNumberOfProcessors ();
+	static void YieldThread ();	// lets another thread run on this processor
+	static bool AddExitFunction (void (*function) ());	// called on every thread after Run; false if there are too many
+	static void Execute (RGThread* thread);	// called on the new thread by the platform entry function
+
+protected:
+	void* mHandle;
+	char* mThreadStatics;
+
+	virtual void Run () = 0;
+
+private:
+	RGThread (const RGThread&);
+	RGThread& operator= (const RGThread&);
+};
+
+
+//
+//  A spin lock is a long that is 1 while it is held, for locks held only for a few instructions and needed before any
+//  RGMutex can be constructed.  A waiting thread pauses between tries, and after SpinTries tries yields the processor, so
+//  that it does not keep the holder from running.
+//
+
+const int SpinTries = 16;
+
+inline void RGAcquireSpinLock (volatile long* lock) {
+
+	int tries = 0;
+
+	while ((RGAtomicGet (lock) != 0) || (RGAtomicCompareExchange (lock, 1, 0) != 0)) {
+
+		if (tries < SpinTries) {
+
+			RGSpinPause ();
+			tries++;
+		}
+
+		else
+			RGThread::YieldThread ();
+	}
+}
+
+
+inline void RGReleaseSpinLock (volatile long* lock) { RGAtomicDecrement (lock); }
+
+
+//
+//  RGThreadStaticBase keeps a registry of all RGThreadStatic objects, each with an offset into a per-thread block of
+//  values.  The main thread has no block and uses the values stored in the objects themselves.  Only plain data (numbers,
+//  flags and pointers) may be made thread static, because values are copied between blocks byte by byte.
+//
+
+class RGThreadStaticBase {
+
+public:
+	RGThreadStaticBase (void* masterValue, size_t size);
+	~RGThreadStaticBase () {}
+
+	static char* SaveValues ();	// copy of the calling thread's current values
+	static void RestoreValues (const char* savedValues);	// restores the calling thread's values from a copy
+	static char* CopyValues (const char* savedValues);	// NULL if savedValues is NULL
+	static void DeleteValues (char* savedValues);
+
+	static void SetThreadBlock (char* block) { ThreadBlock = block; }
+	static char* GetThreadBlock () { return ThreadBlock; }
+
+protected:
+	void* mMasterValue;
+	size_t mSize;
+	size_t mOffset;
+	RGThreadStaticBase* mNext;
+
+	static RG_THREAD_LOCAL char* ThreadBlock;
+	static RGThreadStaticBase* First;
+	static size_t BlockSize;
+};
+
+
+template <class T> class RGThreadStatic : public RGThreadStaticBase {
+
+public:
+	RGThreadStatic () : RGThreadStaticBase (&mValue, sizeof (T)), mValue () {}
+	explicit RGThreadStatic (const T& value) : RGThreadStaticBase (&mValue, sizeof (T)), mValue (value) {}
+	~RGThreadStatic () {}
+
+	operator T () const { return *Address (); }
+	T operator-> () const { return *Address (); }	// for pointer types only
+	T& Value () { return *Address (); }
+
+	RGThreadStatic<T>& operator= (const T& value) { *Address () = value; return *this; }
+	RGThreadStatic<T>& operator= (const RGThreadStatic<T>& value) { *Address () = (T) value; return *this; }
+	RGThreadStatic<T>& operator+= (const T& value) { *Address () += value; return *this; }
+	RGThreadStatic<T>& operator-= (const T& value) { *Address () -= value; return *this; }
+	T operator++ () { return ++(*Address ()); }
+	T operator++ (int) { return (*Address ())++; }
+	T operator-- () { return --(*Address ()); }
+	T operator-- (int) { return (*Address ())--; }
+
+protected:
+	T mValue;
+
+	T* Address () const {
+
+		char* block = ThreadBlock;
+
+		if (block == NULL)
+			return (T*) &mValue;
+
+		return (T*) (block + mOffset);
+	}
+
+private:
+	RGThreadStatic (const RGThreadStatic<T>&);
+};
+
+
+#endif  /*  _RGTHREAD_H_  */
@@ -56,7 +56,7 @@ int RGTree :: CurrentRepetition = 0;
 PERSISTENT_DEFINITION (RGDocument, _RGDOCUMENT_, "Document")
 PERSISTENT_DEFINITION (RGTree, _RGTREE_, "Tree")
 
-Boolean RGDocument :: CompareOnName = TRUE;
+RGThreadStatic<Boolean> RGDocument :: CompareOnName (TRUE);
 
 //using namespace std;
 
@@ -38,6 +38,7 @@
 #include "rgpersist.h"
 #include "rgdlist.h"
 #include "rgstring.h"
+#include "rgthread.h"
 
 
 const int _RGTREE_ = 4;
@@ -98,7 +99,7 @@ protected:
 	RGString Name;
 
 	RGDocument (const RGDocument& doc);
-	static Boolean CompareOnName;
+	static RGThreadStatic<Boolean> CompareOnName;
 };
 
 
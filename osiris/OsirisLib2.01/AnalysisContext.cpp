@@ -0,0 +1,80 @@
+/*
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+*  FileName: AnalysisContext.cpp
+*  Author:   Robert Goor
+*
+*/
+//
+//  class AnalysisContext holds the analysis settings of one analysis, which are kept in thread static members, so that each
+//  thread working on the analysis can be given them; class AnalysisContextScope makes a context current for a block
+//
+
+#include "AnalysisContext.h"
+
+
+
+AnalysisContext :: AnalysisContext () {
+
+	mValues = RGThreadStaticBase::SaveValues ();
+}
+
+
+AnalysisContext :: AnalysisContext (const AnalysisContext& context) {
+
+	mValues = RGThreadStaticBase::CopyValues (context.mValues);
+}
+
+
+AnalysisContext :: ~AnalysisContext () {
+
+	RGThreadStaticBase::DeleteValues (mValues);
+}
+
+
+AnalysisContext& AnalysisContext :: operator= (const AnalysisContext& context) {
+
+	if (this != &context) {
+
+		RGThreadStaticBase::DeleteValues (mValues);
+		mValues = RGThreadStaticBase::CopyValues (context.mValues);
+	}
+
+	return *this;
+}
+
+
+void AnalysisContext :: Capture () {
+
+	RGThreadStaticBase::DeleteValues (mValues);
+	mValues = RGThreadStaticBase::SaveValues ();
+}
+
+
+void AnalysisContext :: MakeCurrent () const {
+
+	RGThreadStaticBase::RestoreValues (mValues);
+}
+
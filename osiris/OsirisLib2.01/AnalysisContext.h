@@ -0,0 +1,81 @@
+/*
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+*  FileName: AnalysisContext.h
+*  Author:   Robert Goor
+*
+*/
+//
+//  class AnalysisContext holds the analysis settings of one analysis:  the lab, command line and message book settings that
+//  are kept in thread static members (thresholds, minimum RFU's, fit tolerances, etc.).  A context is captured from the calling
+//  thread once the settings have been made, and is made current on each thread that works on the analysis, so that
+//  analyses with different command line settings can run in one process, each on its own threads.  AnalysisContextScope
+//  makes a context current for the duration of a block and then restores the settings that were current before.
+//
+//  A context does not hold the ParameterServer or the message book tables, which are loaded once in a process and shared by
+//  all contexts.  The lab settings are read into both:  the ParameterServer keeps the locus specific thresholds and sample
+//  type synonyms, and the message thresholds are written into the message book.  So the analyses in one process must use
+//  the same standard settings, lab settings and message book, and analyses with others are run in another process.
+//
+
+#ifndef _ANALYSISCONTEXT_H_
+#define _ANALYSISCONTEXT_H_
+
+#include "rgthread.h"
+
+
+class AnalysisContext {
+
+public:
+	AnalysisContext ();	// the settings current on the calling thread
+	AnalysisContext (const AnalysisContext& context);
+	~AnalysisContext ();
+
+	AnalysisContext& operator= (const AnalysisContext& context);
+
+	void Capture ();	// replaces the settings with those current on the calling thread
+	void MakeCurrent () const;	// makes the settings current on the calling thread
+
+protected:
+	char* mValues;
+};
+
+
+class AnalysisContextScope {
+
+public:
+	AnalysisContextScope (const AnalysisContext& context) : mPrevious () { context.MakeCurrent (); }
+	~AnalysisContextScope () { mPrevious.MakeCurrent (); }
+
+protected:
+	AnalysisContext mPrevious;
+
+private:
+	AnalysisContextScope (const AnalysisContextScope&);
+	AnalysisContextScope& operator= (const AnalysisContextScope&);
+};
+
+
+#endif  /*  _ANALYSISCONTEXT_H_  */
@@ -0,0 +1,136 @@
+/*
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+*  FileName: AnalysisServer.cpp
+*  Author:   Robert Goor
+*
+*/
+//
+//  class AnalysisServer receives analysis jobs on a Unix-domain socket and reports each job's progress to the client that
+//  sent it
+//
+
+#include "AnalysisServer.h"
+#include <iostream>
+#include <ctype.h>
+
+using namespace std;
+
+
+
+AnalysisServer :: AnalysisServer (const RGString& socketName) : AnalysisProgress (), mServer (socketName), mClientId (0) {
+
+}
+
+
+AnalysisServer :: ~AnalysisServer () {
+
+}
+
+
+bool AnalysisServer :: ReceiveJob (RGString& inputs) {
+
+	unsigned char* buffer;
+	int length;
+	int clientId;
+	RGString message;
+
+	while (true) {
+
+		clientId = mServer.Receive (0, buffer, length);
+
+		if (clientId < 0) {
+
+			cout << "Analysis server could not receive a job:  error " << mServer.GetLastError () << endl;
+			return false;
+		}
+
+		message = (char*) buffer;	// the server ends each message with a null
+		message.FindAndReplaceAllSubstrings ("\r", "");
+
+		while ((message.Length () > 0) && isspace (message.GetLastCharacter ()))
+			message.RemoveLastCharacter ();
+
+		if (message.Length () == 0)
+			continue;
+
+		if (message == "Shutdown;") {
+
+			cout << "Analysis server shutting down..." << endl;
+			mServer.Reply (clientId, (unsigned char*) "Shutdown;", 9);
+			return false;
+		}
+
+		RGLock lock (mMutex);
+		mClientId = clientId;
+		inputs = message;
+		return true;
+	}
+}
+
+
+void AnalysisServer :: EndJob (int status) {
+
+	RGString event;
+	event << "AnalysisComplete = " << status << ";";
+	SendEvent (event, true);
+	RGLock lock (mMutex);
+	mClientId = 0;
+}
+
+
+void AnalysisServer :: ReportProgress (const RGString& inputDirectory, double percentComplete) {
+
+	RGString event;
+	event << "Progress = " << inputDirectory << ", " << percentComplete << ";";
+	SendEvent (event, false);
+}
+
+
+void AnalysisServer :: ReportRunComplete (const RGString& inputDirectory, const RGString& reportDirectory, int status) {
+
+	RGString event;
+	event << "RunComplete = " << inputDirectory << ", " << reportDirectory << ", " << status << ";";
+	SendEvent (event, false);
+}
+
+
+void AnalysisServer :: SendEvent (const RGString& event, bool isLast) {
+
+	RGLock lock (mMutex);
+	int status;
+
+	if (mClientId == 0)
+		return;
+
+	if (isLast)
+		status = mServer.Reply (mClientId, (unsigned char*) event.GetData (), (int) event.Length ());
+
+	else
+		status = mServer.ReplyWithContinuation (mClientId, (unsigned char*) event.GetData (), (int) event.Length ());
+
+	if (status < 0)
+		mClientId = 0;	// the client has gone, but its job is completed
+}
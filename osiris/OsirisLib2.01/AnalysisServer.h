@@ -0,0 +1,76 @@
+/*
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+*  FileName: AnalysisServer.h
+*  Author:   Robert Goor
+*
+*/
+//
+//  class AnalysisServer is a resident analysis service on a Unix-domain socket, so that the kit, message book and settings
+//  that it loaded when it started are used by every analysis it is sent, without reading them again.  A job is one message:
+//  the lines of an input file, as they would be given on standard in.  While the job is analyzed, the server replies with
+//  continuation, one line for each event:
+//
+//      Progress = <input directory>, <percent complete>;
+//      RunComplete = <input directory>, <report directory>, <status>;
+//
+//  and then ends the job with the reply "AnalysisComplete = <status>;".  The message "Shutdown;" ends the service.  Jobs are
+//  analyzed one at a time, in the order they are received.
+//
+
+#ifndef _ANALYSISSERVER_H_
+#define _ANALYSISSERVER_H_
+
+#include "rgstring.h"
+#include "rgthread.h"
+#include "rgserver.h"
+#include "STRLCAnalysis.h"
+
+
+class AnalysisServer : public AnalysisProgress {
+
+public:
+	AnalysisServer (const RGString& socketName);
+	virtual ~AnalysisServer ();
+
+	bool IsActive () const { return (mServer.IsActive () == TRUE); }
+	int GetLastError () const { return mServer.GetLastError (); }
+
+	bool ReceiveJob (RGString& inputs);	// false when the service is to end
+	void EndJob (int status);
+
+	virtual void ReportProgress (const RGString& inputDirectory, double percentComplete);
+	virtual void ReportRunComplete (const RGString& inputDirectory, const RGString& reportDirectory, int status);
+
+protected:
+	RGServer mServer;
+	int mClientId;	// of the job being analyzed; 0 if none, or if its client has gone
+	RGMutex mMutex;	// events are reported by every thread analyzing the job
+
+	void SendEvent (const RGString& event, bool isLast);
+};
+
+
+#endif  /*  _ANALYSISSERVER_H_  */
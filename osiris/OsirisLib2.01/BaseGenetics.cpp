@@ -41,9 +41,10 @@
 #include "ChannelData.h"
 #include "CoreBioComponent.h"
 #include "ParameterServer.h"
+#include "SampleResultCache.h"
 
 
-Boolean BaseAllele::SearchByName = TRUE;
+RGThreadStatic<Boolean> BaseAllele::SearchByName (TRUE);
 bool* BaseLocus::InitialMatrix = NULL;
 RGString BaseLocus::ILSFamilyName;
 RGString BasePopulationMarkerSet::UserLaneStandardName;
@@ -185,6 +186,15 @@ unsigned BaseAllele :: HashNumber (unsigned long Base) const {
 }
 
 
+unsigned long BaseAllele :: FullHashNumber () const {
+
+	if (BaseAllele::SearchByName)
+		return AlleleName.FullHashNumber ();
+
+	return Curve;
+}
+
+
 
 Boolean BaseAllele :: IsEqualTo (const RGPersistent* p) const {
 
@@ -282,9 +292,7 @@ BaseLocus :: ~BaseLocus () {
 
 void BaseLocus :: SetTableLink (int linkNumber) {
 
-	RGString temp;
-	temp.Convert (linkNumber, 10);
-	mTableLink = "&" + temp + "&";
+	mTableLink = "&" + SampleResultCache::FormatLinkNumber (linkNumber) + "&";
 }
 
 
@@ -532,6 +540,12 @@ unsigned BaseLocus :: HashNumber (unsigned long Base) const {
 }
 
 
+unsigned long BaseLocus :: FullHashNumber () const {
+
+	return LocusName.FullHashNumber ();
+}
+
+
 
 Boolean BaseLocus :: IsEqualTo (const RGPersistent* p) const {
 
@@ -768,6 +782,12 @@ unsigned BasePopulationMarkerSet :: HashNumber (unsigned long Base) const {
 }
 
 
+unsigned long BasePopulationMarkerSet :: FullHashNumber () const {
+
+	return LCMarkerSetName.FullHashNumber ();
+}
+
+
 Boolean BasePopulationMarkerSet :: IsEqualTo (const RGPersistent* p) const {
 
 	BasePopulationMarkerSet* q = (BasePopulationMarkerSet*) p;
@@ -910,6 +930,12 @@ unsigned BaseLaneStandard :: HashNumber (unsigned long Base) const {
 }
 
 
+unsigned long BaseLaneStandard :: FullHashNumber () const {
+
+	return Name.FullHashNumber ();
+}
+
+
 Boolean BaseLaneStandard :: IsEqualTo (const RGPersistent* p) const {
 
 	BaseLaneStandard* q = (BaseLaneStandard*) p;
@@ -42,6 +42,7 @@
 #include "rgdlist.h"
 #include "SmartMessagingObject.h"
 #include "rgparray.h"
+#include "rgthread.h"
 
 
 class DataSignal;
@@ -88,6 +89,7 @@ public:
 
 	virtual int CompareTo (const RGPersistent* p) const;
 	virtual unsigned HashNumber (unsigned long Base) const;
+	virtual unsigned long FullHashNumber () const;
 	virtual Boolean IsEqualTo (const RGPersistent* p) const;
 
 	virtual void RestoreAll (RGFile&);
@@ -104,7 +106,7 @@ protected:
 	RGString Msg;
 	int mRelativeHeight;
 
-	static Boolean SearchByName;
+	static RGThreadStatic<Boolean> SearchByName;
 };
 
 
@@ -202,6 +204,7 @@ public:
 
 	virtual int CompareTo (const RGPersistent* p) const;
 	virtual unsigned HashNumber (unsigned long Base) const;
+	virtual unsigned long FullHashNumber () const;
 	virtual Boolean IsEqualTo (const RGPersistent* p) const;
 
 	virtual void RestoreAll (RGFile&);
@@ -215,6 +218,7 @@ public:
 
 	virtual Boolean ExtractGridSignalsSM (RGDList& channelSignalList, const LaneStandard* ls, RGDList& locusDataSignalList, ChannelData* lsData, Locus* locus);
 	virtual int GetObjectScope () const { return 5; }
+	virtual bool IsSharedBetweenSamples () const { return true; }
 	virtual void OutputDebugID (SmartMessagingComm& comm, int numHigherObjects);
 	virtual int AddAllSmartMessageReporters ();
 	virtual int AddAllSmartMessageReporters (SmartMessagingComm& comm, int numHigherObjects);
@@ -312,6 +316,7 @@ public:
 
 	virtual int CompareTo (const RGPersistent* p) const;
 	virtual unsigned HashNumber (unsigned long Base) const;
+	virtual unsigned long FullHashNumber () const;
 	virtual Boolean IsEqualTo (const RGPersistent* p) const;
 
 	virtual BaseLocus* GetNewLocus (const RGString& input);
@@ -390,6 +395,7 @@ public:
 
 	virtual int CompareTo (const RGPersistent* p) const;
 	virtual unsigned HashNumber (unsigned long Base) const;
+	virtual unsigned long FullHashNumber () const;
 	virtual Boolean IsEqualTo (const RGPersistent* p) const;
 
 protected:
@@ -68,7 +68,6 @@ int BaseLocus :: AddAllSmartMessageReporters () {
 	int nMsgs = 0;
 	SmartMessageReporter* newMsg;
 	SmartMessage* nextSmartMsg;
-	SmartMessageData target;
 	SmartMessageData* smd;
 
 	for (i=0; i<size; i++) {
@@ -81,8 +80,7 @@ int BaseLocus :: AddAllSmartMessageReporters () {
 		if (!nextSmartMsg->EvaluateReport (mMessageArray))
 			continue;
 
-		target.SetIndex (i);
-		smd = (SmartMessageData*) mMessageDataTable->Find (&target);
+		smd = FindMessageData (i);
 		newMsg = new SmartMessageReporter;
 		newMsg->SetSmartMessage (nextSmartMsg);
 		
@@ -107,7 +105,6 @@ int BaseLocus :: AddAllSmartMessageReporters (SmartMessagingComm& comm, int numH
 	int nMsgs = 0;
 	SmartMessageReporter* newMsg;
 	SmartMessage* nextSmartMsg;
-	SmartMessageData target;
 	SmartMessageData* smd;
 	RGString exportProtocol;
 	bool editable;
@@ -152,8 +149,7 @@ int BaseLocus :: AddAllSmartMessageReporters (SmartMessagingComm& comm, int numH
 		if (!report && !displayExport)
 			continue;
 
-		target.SetIndex (i);
-		smd = (SmartMessageData*) mMessageDataTable->Find (&target);
+		smd = FindMessageData (i);
 		newMsg = new SmartMessageReporter;
 		newMsg->SetSmartMessage (nextSmartMsg);
 		
@@ -206,7 +202,7 @@ Boolean BaseLocus :: ReportSmartNoticeObjects (RGTextOutput& text, const RGStrin
 	if (NumberOfSmartNoticeObjects () > 0) {
 
 		int msgLevel = GetHighestMessageLevelWithRestrictionSM ();
-		RGDListIterator it (*mSmartMessageReporters);
+		RGDListIterator it (GetSmartMessageReporterList ());
 		SmartMessageReporter* nextNotice;
 		text.SetOutputLevel (msgLevel);
 
@@ -239,7 +235,7 @@ Boolean BaseLocus :: ReportSmartNoticeObjects (RGTextOutput& text, const RGStrin
 	if (NumberOfSmartNoticeObjects () > 0) {
 
 		int msgLevel = GetHighestMessageLevelWithRestrictionSM ();
-		RGDListIterator it (*mSmartMessageReporters);
+		RGDListIterator it (GetSmartMessageReporterList ());
 		SmartMessageReporter* nextNotice;
 		text.SetOutputLevel (msgLevel);
 		RGString indent2 = indent + "\t";
@@ -291,7 +287,7 @@ Boolean BaseLocus :: ReportXMLSmartNoticeObjects (RGTextOutput& text, RGTextOutp
 	if (NumberOfSmartNoticeObjects () > 0) {
 
 		int msgLevel = GetHighestMessageLevelWithRestrictionSM ();
-		RGDListIterator it (*mSmartMessageReporters);
+		RGDListIterator it (GetSmartMessageReporterList ());
 		SmartMessageReporter* nextNotice;
 		text.SetOutputLevel (msgLevel);
 		tempText.SetOutputLevel (1);
@@ -347,7 +343,7 @@ Boolean BaseLocus :: ReportXMLSmartNoticeObjectsWithExport (RGTextOutput& text,
 	if (NumberOfSmartNoticeObjects () > 0) {
 
 		int msgLevel = GetHighestMessageLevelWithRestrictionSM ();
-		RGDListIterator it (*mSmartMessageReporters);
+		RGDListIterator it (GetSmartMessageReporterList ());
 		SmartMessageReporter* nextNotice;
 		text.SetOutputLevel (msgLevel);
 		tempText.SetOutputLevel (1);
@@ -0,0 +1,172 @@
+/*
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+*  FileName: BatchAnalysis.cpp
+*  Author:   Robert Goor
+*
+*/
+//
+//  class BatchAnalysis analyzes a batch of run directories concurrently in one process, sharing the kit, message book and
+//  settings loaded by one STRLCAnalysis
+//
+
+#include "BatchAnalysis.h"
+#include "STRLCAnalysis.h"
+#include "AnalysisContext.h"
+#include <iostream>
+
+using namespace std;
+
+
+BatchAnalysisRun :: BatchAnalysisRun (const RGString& inputDirectory, const RGString& reportDirectory, const RGString& commandLine,
+const RGString& commandInputs) : mInputDirectory (inputDirectory), mReportDirectory (reportDirectory), mCommandLine (commandLine),
+mCommandInputs (commandInputs), mStatus (0) {
+
+}
+
+
+BatchAnalysis :: BatchAnalysis (STRLCAnalysis& loaded, const RGString& markerSetName, int outputLevel, bool isLadderFree) :
+mLoaded (loaded), mMarkerSetName (markerSetName), mOutputLevel (outputLevel), mIsLadderFree (isLadderFree), mProgress (NULL),
+mThreadsPerRun (1), mNextRun (0) {
+
+}
+
+
+BatchAnalysis :: ~BatchAnalysis () {
+
+	vector<BatchAnalysisRun*>::iterator it;
+
+	for (it = mRuns.begin (); it != mRuns.end (); it++)
+		delete *it;
+
+	mRuns.clear ();
+}
+
+
+int BatchAnalysis :: AnalyzeAll () {
+
+	vector<BatchAnalysisRun*>::iterator it;
+	BatchAnalysisThread** threads;
+	int nThreads;
+	int i;
+
+	{
+		AnalysisContextScope loadedSettings (mLoaded.GetAnalysisContext ());
+		nThreads = STRLCAnalysis::GetNumberOfAnalysisThreads (NumberOfRuns ());
+		mThreadsPerRun = STRLCAnalysis::GetNumberOfChannelThreads (nThreads);	// the threads left to each of nThreads runs
+	}
+
+	cout << "Analyzing " << NumberOfRuns () << " runs with " << nThreads << " concurrent runs..." << endl;
+	threads = new BatchAnalysisThread* [nThreads];
+
+	for (i=1; i<nThreads; i++) {
+
+		threads [i] = new BatchAnalysisThread (this);
+
+		if (!threads [i]->Start ())
+			cout << "Could not start batch thread " << i << ".  Continuing with fewer threads..." << endl;
+	}
+
+	AnalyzeRuns ();
+
+	for (i=1; i<nThreads; i++)
+		delete threads [i];	// joins thread
+
+	delete[] threads;
+
+	for (it = mRuns.begin (); it != mRuns.end (); it++) {
+
+		if ((*it)->mStatus < 0)
+			return (*it)->mStatus;
+	}
+
+	return 0;
+}
+
+
+void BatchAnalysis :: AnalyzeRuns () {
+
+	BatchAnalysisRun* run;
+
+	while (run = GetNextRun ())
+		run->mStatus = AnalyzeRun (*run);
+}
+
+
+BatchAnalysisRun* BatchAnalysis :: GetNextRun () {
+
+	RGLock lock (mMutex);
+
+	if (mNextRun >= (int) mRuns.size ())
+		return NULL;
+
+	return mRuns [mNextRun++];
+}
+
+
+int BatchAnalysis :: AnalyzeRun (BatchAnalysisRun& run) {
+
+	int status;
+	STRLCAnalysis analysis (mLoaded, run.mReportDirectory);
+	AnalysisContextScope loadedSettings (mLoaded.GetAnalysisContext ());
+	STRLCAnalysis::SetNumberOfAnalysisThreads (mThreadsPerRun);
+	analysis.SetAnalysisContext (AnalysisContext ());
+	analysis.SetXMLCommandLineString (run.mCommandLine);
+	analysis.SetProgress (mProgress);
+	cout << "Analyzing run " << run.mInputDirectory.GetData () << "..." << endl;
+	cout << run.mCommandInputs.GetData ();
+
+	try {
+
+		if (!mIsLadderFree)
+			status = analysis.AnalyzeIncrementallySM (run.mInputDirectory, mMarkerSetName, mOutputLevel, run.mReportDirectory, run.mCommandInputs);
+
+		else
+			status = analysis.AnalyzeIncrementallySMLF (run.mInputDirectory, mMarkerSetName, mOutputLevel, run.mReportDirectory, run.mCommandInputs);
+	}
+
+	catch (...) {
+
+		status = -1170;
+	}
+
+	if (status < 0)
+		cout << "Could not complete analysis of run " << run.mInputDirectory.GetData () << "...status:  " << status << endl;
+
+	else
+		cout << "Analysis of run " << run.mInputDirectory.GetData () << " complete" << endl;
+
+	if (mProgress != NULL)
+		mProgress->ReportRunComplete (run.mInputDirectory, run.mReportDirectory, status);
+
+	return status;
+}
+
+
+void BatchAnalysisThread :: Run () {
+
+	mBatch->AnalyzeRuns ();
+}
+
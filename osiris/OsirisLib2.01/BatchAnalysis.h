@@ -0,0 +1,111 @@
+/*
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+*  FileName: BatchAnalysis.h
+*  Author:   Robert Goor
+*
+*/
+//
+//  class BatchAnalysis analyzes a batch of run directories in one process.  Every run shares the kit, message book and
+//  settings loaded by one STRLCAnalysis, so these are read once for the whole batch.  Runs are analyzed concurrently by up
+//  to STRLCAnalysis::GetNumberOfAnalysisThreads threads, and the analysis threads are divided among the runs being analyzed.
+//  Each run is a BatchAnalysisRun, and its reports are the same as if it had been analyzed by itself.
+//
+
+#ifndef _BATCHANALYSIS_H_
+#define _BATCHANALYSIS_H_
+
+#include "rgstring.h"
+#include "rgthread.h"
+
+#include <vector>
+
+using namespace std;
+
+class STRLCAnalysis;
+class AnalysisProgress;
+
+
+struct BatchAnalysisRun {
+
+	BatchAnalysisRun (const RGString& inputDirectory, const RGString& reportDirectory, const RGString& commandLine, const RGString& commandInputs);
+	~BatchAnalysisRun () {}
+
+	RGString mInputDirectory;
+	RGString mReportDirectory;
+	RGString mCommandLine;	// <argv> lines for the run's reports
+	RGString mCommandInputs;
+	int mStatus;
+};
+
+
+class BatchAnalysis {
+
+public:
+	BatchAnalysis (STRLCAnalysis& loaded, const RGString& markerSetName, int outputLevel, bool isLadderFree);
+	~BatchAnalysis ();
+
+	void Append (BatchAnalysisRun* run) { mRuns.push_back (run); }	// only before AnalyzeAll
+	int NumberOfRuns () const { return (int) mRuns.size (); }
+	BatchAnalysisRun* GetRun (int i) { return mRuns [i]; }	// i from 0
+	void SetProgress (AnalysisProgress* progress) { mProgress = progress; }	// told of every run's progress and completion, from any thread
+
+	int AnalyzeAll ();	// returns 0 or the status of the first run that failed
+	void AnalyzeRuns ();	// analyzes runs until none remain
+
+protected:
+	STRLCAnalysis& mLoaded;
+	RGString mMarkerSetName;
+	int mOutputLevel;
+	bool mIsLadderFree;
+	AnalysisProgress* mProgress;
+	int mThreadsPerRun;
+	vector<BatchAnalysisRun*> mRuns;
+	int mNextRun;
+	RGMutex mMutex;
+
+	BatchAnalysisRun* GetNextRun ();	// NULL when all runs have been handed out
+	int AnalyzeRun (BatchAnalysisRun& run);
+
+private:
+	BatchAnalysis (const BatchAnalysis&);
+	BatchAnalysis& operator= (const BatchAnalysis&);
+};
+
+
+class BatchAnalysisThread : public RGThread {
+
+public:
+	BatchAnalysisThread (BatchAnalysis* batch) : RGThread (), mBatch (batch) {}
+	virtual ~BatchAnalysisThread () { Join (); }
+
+protected:
+	BatchAnalysis* mBatch;
+
+	virtual void Run ();
+};
+
+
+#endif  /*  _BATCHANALYSIS_H_  */
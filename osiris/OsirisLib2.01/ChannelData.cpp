@@ -46,33 +46,34 @@
 #include "SmartMessage.h"
 #include "SmartNotice.h"
 #include "STRSmartNotices.h"
+#include "SampleResultCache.h"
 
 
 ABSTRACT_DEFINITION (ChannelData)
 
-double ChannelData::MinDistanceBetweenPeaks = 1.5;
+RGThreadStatic<double> ChannelData::MinDistanceBetweenPeaks (1.5);
 bool* ChannelData::InitialMatrix = NULL;
-double ChannelData::AveSecondsPerBP = 6.0;
-bool ChannelData::UseFilterForNormalization = false;
-bool ChannelData::DisableStutterFilter = false;
-bool ChannelData::DisableAdenylationFilter = false;
-bool ChannelData::TestForDualSignal = true;
-bool ChannelData::UseILSHistory = false;
-bool ChannelData::UseLadderILSEndPointAlgorithm = false;
-double ChannelData::LatitudeFactorForILSHistory = 0.0;
-double ChannelData::LatitudeFactorForLadderILS = 0.01;
-double ChannelData::BeginAnalysis = -1.0;
-bool ChannelData::UseEnhancedShoulderAlgorithm = false;
+RGThreadStatic<double> ChannelData::AveSecondsPerBP (6.0);
+RGThreadStatic<bool> ChannelData::UseFilterForNormalization (false);
+RGThreadStatic<bool> ChannelData::DisableStutterFilter (false);
+RGThreadStatic<bool> ChannelData::DisableAdenylationFilter (false);
+RGThreadStatic<bool> ChannelData::TestForDualSignal (true);
+RGThreadStatic<bool> ChannelData::UseILSHistory (false);
+RGThreadStatic<bool> ChannelData::UseLadderILSEndPointAlgorithm (false);
+RGThreadStatic<double> ChannelData::LatitudeFactorForILSHistory (0.0);
+RGThreadStatic<double> ChannelData::LatitudeFactorForLadderILS (0.01);
+RGThreadStatic<double> ChannelData::BeginAnalysis (-1.0);
+RGThreadStatic<bool> ChannelData::UseEnhancedShoulderAlgorithm (false);
 
-bool ChannelData::UseNoiseLevelDefaultForFit = true;
-bool ChannelData::UseDetectionLevelForFit = false;
-bool ChannelData::UseNoiseLevelPercentForFit = false;
+RGThreadStatic<bool> ChannelData::UseNoiseLevelDefaultForFit (true);
+RGThreadStatic<bool> ChannelData::UseDetectionLevelForFit (false);
+RGThreadStatic<bool> ChannelData::UseNoiseLevelPercentForFit (false);
 
-double ChannelData::NoisePercentNormalizationPass = 50.0;
-double ChannelData::NoisePercentFinalPass = 75.0;
+RGThreadStatic<double> ChannelData::NoisePercentNormalizationPass (50.0);
+RGThreadStatic<double> ChannelData::NoisePercentFinalPass (75.0);
 
-bool ChannelData::IsNormalizationPass = true;
-double ChannelData::NormalizationSplitTime = -1.0;
+RGThreadStatic<bool> ChannelData::IsNormalizationPass (true);
+RGThreadStatic<double> ChannelData::NormalizationSplitTime (-1.0);
 
 
 bool operator== (const RaisedBaseLineData& first, const RaisedBaseLineData& second) {
@@ -542,16 +543,15 @@ ChannelData :: ~ChannelData () {
 
 void ChannelData :: SetTableLink (int linkNumber) {
 
-	RGString temp;
-	temp.Convert (linkNumber, 10);
-	mTableLink = "&" + temp + "&";
+	mTableLink = "&" + SampleResultCache::FormatLinkNumber (linkNumber) + "&";
 }
 
 
 Locus* ChannelData :: FindLocus (const RGString& locusName) {
 
-	mTargetLocus.SetLocusName (locusName);
-	return (Locus*) mLocusList.Find (&mTargetLocus);
+	Locus targetLocus;	// not a member:  samples analyzed concurrently search the same ladder
+	targetLocus.SetLocusName (locusName);
+	return (Locus*) mLocusList.Find (&targetLocus);
 }
 
 
@@ -38,12 +38,14 @@
 #include "rgpersist.h"
 #include "rgdefs.h"
 #include "rgdlist.h"
+#include "rgordereddlist.h"
 #include "Genetics.h"
 #include "coordtrans.h"
 #include "DataSignal.h"
 #include "Notice.h"
 #include "SmartMessagingObject.h"
 #include "rgtptrdlist.h"
+#include "rgthread.h"
 
 
 class SampleData;
@@ -560,8 +562,8 @@ protected:
 	RGDList PreliminaryCurveList;
 	RGDList FinalCurveList;
 	RGDList MarginalCurveList;
-	RGDList ArtifactList;
-	RGDList CompleteCurveList;
+	RGOrderedDList ArtifactList;
+	RGOrderedDList CompleteCurveList;
 	RGDList SmartPeaks;
 	RGDList BleedThroughCandidateList;
 	RGDList SupplementalArtifacts;
@@ -582,7 +584,6 @@ protected:
 	double* SecondaryContent;
 
 	LaneStandard* mLaneStandard;  // DON'T DELETE!!!
-	Locus mTargetLocus;
 	RGString ErrorString;
 
 	double mBeginAnalysis;
@@ -610,29 +611,29 @@ protected:
 
 	double mMaxLaserInScalePeak;
 
-	static double MinDistanceBetweenPeaks;
+	static RGThreadStatic<double> MinDistanceBetweenPeaks;
 	static bool* InitialMatrix;
-	static double AveSecondsPerBP;
-	static bool UseFilterForNormalization;
-	static bool DisableStutterFilter;
-	static bool DisableAdenylationFilter;
-	static bool TestForDualSignal;
-	static bool UseILSHistory;
-	static bool UseLadderILSEndPointAlgorithm;
-	static double LatitudeFactorForILSHistory;
-	static double LatitudeFactorForLadderILS;
-	static double BeginAnalysis;
-	static bool UseEnhancedShoulderAlgorithm;
-
-	static bool UseNoiseLevelDefaultForFit;
-	static bool UseDetectionLevelForFit;
-	static bool UseNoiseLevelPercentForFit;
-
-	static double NoisePercentNormalizationPass;
-	static double NoisePercentFinalPass;
-
-	static bool IsNormalizationPass;
-	static double NormalizationSplitTime;
+	static RGThreadStatic<double> AveSecondsPerBP;
+	static RGThreadStatic<bool> UseFilterForNormalization;
+	static RGThreadStatic<bool> DisableStutterFilter;
+	static RGThreadStatic<bool> DisableAdenylationFilter;
+	static RGThreadStatic<bool> TestForDualSignal;
+	static RGThreadStatic<bool> UseILSHistory;
+	static RGThreadStatic<bool> UseLadderILSEndPointAlgorithm;
+	static RGThreadStatic<double> LatitudeFactorForILSHistory;
+	static RGThreadStatic<double> LatitudeFactorForLadderILS;
+	static RGThreadStatic<double> BeginAnalysis;
+	static RGThreadStatic<bool> UseEnhancedShoulderAlgorithm;
+
+	static RGThreadStatic<bool> UseNoiseLevelDefaultForFit;
+	static RGThreadStatic<bool> UseDetectionLevelForFit;
+	static RGThreadStatic<bool> UseNoiseLevelPercentForFit;
+
+	static RGThreadStatic<double> NoisePercentNormalizationPass;
+	static RGThreadStatic<double> NoisePercentFinalPass;
+
+	static RGThreadStatic<bool> IsNormalizationPass;
+	static RGThreadStatic<double> NormalizationSplitTime;
 };
 
 
@@ -331,7 +331,7 @@ bool ChannelData :: ReportSmartNoticeObjects (RGTextOutput& text, const RGString
 		if (msgLevel < 0)
 			return false;
 
-		RGDListIterator it (*mSmartMessageReporters);
+		RGDListIterator it (GetSmartMessageReporterList ());
 		SmartMessageReporter* nextNotice;
 		text.SetOutputLevel (msgLevel);
 		RGString indent2 = indent + "\t";
@@ -386,7 +386,6 @@ int ChannelData :: AddAllSmartMessageReporters () {
 	int nMsgs = 0;
 	SmartMessageReporter* newMsg;
 	SmartMessage* nextSmartMsg;
-	SmartMessageData target;
 	SmartMessageData* smd;
 
 	RGDListIterator loci (mLocusList);
@@ -405,8 +404,7 @@ int ChannelData :: AddAllSmartMessageReporters () {
 		if (!nextSmartMsg->EvaluateReport (mMessageArray))
 			continue;
 
-		target.SetIndex (i);
-		smd = (SmartMessageData*) mMessageDataTable->Find (&target);
+		smd = FindMessageData (i);
 		newMsg = new SmartMessageReporter;
 		newMsg->SetSmartMessage (nextSmartMsg);
 		
@@ -449,7 +447,6 @@ int ChannelData :: AddAllSmartMessageReporters (SmartMessagingComm& comm, int nu
 	int nMsgs = 0;
 	SmartMessageReporter* newMsg;
 	SmartMessage* nextSmartMsg;
-	SmartMessageData target;
 	SmartMessageData* smd;
 	bool editable;
 	bool enabled;
@@ -499,8 +496,7 @@ int ChannelData :: AddAllSmartMessageReporters (SmartMessagingComm& comm, int nu
 		if (!report && !displayExport)
 			continue;
 
-		target.SetIndex (i);
-		smd = (SmartMessageData*) mMessageDataTable->Find (&target);
+		smd = FindMessageData (i);
 		newMsg = new SmartMessageReporter;
 		newMsg->SetSmartMessage (nextSmartMsg);
 		
@@ -596,7 +592,7 @@ Boolean ChannelData :: ReportAllSmartNoticeObjects (RGTextOutput& text, const RG
 
 Boolean ChannelData :: ReportXMLSmartNoticeObjects (RGTextOutput& text, RGTextOutput& tempText, const RGString& delim) {
 
-	RGDListIterator it (*mSmartMessageReporters);
+	RGDListIterator it (GetSmartMessageReporterList ());
 	SmartMessageReporter* nextNotice;
 //		text.SetOutputLevel (mHighestMessageLevel);
 //		tempText.SetOutputLevel (1);
@@ -716,7 +712,7 @@ Boolean ChannelData :: ReportXMLILSSmartNoticeObjects (RGTextOutput& text, RGTex
 	if (NumberOfSmartNoticeObjects () > 0) {
 
 		int msgLevel = GetHighestMessageLevelWithRestrictionSM ();
-		RGDListIterator it (*mSmartMessageReporters);
+		RGDListIterator it (GetSmartMessageReporterList ());
 		SmartMessageReporter* nextNotice;
 		text.SetOutputLevel (msgLevel);
 		tempText.SetOutputLevel (1);
@@ -1642,9 +1638,9 @@ bool ChannelData :: TestForArtifactsSM (DataSignal* currentSignal, double fit) {
 	DataSignal* gaussianSignal;
 	DataSignal* justSuperSignal;
 
-	double blobFit;
-	double gaussianFit;
-	double justSuperFit;
+	double blobFit = 0.0;		// not every characteristic found sets its fit
+	double gaussianFit = 0.0;
+	double justSuperFit = 0.0;
 
 	DataSignal* signalArray [3];
 	double fitArray [3];
@@ -0,0 +1,198 @@
+/*
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+*  FileName: ColorCorrectionKernel.cpp
+*  Author:   Robert Goor
+*
+*/
+//
+//  class ColorCorrectionKernel applies a color correction matrix to the raw data of all channels, a block of samples at a time
+//
+
+#include "ColorCorrectionKernel.h"
+#include "GaussianKernels.h"
+
+#if defined (_M_X64) || defined (_M_IX86) || defined (__x86_64__) || defined (__i386__)
+#define _COLORCORRECTIONKERNEL_X86_
+#include <emmintrin.h>
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#define _TARGET_SSE2_
+#define _TARGET_AVX2_
+#else
+#define _TARGET_SSE2_ __attribute__ ((target ("sse2")))
+#define _TARGET_AVX2_ __attribute__ ((target ("avx2")))
+#endif
+#endif
+
+
+//  512 samples of 8 raw channels and one corrected channel fit in a 64K first level cache
+
+static const int BlockSize = 512;
+
+
+void ColorCorrectionKernel :: Apply (const double* matrix, int numChannels, const double* const* raw, double* const* corrected, int numSamples) {
+
+	GaussianKernels::InstructionSet set = GaussianKernels::GetInstructionSet ();
+	int start;
+	int end;
+	int done;
+
+	for (start=0; start<numSamples; start+=BlockSize) {
+
+		end = start + BlockSize;
+
+		if (end > numSamples)
+			end = numSamples;
+
+		if (set == GaussianKernels::AVX2)
+			done = AVX2Block (matrix, numChannels, raw, corrected, start, end);
+
+		else if (set == GaussianKernels::SSE2)
+			done = SSE2Block (matrix, numChannels, raw, corrected, start, end);
+
+		else
+			done = start;
+
+		ScalarBlock (matrix, numChannels, raw, corrected, done, end);
+	}
+}
+
+
+void ColorCorrectionKernel :: ScalarBlock (const double* matrix, int numChannels, const double* const* raw, double* const* corrected, int start, int end) {
+
+	const double* row;
+	double* out;
+	double sum;
+	int i;
+	int j;
+	int k;
+
+	for (i=0; i<numChannels; i++) {
+
+		row = matrix + i * numChannels;
+		out = corrected [i];
+
+		for (k=start; k<end; k++) {
+
+			sum = 0.0;
+
+			for (j=0; j<numChannels; j++)
+				sum += row [j] * raw [j][k];
+
+			out [k] = sum;
+		}
+	}
+}
+
+
+#ifdef _COLORCORRECTIONKERNEL_X86_
+
+_TARGET_SSE2_
+int ColorCorrectionKernel :: SSE2Block (const double* matrix, int numChannels, const double* const* raw, double* const* corrected, int start, int end) {
+
+	//
+	//  Each corrected channel is accumulated over the raw channels in order, two samples per register, and returns the first sample
+	//  left for the scalar block
+	//
+
+	int last = start + 2 * ((end - start) / 2);
+	const double* row;
+	double* out;
+	__m128d coefficient;
+	int i;
+	int j;
+	int k;
+
+	for (i=0; i<numChannels; i++) {
+
+		row = matrix + i * numChannels;
+		out = corrected [i];
+
+		for (k=start; k<last; k+=2)
+			_mm_storeu_pd (out + k, _mm_setzero_pd ());
+
+		for (j=0; j<numChannels; j++) {
+
+			coefficient = _mm_set1_pd (row [j]);
+
+			for (k=start; k<last; k+=2)
+				_mm_storeu_pd (out + k, _mm_add_pd (_mm_loadu_pd (out + k), _mm_mul_pd (coefficient, _mm_loadu_pd (raw [j] + k))));
+		}
+	}
+
+	return last;
+}
+
+
+_TARGET_AVX2_
+int ColorCorrectionKernel :: AVX2Block (const double* matrix, int numChannels, const double* const* raw, double* const* corrected, int start, int end) {
+
+	//  As SSE2Block, four samples per register; multiplies and adds are kept separate so that they round as the scalar evaluation does
+
+	int last = start + 4 * ((end - start) / 4);
+	const double* row;
+	double* out;
+	__m256d coefficient;
+	int i;
+	int j;
+	int k;
+
+	for (i=0; i<numChannels; i++) {
+
+		row = matrix + i * numChannels;
+		out = corrected [i];
+
+		for (k=start; k<last; k+=4)
+			_mm256_storeu_pd (out + k, _mm256_setzero_pd ());
+
+		for (j=0; j<numChannels; j++) {
+
+			coefficient = _mm256_set1_pd (row [j]);
+
+			for (k=start; k<last; k+=4)
+				_mm256_storeu_pd (out + k, _mm256_add_pd (_mm256_loadu_pd (out + k), _mm256_mul_pd (coefficient, _mm256_loadu_pd (raw [j] + k))));
+		}
+	}
+
+	_mm256_zeroupper ();	// otherwise, the SSE instructions that follow wait on the upper halves of the registers
+	return last;
+}
+
+#else
+
+int ColorCorrectionKernel :: SSE2Block (const double* matrix, int numChannels, const double* const* raw, double* const* corrected, int start, int end) {
+
+	return start;
+}
+
+
+int ColorCorrectionKernel :: AVX2Block (const double* matrix, int numChannels, const double* const* raw, double* const* corrected, int start, int end) {
+
+	return start;
+}
+
+#endif
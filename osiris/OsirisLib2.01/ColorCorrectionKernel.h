@@ -0,0 +1,59 @@
+/*
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+*  FileName: ColorCorrectionKernel.h
+*  Author:   Robert Goor
+*
+*/
+//
+//  class ColorCorrectionKernel applies a spectral (color correction) matrix to the raw data of all of the channels of a sample.
+//  The samples are processed in blocks small enough that the raw data of every channel in a block stays in cache while all of
+//  the corrected channels are computed from it, and each block is computed with the instruction set selected for the
+//  GaussianKernels.  Every corrected sample is the sum of the same products, added in the same order, as the scalar evaluation,
+//  so the results do not depend on the instruction set.
+//
+
+#ifndef _COLORCORRECTIONKERNEL_H_
+#define _COLORCORRECTIONKERNEL_H_
+
+
+class ColorCorrectionKernel {
+
+public:
+	//
+	//  corrected [i][k] = sum over j of matrix [i * numChannels + j] * raw [j][k], for 0 <= i, j < numChannels and 0 <= k < numSamples.
+	//  The corrected arrays may not be raw arrays.
+	//
+
+	static void Apply (const double* matrix, int numChannels, const double* const* raw, double* const* corrected, int numSamples);
+
+protected:
+	static void ScalarBlock (const double* matrix, int numChannels, const double* const* raw, double* const* corrected, int start, int end);
+	static int SSE2Block (const double* matrix, int numChannels, const double* const* raw, double* const* corrected, int start, int end);
+	static int AVX2Block (const double* matrix, int numChannels, const double* const* raw, double* const* corrected, int start, int end);
+};
+
+
+#endif  /*  _COLORCORRECTIONKERNEL_H_  */
@@ -49,26 +49,28 @@
 #include "STRSmartNotices.h"
 #include "DirectoryManager.h"
 #include "LeastMedianOfSquares.h"
+#include "SampleResultCache.h"
 
 
-Boolean CoreBioComponent::SearchByName = TRUE;
-Boolean CoreBioComponent::GaussianSignature = TRUE;
-Boolean CoreBioComponent::UseRawData = TRUE;
+RGThreadStatic<Boolean> CoreBioComponent::SearchByName (TRUE);
+RGThreadStatic<Boolean> CoreBioComponent::GaussianSignature (TRUE);
+RGThreadStatic<Boolean> CoreBioComponent::UseRawData (TRUE);
 RGDList CoreBioComponent::testChannelArtifactNoticeList;
-int CoreBioComponent::minBioIDForArtifacts = 0;
-double CoreBioComponent::minBioIDForLadderLoci = -1.0;
+RGThreadStatic<int> CoreBioComponent::minBioIDForArtifacts (0);
+RGThreadStatic<double> CoreBioComponent::minBioIDForLadderLoci (-1.0);
 bool* CoreBioComponent::InitialMatrix = NULL;
-bool* CoreBioComponent::OffScaleData = NULL;
-int CoreBioComponent::OffScaleDataLength = 0;
-double CoreBioComponent::minPrimaryPullupThreshold = 500.0;
+RGThreadStatic<bool*> CoreBioComponent::OffScaleData (NULL);
+RGThreadStatic<int> CoreBioComponent::OffScaleDataLength (0);
+RGThreadStatic<double> CoreBioComponent::minPrimaryPullupThreshold (500.0);
 
-bool CoreBioComponent::UseHermiteTimeTransforms = false;
-bool CoreBioComponent::UseNaturalCubicSplineTimeTransform = true;
+RGThreadStatic<bool> CoreBioComponent::UseHermiteTimeTransforms (false);
+RGThreadStatic<bool> CoreBioComponent::UseNaturalCubicSplineTimeTransform (true);
 RGString CoreBioComponent::ILSDyeName;
 RGString* CoreBioComponent::DyeNames = NULL;
 RGTextOutput* CoreBioComponent::HeightFile = NULL;
-RGTextOutput* CoreBioComponent::NonLaserOffScalePUCoefficients = NULL;
-RGTextOutput* CoreBioComponent::pullUpMatrixFile = NULL;
+RGThreadStatic<RGTextOutput*> CoreBioComponent::NonLaserOffScalePUCoefficients (NULL);
+RGThreadStatic<RGTextOutput*> CoreBioComponent::pullUpMatrixFile (NULL);
+int CoreBioComponent::NumberOfChannelThreads = 1;
 
 
 
@@ -559,9 +561,7 @@ int CoreBioComponent :: GetAllAmbientData (SampleData* data) {
 
 void CoreBioComponent :: SetTableLink (int linkNumber) {
 
-	RGString temp;
-	temp.Convert (linkNumber, 10);
-	mTableLink = "&" + temp + "&";
+	mTableLink = "&" + SampleResultCache::FormatLinkNumber (linkNumber) + "&";
 
 	for (int i=1; i<=mNumberOfChannels; i++)
 		mDataChannels [i]->SetTableLink (linkNumber);
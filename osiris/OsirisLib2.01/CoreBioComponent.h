@@ -38,6 +38,7 @@
 #include "rgdefs.h"
 #include "rgstring.h"
 #include "rgdlist.h"
+#include "rgthread.h"
 
 #include "PackedTime.h"
 #include "PackedDate.h"
@@ -411,6 +412,7 @@ public:
 	virtual int FitAllCharacteristicsSM (RGTextOutput& text, RGTextOutput& ExcelText, OsirisMsg& msg, Boolean print = TRUE);
 	virtual int FitNonLaneStandardCharacteristicsSM (RGTextOutput& text, RGTextOutput& ExcelText, OsirisMsg& msg, Boolean print = TRUE);
 	virtual int FitNonLaneStandardNegativeCharacteristicsSM (RGTextOutput& text, RGTextOutput& ExcelText, OsirisMsg& msg, Boolean print = TRUE);
+	int FitCharacteristicsConcurrentlySM (RGTextOutput& text, RGTextOutput& ExcelText, OsirisMsg& msg, Boolean print, bool includeLaneStandard);
 	virtual int AssignSampleCharacteristicsToLociSM (CoreBioComponent* grid, CoordinateTransform* timeMap);
 	virtual int AssignSampleCharacteristicsToLociSMLF ();
 	virtual int TestForNearlyDuplicateAllelesSMLF ();
@@ -531,6 +533,8 @@ public:
 	static void SetHeightFile (RGTextOutput* hf) { HeightFile = hf; }
 	static void SetNonLaserOffScalePUCoeffsFile (RGTextOutput* puf) { NonLaserOffScalePUCoefficients = puf; }
 	static void SetPullupMatrixFile (RGTextOutput* pumf) { pullUpMatrixFile = pumf; }
+	static void SetNumberOfChannelThreads (int n) { NumberOfChannelThreads = n; }	// threads that fit the channels of each ladder or sample
+	static int GetNumberOfChannelThreads () { return NumberOfChannelThreads; }
 
 	//************************************************************************************************************************************
 
@@ -607,23 +611,24 @@ protected:
 	//************************************************************************************************************************************
 	//************************************************************************************************************************************
 
-	static Boolean SearchByName;
-	static Boolean GaussianSignature;
-	static Boolean UseRawData;
+	static RGThreadStatic<Boolean> SearchByName;
+	static RGThreadStatic<Boolean> GaussianSignature;
+	static RGThreadStatic<Boolean> UseRawData;
 	static RGDList testChannelArtifactNoticeList;
-	static int minBioIDForArtifacts;
-	static double minBioIDForLadderLoci;
+	static RGThreadStatic<int> minBioIDForArtifacts;
+	static RGThreadStatic<double> minBioIDForLadderLoci;
 	static bool* InitialMatrix;
-	static bool* OffScaleData;
-	static int OffScaleDataLength;
-	static double minPrimaryPullupThreshold;
-	static bool UseHermiteTimeTransforms;
-	static bool UseNaturalCubicSplineTimeTransform;
+	static RGThreadStatic<bool*> OffScaleData;
+	static RGThreadStatic<int> OffScaleDataLength;
+	static RGThreadStatic<double> minPrimaryPullupThreshold;
+	static RGThreadStatic<bool> UseHermiteTimeTransforms;
+	static RGThreadStatic<bool> UseNaturalCubicSplineTimeTransform;
 	static RGString ILSDyeName;
 	static RGString* DyeNames;
 	static RGTextOutput* HeightFile;
-	static RGTextOutput* NonLaserOffScalePUCoefficients;
-	static RGTextOutput* pullUpMatrixFile;
+	static RGThreadStatic<RGTextOutput*> NonLaserOffScalePUCoefficients;
+	static RGThreadStatic<RGTextOutput*> pullUpMatrixFile;
+	static int NumberOfChannelThreads;
 
 	static int InitializeOffScaleData (SampleData& sd);
 	static void ReleaseOffScaleData ();
@@ -51,6 +51,8 @@
 #include "TracePrequalification.h"
 #include "DirectoryManager.h"
 #include "LeastMedianOfSquares.h"
+#include "SampleAnalysisQueue.h"
+#include "ColorCorrectionKernel.h"
 
 
 // Smart Message Functions**************************************************************************************************************
@@ -240,7 +242,7 @@ Boolean CoreBioComponent :: ReportSmartNoticeObjects (RGTextOutput& text, const
 	if (NumberOfSmartNoticeObjects () > 0) {
 
 		int msgLevel = GetHighestMessageLevelWithRestrictionSM ();
-		RGDListIterator it (*mSmartMessageReporters);
+		RGDListIterator it (GetSmartMessageReporterList ());
 		SmartMessageReporter* nextNotice;
 		text.SetOutputLevel (msgLevel);
 
@@ -323,7 +325,7 @@ bool CoreBioComponent :: ReportXMLSmartNoticeObjects (RGTextOutput& text, RGText
 	if (NumberOfSmartNoticeObjects () > 0) {
 
 		int msgLevel = GetHighestMessageLevelWithRestrictionSM ();
-		RGDListIterator it (*mSmartMessageReporters);
+		RGDListIterator it (GetSmartMessageReporterList ());
 		SmartMessageReporter* nextNotice;
 		text.SetOutputLevel (msgLevel);
 		tempText.SetOutputLevel (1);
@@ -430,7 +432,6 @@ int CoreBioComponent :: AddAllSmartMessageReporters () {
 	int nMsgs = 0;
 	SmartMessageReporter* newMsg;
 	SmartMessage* nextSmartMsg;
-	SmartMessageData target;
 	SmartMessageData* smd;
 
 	for (i=1; i<=mNumberOfChannels; i++)
@@ -446,8 +447,7 @@ int CoreBioComponent :: AddAllSmartMessageReporters () {
 		if (!nextSmartMsg->EvaluateReport (mMessageArray))
 			continue;
 
-		target.SetIndex (i);
-		smd = (SmartMessageData*) mMessageDataTable->Find (&target);
+		smd = FindMessageData (i);
 		newMsg = new SmartMessageReporter;
 		newMsg->SetSmartMessage (nextSmartMsg);
 		
@@ -484,7 +484,6 @@ int CoreBioComponent :: AddAllSmartMessageReporters (SmartMessagingComm& comm, i
 	int nMsgs = 0;
 	SmartMessageReporter* newMsg;
 	SmartMessage* nextSmartMsg;
-	SmartMessageData target;
 	SmartMessageData* smd;
 	bool editable;
 	bool enabled;
@@ -528,8 +527,7 @@ int CoreBioComponent :: AddAllSmartMessageReporters (SmartMessagingComm& comm, i
 		if (!report && !displayExport)
 			continue;
 
-		target.SetIndex (i);
-		smd = (SmartMessageData*) mMessageDataTable->Find (&target);
+		smd = FindMessageData (i);
 		newMsg = new SmartMessageReporter;
 		newMsg->SetSmartMessage (nextSmartMsg);
 		
@@ -706,7 +704,7 @@ void CoreBioComponent :: ReportXMLSmartGridTableRowWithLinks (RGTextOutput& text
 	int cbcHighestMsgLevel = GetHighestMessageLevelWithRestrictionSM ();
 	bool includesExportInfo = false;
 
-	RGDListIterator it (*mSmartMessageReporters);
+	RGDListIterator it (GetSmartMessageReporterList ());
 	SmartMessageReporter* nextNotice;
 
 	while (nextNotice = (SmartMessageReporter*) it ()) {
@@ -841,7 +839,7 @@ void CoreBioComponent :: ReportXMLSmartSampleTableRowWithLinks (RGTextOutput& te
 //	int channelHighestLevel;
 //	bool channelAlerts = false;
 	int cbcHighestMsgLevel = GetHighestMessageLevelWithRestrictionSM ();
-	RGDListIterator it (*mSmartMessageReporters);
+	RGDListIterator it (GetSmartMessageReporterList ());
 	SmartMessageReporter* nextNotice;
 	bool includesExportInfo = false;
 
@@ -1184,8 +1182,6 @@ int CoreBioComponent :: SetAllRawDataWithMatrixSM (SampleData& fileData, TestCha
 	int numElements;
 	double* matrix = fileData.GetMatrix (numElements);
 	int i;
-	int j;
-	int k;
 	smColorCorrectionMatrixWrongSize matrixWrongSize;
 	smColorCorrectionMatrixExpectedButNotFound matrixNotFound;
 
@@ -1203,20 +1199,34 @@ int CoreBioComponent :: SetAllRawDataWithMatrixSM (SampleData& fileData, TestCha
 		return SetAllRawDataSM (fileData, testControlPeak, testSamplePeak);
 	}
 
-	double* matrixBase = matrix;
 	double** rawChannelData = new double* [mNumberOfChannels + 1];
 	int numDataPoints;
-	double sum;
 
-	for (i=1; i<=mNumberOfChannels; i++) {
+	//
+	//	The raw data of all channels are read together when the file supports it; otherwise, or if a channel is missing, they are
+	//	read one channel at a time, which identifies the missing channels
+	//
 
-		rawChannelData [i] = fileData.GetRawDataForDataChannel (i, numDataPoints);
+	double* allRawData = fileData.GetRawDataForAllDataChannels (mNumberOfChannels, numDataPoints);
 
-		if (rawChannelData [i] == NULL) {
+	if (allRawData != NULL) {
 
-			mDataChannels [i]->SetRawDataFromColorCorrectedArraySM (NULL, numDataPoints, testControlPeak, testSamplePeak);
-			ErrorString << mDataChannels [i]->GetError ();
-			status = -1;
+		for (i=1; i<=mNumberOfChannels; i++)
+			rawChannelData [i] = allRawData + (i - 1) * numDataPoints;
+	}
+
+	else {
+
+		for (i=1; i<=mNumberOfChannels; i++) {
+
+			rawChannelData [i] = fileData.GetRawDataForDataChannel (i, numDataPoints);
+
+			if (rawChannelData [i] == NULL) {
+
+				mDataChannels [i]->SetRawDataFromColorCorrectedArraySM (NULL, numDataPoints, testControlPeak, testSamplePeak);
+				ErrorString << mDataChannels [i]->GetError ();
+				status = -1;
+			}
 		}
 	}
 
@@ -1230,50 +1240,38 @@ int CoreBioComponent :: SetAllRawDataWithMatrixSM (SampleData& fileData, TestCha
 		return status;
 	}
 	
+	//
+	//	The corrected arrays are computed in place for all channels at once and become the data of the channels, which delete them
+	//
+
 	double** correctedChannelData = new double* [mNumberOfChannels + 1];
 
 	for (i=1; i<=mNumberOfChannels; i++)
 		correctedChannelData [i] = new double [numDataPoints];
 
-	for (i=1; i<=mNumberOfChannels; i++) {
-
-		for (k=0; k<numDataPoints; k++){
-
-			sum = 0.0;
+	ColorCorrectionKernel::Apply (matrix, mNumberOfChannels, rawChannelData + 1, correctedChannelData + 1, numDataPoints);
 
-			for (j=1; j<=mNumberOfChannels; j++)
-				sum += (*(matrixBase + j - 1)) * rawChannelData [j][k];
+	if (allRawData != NULL)
+		delete[] allRawData;
 
-			correctedChannelData [i][k] = sum;
-		}
+	else {
 
-		matrixBase += mNumberOfChannels;
+		for (i=1; i<=mNumberOfChannels; i++)
+			delete[] rawChannelData [i];
 	}
 
-	for (i=1; i<=mNumberOfChannels; i++)
-		delete[] rawChannelData [i];
-
 	delete[] rawChannelData;
 	delete[] matrix;
-	double* tempArray;
 
 	for (i=1; i<=mNumberOfChannels; i++) {
 
-		tempArray = new double [numDataPoints];
-
-		for (j=0; j<numDataPoints; j++)
-			tempArray [j] = correctedChannelData [i][j];
-
-		if (mDataChannels [i]->SetRawDataFromColorCorrectedArraySM (tempArray, numDataPoints, testControlPeak, testSamplePeak) < 0) {
+		if (mDataChannels [i]->SetRawDataFromColorCorrectedArraySM (correctedChannelData [i], numDataPoints, testControlPeak, testSamplePeak) < 0) {
 
 			ErrorString << mDataChannels [i]->GetError ();
 			status = -1;
 		}
 	}
 
-	for (i=1; i<=mNumberOfChannels; i++)
-		delete[] correctedChannelData [i];
-
 	delete[] correctedChannelData;
 
 	if (status == 0)
@@ -1289,6 +1287,9 @@ int CoreBioComponent :: FitAllCharacteristicsSM (RGTextOutput& text, RGTextOutpu
 	//  This is sample stage 1
 	//
 
+	if (NumberOfChannelThreads > 1)
+		return FitCharacteristicsConcurrentlySM (text, ExcelText, msg, print, true);
+
 	int status = 0;
 
 	for (int i=1; i<=mNumberOfChannels; i++) {
@@ -1310,6 +1311,9 @@ int CoreBioComponent :: FitNonLaneStandardCharacteristicsSM (RGTextOutput& text,
 	//  This is ladder and sample stage 1
 	//
 
+	if (NumberOfChannelThreads > 1)
+		return FitCharacteristicsConcurrentlySM (text, ExcelText, msg, print, false);
+
 	int status = 0;
 
 	for (int i=1; i<=mNumberOfChannels; i++) {
@@ -1330,6 +1334,47 @@ int CoreBioComponent :: FitNonLaneStandardCharacteristicsSM (RGTextOutput& text,
 }
 
 
+int CoreBioComponent :: FitCharacteristicsConcurrentlySM (RGTextOutput& text, RGTextOutput& ExcelText, OsirisMsg& msg, Boolean print, bool includeLaneStandard) {
+
+	//
+	//  This is ladder and sample stage 1.  The channels are independent until cross channel analysis, so they are fitted
+	//  by up to NumberOfChannelThreads threads, with results identical to those of fitting them in channel order
+	//
+
+	ChannelFitQueue queue (text, ExcelText, msg, print);
+	ChannelFitJob* job;
+	int status = 0;
+	int i;
+
+	for (i=1; i<=mNumberOfChannels; i++) {
+
+		if (includeLaneStandard || (i != mLaneStandardChannel))
+			queue.Append (new ChannelFitJob (i, mDataChannels [i]));
+	}
+
+	if (NumberOfChannelThreads < queue.NumberOfJobs ())
+		queue.FitAll (NumberOfChannelThreads);
+
+	else
+		queue.FitAll (queue.NumberOfJobs ());
+
+	msg.ResetMessage ();
+
+	for (i=0; i<queue.NumberOfJobs (); i++) {
+
+		job = queue.GetJob (i);
+
+		if (job->mStatus < 0) {
+
+			ErrorString << job->mData->GetError ();
+			status = job->mStatus;
+		}
+	}
+
+	return status;
+}
+
+
 int CoreBioComponent :: FitNonLaneStandardNegativeCharacteristicsSM (RGTextOutput& text, RGTextOutput& ExcelText, OsirisMsg& msg, Boolean print) {
 
 	//
@@ -1421,6 +1466,7 @@ int CoreBioComponent :: AnalyzeLaneStandardChannelSM (RGTextOutput& text, RGText
 		DataSignal* firstILS = (DataSignal*)ilsList.First ();
 		mQC.mFirstILSTime = firstILS->GetMean ();
 		mQC.mNumberOfSamples = mDataChannels [mLaneStandardChannel]->GetNumberOfSamples ();
+		ilsList.ClearAndDelete ();	// the copies
 	}
 
 	return status;
@@ -38,6 +38,7 @@
 #include "rgfile.h"
 #include "rgvstream.h"
 #include "rgdefs.h"
+#include "rgarena.h"
 #include <list>
 
 PERSISTENT_DEFINITION(DataInterval, _DATAINTERVAL_, "DataInterval")
@@ -64,6 +65,18 @@ DataInterval :: DataInterval (const DataInterval& di) : RGPersistent (di), Left
 DataInterval :: ~DataInterval () {}
 
 
+void* DataInterval :: operator new (size_t nbytes) {
+
+	return RGArena::Allocate (nbytes);
+}
+
+
+void DataInterval :: operator delete (void* p) {
+
+	RGArena::Free (p);
+}
+
+
 DataInterval* DataInterval :: Split (DataInterval*& secondInterval) const {
 
 	if (mNumberOfMinima == 0) {
@@ -58,6 +58,9 @@ public:
 	DataInterval (const DataInterval& di);
 	virtual ~DataInterval ();
 
+	void* operator new (size_t);
+	void operator delete (void*);
+
 	DataInterval* Split (DataInterval*& secondInterval) const;
 
 	void SetMass (double mass) { Mass = mass; }
@@ -38,6 +38,7 @@
 #include "rgfile.h"
 #include "rgvstream.h"
 #include "rgdefs.h"
+#include "rgarena.h"
 #include "TracePrequalification.h"
 #include "DataInterval.h"
 #include "RGTextOutput.h"
@@ -52,48 +53,52 @@
 #include "SmartMessage.h"
 #include "STRSmartNotices.h"
 #include "OsirisPosix.h"
+#include "GaussianKernels.h"
+#include "TraceFilterPipeline.h"
 #include <cmath>
 #include <limits>
 
 using namespace::std;
 
-double PeakInfoForClusters::HeightFactor = 1.0;
+RGThreadStatic<double> PeakInfoForClusters::HeightFactor (1.0);
 Boolean DataSignal :: DebugFlag = FALSE;
-double DataSignal :: SignalSpacing = 1.0;
-double DataSignal :: minHeight = 150.0;
-double DataSignal :: maxHeight = -1.0;
-unsigned long DataSignal :: signalID = 0;
+RGThreadStatic<double> DataSignal :: SignalSpacing (1.0);
+RGThreadStatic<double> DataSignal :: minHeight (150.0);
+RGThreadStatic<double> DataSignal :: maxHeight (-1.0);
+RGThreadStatic<unsigned long> DataSignal :: signalID (0);
+RGThreadStatic<unsigned long> DataSignal :: signalIDOffset (0);
+RGThreadStatic<set<DataSignal*>*> DataSignal :: CreatedSignals (NULL);
 bool* DataSignal::InitialMatrix = NULL;
-bool DataSignal::ConsiderAllOLAllelesAccepted = false;
-int DataSignal::NumberOfChannels = 0;
-int DataSignal::NumberOfIntervalsForConcaveDownAlgorithm = 3;
+RGThreadStatic<bool> DataSignal::ConsiderAllOLAllelesAccepted (false);
+RGThreadStatic<int> DataSignal::NumberOfChannels (0);
+RGThreadStatic<int> DataSignal::NumberOfIntervalsForConcaveDownAlgorithm (3);
 
 const double two_thirds = 2.0 / 3.0;
 const double sqRoot_two_thirds = sqrt (two_thirds);
 
-double SampledData::PeakFractionForFlatCurveTest = 0.25;
-double SampledData::PeakLevelForFlatCurveTest = 60.0;
-bool SampledData::IgnoreNoiseAnalysisAboveDetectionInSmoothing = false;
-double SampledData::DetectionRFU = 1;
+RGThreadStatic<double> SampledData::PeakFractionForFlatCurveTest (0.25);
+RGThreadStatic<double> SampledData::PeakLevelForFlatCurveTest (60.0);
+RGThreadStatic<bool> SampledData::IgnoreNoiseAnalysisAboveDetectionInSmoothing (false);
+RGThreadStatic<double> SampledData::DetectionRFU (1);
 
-double ParametricCurve::FitTolerance = 0.999995;
-double ParametricCurve::TriggerForArtifactTest = 0.992;
-double ParametricCurve::MinimumFitThreshold = 0.99;
-double ParametricCurve::SigmaForSignature = 2.0;
-double ParametricCurve::AbsoluteMinimumFit = 0.85;
+RGThreadStatic<double> ParametricCurve::FitTolerance (0.999995);
+RGThreadStatic<double> ParametricCurve::TriggerForArtifactTest (0.992);
+RGThreadStatic<double> ParametricCurve::MinimumFitThreshold (0.99);
+RGThreadStatic<double> ParametricCurve::SigmaForSignature (2.0);
+RGThreadStatic<double> ParametricCurve::AbsoluteMinimumFit (0.85);
 
-double Gaussian :: SigmaWidth = 10.0;
-double Gaussian :: SampleSigmaWidth = 3.5;
-int Gaussian :: NumberOfSteps = 50;
+RGThreadStatic<double> Gaussian :: SigmaWidth (10.0);
+RGThreadStatic<double> Gaussian :: SampleSigmaWidth (3.5);
+RGThreadStatic<int> Gaussian :: NumberOfSteps (50);
 
-int NormalizedGaussian::MaximumIterations = 5;
-double NormalizedGaussian::SigmaTolerance = 1.5e-4;
+RGThreadStatic<int> NormalizedGaussian::MaximumIterations (5);
+RGThreadStatic<double> NormalizedGaussian::SigmaTolerance (1.5e-4);
 
-double DoubleGaussian :: DefaultSigmaRatio = 4.5;
-double DoubleGaussian :: DefaultSqrtSigmaRatio = sqrt (DoubleGaussian::DefaultSigmaRatio);
+RGThreadStatic<double> DoubleGaussian :: DefaultSigmaRatio (4.5);
+RGThreadStatic<double> DoubleGaussian :: DefaultSqrtSigmaRatio (sqrt (DoubleGaussian::DefaultSigmaRatio));
 
-int SuperGaussian :: NumberOfSteps = 50;
-double SuperGaussian :: SigmaWidth = 2.1;
+RGThreadStatic<int> SuperGaussian :: NumberOfSteps (50);
+RGThreadStatic<double> SuperGaussian :: SigmaWidth (2.1);
 
 double SuperGaussian :: SuperNorms [8] = {1.785928938266120E+00,
 1.812804952863950E+00,
@@ -125,7 +130,7 @@ double SuperGaussian :: RootTwos [8] = {1.259921049894870E+00,
 1.071773462536290E+00,
 };
 
-int SuperGaussian::BlobDegree = 6;
+RGThreadStatic<int> SuperGaussian::BlobDegree (6);
 
 int MaxIndex (double* array, int N);
 int MinIndex (double* array, int N);
@@ -1122,6 +1127,9 @@ DataSignal :: DataSignal (const DataSignal& ds) : SmartMessagingObject ((SmartMe
 
 		else
 			mThisDataSegment = NULL;
+
+		if (CreatedSignals != NULL)
+			CreatedSignals->insert (this);
 	}
 
 
@@ -1152,12 +1160,18 @@ mPreviousSignal (NULL), mCumulativeStutterThreshold (0.0), mIsShoulderSignal (ds
 
 	else
 		mThisDataSegment = NULL;
+
+	if (CreatedSignals != NULL)
+		CreatedSignals->insert (this);
 }
 
 
 
 DataSignal :: ~DataSignal () {
 
+	if (CreatedSignals != NULL)
+		CreatedSignals->erase (this);
+
 	NoticeList.ClearAndDelete ();
 	NewNoticeList.ClearAndDelete ();
 	mCrossChannelSignalLinks.Clear ();
@@ -1181,6 +1195,18 @@ DataSignal :: ~DataSignal () {
 }
 
 
+void* DataSignal :: operator new (size_t nbytes) {
+
+	return RGArena::Allocate (nbytes);
+}
+
+
+void DataSignal :: operator delete (void* p) {
+
+	RGArena::Free (p);
+}
+
+
 double DataSignal :: LeftTestValue () const {
 
 	return Value (mTestLeftEndPoint);
@@ -1765,11 +1791,11 @@ int DataSignal :: RemoveFromAllLoci () {
 
 void DataSignal :: SetCurrentDataInterval (const DataInterval* di) {
 	
-	if (di != NULL)
-		mThisDataSegment = new DataInterval (*di);
+	if (di != NULL) {
 
-	else
-		di = NULL;
+		delete mThisDataSegment;
+		mThisDataSegment = new DataInterval (*di);
+	}
 }
 
 
@@ -2116,6 +2142,12 @@ DataSignal* DataSignal :: CreateAveragingFilteredSignal (int nPasses, int halfWi
 }
 
 
+DataSignal* DataSignal :: CreateFilteredSignal (TraceFilterPipeline& pipeline) {
+
+	return NULL;
+}
+
+
 void DataSignal :: SetAlleleName (const RGString& name) {
 
 	mAlleleName = name;
@@ -3072,7 +3104,8 @@ void DataSignal :: SaveAll (RGVOutStream& f) const {
 }
 
 
-SampledData :: SampledData () : DataSignal (), NumberOfSamples (0), Measurements (NULL), norm2 (0.0), mDeleteArray (true), mNoiseRange (0.0) {
+SampledData :: SampledData () : DataSignal (), NumberOfSamples (0), Measurements (NULL), norm2 (0.0), mDeleteArray (true), mNoiseRange (0.0),
+mMomentTables (NULL), mMomentSamplesScanned (0) {
 
 	Spacing = DataSignal::GetSampleSpacing ();
 	NoiseThreshold = TracePrequalification::GetNoiseThreshold ();
@@ -3083,7 +3116,8 @@ SampledData :: SampledData () : DataSignal (), NumberOfSamples (0), Measurements
 
 
 SampledData :: SampledData (int numSamples, double left, double right, double* samples, bool deleteArray) : DataSignal (left, right),
-NumberOfSamples (numSamples), Measurements (samples), norm2 (0.0), mDeleteArray (deleteArray), mNoiseRange (0.0) {
+NumberOfSamples (numSamples), Measurements (samples), norm2 (0.0), mDeleteArray (deleteArray), mNoiseRange (0.0), mMomentTables (NULL),
+mMomentSamplesScanned (0) {
 
 	Spacing = DataSignal::GetSampleSpacing ();
 	NoiseThreshold = TracePrequalification::GetNoiseThreshold ();
@@ -3094,7 +3128,7 @@ NumberOfSamples (numSamples), Measurements (samples), norm2 (0.0), mDeleteArray
 
 
 SampledData :: SampledData (const DataSignal& base, const DataSignal& second, double baseCoeff, double left, double right) : DataSignal (left, right),
-norm2 (0.0), mDeleteArray (true), mNoiseRange (0.0) {
+norm2 (0.0), mDeleteArray (true), mNoiseRange (0.0), mMomentTables (NULL), mMomentSamplesScanned (0) {
 
 	Spacing = DataSignal::GetSampleSpacing ();
 	NoiseThreshold = TracePrequalification::GetNoiseThreshold ();
@@ -3116,7 +3150,7 @@ norm2 (0.0), mDeleteArray (true), mNoiseRange (0.0) {
 
 
 SampledData :: SampledData (const SampledData& sd) : DataSignal (sd.Left, sd.Right), NumberOfSamples (sd.NumberOfSamples), norm2 (sd.norm2), 
-mDeleteArray (true), mNoiseRange (sd.mNoiseRange) {
+mDeleteArray (true), mNoiseRange (sd.mNoiseRange), mMomentTables (NULL), mMomentSamplesScanned (0) {
 
 	Spacing = DataSignal::GetSampleSpacing ();
 	NoiseThreshold = TracePrequalification::GetNoiseThreshold ();
@@ -3137,6 +3171,7 @@ SampledData :: ~SampledData () {
 	if (mDeleteArray)
 		delete[] Measurements;
 
+	delete[] mMomentTables;
 	PeakList.ClearAndDelete ();
 	NoiseList.ClearAndDelete ();
 	delete PeakIterator;
@@ -3261,6 +3296,16 @@ void SampledData :: RestrictToMaximum (double MaxValue) {
 		if (Measurements [i] > MaxValue)
 			Measurements [i] = MaxValue;
 	}
+
+	InvalidateMomentTables ();
+}
+
+
+void SampledData :: InvalidateMomentTables () {
+
+	delete[] mMomentTables;
+	mMomentTables = NULL;
+	mMomentSamplesScanned = 0;
 }
 
 
@@ -3327,6 +3372,7 @@ int SampledData :: FindAndRemoveFixedOffset () {
 		for (CurrentPtr=Measurements; CurrentPtr<endPtr; CurrentPtr++)
 			*CurrentPtr -= minB;
 
+		InvalidateMomentTables ();
 		return 0;
 	}
 
@@ -3358,6 +3404,7 @@ int SampledData :: FindAndRemoveFixedOffset () {
 	for (CurrentPtr=Measurements; CurrentPtr<endPtr; CurrentPtr++)
 		*CurrentPtr -= currentAve;
 
+	InvalidateMomentTables ();
 	return 0;
 }
 
@@ -3365,333 +3412,51 @@ int SampledData :: FindAndRemoveFixedOffset () {
 double* SampledData :: CreateMovingAverageFilteredArray (int window, double* inputArray) {
 
 	double* newMeasurements = new double [NumberOfSamples];
-	int i;
-	double temp;
-	double factor;
-	int win = window;
-	int halfWindow;
-
-	if (window > 0) {
-
-		if (win%2 == 0)
-			win++;
-
-		factor = 1.0 / (double)win;
-	}
-
-	else {
-
-		win = 1;
-		factor = 1.0;
-	}
-
-	halfWindow = win / 2;
-	temp = 0.0;
-	double currentAve;
-
-	for (i=0; i<=halfWindow; i++) {
-
-		temp += inputArray [i];
-	}
-
-	currentAve = newMeasurements [0] = temp * factor;
-	double oldValue;
-	double nextValue;
-	int indexNext = halfWindow;
-	int indexOld = -halfWindow - 1;
-
-	for (i=1; i<NumberOfSamples; i++) {
-
-		indexNext++;
-		indexOld++;
-
-		if (indexNext < NumberOfSamples)
-			nextValue = inputArray [indexNext];
-
-		else
-			nextValue = 0.0;
-
-		if (indexOld >= 0)
-			oldValue = inputArray [indexOld];
-
-		else
-			oldValue = 0.0;
-
-		currentAve += factor * (nextValue - oldValue);
-		newMeasurements [i] = currentAve;
-	}
-
-	//for (i=0; i<NumberOfSamples; i++) {
-
-	//	temp = 0.0;
-
-	//	for (j=-halfWindow; j<=halfWindow; j++) {
-
-	//		index = i + j;
-
-	//		if (index < 0)
-	//			continue;
-
-	//		if (index >= NumberOfSamples)
-	//			break;
-
-	//		temp += Measurements [index];
-	//	}
-
-	//	newMeasurements [i] = temp * factor;
-	//}
-
+	TraceFilterPipeline pipeline;
+	pipeline.AppendMovingAverage (window);
+	pipeline.Filter (inputArray, NumberOfSamples, newMeasurements);
 	return newMeasurements;
 }
 
 
-DataSignal* SampledData :: CreateMovingAverageFilteredSignal (int window) {
+DataSignal* SampledData :: CreateFilteredSignal (TraceFilterPipeline& pipeline) {
 
 	double* newMeasurements = new double [NumberOfSamples];
-	int i;
-	double temp;
-	double factor;
-	int win = window;
-	int halfWindow;
-
-	if (window > 0) {
-
-		if (win%2 == 0)
-			win++;
-
-		factor = 1.0 / (double)win;
-	}
-
-	else {
-
-		win = 1;
-		factor = 1.0;
-	}
-
-	halfWindow = win / 2;
-	temp = 0.0;
-	double currentAve;
-
-	for (i=0; i<=halfWindow; i++) {
-
-		temp += Measurements [i];
-	}
-
-	currentAve = newMeasurements [0] = temp * factor;
-	double oldValue;
-	double nextValue;
-	int indexNext = halfWindow;
-	int indexOld = -halfWindow - 1;
-
-	for (i=1; i<NumberOfSamples; i++) {
-
-		indexNext++;
-		indexOld++;
-
-		if (indexNext < NumberOfSamples)
-			nextValue = Measurements [indexNext];
-
-		else
-			nextValue = 0.0;
-
-		if (indexOld >= 0)
-			oldValue = Measurements [indexOld];
-
-		else
-			oldValue = 0.0;
-
-		currentAve += factor * (nextValue - oldValue);
-		newMeasurements [i] = currentAve;
-	}
-
-	//for (i=0; i<NumberOfSamples; i++) {
-
-	//	temp = 0.0;
-
-	//	for (j=-halfWindow; j<=halfWindow; j++) {
-
-	//		index = i + j;
-
-	//		if (index < 0)
-	//			continue;
-
-	//		if (index >= NumberOfSamples)
-	//			break;
+	pipeline.Filter (Measurements, NumberOfSamples, newMeasurements);
+	DataSignal* filteredSignal = new SampledData (NumberOfSamples, Left, Right, newMeasurements, true);
+	return filteredSignal;
+}
 
-	//		temp += Measurements [index];
-	//	}
 
-	//	newMeasurements [i] = temp * factor;
-	//}
+DataSignal* SampledData :: CreateMovingAverageFilteredSignal (int window) {
 
-	DataSignal* filteredSignal = new SampledData (NumberOfSamples, Left, Right, newMeasurements, true);
-	return filteredSignal;
+	TraceFilterPipeline pipeline;
+	pipeline.AppendMovingAverage (window);
+	return CreateFilteredSignal (pipeline);
 }
 
 
 DataSignal* SampledData :: CreateThreeMovingAverageFilteredSignal (int minWindow) {
 
 	//
-	//  First find the three windows assuming input window is minimum.  Then create temporary filter arrays and perform three filterings.  Clean up all but last array and 
-	//  create filtered signal, as above, and return
+	//  The three windows are found assuming input window is minimum, and the three filterings are done in one sweep
 	//
 
-	if (minWindow == 1)
-		return CreateMovingAverageFilteredSignal (minWindow);
-
-	int win3 = minWindow;
-
-	if (win3%2 == 0)
-		win3++;
-
-	double temp = 1.4303 * (double)win3;
-	int high = (int)ceil (temp);
-	int low = (int)floor (temp);
-	int win2, win1;
-
-	if (high%2 == 0) {
-
-		if (low%2 == 0)
-			win2 = low + 1;
-
-		else
-			win2 = low;
-	}
-
-	else
-		win2 = high;
-
-	temp = 1.4303 * (double)win2;
-	high = (int)ceil (temp);
-	low = (int)floor (temp);
-
-	if (high%2 == 0) {
-
-		if (low%2 == 0)
-			win1 = low + 1;
-
-		else
-			win1 = low;
-	}
-
-	else
-		win1 = high;
-
-	//cout << "Filter windows = " << win1 << ", " << win2 << ", and " << win3 << endl;
-
-	double* filterOut1 = CreateMovingAverageFilteredArray (win1, Measurements);
-	double* filterOut2 = CreateMovingAverageFilteredArray (win2, filterOut1);
-	double* filterOut3 = CreateMovingAverageFilteredArray (win3, filterOut2);
-	delete[] filterOut1;
-	delete[] filterOut2;
-
-	DataSignal* filteredSignal = new SampledData (NumberOfSamples, Left, Right, filterOut3, true);
-	return filteredSignal;
+	TraceFilterPipeline pipeline;
+	pipeline.AppendTripleMovingAverage (minWindow);
+	return CreateFilteredSignal (pipeline);
 }
 
 DataSignal* SampledData :: CreateAveragingFilteredSignal (int nPasses, int halfWidth, double noiseLevel, double noiseLevelStart, bool* changeArray, double& fractionOfChangedData, double splitTime) {
 
 	// noiseLevel has already been calibrated by user parameter from lab settings
 
-	double* smoothedData = new double [NumberOfSamples];
-
-	int disp = halfWidth;
-	int startPt = disp;
-	int endPt = NumberOfSamples - disp - 1;
-	int i;
-	int j;
-	double divisor;
-	bool FirstTime = true;
-	double previous = 0.0;
-	int k;
-	FirstTime = true;
-	int timeSplit = (int) floor (splitTime);
-
-	int upperLimit;
-	int lowerLimit;
-	double sum;
-
-	divisor = (double) (2 * halfWidth + 1);
-	lowerLimit = 0;
-
-	for (i=0; i<startPt; i++) {
-
-		upperLimit = i + halfWidth;	
-		sum = 0.0;
-
-		for (j=lowerLimit; j<=upperLimit; j++)
-			sum += Measurements[j];
-
-		smoothedData[i] = sum / divisor;
-	}
-
-	for (i=startPt; i<=endPt; i++) {
-
-		sum = 0.0;
-		upperLimit = i + halfWidth;
-		lowerLimit = i - halfWidth;
-
-		if (FirstTime) {
-
-			FirstTime = false;
+	TraceFilterPipeline pipeline;
+	pipeline.AppendLevelChangeAveraging (halfWidth, noiseLevel, noiseLevelStart, splitTime, changeArray);
+	DataSignal* filteredSignal = CreateFilteredSignal (pipeline);
 
-			for (j=lowerLimit; j<=upperLimit; j++)
-				sum += Measurements [j]; //mData->Value (j);
-
-			previous = sum;
-			smoothedData [i] = sum / divisor;
-		}
-
-		else {
-
-			previous = previous - Measurements [lowerLimit - 1] + Measurements [upperLimit]; //previous - mData->Value (lowerLimit - 1) + mData->Value (upperLimit);
-			smoothedData [i] = previous / divisor;
-		}
-	}
-
-	upperLimit = NumberOfSamples - 1;
-
-	for (i=endPt+1; i<NumberOfSamples; i++) {
-
-		sum = 0.0;
-		lowerLimit = i - halfWidth;
-		
-		for (j=lowerLimit; j<=upperLimit; j++)
-			sum += Measurements[j];
-
-		smoothedData[i] = sum / divisor;
-	}
-
-	k = 0;
-
-	for (i=0; i<=timeSplit; i++) {
-
-		changeArray [i] = false;
-
-		if (fabs (smoothedData [i] - Measurements [i]) > noiseLevelStart) {
-
-			smoothedData [i] = Measurements [i];
-			changeArray [i] = true;
-			k++;
-		}
-	}
-
-	for (i=timeSplit+1; i<NumberOfSamples; i++) {
-
-		changeArray [i] = false;
-
-		if (fabs (smoothedData [i] - Measurements [i]) > noiseLevel) {
-
-			smoothedData [i] = Measurements [i];
-			changeArray [i] = true;
-			k++;
-		}
-	}
-
-	fractionOfChangedData = (double)k / (double)NumberOfSamples;
+	fractionOfChangedData = (double)pipeline.GetNumberOfChangedSamples () / (double)NumberOfSamples;
 	cout << "Fraction of unchanged measurements = " << fractionOfChangedData << "  based on noise threshold = " << noiseLevel << "\n";
-
-	DataSignal* filteredSignal = new SampledData (NumberOfSamples, Left, Right, smoothedData, true);
 	return filteredSignal;
 }
 
@@ -3736,7 +3501,6 @@ void SampledData :: ResetCharacteristicsFromRight (TracePrequalification& trace,
 	NoiseList.ClearAndDelete ();
 	trace.ResetSearch (this, NumberOfSamples, mNoiseRange);
 	DataInterval* NextDataInterval;
-	NoiseInterval* NextNoiseInterval;
 	DataInterval* PreviousDataInterval = NULL;
 	double minFraction = SampledData::GetPeakFractionForFlatCurveTest ();
 	double absMaxTolerance = SampledData::GetPeakLevelForFlatCurveTest ();
@@ -3749,34 +3513,26 @@ void SampledData :: ResetCharacteristicsFromRight (TracePrequalification& trace,
 	double upperLimit;
 	double upperTolerance;
 	double noiseRange = 1.5 * mNoiseRange;
-	int leftTime;
 
-	while (NextDataInterval = trace.GetNextDataIntervalWithPrecomputedConvolution (NextNoiseInterval, text, minRFU, PreviousDataInterval, print)) {
+	//
+	//	The search only uses the left end point of the previous accepted interval, which the reassessment below does not change, so
+	//	all of the intervals are found first and then reassessed in order
+	//
+
+	trace.GetDataIntervals (PeakList, NoiseList, text, minRFU, noiseRange, ignoreNoise, print);
+	RGDListIterator it (PeakList);
+
+	while (NextDataInterval = (DataInterval*) it ()) {
 
 		leftMin = NextDataInterval->GetLeftMinimum ();
 		rightMin = NextDataInterval->GetRightMinimum ();
 		maxAtMode = NextDataInterval->GetMaxAtMode ();
-		NoiseList.Append (NextNoiseInterval);
-		leftTime = NextDataInterval->GetLeft ();
-
-		if ((maxAtMode - leftMin < noiseRange) && (maxAtMode - rightMin < noiseRange)) {
-
-			if (!ignoreNoise || (ignoreNoise && (maxAtMode < minRFU))) {
-
-				delete NextDataInterval;
-				NextDataInterval = NULL;
-				continue;
-			}
-		}
-
 		NextDataInterval->ReassessRelativeMinimaGivenNoise (mNoiseRange, (SampledData*)this);
 
 		//
 		//	Add test for noise correction to relative minima here...********07/01/2014********
 		//
 
-		PeakList.Append (NextDataInterval);
-
 		if (PreviousDataInterval != NULL) {
 
 			if (PreviousDataInterval->HasFixedLeftEndPoint ())
@@ -3808,9 +3564,6 @@ void SampledData :: ResetCharacteristicsFromRight (TracePrequalification& trace,
 	// both of the merged DataIntervals in the PeakList.
 	//
 
-	if (NextNoiseInterval != NULL)
-		NoiseList.Append (NextNoiseInterval);
-
 	norm2 = trace.GetNorm ();
 	PeakIterator->Reset ();
 	NoiseIterator->Reset ();
@@ -4869,7 +4622,13 @@ double SampledData :: Centroid (double left, double right) const {
 	double M2;
 	double M1;
 
-	for (int i=nleft+1; i<nright; i++) {
+	if (UseMomentTables (nleft, nright)) {
+
+		Sum1 = MomentTableSum (Squares, nleft, nright);
+		Sum2 = MomentTableSum (SquaresTimesN, nleft, nright);
+	}
+
+	else for (int i=nleft+1; i<nright; i++) {
 
 		M2 = Measurements [i];
 		M2 *= M2;
@@ -4914,7 +4673,14 @@ double SampledData :: SecondMoment (double left, double right) const {
 	double M1;
 	double M2;
 
-	for (int i=nleft+1; i<nright; i++) {
+	if (UseMomentTables (nleft, nright)) {
+
+		Sum2 = MomentTableSum (Squares, nleft, nright);
+		Sum1 = Sum2 * Left * Left + 2.0 * Spacing * Left * MomentTableSum (SquaresTimesN, nleft, nright) +
+			Spacing * Spacing * MomentTableSum (SquaresTimesN2, nleft, nright);
+	}
+
+	else for (int i=nleft+1; i<nright; i++) {
 
 		M2 = Measurements [i];
 		M1 = M2 * (Left + i * Spacing);
@@ -5018,6 +4784,7 @@ int SampledData :: TruncateToResolution (double resolution) {
 	for (int i=0; i<NumberOfSamples; i++)
 		Measurements [i] = resolution * floor (r * Measurements [i]);
 
+	InvalidateMomentTables ();
 	return 0;
 }
 
@@ -5141,7 +4908,10 @@ double SampledData :: Norm2 (double left, double right) {
 	double M2;
 	double M1;
 
-	for (int i=nleft+1; i<nright; i++) {
+	if (UseMomentTables (nleft, nright))
+		Sum1 = MomentTableSum (Squares, nleft, nright);
+
+	else for (int i=nleft+1; i<nright; i++) {
 
 		M2 = Measurements [i];
 		M2 *= M2;
@@ -5233,7 +5003,10 @@ double SampledData :: OneNorm (double left, double right) {
 	double M2;
 	double M1;
 
-	for (int i=nleft+1; i<nright; i++) {
+	if (UseMomentTables (nleft, nright))
+		Sum = MomentTableSum (AbsoluteValues, nleft, nright);
+
+	else for (int i=nleft+1; i<nright; i++) {
 
 		M1 = fabs (Measurements [i]);
 		Sum += M1;
@@ -5277,7 +5050,13 @@ int SampledData :: FirstMomentForOneNorm (double left, double right, double& one
 	double M2;
 	double M1;
 
-	for (int i=nleft+1; i<nright; i++) {
+	if (UseMomentTables (nleft, nright)) {
+
+		Sum1 = MomentTableSum (AbsoluteValues, nleft, nright);
+		Sum2 = MomentTableSum (AbsoluteValuesTimesN, nleft, nright);
+	}
+
+	else for (int i=nleft+1; i<nright; i++) {
 
 		M1 = fabs (Measurements [i]);
 		Sum1 += M1;  // this is for oneNorm
@@ -5342,7 +5121,14 @@ int SampledData :: SecondMomentForOneNorm (double left, double right, double& on
 	double M2;
 	double M3;
 
-	for (int i=nleft+1; i<nright; i++) {
+	if (UseMomentTables (nleft, nright)) {
+
+		Sum1 = MomentTableSum (AbsoluteValues, nleft, nright);
+		Sum2 = MomentTableSum (AbsoluteValuesTimesN, nleft, nright);
+		Sum3 = MomentTableSum (AbsoluteValuesTimesN2, nleft, nright);
+	}
+
+	else for (int i=nleft+1; i<nright; i++) {
 
 		M1 = fabs (Measurements [i]);
 		M2 = M1 * i;
@@ -5415,7 +5201,13 @@ int SampledData :: FirstMoment (double left, double right, double& twoNorm2, dou
 	double M2;
 	double M1;
 
-	for (int i=nleft+1; i<nright; i++) {
+	if (UseMomentTables (nleft, nright)) {
+
+		Sum1 = MomentTableSum (Squares, nleft, nright);
+		Sum2 = MomentTableSum (SquaresTimesN, nleft, nright);
+	}
+
+	else for (int i=nleft+1; i<nright; i++) {
 
 		M1 = Measurements [i];
 		M1 *= M1;
@@ -5480,7 +5272,14 @@ int SampledData :: SecondMoment (double left, double right, double& twoNorm2, do
 	double M2;
 	double M3;
 
-	for (int i=nleft+1; i<nright; i++) {
+	if (UseMomentTables (nleft, nright)) {
+
+		Sum1 = MomentTableSum (Squares, nleft, nright);
+		Sum2 = MomentTableSum (SquaresTimesN, nleft, nright);
+		Sum3 = MomentTableSum (SquaresTimesN2, nleft, nright);
+	}
+
+	else for (int i=nleft+1; i<nright; i++) {
 
 		M1 = Measurements [i];
 		M1 *= M1;
@@ -5543,6 +5342,7 @@ void SampledData :: RestoreAll (RGFile& f) {
 	Measurements = new double [NumberOfSamples];
 	f.Read (Measurements, (size_t)NumberOfSamples);
 	f.Read (Spacing);
+	InvalidateMomentTables ();
 }
 
 
@@ -5554,6 +5354,7 @@ void SampledData :: RestoreAll (RGVInStream& f) {
 	Measurements = new double [NumberOfSamples];
 	f.Get (Measurements, (size_t)NumberOfSamples);
 	f >> Spacing;
+	InvalidateMomentTables ();
 }
 
 
@@ -5601,7 +5402,10 @@ double SampledData :: GetNorm2 (int nleft, int nright) {
 	double M2;
 	double M1;
 
-	for (int i=nleft+1; i<nright; i++) {
+	if (UseMomentTables (nleft, nright))
+		Sum1 = MomentTableSum (Squares, nleft, nright);
+
+	else for (int i=nleft+1; i<nright; i++) {
 
 		M2 = Measurements [i];
 		M2 *= M2;
@@ -5619,6 +5423,95 @@ double SampledData :: GetNorm2 (int nleft, int nright) {
 }
 
 
+bool SampledData :: UseMomentTables (int nleft, int nright) const {
+
+	//
+	//  The tables take about as long to build as a scan of all of the samples, so they are built only after the windows scanned
+	//  add up to that many samples.  Signals whose moments are found only a few times are never given tables.
+	//
+
+	if ((nleft < 0) || (nright >= NumberOfSamples))
+		return false;
+
+	if (mMomentTables != NULL)
+		return true;
+
+	mMomentSamplesScanned += nright - nleft;
+
+	if (mMomentSamplesScanned < NumberOfSamples)
+		return false;
+
+	BuildMomentTables ();
+	return true;
+}
+
+
+void SampledData :: BuildMomentTables () const {
+
+	//
+	//  Each table is a pair of arrays of NumberOfSamples + 1 cumulative sums, the sums and their compensations, accumulated with
+	//  Neumaier's summation.  A window sum is the difference of two cumulative sums, so its rounding error is relative to the
+	//  sums, which can be much larger than the window sum, unless the compensations are subtracted too.
+	//
+
+	int n = NumberOfSamples + 1;
+	mMomentTables = new double [2 * NumberOfMomentTables * n];
+	double sums [NumberOfMomentTables];
+	double compensations [NumberOfMomentTables];
+	double terms [NumberOfMomentTables];
+	double* sumTable;
+	double* compensationTable;
+	double sum;
+	double M1;
+	int i;
+	int k;
+
+	for (k=0; k<NumberOfMomentTables; k++) {
+
+		sums [k] = compensations [k] = 0.0;
+		mMomentTables [2 * k * n] = mMomentTables [(2 * k + 1) * n] = 0.0;
+	}
+
+	for (i=0; i<NumberOfSamples; i++) {
+
+		M1 = Measurements [i];
+		M1 *= M1;
+		terms [Squares] = M1;
+		terms [SquaresTimesN] = M1 * i;
+		terms [SquaresTimesN2] = terms [SquaresTimesN] * i;
+		M1 = fabs (Measurements [i]);
+		terms [AbsoluteValues] = M1;
+		terms [AbsoluteValuesTimesN] = M1 * i;
+		terms [AbsoluteValuesTimesN2] = terms [AbsoluteValuesTimesN] * i;
+
+		for (k=0; k<NumberOfMomentTables; k++) {
+
+			sum = sums [k] + terms [k];
+
+			if (fabs (sums [k]) >= fabs (terms [k]))
+				compensations [k] += (sums [k] - sum) + terms [k];
+
+			else
+				compensations [k] += (terms [k] - sum) + sums [k];
+
+			sums [k] = sum;
+			sumTable = mMomentTables + 2 * k * n;
+			compensationTable = sumTable + n;
+			sumTable [i + 1] = sum;
+			compensationTable [i + 1] = compensations [k];
+		}
+	}
+}
+
+
+double SampledData :: MomentTableSum (MomentTable table, int nleft, int nright) const {
+
+	const double* sumTable = mMomentTables + 2 * (int)table * (NumberOfSamples + 1);
+	const double* compensationTable = sumTable + NumberOfSamples + 1;
+	return (sumTable [nright] - sumTable [nleft + 1]) + (compensationTable [nright] - compensationTable [nleft + 1]);
+}
+
+
 double SampledData :: FindApproximateIntersection (DataSignal* prevSignal, DataSignal* nextSignal) {
 
 	double h1 = prevSignal->Peak ();
@@ -6683,15 +6576,18 @@ int windowSize, double& fit, RGDList& previous) const {
 	double sampleMean;
 	double sampleTwoMoment;
 	
-	if (Target->SecondMoment (left, right, sampleTwoNorm2, sampleMean, sampleTwoMoment) != 0)
+	// When no previous curves overlap the interval, Overlapped is Target, and its moments need only be found once
+
+	if ((Overlapped != Target) && (Target->SecondMoment (left, right, sampleTwoNorm2, sampleMean, sampleTwoMoment) != 0)) {
+
+		delete Overlapped;
 		return NULL;
+	}
 	
 	if (Overlapped->SecondMoment (left, right, sampleTwoNorm2, sampleMean, sampleTwoMoment) != 0) {
 		
-		if (Overlapped != Target) {
+		if (Overlapped != Target)
 			delete Overlapped;
-			Overlapped = BuildOverlappedSignal (left, right, previous, Target);
-		}
 
 		return NULL;
 	}
@@ -6734,10 +6630,8 @@ int windowSize, double& fit, RGDList& previous) const {
 
 	if (Overlapped->SecondMoment (left, right, sampleTwoNorm2, sampleMean, sampleTwoMoment) != 0) {
 		
-		if (Overlapped != Target) {
+		if (Overlapped != Target)
 			delete Overlapped;
-			Overlapped = BuildOverlappedSignal (left, right, previous, Target);
-		}
 		
 		return NULL;
 	}
@@ -7292,48 +7186,17 @@ double NormalizedGaussian :: InnerProductWithOffsetAndStandardDeviation (double
 	//  should not have to be evaluated many times - use Brent's method or some other involving iterative 
 	//  inverse parabolic interpolation.
 	//
-	//  Note:  double* target should be midpoint of array!!!
+	//  Note:  double* target should be midpoint of array!!!  The samples are symmetric about the midpoint.
 	//
 	
-	const double* ptargetPlus = info.DataCenter;
-	const double* ptargetPlusEnd = info.DataRight;
-	const double* ptargetMinus = ptargetPlus;
-	double sampleSpacing = info.Spacing;
-	double center = info.AbscissaLeft + info.IndexCenter * sampleSpacing;
-	double x = (center - offset) / sigma;
-	x *= 0.5 * x;
-	double sum = exp (-x) * (*ptargetPlus);
-//	int size = sampleSize - 1;
-	int j = 0;
-	double refRight;
-	double refLeft;
-	double y;
-	double temp;
+	int halfWidth = (int) (info.DataRight - info.DataCenter);
 
-	for (ptargetPlus=info.DataCenter+1; ptargetPlus<ptargetPlusEnd; ptargetPlus++) {
-
-		j++;
-		ptargetMinus--;
-		temp = j * sampleSpacing;
-		refRight = center + temp;
-		refLeft = center - temp;
-		x = (refRight - offset) / sigma;
-		y = (refLeft - offset) / sigma;
-		x *= 0.5 * x;
-		y *= 0.5 * y;
-		sum += (*ptargetPlus) * exp (-x) + (*ptargetMinus) * exp (-y);
-	}
+	if (halfWidth < 1)
+		halfWidth = 1;
 
-	j++;
-	ptargetMinus--;
-	temp = j * sampleSpacing;
-	refRight = center + temp;
-	refLeft = center - temp;
-	x = (refRight - offset) / sigma;
-	y = (refLeft - offset) / sigma;
-	x *= 0.5 * x;
-	y *= 0.5 * y;
-	sum += 0.5 * ((*ptargetPlus) * exp (-x) + (*ptargetMinus) * exp (-y));
+	double sampleSpacing = info.Spacing;
+	double center = info.AbscissaLeft + info.IndexCenter * sampleSpacing;
+	double sum = GaussianKernels::DataSum (info.DataCenter - halfWidth, 2 * halfWidth, center - halfWidth * sampleSpacing, sampleSpacing, offset, sigma);
 
 	sum *= sampleSpacing / (sqrt (sqrtPi * sigma));
 	return sum;
@@ -7342,33 +7205,14 @@ double NormalizedGaussian :: InnerProductWithOffsetAndStandardDeviation (double
 
 double NormalizedGaussian :: AsymmetricInnerProductWithOffsetAndStandardDeviation (double offset, double sigma, double* coeffs, const SampleDataInfo& info) const {
 
-	const double* ptargetPlus = info.DataLeft;
-	const double* ptargetPlusEnd = info.DataRight;
-	double sampleSpacing = info.Spacing;
-	double left = info.AbscissaLeft + info.Spacing * info.IndexLeft;
-	double x = (left - offset) / sigma;
-	x *= 0.5 * x;
-	double sum = 0.5 * exp (-x) * (*ptargetPlus);
-	int j = 0;
-	double temp;
-	double ref;
+	int n = (int) (info.DataRight - info.DataLeft);
 
-	for (ptargetPlus=info.DataLeft+1; ptargetPlus<ptargetPlusEnd; ptargetPlus++) {
+	if (n < 1)
+		n = 1;
 
-		j++;
-		temp = j * sampleSpacing;
-		ref = left + temp;
-		x = (ref - offset) / sigma;
-		x *= 0.5 * x;
-		sum += (*ptargetPlus) * exp (-x);
-	}
-
-	j++;
-	temp = j * sampleSpacing;
-	ref = left + temp;
-	x = (ref - offset) / sigma;
-	x *= 0.5 * x;
-	sum += 0.5 * (*ptargetPlus) * exp (-x);
+	double sampleSpacing = info.Spacing;
+	double left = info.AbscissaLeft + info.Spacing * info.IndexLeft;
+	double sum = GaussianKernels::DataSum (info.DataLeft, n, left, sampleSpacing, offset, sigma);
 
 	sum *= sampleSpacing / (sqrt (sqrtPi * sigma));  // this is inner product of sample with first Gaussian
 	*coeffs = sum / (sqrt (sqrtPi * sigma));  // This coefficient must be scaled by the sample two norm
@@ -7798,10 +7642,8 @@ int windowSize, double& fit, RGDList& previous) const {
 	
 	if (Overlapped->SecondMoment (left, right, sampleTwoNorm2, sampleMean, sampleTwoMoment) != 0) {
 		
-		if (Overlapped != Target) {
+		if (Overlapped != Target)
 			delete Overlapped;
-			Overlapped = BuildOverlappedSignal (left, right, previous, Target);
-		}
 
 		return NULL;
 	}
@@ -7854,10 +7696,8 @@ int windowSize, double& fit, RGDList& previous) const {
 
 	if (Overlapped->SecondMoment (left, right, sampleTwoNorm2, sampleMean, sampleTwoMoment) != 0) {
 		
-		if (Overlapped != Target) {
+		if (Overlapped != Target)
 			delete Overlapped;
-			Overlapped = BuildOverlappedSignal (left, right, previous, Target);
-		}
 		
 		return NULL;
 	}
@@ -8792,78 +8632,23 @@ double DoubleGaussian :: InnerProductWithOffsetAndStandardDeviation (double offs
 	double sigma2 = SigmaRatio * sigma;
 	double SigmaCorrection = 1.0 / (SigmaRatio * SigmaRatio);
 
-	const double* ptargetPlus = info.DataCenter;
-	const double* ptargetPlusEnd = info.DataRight;
-	const double* ptargetMinus = ptargetPlus;
-	double sampleSpacing = info.Spacing;
-	double center = info.AbscissaLeft + info.IndexCenter * sampleSpacing;
-	double x = (center - offset) / sigma;
-	double z;
-	x *= 0.5 * x;
-	z = x * SigmaCorrection;
-	double tempx, tempy;
-	tempx = exp (-x);
-	double sum = tempx * (*ptargetPlus);
-	double tempz, tempw;
-	tempz = exp (-z);
-	double sum2 = tempz * (*ptargetPlus);
-	double sum3 = tempz * tempz;
-
-	double sumv1 = tempx * tempx;
-	double sumv1v2 = tempx * tempz;
-
-//	int size = sampleSize - 1;
-	int j = 0;
-	double refRight;
-	double refLeft;
-	double y;
-	double w;
-	double temp;
+	int halfWidth = (int) (info.DataRight - info.DataCenter);	// the samples are symmetric about the center
 
-	for (ptargetPlus=info.DataCenter+1; ptargetPlus<ptargetPlusEnd; ptargetPlus++) {
+	if (halfWidth < 1)
+		halfWidth = 1;
 
-		j++;
-		ptargetMinus--;
-		temp = j * sampleSpacing;
-		refRight = center + temp;
-		refLeft = center - temp;
-		x = (refRight - offset) / sigma;
-		y = (refLeft - offset) / sigma;
-		x *= 0.5 * x;
-		y *= 0.5 * y;
-		w = x * SigmaCorrection;
-		z = y * SigmaCorrection;
-		tempw = exp (-w);
-		tempz = exp (-z);
-		tempx = exp (-x);
-		tempy = exp (-y);
-		sum += (*ptargetPlus) * tempx + (*ptargetMinus) * tempy;
-		sum2 += (*ptargetPlus) * tempw + (*ptargetMinus) * tempz;
-		sum3 += tempz * tempz + tempw * tempw;
-		sumv1 += tempx * tempx + tempy * tempy;
-		sumv1v2 += tempx * tempw + tempy * tempz;
-	}
+	double sampleSpacing = info.Spacing;
+	double center = info.AbscissaLeft + info.IndexCenter * sampleSpacing;
+	GaussianSums sums;
+	GaussianKernels::DoubleGaussianSums (info.DataCenter - halfWidth, 2 * halfWidth, center - halfWidth * sampleSpacing, sampleSpacing, offset, sigma,
+		SigmaCorrection, sums);
 
-	j++;
-	ptargetMinus--;
-	temp = j * sampleSpacing;
-	refRight = center + temp;
-	refLeft = center - temp;
-	x = (refRight - offset) / sigma;
-	y = (refLeft - offset) / sigma;
-	x *= 0.5 * x;
-	y *= 0.5 * y;
-	w = x * SigmaCorrection;
-	z = y * SigmaCorrection;
-	tempw = exp (-w);
-	tempz = exp (-z);
-	tempx = exp (-x);
-	tempy = exp (-y);
-	sum += 0.5 * ((*ptargetPlus) * tempx + (*ptargetMinus) * tempy);
-	sum2 += 0.5 * ((*ptargetPlus) * tempw + (*ptargetMinus) * tempz);
-	sum3 += 0.5 * (tempz * tempz + tempw * tempw);
-	sumv1 += 0.5 * (tempx * tempx + tempy * tempy);
-	sumv1v2 += 0.5 * (tempx * tempw + tempy * tempz);
+	double sum = sums.mDataPrimary;
+	double sum2 = sums.mDataSecondary;
+	double sum3 = sums.mSecondaryNorm2;
+	double sumv1 = sums.mPrimaryNorm2;
+	double sumv1v2 = sums.mPrimarySecondary;
+	double tempz;
 
 	sum *= sampleSpacing / (sqrt (sqrtPi * sigma));  // this is inner product of sample with first Gaussian
 	sum2 *= sampleSpacing / (sqrt (sqrtPi * sigma2));  // this is inner product of (projected) sample with (projected) second Gaussian
@@ -8939,59 +8724,22 @@ double DoubleGaussian :: AsymmetricInnerProductWithOffsetAndStandardDeviation (d
 	double sigma2 = SigmaRatio * sigma;
 	double SigmaCorrection = 1.0 / (SigmaRatio * SigmaRatio);
 
-	const double* ptargetPlus = info.DataLeft;
-	const double* ptargetPlusEnd = info.DataRight;
+	int n = (int) (info.DataRight - info.DataLeft);
+
+	if (n < 1)
+		n = 1;
+
 	double sampleSpacing = info.Spacing;
 	double left = info.AbscissaLeft + info.Spacing * info.IndexLeft;
-	double x = (left - offset) / sigma;
-	x *= 0.5 * x;
-	double w;
-	w = x * SigmaCorrection;
-	double tempx;
-	tempx = exp (-x);
-	double sum = 0.5 * tempx * (*ptargetPlus);
+	GaussianSums sums;
+	GaussianKernels::DoubleGaussianSums (info.DataLeft, n, left, sampleSpacing, offset, sigma, SigmaCorrection, sums);
+
+	double sum = sums.mDataPrimary;
+	double sum2 = sums.mDataSecondary;
+	double sum3 = sums.mSecondaryNorm2;
+	double sumv1 = sums.mPrimaryNorm2;
+	double sumv1v2 = sums.mPrimarySecondary;
 	double tempw;
-	tempw = exp (-w);
-	double sum2 = 0.5 * tempw * (*ptargetPlus);
-	double sum3 = 0.5 * tempw * tempw;
-
-	double sumv1 = 0.5 * tempx * tempx;
-	double sumv1v2 = 0.5 * tempx * tempw;
-
-	int j = 0;
-	double temp;
-	double ref;
-
-	for (ptargetPlus=info.DataLeft+1; ptargetPlus<ptargetPlusEnd; ptargetPlus++) {
-
-		j++;
-		temp = j * sampleSpacing;
-		ref = left + temp;
-		x = (ref - offset) / sigma;
-		x *= 0.5 * x;
-		w = x * SigmaCorrection;
-		tempw = exp (-w);
-		tempx = exp (-x);
-		sum += (*ptargetPlus) * tempx;
-		sum2 += (*ptargetPlus) * tempw;
-		sum3 += tempw * tempw;
-		sumv1 += tempx * tempx;
-		sumv1v2 += tempx * tempw;
-	}
-
-	j++;
-	temp = j * sampleSpacing;
-	ref = left + temp;
-	x = (ref - offset) / sigma;
-	x *= 0.5 * x;
-	w = x * SigmaCorrection;
-	tempw = exp (-w);
-	tempx = exp (-x);
-	sum += 0.5 * (*ptargetPlus) * tempx;
-	sum2 += 0.5 * (*ptargetPlus) * tempw;
-	sum3 += 0.5 * (tempw * tempw);
-	sumv1 += 0.5 * (tempx * tempx);
-	sumv1v2 += 0.5 * (tempx * tempw);
 
 	sum *= sampleSpacing / (sqrt (sqrtPi * sigma));  // this is inner product of sample with first Gaussian
 	sum2 *= sampleSpacing / (sqrt (sqrtPi * sigma2));  // this is inner product of (projected) sample with (projected) second Gaussian
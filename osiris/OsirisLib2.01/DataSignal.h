@@ -37,6 +37,7 @@
 
 #include "rgpersist.h"
 #include "rgdlist.h"
+#include "rgthread.h"
 #include "Notice.h"
 #include "SmartNotice.h"
 #include "SmartMessagingObject.h"
@@ -93,6 +94,7 @@ class NoiseInterval;
 class RGTextOutput;
 class RGString;
 class SpecialLinearRegression;
+class TraceFilterPipeline;
 class CoordinateTransform;
 class Locus;
 class RGHashTable;
@@ -284,7 +286,7 @@ protected:
 	bool mChosen;
 	bool mProcessed;
 
-	static double HeightFactor;
+	static RGThreadStatic<double> HeightFactor;
 };
 
 
@@ -326,6 +328,9 @@ public:
 		DataSignal::signalID++;
 		mSignalID = DataSignal::signalID;
 		InitializeSmartMessages ();
+
+		if (CreatedSignals != NULL)
+			CreatedSignals->insert (this);
 	}
 
 	DataSignal (double left, double right) : SmartMessagingObject (), Left (left), Right (right), LeftSearch (left), 
@@ -344,6 +349,9 @@ public:
 		DataSignal::signalID++;
 		mSignalID = DataSignal::signalID;
 		InitializeSmartMessages ();
+
+		if (CreatedSignals != NULL)
+			CreatedSignals->insert (this);
 	}
 
 
@@ -352,6 +360,9 @@ public:
 	DataSignal (const DataSignal& ds, CoordinateTransform* trans);
 	virtual ~DataSignal () = 0;
 
+	void* operator new (size_t);	// from the RGArena of the sample being analyzed, if any
+	void operator delete (void*);
+
 	// Not message-related**********************************************************************************************************************************************************
 
 	virtual DataSignal* MakeCopy (double mean) const { return NULL; }
@@ -359,7 +370,7 @@ public:
 	virtual DataSignal* GetPreviousLinkedSignal () { return NULL; }
 	virtual DataSignal* GetNextLinkedSignal () { return NULL; }
 
-	unsigned long GetSignalID () const { return mSignalID; }
+	unsigned long GetSignalID () const { return mSignalID + signalIDOffset; }
 
 	void MarkForDeletion (bool mark) { markForDeletion = mark; }
 	bool GetMarkForDeletion () const { return markForDeletion; }
@@ -596,6 +607,12 @@ public:
 	static void SetAllOLAllelesAccepted (bool b) { ConsiderAllOLAllelesAccepted = b; }
 	static bool GetAllOLAllelesAccepted () { return ConsiderAllOLAllelesAccepted; } 
 
+	static unsigned long GetSignalIDCount () { return signalID; }
+	static void SetSignalIDCount (unsigned long count) { signalID = count; }
+	static void SetSignalIDOffset (unsigned long offset) { signalIDOffset = offset; }	// added to reported ids of samples analyzed concurrently
+	static void SetCreatedSignals (set<DataSignal*>* created) { CreatedSignals = created; }	// signals the calling thread constructs are kept in created until deleted
+	void OffsetSignalID (unsigned long count, unsigned long offset) { if (mSignalID > count) mSignalID += offset; }	// only ids assigned after count are offset
+
 	virtual RGString GetSignalType () const;
 
 	virtual void SetPullupRatio (int channel, double ratio, int nChannels);
@@ -624,6 +641,7 @@ public:
 	virtual DataSignal* CreateMovingAverageFilteredSignal (int window);
 	virtual DataSignal* CreateThreeMovingAverageFilteredSignal (int window);
 	virtual DataSignal* CreateAveragingFilteredSignal (int nPasses, int halfWidth, double noiseLevel, double noiseLevelStart, bool* changeArray, double& fractionOfChangedData, double splitTime);
+	virtual DataSignal* CreateFilteredSignal (TraceFilterPipeline& pipeline);
 	virtual double GetPullupToleranceInBP () const { return (mPullupTolerance + (2.0 * sin (0.5 * acos (Fit)) / 4.47)); }  // The trig expression corrects for poor fit - this is proportional to Hilbert Space distance 07/22/2014;
 	                                                                                                                       // with a proportionality coefficient of 1 / 4.47, so that a fit of 0.999 has a correction of 0.01 (changed from 1/10 07/23/2014)
 	virtual double GetPullupToleranceInBP (double noise) const { return (mPullupTolerance + (2.0 * sin (0.5 * acos (Fit)) / 4.47)); }  // see above
@@ -1024,15 +1042,17 @@ protected:
 	bool mCouldBePullup;
 	bool mHasReportedArtifacts;
 
-	static double SignalSpacing;
+	static RGThreadStatic<double> SignalSpacing;
 	static Boolean DebugFlag;
-	static double minHeight;
-	static double maxHeight;
-	static unsigned long signalID;
+	static RGThreadStatic<double> minHeight;
+	static RGThreadStatic<double> maxHeight;
+	static RGThreadStatic<unsigned long> signalID;
+	static RGThreadStatic<unsigned long> signalIDOffset;
+	static RGThreadStatic<set<DataSignal*>*> CreatedSignals;
 	static bool* InitialMatrix;
-	static bool ConsiderAllOLAllelesAccepted;
-	static int NumberOfChannels;
-	static int NumberOfIntervalsForConcaveDownAlgorithm;
+	static RGThreadStatic<bool> ConsiderAllOLAllelesAccepted;
+	static RGThreadStatic<int> NumberOfChannels;
+	static RGThreadStatic<int> NumberOfIntervalsForConcaveDownAlgorithm;
 
 	// Smart Message functions*******************************************************************************
 	//*******************************************************************************************************
@@ -1067,12 +1087,14 @@ public:
 	virtual const double* GetData () const;
 	virtual int GetNumberOfSamples () const;
 	virtual void RestrictToMaximum (double MaxValue);
+	void InvalidateMomentTables ();	// must be called after the array returned by GetData is modified
 
 	virtual int FindAndRemoveFixedOffset ();
 	double* CreateMovingAverageFilteredArray (int window, double* inputArray);
 	virtual DataSignal* CreateMovingAverageFilteredSignal (int window);
 	virtual DataSignal* CreateThreeMovingAverageFilteredSignal (int minWindow);
 	virtual DataSignal* CreateAveragingFilteredSignal (int nPasses, int halfWidth, double noiseLevel, double noiseLevelStart, bool* changeArray, double& fractionOfChangedData, double splitTime);
+	virtual DataSignal* CreateFilteredSignal (TraceFilterPipeline& pipeline);
 
 	virtual DataSignal* Project (double left, double right) const;
 	virtual DataSignal* Project (const DataSignal* target) const;
@@ -1178,14 +1200,30 @@ protected:
 	bool mDeleteArray;
 	double mNoiseRange;
 
-	static double PeakFractionForFlatCurveTest;
-	static double PeakLevelForFlatCurveTest;
-	static bool IgnoreNoiseAnalysisAboveDetectionInSmoothing;
-	static double DetectionRFU;
+	//
+	//  The moment tables hold, for each sum of MomentTable, the cumulative sums of the samples before each sample number, so that
+	//  the window sums of the moment functions do not need to scan the window.  They are built when the window scans have cost as
+	//  much as building them.
+	//
+
+	enum MomentTable { Squares, SquaresTimesN, SquaresTimesN2, AbsoluteValues, AbsoluteValuesTimesN, AbsoluteValuesTimesN2,
+		NumberOfMomentTables };
+
+	mutable double* mMomentTables;
+	mutable int mMomentSamplesScanned;
+
+	static RGThreadStatic<double> PeakFractionForFlatCurveTest;
+	static RGThreadStatic<double> PeakLevelForFlatCurveTest;
+	static RGThreadStatic<bool> IgnoreNoiseAnalysisAboveDetectionInSmoothing;
+	static RGThreadStatic<double> DetectionRFU;
 
 	int GetSampleNumber (double abscissa) const;
 	double GetNorm2 (int nleft, int nright);
 	double FindApproximateIntersection (DataSignal* prevSignal, DataSignal* nextSignal);
+
+	bool UseMomentTables (int nleft, int nright) const;
+	void BuildMomentTables () const;
+	double MomentTableSum (MomentTable table, int nleft, int nright) const;	// sum for nleft < i < nright
 };
 
 
@@ -1243,6 +1281,7 @@ public:
 	virtual DataSignal* Digitize (int numSamples, double left, double resolution);
 	virtual DataSignal* BuildSample (int numSamples, double left, double resolution);
 	virtual const DataSignal* BuildOverlappedSignal (double left, double right, RGDList& previous, const DataSignal* target) const;
+		// returns target itself, without copying, since previous curves are not subtracted; delete the result only if it is not target
 
 //	virtual int SampleAndSave () { return -1; }
 //	virtual double InnerProductWithOffset (double offset, double* coeffs, const SampleDataInfo& info) const { return -DOUBLEMAX; }
@@ -1270,12 +1309,12 @@ protected:
 	double Displacement;
 	double Scale;
 	RGString mWouldBeAlleleName;
-	static double FitTolerance;
+	static RGThreadStatic<double> FitTolerance;
 
-	static double TriggerForArtifactTest;
-	static double MinimumFitThreshold;
-	static double SigmaForSignature;
-	static double AbsoluteMinimumFit;
+	static RGThreadStatic<double> TriggerForArtifactTest;
+	static RGThreadStatic<double> MinimumFitThreshold;
+	static RGThreadStatic<double> SigmaForSignature;
+	static RGThreadStatic<double> AbsoluteMinimumFit;
 
 	double TruncateWithResolution (double value, double resolution);
 };
@@ -1355,9 +1394,9 @@ protected:
 	double Mean;
 	double StandardDeviation;
 
-	static int NumberOfSteps;
-	static double SigmaWidth;
-	static double SampleSigmaWidth;
+	static RGThreadStatic<int> NumberOfSteps;
+	static RGThreadStatic<double> SigmaWidth;
+	static RGThreadStatic<double> SampleSigmaWidth;
 };
 
 
@@ -1419,8 +1458,8 @@ public:
 protected:
 	double SampleSpacing;
 
-	static double SigmaTolerance;
-	static int MaximumIterations;
+	static RGThreadStatic<double> SigmaTolerance;
+	static RGThreadStatic<int> MaximumIterations;
 };
 
 
@@ -1532,8 +1571,8 @@ protected:
 	double Mean;
 	double StandardDeviation;
 
-	static double DefaultSigmaRatio;
-	static double DefaultSqrtSigmaRatio;
+	static RGThreadStatic<double> DefaultSigmaRatio;
+	static RGThreadStatic<double> DefaultSqrtSigmaRatio;
 };
 
 
@@ -1619,12 +1658,12 @@ protected:
 	double Sigma1;
 	double SuperSigma2;
 
-	static int NumberOfSteps;
-	static double SigmaWidth;
+	static RGThreadStatic<int> NumberOfSteps;
+	static RGThreadStatic<double> SigmaWidth;
 	static double SuperNorms [8];
 	static double SuperSigma2s [8];
 	static double RootTwos [8];
-	static int BlobDegree;
+	static RGThreadStatic<int> BlobDegree;
 
 	double UnscaledValue (double x) const;
 };
@@ -580,7 +580,11 @@ void DataSignal :: SetMessageValue (int scope, int location, bool value) {
 	if (myScope == scope) {
 
 		SmartMessage* msg = SmartMessage::GetSmartMessageForScopeAndElement (scope, location);
-		msg->SetMessageValue (mMessageArray, mValueArray, location, value);
+		bool previous = mMessageArray [location];
+		msg->SetMessageValue (mMessageArray, GetValueArray (msg), location, value);
+
+		if (mMessageArray [location] != previous)
+			NoteMessageChange (scope, location);
 
 		if (value) {
 
@@ -600,6 +604,10 @@ void DataSignal :: SetMessageValue (const SmartNotice& notice, bool value) {
 	if (notice.GetScope () == scope) {
 
 		int index = notice.GetMessageIndex ();
+
+		if (mMessageArray [index] != value)
+			NoteMessageChange (scope, index);
+
 		mMessageArray [index] = value;
 
 		if (value) {
@@ -621,6 +629,9 @@ void DataSignal :: SetMessageValue (int scope, int location, bool value, bool us
 
 	else if (scope == GetObjectScope ()) {
 
+		if (mMessageArray [location] != value)
+			NoteMessageChange (scope, location);
+
 		mMessageArray [location] = value;
 
 		if (value) {
@@ -1160,7 +1171,7 @@ void DataSignal :: WriteSmartArtifactInfoToXML (RGTextOutput& text, const RGStri
 
 		virtualAllele = GetVirtualAlleleName ();
 
-		RGDListIterator it (*mSmartMessageReporters);
+		RGDListIterator it (GetSmartMessageReporterList ());
 		i = 0;
 
 		while (notice = (SmartMessageReporter*) it ()) {
@@ -1310,7 +1321,7 @@ void DataSignal :: WriteSmartTableArtifactInfoToXML (RGTextOutput& text, RGTextO
 		if (!mAllowPeakEdit)
 			text << indent << "\t<AllowPeakEdit>false</AllowPeakEdit>" << endLine;
 		
-		RGDListIterator it (*mSmartMessageReporters);
+		RGDListIterator it (GetSmartMessageReporterList ());
 		i = 0;
 
 		while (notice = (SmartMessageReporter*) it ()) {
@@ -1504,7 +1515,7 @@ bool DataSignal :: ReportSmartNoticeObjects (RGTextOutput& text, const RGString&
 	if (NumberOfSmartNoticeObjects () > 0) {
 
 		int msgLevel = GetHighestMessageLevelWithRestrictionSM ();
-		RGDListIterator it (*mSmartMessageReporters);
+		RGDListIterator it (GetSmartMessageReporterList ());
 		SmartMessageReporter* nextNotice;
 		text.SetOutputLevel (msgLevel);
 
@@ -1541,7 +1552,6 @@ int DataSignal :: AddAllSmartMessageReporters () {
 	int nMsgs = 0;
 	SmartMessageReporter* newMsg;
 	SmartMessage* nextSmartMsg;
-	SmartMessageData target;
 	SmartMessageData* smd;
 	bool call;
 
@@ -1559,8 +1569,7 @@ int DataSignal :: AddAllSmartMessageReporters () {
 		if (!nextSmartMsg->EvaluateReport (mMessageArray))
 			continue;
 
-		target.SetIndex (i);
-		smd = (SmartMessageData*) mMessageDataTable->Find (&target);
+		smd = FindMessageData (i);
 		newMsg = new SmartMessageReporter;
 		newMsg->SetSmartMessage (nextSmartMsg);
 		
@@ -1591,7 +1600,6 @@ int DataSignal :: AddAllSmartMessageReporters (SmartMessagingComm& comm, int num
 	int nMsgs = 0;
 	SmartMessageReporter* newMsg;
 	SmartMessage* nextSmartMsg;
-	SmartMessageData target;
 	SmartMessageData* smd;
 	bool call;
 	RGString exportProtocol;
@@ -1645,8 +1653,7 @@ int DataSignal :: AddAllSmartMessageReporters (SmartMessagingComm& comm, int num
 		if (!report && !displayExport)
 			continue;
 
-		target.SetIndex (i);
-		smd = (SmartMessageData*) mMessageDataTable->Find (&target);
+		smd = FindMessageData (i);
 		newMsg = new SmartMessageReporter;
 		newMsg->SetSmartMessage (nextSmartMsg);
 		
@@ -2170,7 +2177,6 @@ double DataSignal::GetPullupCorrectionFromPrimariesWithNoPullupSM (int numberOfC
 RGString DataSignal :: GetDataForNoticeSM (SmartNotice& sn) {
 
 	RGString str;
-	SmartMessageData target;
 	SmartMessageData* smd;
 
 	int k = sn.GetScope ();
@@ -2180,8 +2186,7 @@ RGString DataSignal :: GetDataForNoticeSM (SmartNotice& sn) {
 
 	int i = sn.GetMessageIndex ();
 
-	target.SetIndex (i);
-	smd = (SmartMessageData*) mMessageDataTable->Find (&target);
+	smd = FindMessageData (i);
 
 	if (smd != NULL) {
 
@@ -120,6 +120,15 @@ bool Expression :: EvaluateLocal (const bool* msgArray) const {
 }
 
 
+bool Expression :: AppendToProgram (ExpressionProgram& program) const {
+
+	//  matches EvaluateLocal and Evaluate (comm, numHigherObjects), which are always false here
+
+	program.AppendConstant (false);
+	return true;
+}
+
+
 
 size_t Expression :: StoreSize () const {
   
@@ -455,6 +464,19 @@ bool And :: EvaluateLocal (const bool* msgArray) const {
 }
 
 
+bool And :: AppendToProgram (ExpressionProgram& program) const {
+
+	if ((mOperand1 == NULL) || (mOperand2 == NULL))
+		return false;
+
+	if (!mOperand1->AppendToProgram (program) || !mOperand2->AppendToProgram (program))
+		return false;
+
+	program.AppendOperator (ExpressionProgram::AndOperation);
+	return true;
+}
+
+
 void And :: Print (const RGString& indent) {
 
 	cout << indent.GetData () << "And expression with subexpressions:" << endl;
@@ -515,6 +537,19 @@ bool Or :: EvaluateLocal (const bool* msgArray) const {
 }
 
 
+bool Or :: AppendToProgram (ExpressionProgram& program) const {
+
+	if ((mOperand1 == NULL) || (mOperand2 == NULL))
+		return false;
+
+	if (!mOperand1->AppendToProgram (program) || !mOperand2->AppendToProgram (program))
+		return false;
+
+	program.AppendOperator (ExpressionProgram::OrOperation);
+	return true;
+}
+
+
 void Or :: Print (const RGString& indent) {
 
 	cout << indent.GetData () << "Or expression with subexpressions:" << endl;
@@ -771,6 +806,16 @@ bool Not :: EvaluateLocal (const bool* msgArray) const {
 }
 
 
+bool Not :: AppendToProgram (ExpressionProgram& program) const {
+
+	if ((mOperand == NULL) || !mOperand->AppendToProgram (program))
+		return false;
+
+	program.AppendOperator (ExpressionProgram::NotOperation);
+	return true;
+}
+
+
 void Not :: Print (const RGString& indent) {
 
 	cout << indent.GetData () << "Not expression with subexpression:" << endl;
@@ -1321,6 +1366,19 @@ bool ExclusiveOr :: EvaluateLocal (const bool* msgArray) const {
 }
 
 
+bool ExclusiveOr :: AppendToProgram (ExpressionProgram& program) const {
+
+	if ((mOperand1 == NULL) || (mOperand2 == NULL))
+		return false;
+
+	if (!mOperand1->AppendToProgram (program) || !mOperand2->AppendToProgram (program))
+		return false;
+
+	program.AppendOperator (ExpressionProgram::ExclusiveOrOperation);
+	return true;
+}
+
+
 void ExclusiveOr :: Print (const RGString& indent) {
 
 	cout << indent.GetData () << "Exclusive Or expression with subexpressions:" << endl;
@@ -1413,6 +1471,16 @@ bool SingleMessage :: EvaluateLocal (const bool* msgArray) const {
 }
 
 
+bool SingleMessage :: AppendToProgram (ExpressionProgram& program) const {
+
+	if ((mIndex < 0) || (mScope < 0) || (mScope >= _EXPRESSIONPROGRAMSCOPES_))
+		return false;
+
+	program.AppendMessage (mIndex, mScope);
+	return true;
+}
+
+
 void SingleMessage :: Print (const RGString& indent) {
 
 	cout << indent.GetData () << "Single Message expression with name:  " << mName.GetData () << endl;
@@ -1815,6 +1883,13 @@ bool ConstantExpr :: EvaluateLocal (const bool* msgArray) const {
 }
 
 
+bool ConstantExpr :: AppendToProgram (ExpressionProgram& program) const {
+
+	program.AppendConstant (mValue);
+	return true;
+}
+
+
 void ConstantExpr :: Print (const RGString& indent) {
 
 	cout << indent.GetData () << "Constant expression with value:  ";
@@ -1891,3 +1966,230 @@ void ConstantExpr :: SaveAll (RGVOutStream& s) const {
 }
 
 
+
+ExpressionProgram :: ExpressionProgram (const Expression* ex) : mExpression (ex), mFirst (NULL), mLength (0), mDepth (0),
+mMaxDepth (0), mCompiled (false), mUsesMessages (false) {
+
+	if (ex == NULL)
+		return;
+
+	if (!ex->AppendToProgram (*this))
+		return;
+
+	if ((mDepth != 1) || (mMaxDepth > _EXPRESSIONPROGRAMSTACKSIZE_))
+		return;
+
+	mLength = (int) mInstructions.size ();
+	mFirst = &mInstructions [0];
+	mCompiled = true;
+}
+
+
+ExpressionProgram :: ~ExpressionProgram () {
+
+}
+
+
+bool ExpressionProgram :: EvaluateLocal (const bool* msgArray) const {
+
+	if (!mCompiled)
+		return mExpression->EvaluateLocal (msgArray);
+
+	//  Operands are 0 or 1, so the logical operators reduce to bitwise ones and no operand is skipped; the tree evaluation
+	//  short circuits, but its operands have no side effects
+
+	unsigned char stack [_EXPRESSIONPROGRAMSTACKSIZE_];
+	int top = -1;
+	const ExpressionInstruction* next = mFirst;
+	const ExpressionInstruction* last = mFirst + mLength;
+
+	for (; next<last; next++) {
+
+		switch (next->mOperation) {
+
+			case PushFalse:
+				stack [++top] = 0;
+				break;
+
+			case PushTrue:
+				stack [++top] = 1;
+				break;
+
+			case PushMessage:
+				stack [++top] = msgArray [next->mIndex] ? 1 : 0;
+				break;
+
+			case AndOperation:
+				top--;
+				stack [top] &= stack [top + 1];
+				break;
+
+			case OrOperation:
+				top--;
+				stack [top] |= stack [top + 1];
+				break;
+
+			case ExclusiveOrOperation:
+				top--;
+				stack [top] ^= stack [top + 1];
+				break;
+
+			case NotOperation:
+				stack [top] ^= 1;
+				break;
+		}
+	}
+
+	return (stack [0] != 0);
+}
+
+
+bool ExpressionProgram :: Evaluate (SmartMessagingComm& comm, int numHigherObjects) const {
+
+	if (!mCompiled)
+		return mExpression->Evaluate (comm, numHigherObjects);
+
+	//  A message is read from the highest object on the stack with the message's scope, as in SingleMessage::Evaluate, so
+	//  the message arrays are looked up once per scope rather than once per message
+
+	const bool* messageArrays [_EXPRESSIONPROGRAMSCOPES_];
+	int i;
+
+	if (mUsesMessages) {
+
+		for (i=0; i<_EXPRESSIONPROGRAMSCOPES_; i++)
+			messageArrays [i] = NULL;
+
+		for (i=0; i<numHigherObjects; i++) {
+
+			SmartMessagingObject* smo = comm.SMOStack [i];
+			int scope = smo->GetObjectScope ();
+
+			if ((scope >= 0) && (scope < _EXPRESSIONPROGRAMSCOPES_))
+				messageArrays [scope] = smo->GetMessageArray ();
+		}
+	}
+
+	unsigned char stack [_EXPRESSIONPROGRAMSTACKSIZE_];
+	int top = -1;
+	const ExpressionInstruction* next = mFirst;
+	const ExpressionInstruction* last = mFirst + mLength;
+	const bool* msgArray;
+
+	for (; next<last; next++) {
+
+		switch (next->mOperation) {
+
+			case PushFalse:
+				stack [++top] = 0;
+				break;
+
+			case PushTrue:
+				stack [++top] = 1;
+				break;
+
+			case PushMessage:
+				msgArray = messageArrays [next->mScope];
+				stack [++top] = ((msgArray != NULL) && msgArray [next->mIndex]) ? 1 : 0;
+				break;
+
+			case AndOperation:
+				top--;
+				stack [top] &= stack [top + 1];
+				break;
+
+			case OrOperation:
+				top--;
+				stack [top] |= stack [top + 1];
+				break;
+
+			case ExclusiveOrOperation:
+				top--;
+				stack [top] ^= stack [top + 1];
+				break;
+
+			case NotOperation:
+				stack [top] ^= 1;
+				break;
+		}
+	}
+
+	return (stack [0] != 0);
+}
+
+
+void ExpressionProgram :: AppendConstant (bool value) {
+
+	ExpressionInstruction instruction;
+	instruction.mOperation = value ? PushTrue : PushFalse;
+	instruction.mIndex = -1;
+	instruction.mScope = -1;
+	mInstructions.push_back (instruction);
+	mDepth++;
+
+	if (mDepth > mMaxDepth)
+		mMaxDepth = mDepth;
+}
+
+
+void ExpressionProgram :: AppendMessage (int index, int scope) {
+
+	ExpressionInstruction instruction;
+	instruction.mOperation = PushMessage;
+	instruction.mIndex = index;
+	instruction.mScope = scope;
+	mInstructions.push_back (instruction);
+	mUsesMessages = true;
+	mDepth++;
+
+	if (mDepth > mMaxDepth)
+		mMaxDepth = mDepth;
+}
+
+
+void ExpressionProgram :: AppendOperator (int operation) {
+
+	//  Operators on constant operands are folded, so that, for example, a criterion of "true" costs a single push
+
+	int n = (int) mInstructions.size ();
+	ExpressionInstruction instruction;
+	instruction.mOperation = operation;
+	instruction.mIndex = -1;
+	instruction.mScope = -1;
+
+	if (operation == NotOperation) {
+
+		if ((n >= 1) && (mInstructions [n-1].mOperation <= PushTrue)) {
+
+			mInstructions [n-1].mOperation = (mInstructions [n-1].mOperation == PushTrue) ? PushFalse : PushTrue;
+			return;
+		}
+
+		mInstructions.push_back (instruction);
+		return;
+	}
+
+	mDepth--;
+
+	if ((n >= 2) && (mInstructions [n-1].mOperation <= PushTrue) && (mInstructions [n-2].mOperation <= PushTrue)) {
+
+		bool left = (mInstructions [n-2].mOperation == PushTrue);
+		bool right = (mInstructions [n-1].mOperation == PushTrue);
+		bool result;
+
+		if (operation == AndOperation)
+			result = left && right;
+
+		else if (operation == OrOperation)
+			result = left || right;
+
+		else
+			result = (left != right);
+
+		mInstructions.pop_back ();
+		mInstructions [n-2].mOperation = result ? PushTrue : PushFalse;
+		return;
+	}
+
+	mInstructions.push_back (instruction);
+}
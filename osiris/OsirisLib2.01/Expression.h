@@ -44,6 +44,8 @@
 
 #include "SmartMessage.h"
 
+#include <vector>
+
 //#include <iostream>
 
 //using namespace std;
@@ -71,6 +73,9 @@ const int _ANY_           =		2017;
 const int _ALL_           =		2018;
 const int _CONSTANTEXPR_  =		2019;
 
+const int _EXPRESSIONPROGRAMSTACKSIZE_ = 64;
+const int _EXPRESSIONPROGRAMSCOPES_ = 8;
+
 
 //typedef void (*ppmf)();
 PERSISTENT_PREDECLARATION (Expression)
@@ -92,6 +97,9 @@ PERSISTENT_PREDECLARATION (AllExpr)
 PERSISTENT_PREDECLARATION (ConstantExpr)
 
 
+class ExpressionProgram;
+
+
 class ExpressionCleanUp {
 
 public:
@@ -115,6 +123,7 @@ public:
 	virtual bool Evaluate (const bool* msgArray, RGDList& subObjects) const;
 	virtual bool Evaluate (SmartMessagingComm& comm, int numHigherObjects) const;
 	virtual bool EvaluateLocal (const bool* msgArray) const;
+	virtual bool AppendToProgram (ExpressionProgram& program) const;
 
 	virtual void Print (const RGString& indent) {}
 	  
@@ -204,6 +213,7 @@ public:
 	virtual bool Evaluate (const bool* msgArray, RGDList& subObjects) const;
 	virtual bool Evaluate (SmartMessagingComm& comm, int numHigherObjects) const;
 	virtual bool EvaluateLocal (const bool* msgArray) const;
+	virtual bool AppendToProgram (ExpressionProgram& program) const;
 	virtual void Print (const RGString& indent);
 
 protected:
@@ -226,6 +236,7 @@ public:
 	virtual bool Evaluate (SmartMessagingComm& comm, int numHigherObjects) const;
 	virtual void Print (const RGString& indent);
 	virtual bool EvaluateLocal (const bool* msgArray) const;
+	virtual bool AppendToProgram (ExpressionProgram& program) const;
 
 protected:
 
@@ -288,6 +299,7 @@ public:
 	virtual bool Evaluate (const bool* msgArray, RGDList& subObjects) const;
 	virtual bool Evaluate (SmartMessagingComm& comm, int numHigherObjects) const;
 	virtual bool EvaluateLocal (const bool* msgArray) const;
+	virtual bool AppendToProgram (ExpressionProgram& program) const;
 	virtual void Print (const RGString& indent);
 
 protected:
@@ -439,6 +451,7 @@ public:
   virtual bool Evaluate (const bool* msgArray, RGDList& subObjects) const;
   virtual bool Evaluate (SmartMessagingComm& comm, int numHigherObjects) const;
   virtual bool EvaluateLocal (const bool* msgArray) const;
+  virtual bool AppendToProgram (ExpressionProgram& program) const;
   virtual void Print (const RGString& indent);
 
 protected:
@@ -461,6 +474,7 @@ public:
 	virtual bool Evaluate (const bool* msgArray, RGDList& subObjects) const;
 	virtual bool Evaluate (SmartMessagingComm& comm, int numHigherObjects) const;
 	virtual bool EvaluateLocal (const bool* msgArray) const;
+	virtual bool AppendToProgram (ExpressionProgram& program) const;
 	virtual void Print (const RGString& indent);
 	  
 	virtual size_t StoreSize () const;
@@ -553,6 +567,7 @@ public:
 	virtual bool Evaluate (const bool* msgArray, RGDList& subObjects) const;
 	virtual bool Evaluate (SmartMessagingComm& comm, int numHigherObjects) const;
 	virtual bool EvaluateLocal (const bool* msgArray) const;
+	virtual bool AppendToProgram (ExpressionProgram& program) const;
 	virtual void Print (const RGString& indent);
 	  
 	virtual size_t StoreSize () const;
@@ -567,6 +582,56 @@ protected:
 
 
 
+//
+//  ExpressionProgram holds an initialized expression flattened into postfix instructions, so that the conditions in the
+//  message book can be evaluated in one loop over a small stack instead of by virtual calls down the expression tree.  An
+//  expression that cannot be flattened is evaluated through the tree.
+//
+
+struct ExpressionInstruction {
+
+	int mOperation;
+	int mIndex;
+	int mScope;
+};
+
+
+class ExpressionProgram {
+
+public:
+	ExpressionProgram (const Expression* ex);
+	~ExpressionProgram ();
+
+	bool IsCompiled () const { return mCompiled; }
+	int GetLength () const { return mLength; }
+	const ExpressionInstruction* GetInstructions () const { return mFirst; }
+
+	bool EvaluateLocal (const bool* msgArray) const;
+	bool Evaluate (SmartMessagingComm& comm, int numHigherObjects) const;
+
+	void AppendConstant (bool value);
+	void AppendMessage (int index, int scope);
+	void AppendOperator (int operation);
+
+	enum Operation {PushFalse, PushTrue, PushMessage, AndOperation, OrOperation, ExclusiveOrOperation, NotOperation};
+
+protected:
+	const Expression* mExpression;
+	vector<ExpressionInstruction> mInstructions;
+	const ExpressionInstruction* mFirst;
+	int mLength;
+	int mDepth;
+	int mMaxDepth;
+	bool mCompiled;
+	bool mUsesMessages;
+
+private:
+	ExpressionProgram (const ExpressionProgram&);
+	ExpressionProgram& operator= (const ExpressionProgram&);
+};
+
+
+
 #endif   /*  _EXPRESSION_H_  */
 
 
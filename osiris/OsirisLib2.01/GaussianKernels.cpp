@@ -0,0 +1,458 @@
+/*
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+*  FileName: GaussianKernels.cpp
+*  Author:   Robert Goor
+*
+*/
+//
+//  class GaussianKernels evaluates the trapezoidal sums of the inner products of Gaussians with sampled data, with AVX2
+//  instructions when the computer supports them
+//
+
+#include "GaussianKernels.h"
+#include "rgthread.h"
+#include <cmath>
+#include <iostream>
+
+using namespace std;
+
+#if defined (_M_X64) || defined (_M_IX86) || defined (__x86_64__) || defined (__i386__)
+#define _GAUSSIANKERNELS_X86_
+#include <emmintrin.h>
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define _TARGET_AVX2_
+#else
+#define _TARGET_AVX2_ __attribute__ ((target ("avx2")))
+#endif
+#endif
+
+
+GaussianKernels::InstructionSet GaussianKernels::CurrentSet = GaussianKernels::GetBestInstructionSet ();
+bool GaussianKernels::Validate = false;
+double GaussianKernels::Tolerance = 1.0e-10;
+unsigned long GaussianKernels::ValidationFailures = 0;
+
+static RGMutex ValidationMutex;
+
+
+#ifdef _GAUSSIANKERNELS_X86_
+
+//
+//  exp (-x), for x >= 0, is 2^n * exp (r), with n the nearest integer to -x / log (2) and r = -x - n log (2), so that |r| <= log (2) / 2.
+//  log (2) is split in two so that n log (2) is subtracted without rounding, and exp (r) is its Taylor polynomial of degree 13,
+//  which is accurate to about one unit in the last place.  Beyond MaximumArgument, the result is 0, instead of a denormal.
+//
+
+static const double MaximumArgument = 708.0;
+static const double Log2e = 1.44269504088896340736;
+static const double Ln2Hi = 6.93145751953125e-1;
+static const double Ln2Lo = 1.42860682030941723212e-6;
+static const int ExpDegree = 13;
+static const double ExpCoefficients [ExpDegree + 1] = { 1.0, 1.0, 1.0 / 2.0, 1.0 / 6.0, 1.0 / 24.0, 1.0 / 120.0, 1.0 / 720.0,
+	1.0 / 5040.0, 1.0 / 40320.0, 1.0 / 362880.0, 1.0 / 3628800.0, 1.0 / 39916800.0, 1.0 / 479001600.0, 1.0 / 6227020800.0 };
+
+
+_TARGET_AVX2_ static inline __m256d ExpNegAVX2 (__m256d x) {
+
+	const __m256d maxArg = _mm256_set1_pd (MaximumArgument);
+	__m256d underflow = _mm256_cmp_pd (x, maxArg, _CMP_GT_OQ);
+	x = _mm256_min_pd (maxArg, x);	// an undefined argument stays undefined
+	__m256d y = _mm256_sub_pd (_mm256_setzero_pd (), x);
+	__m128i ni = _mm256_cvtpd_epi32 (_mm256_mul_pd (y, _mm256_set1_pd (Log2e)));	// rounds to nearest
+	__m256d n = _mm256_cvtepi32_pd (ni);
+	__m256d r = _mm256_sub_pd (_mm256_sub_pd (y, _mm256_mul_pd (n, _mm256_set1_pd (Ln2Hi))), _mm256_mul_pd (n, _mm256_set1_pd (Ln2Lo)));
+	__m256d p = _mm256_set1_pd (ExpCoefficients [ExpDegree]);
+	int i;
+
+	for (i=ExpDegree-1; i>=0; i--)
+		p = _mm256_add_pd (_mm256_mul_pd (p, r), _mm256_set1_pd (ExpCoefficients [i]));
+
+	__m256i scale = _mm256_slli_epi64 (_mm256_cvtepi32_epi64 (_mm_add_epi32 (ni, _mm_set1_epi32 (1023))), 52);
+	p = _mm256_mul_pd (p, _mm256_castsi256_pd (scale));
+	return _mm256_andnot_pd (underflow, p);
+}
+
+
+//
+//  The samples are evaluated Width at a time.  The first and last blocks, which hold the samples with weight 1/2 and any lanes
+//  past the last sample, are copied with their weights; the lanes past the last sample have weight and data 0.
+//
+
+static inline bool LoadBlock (const double* data, int n, int i, int width, double* blockData, double* blockWeights) {
+
+	//  returns true if the block is interior:  all weights are 1 and the data can be used in place
+
+	int k;
+	int j;
+
+	if ((i > 0) && (i + width - 1 < n))
+		return true;
+
+	for (k=0; k<width; k++) {
+
+		j = i + k;
+
+		if (j <= n) {
+
+			blockData [k] = data [j];
+			blockWeights [k] = ((j == 0) || (j == n)) ? 0.5 : 1.0;
+		}
+
+		else {
+
+			blockData [k] = 0.0;
+			blockWeights [k] = 0.0;
+		}
+	}
+
+	return false;
+}
+
+
+_TARGET_AVX2_ static double DataSumAVX2 (const double* data, int n, double left, double spacing, double offset, double sigma) {
+
+	double blockData [4];
+	double blockWeights [4];
+	double lanes [4];
+	__m256d sum = _mm256_setzero_pd ();
+	__m256d index = _mm256_set_pd (3.0, 2.0, 1.0, 0.0);
+	const __m256d four = _mm256_set1_pd (4.0);
+	const __m256d half = _mm256_set1_pd (0.5);
+	const __m256d vLeft = _mm256_set1_pd (left);
+	const __m256d vSpacing = _mm256_set1_pd (spacing);
+	const __m256d vOffset = _mm256_set1_pd (offset);
+	const __m256d vSigma = _mm256_set1_pd (sigma);
+	__m256d d;
+	__m256d w;
+	__m256d x;
+	__m256d e1;
+	int i;
+
+	for (i=0; i<=n; i+=4) {
+
+		x = _mm256_div_pd (_mm256_sub_pd (_mm256_add_pd (vLeft, _mm256_mul_pd (index, vSpacing)), vOffset), vSigma);
+		x = _mm256_mul_pd (_mm256_mul_pd (half, x), x);
+		e1 = ExpNegAVX2 (x);
+
+		if (LoadBlock (data, n, i, 4, blockData, blockWeights))
+			sum = _mm256_add_pd (sum, _mm256_mul_pd (_mm256_loadu_pd (data + i), e1));
+
+		else {
+
+			d = _mm256_loadu_pd (blockData);
+			w = _mm256_loadu_pd (blockWeights);
+			sum = _mm256_add_pd (sum, _mm256_mul_pd (_mm256_mul_pd (w, d), e1));
+		}
+
+		index = _mm256_add_pd (index, four);
+	}
+
+	_mm256_storeu_pd (lanes, sum);
+	return (lanes [0] + lanes [1]) + (lanes [2] + lanes [3]);
+}
+
+
+_TARGET_AVX2_ static void DoubleGaussianSumsAVX2 (const double* data, int n, double left, double spacing, double offset, double sigma,
+	double sigmaCorrection, GaussianSums& sums) {
+
+	double blockData [4];
+	double blockWeights [4];
+	double lanes [4];
+	__m256d sum1 = _mm256_setzero_pd ();
+	__m256d sum2 = _mm256_setzero_pd ();
+	__m256d sum3 = _mm256_setzero_pd ();
+	__m256d sumv1 = _mm256_setzero_pd ();
+	__m256d sumv1v2 = _mm256_setzero_pd ();
+	__m256d index = _mm256_set_pd (3.0, 2.0, 1.0, 0.0);
+	const __m256d four = _mm256_set1_pd (4.0);
+	const __m256d half = _mm256_set1_pd (0.5);
+	const __m256d vLeft = _mm256_set1_pd (left);
+	const __m256d vSpacing = _mm256_set1_pd (spacing);
+	const __m256d vOffset = _mm256_set1_pd (offset);
+	const __m256d vSigma = _mm256_set1_pd (sigma);
+	const __m256d vCorrection = _mm256_set1_pd (sigmaCorrection);
+	__m256d d;
+	__m256d w;
+	__m256d x;
+	__m256d e1;
+	__m256d e2;
+	__m256d we1;
+	__m256d we2;
+	int i;
+
+	for (i=0; i<=n; i+=4) {
+
+		x = _mm256_div_pd (_mm256_sub_pd (_mm256_add_pd (vLeft, _mm256_mul_pd (index, vSpacing)), vOffset), vSigma);
+		x = _mm256_mul_pd (_mm256_mul_pd (half, x), x);
+		e1 = ExpNegAVX2 (x);
+		e2 = ExpNegAVX2 (_mm256_mul_pd (x, vCorrection));
+
+		if (LoadBlock (data, n, i, 4, blockData, blockWeights)) {
+
+			d = _mm256_loadu_pd (data + i);
+			we1 = e1;
+			we2 = e2;
+		}
+
+		else {
+
+			d = _mm256_loadu_pd (blockData);
+			w = _mm256_loadu_pd (blockWeights);
+			we1 = _mm256_mul_pd (w, e1);
+			we2 = _mm256_mul_pd (w, e2);
+		}
+
+		sum1 = _mm256_add_pd (sum1, _mm256_mul_pd (d, we1));
+		sum2 = _mm256_add_pd (sum2, _mm256_mul_pd (d, we2));
+		sum3 = _mm256_add_pd (sum3, _mm256_mul_pd (we2, e2));
+		sumv1 = _mm256_add_pd (sumv1, _mm256_mul_pd (we1, e1));
+		sumv1v2 = _mm256_add_pd (sumv1v2, _mm256_mul_pd (we1, e2));
+		index = _mm256_add_pd (index, four);
+	}
+
+	_mm256_storeu_pd (lanes, sum1);
+	sums.mDataPrimary = (lanes [0] + lanes [1]) + (lanes [2] + lanes [3]);
+	_mm256_storeu_pd (lanes, sum2);
+	sums.mDataSecondary = (lanes [0] + lanes [1]) + (lanes [2] + lanes [3]);
+	_mm256_storeu_pd (lanes, sum3);
+	sums.mSecondaryNorm2 = (lanes [0] + lanes [1]) + (lanes [2] + lanes [3]);
+	_mm256_storeu_pd (lanes, sumv1);
+	sums.mPrimaryNorm2 = (lanes [0] + lanes [1]) + (lanes [2] + lanes [3]);
+	_mm256_storeu_pd (lanes, sumv1v2);
+	sums.mPrimarySecondary = (lanes [0] + lanes [1]) + (lanes [2] + lanes [3]);
+}
+
+
+_TARGET_AVX2_ static void ClearUpperAVX2 () {
+
+	//
+	//  Called after each AVX2 kernel has returned, so that the compiler cannot move any use of the 256-bit registers after it.
+	//  Otherwise, every SSE instruction that follows, including those of the scalar exp, waits on the upper halves of the registers.
+	//
+
+	_mm256_zeroupper ();
+}
+
+#endif  /*  _GAUSSIANKERNELS_X86_  */
+
+
+double GaussianKernels :: DataSum (const double* data, int n, double left, double spacing, double offset, double sigma) {
+
+	double bound;
+
+#ifdef _GAUSSIANKERNELS_X86_
+	//  The SSE2 exponential, two samples at a time, was no faster than the scalar exp, so only AVX2 is used
+
+	if (CurrentSet == AVX2) {
+
+		double sum = DataSumAVX2 (data, n, left, spacing, offset, sigma);
+		ClearUpperAVX2 ();
+
+		if (!Validate)
+			return sum;
+
+		double scalarSum = ScalarDataSum (data, n, left, spacing, offset, sigma, bound);
+
+		if (WithinTolerance (sum, scalarSum, bound))
+			return sum;
+
+		ReportValidationFailure ("DataSum", offset, sigma, n);
+		return scalarSum;
+	}
+#endif
+
+	return ScalarDataSum (data, n, left, spacing, offset, sigma, bound);
+}
+
+
+void GaussianKernels :: DoubleGaussianSums (const double* data, int n, double left, double spacing, double offset, double sigma,
+	double sigmaCorrection, GaussianSums& sums) {
+
+	double bound;
+
+#ifdef _GAUSSIANKERNELS_X86_
+	if (CurrentSet == AVX2) {
+
+		DoubleGaussianSumsAVX2 (data, n, left, spacing, offset, sigma, sigmaCorrection, sums);
+		ClearUpperAVX2 ();
+
+		if (!Validate)
+			return;
+
+		GaussianSums scalarSums;
+		ScalarDoubleGaussianSums (data, n, left, spacing, offset, sigma, sigmaCorrection, scalarSums, bound);
+		double weightBound = (double) n;	// the Gaussians are at most 1
+
+		if (WithinTolerance (sums.mDataPrimary, scalarSums.mDataPrimary, bound) &&
+			WithinTolerance (sums.mDataSecondary, scalarSums.mDataSecondary, bound) &&
+			WithinTolerance (sums.mSecondaryNorm2, scalarSums.mSecondaryNorm2, weightBound) &&
+			WithinTolerance (sums.mPrimaryNorm2, scalarSums.mPrimaryNorm2, weightBound) &&
+			WithinTolerance (sums.mPrimarySecondary, scalarSums.mPrimarySecondary, weightBound))
+			return;
+
+		ReportValidationFailure ("DoubleGaussianSums", offset, sigma, n);
+		sums = scalarSums;
+		return;
+	}
+#endif
+
+	ScalarDoubleGaussianSums (data, n, left, spacing, offset, sigma, sigmaCorrection, sums, bound);
+}
+
+
+void GaussianKernels :: SetInstructionSet (InstructionSet set) {
+
+	InstructionSet best = GetBestInstructionSet ();
+
+	if (set > best)
+		set = best;
+
+	CurrentSet = set;
+}
+
+
+GaussianKernels::InstructionSet GaussianKernels :: GetBestInstructionSet () {
+
+#ifdef _GAUSSIANKERNELS_X86_
+	bool sse2;
+	bool avx2 = false;
+
+#ifdef _MSC_VER
+	int info [4];
+	__cpuid (info, 0);
+	int maxLeaf = info [0];
+	__cpuid (info, 1);
+	sse2 = ((info [3] & (1 << 26)) != 0);
+	bool osSavesAVX = ((info [2] & (1 << 27)) != 0) && ((info [2] & (1 << 28)) != 0) && ((_xgetbv (0) & 6) == 6);
+
+	if (osSavesAVX && (maxLeaf >= 7)) {
+
+		__cpuidex (info, 7, 0);
+		avx2 = ((info [1] & (1 << 5)) != 0);
+	}
+#else
+	__builtin_cpu_init ();
+	sse2 = (__builtin_cpu_supports ("sse2") != 0);
+	avx2 = (__builtin_cpu_supports ("avx2") != 0);	// only if the operating system saves the AVX registers
+#endif
+
+	if (avx2)
+		return AVX2;
+
+	if (sse2)
+		return SSE2;
+#endif
+
+	return Scalar;
+}
+
+
+const char* GaussianKernels :: GetInstructionSetName (InstructionSet set) {
+
+	switch (set) {
+
+		case AVX2:
+			return "AVX2";
+
+		case SSE2:
+			return "SSE2";
+
+		default:
+			return "scalar";
+	}
+}
+
+
+double GaussianKernels :: ScalarDataSum (const double* data, int n, double left, double spacing, double offset, double sigma, double& bound) {
+
+	double sum = 0.0;
+	double x;
+	double weight;
+	int i;
+	bound = 0.0;
+
+	for (i=0; i<=n; i++) {
+
+		weight = ((i == 0) || (i == n)) ? 0.5 : 1.0;
+		x = (left + i * spacing - offset) / sigma;
+		x *= 0.5 * x;
+		sum += weight * data [i] * exp (-x);
+		bound += weight * fabs (data [i]);
+	}
+
+	return sum;
+}
+
+
+void GaussianKernels :: ScalarDoubleGaussianSums (const double* data, int n, double left, double spacing, double offset, double sigma,
+	double sigmaCorrection, GaussianSums& sums, double& bound) {
+
+	double x;
+	double weight;
+	double tempx;
+	double tempw;
+	int i;
+	bound = 0.0;
+	sums.mDataPrimary = sums.mDataSecondary = sums.mSecondaryNorm2 = sums.mPrimaryNorm2 = sums.mPrimarySecondary = 0.0;
+
+	for (i=0; i<=n; i++) {
+
+		weight = ((i == 0) || (i == n)) ? 0.5 : 1.0;
+		x = (left + i * spacing - offset) / sigma;
+		x *= 0.5 * x;
+		tempx = exp (-x);
+		tempw = exp (-x * sigmaCorrection);
+		sums.mDataPrimary += weight * data [i] * tempx;
+		sums.mDataSecondary += weight * data [i] * tempw;
+		sums.mSecondaryNorm2 += weight * tempw * tempw;
+		sums.mPrimaryNorm2 += weight * tempx * tempx;
+		sums.mPrimarySecondary += weight * tempx * tempw;
+		bound += weight * fabs (data [i]);
+	}
+}
+
+
+bool GaussianKernels :: WithinTolerance (double value, double scalarValue, double bound) {
+
+	// Undefined input, such as an undefined mean, gives undefined sums in both evaluations
+
+	if (scalarValue != scalarValue)
+		return (value != value);
+
+	return (fabs (value - scalarValue) <= Tolerance * bound);
+}
+
+
+void GaussianKernels :: ReportValidationFailure (const char* kernel, double offset, double sigma, int n) {
+
+	RGLock lock (ValidationMutex);
+	ValidationFailures++;
+	cerr << "GaussianKernels::" << kernel << " (" << GetInstructionSetName (CurrentSet) << ") differs from scalar evaluation for offset = "
+		<< offset << ", sigma = " << sigma << ", samples = " << n + 1 << endl;
+}
@@ -0,0 +1,92 @@
+/*
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+*  FileName: GaussianKernels.h
+*  Author:   Robert Goor
+*
+*/
+//
+//  class GaussianKernels evaluates the sums used by the inner products of NormalizedGaussian and DoubleGaussian with
+//  sampled data:  trapezoidal sums over the samples of an interval of the data times a Gaussian, and of the products of a
+//  Gaussian with a second Gaussian whose standard deviation is larger by a fixed ratio.  The sums are evaluated with AVX2
+//  instructions, using a vectorized exponential, if the computer supports them, and otherwise with the scalar exp.  In
+//  validation mode, every vectorized evaluation is checked against the scalar evaluation, and the scalar sums are used if
+//  they differ by more than the tolerance.
+//
+
+#ifndef _GAUSSIANKERNELS_H_
+#define _GAUSSIANKERNELS_H_
+
+
+struct GaussianSums {
+
+	double mDataPrimary;	// sum of data times primary Gaussian
+	double mDataSecondary;	// sum of data times secondary Gaussian
+	double mSecondaryNorm2;	// sum of secondary Gaussian squared
+	double mPrimaryNorm2;	// sum of primary Gaussian squared
+	double mPrimarySecondary;	// sum of primary times secondary Gaussian
+};
+
+
+class GaussianKernels {
+
+public:
+	enum InstructionSet { Scalar, SSE2, AVX2 };
+
+	//
+	//  The samples are data [0], ..., data [n], at abscissas left, left + spacing, ..., left + n * spacing, with weight 1/2 for
+	//  the first and last.  The primary Gaussian is exp (-0.5 * ((t - offset) / sigma)^2) and the secondary Gaussian is the
+	//  primary to the power sigmaCorrection.  The sums are not scaled.
+	//
+
+	static double DataSum (const double* data, int n, double left, double spacing, double offset, double sigma);
+	static void DoubleGaussianSums (const double* data, int n, double left, double spacing, double offset, double sigma,
+		double sigmaCorrection, GaussianSums& sums);
+
+	static void SetInstructionSet (InstructionSet set);	// no better than GetBestInstructionSet ()
+	static InstructionSet GetInstructionSet () { return CurrentSet; }
+	static InstructionSet GetBestInstructionSet ();
+	static const char* GetInstructionSetName (InstructionSet set);
+
+	static void SetValidation (bool validate) { Validate = validate; }
+	static bool GetValidation () { return Validate; }
+	static void SetValidationTolerance (double tolerance) { Tolerance = tolerance; }	// relative to the sum of absolute terms
+	static unsigned long GetNumberOfValidationFailures () { return ValidationFailures; }
+
+protected:
+	static InstructionSet CurrentSet;
+	static bool Validate;
+	static double Tolerance;
+	static unsigned long ValidationFailures;
+
+	static double ScalarDataSum (const double* data, int n, double left, double spacing, double offset, double sigma, double& bound);
+	static void ScalarDoubleGaussianSums (const double* data, int n, double left, double spacing, double offset, double sigma,
+		double sigmaCorrection, GaussianSums& sums, double& bound);
+	static bool WithinTolerance (double value, double scalarValue, double bound);
+	static void ReportValidationFailure (const char* kernel, double offset, double sigma, int n);
+};
+
+
+#endif  /*  _GAUSSIANKERNELS_H_  */
@@ -51,6 +51,7 @@
 #include "SmartNotice.h"
 #include "STRSmartNotices.h"
 #include "CoreBioComponent.h"
+#include "SampleResultCache.h"
 
 #include <iostream>
 #include <vector>
@@ -87,16 +88,20 @@ double Locus::MaxResidualForAlleleCalls = -1.0;
 double Locus::AlleleOverloadThreshold = -1.0;
 double Locus::ImbalanceThresholdForNoisyPeak = 0.5;
 bool* Locus::InitialMatrix = NULL;
-bool Locus::NoYForAMEL = false;
-bool Locus::DisableStutterFilter = false;
-bool Locus::DisableAdenylationFilter = false;
-bool Locus::CallOnLadderAdenylation = false;
+RGThreadStatic<bool> Locus::NoYForAMEL (false);
+RGThreadStatic<bool> Locus::DisableStutterFilter (false);
+RGThreadStatic<bool> Locus::DisableAdenylationFilter (false);
+RGThreadStatic<bool> Locus::CallOnLadderAdenylation (false);
 int Locus::NumberOfChannels = 0;
-bool Locus::IsSingleSourceSample = false;
-bool Locus::IsControlSample = false;
+RGThreadStatic<bool> Locus::IsSingleSourceSample (false);
+RGThreadStatic<bool> Locus::IsControlSample (false);
 
-ILSHistory LaneStandard::mILSHistory;
-ILSHistory LaneStandard::mLadderILSHistory;
+ILSHistory LaneStandard::DefaultILSHistory;
+ILSHistory LaneStandard::DefaultLadderILSHistory;
+RGThreadStatic<ILSHistory*> LaneStandard::mILSHistory (&LaneStandard::DefaultILSHistory);
+RGThreadStatic<ILSHistory*> LaneStandard::mLadderILSHistory (&LaneStandard::DefaultLadderILSHistory);
+int LaneStandard::ILSHistoryNumberOfCharacteristics = 0;
+RGMutex LaneStandard::mILSHistoryMutex;
 
 bool PopulationCollection::UseILSFamilies = false;
 
@@ -303,6 +308,12 @@ unsigned Allele :: HashNumber (unsigned long Base) const {
 }
 
 
+unsigned long Allele :: FullHashNumber () const {
+
+	return mLink->FullHashNumber ();
+}
+
+
 
 Boolean Allele :: IsEqualTo (const RGPersistent* p) const {
 
@@ -490,9 +501,7 @@ void Locus :: ClearAndDestroy () {
 
 void Locus :: SetTableLink (int linkNumber) {
 
-	RGString temp;
-	temp.Convert (linkNumber, 10);
-	mTableLink = "&" + temp + "&";
+	mTableLink = "&" + SampleResultCache::FormatLinkNumber (linkNumber) + "&";
 }
 
 
@@ -5420,6 +5429,12 @@ unsigned Locus :: HashNumber (unsigned long Base) const {
 }
 
 
+unsigned long Locus :: FullHashNumber () const {
+
+	return mLink->FullHashNumber ();
+}
+
+
 
 Boolean Locus :: IsEqualTo (const RGPersistent* p) const {
 
@@ -6435,6 +6450,27 @@ double LaneStandard :: GetLaneStandardTimeForCharacteristicNumber (int i) const
 }
 
 
+void LaneStandard :: SetILSHistoryNumberOfCharacteristics (int n) {
+
+	ILSHistoryNumberOfCharacteristics = n;
+	DefaultILSHistory.SetNumberOfCharacteristics (n);
+	DefaultLadderILSHistory.SetNumberOfCharacteristics (n);
+}
+
+
+void LaneStandard :: SetILSHistories (ILSHistory& history, ILSHistory& ladderHistory) {
+
+	if (ILSHistoryNumberOfCharacteristics > 0) {
+
+		history.SetNumberOfCharacteristics (ILSHistoryNumberOfCharacteristics);
+		ladderHistory.SetNumberOfCharacteristics (ILSHistoryNumberOfCharacteristics);
+	}
+
+	mILSHistory = &history;
+	mLadderILSHistory = &ladderHistory;
+}
+
+
 void LaneStandard :: SetLaneStandardName (const RGString& name) {
 
 	mLink->SetName (name);
@@ -6630,6 +6666,12 @@ unsigned LaneStandard :: HashNumber (unsigned long Base) const {
 }
 
 
+unsigned long LaneStandard :: FullHashNumber () const {
+
+	return mLink->FullHashNumber ();
+}
+
+
 
 Boolean LaneStandard :: IsEqualTo (const RGPersistent* p) const {
 
@@ -6941,6 +6983,12 @@ unsigned PopulationMarkerSet :: HashNumber (unsigned long Base) const {
 }
 
 
+unsigned long PopulationMarkerSet :: FullHashNumber () const {
+
+	return mLink->FullHashNumber ();
+}
+
+
 Boolean PopulationMarkerSet :: IsEqualTo (const RGPersistent* p) const {
 
 	PopulationMarkerSet* q = (PopulationMarkerSet*) p;
@@ -9616,8 +9664,9 @@ int PopulationCollection :: InitializeFromDifferentSets () {
 
 PopulationMarkerSet* PopulationCollection :: GetNamedPopulationMarkerSet (const RGString& markerSetName) {
 
-	mTargetSet.SetMarkerSetName (markerSetName);
-	PopulationMarkerSet* pms = (PopulationMarkerSet*)MarkerSets.Find (&mTargetSet);
+	PopulationMarkerSet targetSet;	// not a member:  samples may be analyzed concurrently
+	targetSet.SetMarkerSetName (markerSetName);
+	PopulationMarkerSet* pms = (PopulationMarkerSet*)MarkerSets.Find (&targetSet);
 
 	if (pms == NULL)
 		return NULL;
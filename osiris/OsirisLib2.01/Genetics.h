@@ -60,6 +60,7 @@
 #include "rgdefs.h"
 #include "rghashtable.h"
 #include "rgdlist.h"
+#include "rgthread.h"
 #include "BaseGenetics.h"
 #include "Notices.h"
 #include "SmartMessagingObject.h"
@@ -186,6 +187,7 @@ public:
 
 	virtual int CompareTo (const RGPersistent* p) const;
 	virtual unsigned HashNumber (unsigned long Base) const;
+	virtual unsigned long FullHashNumber () const;
 	virtual Boolean IsEqualTo (const RGPersistent* p) const;
 
 	virtual void Write (RGFile& textOutput, const RGString& indent);
@@ -356,6 +358,7 @@ public:
 
 	virtual int CompareTo (const RGPersistent* p) const;
 	virtual unsigned HashNumber (unsigned long Base) const;
+	virtual unsigned long FullHashNumber () const;
 	virtual Boolean IsEqualTo (const RGPersistent* p) const;
 
 	virtual void Write (RGFile& textOutput, const RGString& indent);
@@ -667,13 +670,13 @@ protected:
 	static double AlleleOverloadThreshold;
 	static double ImbalanceThresholdForNoisyPeak;
 	static bool* InitialMatrix;
-	static bool NoYForAMEL;
-	static bool DisableStutterFilter;
-	static bool DisableAdenylationFilter;
-	static bool CallOnLadderAdenylation;
+	static RGThreadStatic<bool> NoYForAMEL;
+	static RGThreadStatic<bool> DisableStutterFilter;
+	static RGThreadStatic<bool> DisableAdenylationFilter;
+	static RGThreadStatic<bool> CallOnLadderAdenylation;
 	static int NumberOfChannels;
-	static bool IsSingleSourceSample;
-	static bool IsControlSample;
+	static RGThreadStatic<bool> IsSingleSourceSample;
+	static RGThreadStatic<bool> IsControlSample;
 
 	Boolean BuildAlleleLists (const RGString& xmlString);
 	Boolean BuildMappings (RGDList& signalList);
@@ -795,18 +798,18 @@ public:
 	int SelectBestSubsetOfCharacteristics (RGDList& curveList, double& correlation);  // returns index of first (from 0) in contiguous list of characteristics
 	int AssignLaneStandardSignals (RGDList& curveList);   // takes first mNumberOfCharacteristics elements
 
-	double GetMaxILSWidth () const { return mILSHistory.GetMaxWidth (); }
-	double GetMinILSWidth () const { return mILSHistory.GetMinWidth (); }
-	double* GetILSNormalizedDifferences () const { return mILSHistory.GetNormalizedDifferences (); }
-	double* GetLadderILSNormalizedDifferences () const { return mLadderILSHistory.GetLadderNormalizedDifferences (); }
-	bool AddILSToHistory (double* times) { return mILSHistory.AddILS (times); }
-	void ResetBoundsUsingFactorToILSHistory (double factor) { mILSHistory.ResetBoundsUsingFactor (factor); }
-	void ResetStartAndEndTimesForILSTests (double startC, double endC, DataSignal* startSignal) { mILSHistory.ResetStartAndEndTimesForILSTests (startC, endC, startSignal); }
-	void ResetStartAndEndTimesForLadderILSTests (double startC, double endC, DataSignal* startSignal) { mLadderILSHistory.ResetStartAndEndTimesForLadderILSTests (startC, endC, startSignal); }
-	void ResetIdealCharacteristicsAndIntervalsForLadderILS (const double* actualArray, const double* differenceArray, double factor) { mLadderILSHistory.ResetIdealCharacteristicsAndIntervalsForLadderILS (actualArray, differenceArray, factor); }
-	int TestILSUsingHistory (int index, DataSignal* candidate) { return mILSHistory.TestILS (index, candidate); }
-	bool FindAndTestILS (int index, DataSignal* startCandidate, DataSignal*& mostAveragePeak) { return mILSHistory.FindAndTestILS (index, startCandidate, mostAveragePeak); }
-	bool FindAndTestLadderILS (int index, DataSignal* startCandidate, DataSignal*& firstPeakFound) {  return mLadderILSHistory.FindAndTestLadderILS (index, startCandidate, firstPeakFound); }
+	double GetMaxILSWidth () const { return mILSHistory->GetMaxWidth (); }
+	double GetMinILSWidth () const { return mILSHistory->GetMinWidth (); }
+	double* GetILSNormalizedDifferences () const { return mILSHistory->GetNormalizedDifferences (); }
+	double* GetLadderILSNormalizedDifferences () const { return mLadderILSHistory->GetLadderNormalizedDifferences (); }
+	bool AddILSToHistory (double* times) { return mILSHistory->AddILS (times); }
+	void ResetBoundsUsingFactorToILSHistory (double factor) { mILSHistory->ResetBoundsUsingFactor (factor); }
+	void ResetStartAndEndTimesForILSTests (double startC, double endC, DataSignal* startSignal) { mILSHistory->ResetStartAndEndTimesForILSTests (startC, endC, startSignal); }
+	void ResetStartAndEndTimesForLadderILSTests (double startC, double endC, DataSignal* startSignal) { mLadderILSHistory->ResetStartAndEndTimesForLadderILSTests (startC, endC, startSignal); }
+	void ResetIdealCharacteristicsAndIntervalsForLadderILS (const double* actualArray, const double* differenceArray, double factor) { mLadderILSHistory->ResetIdealCharacteristicsAndIntervalsForLadderILS (actualArray, differenceArray, factor); }
+	int TestILSUsingHistory (int index, DataSignal* candidate) { return mILSHistory->TestILS (index, candidate); }
+	bool FindAndTestILS (int index, DataSignal* startCandidate, DataSignal*& mostAveragePeak) { return mILSHistory->FindAndTestILS (index, startCandidate, mostAveragePeak); }
+	bool FindAndTestLadderILS (int index, DataSignal* startCandidate, DataSignal*& firstPeakFound) {  return mLadderILSHistory->FindAndTestLadderILS (index, startCandidate, firstPeakFound); }
 
 	virtual int GetCharacteristicArray (const double*& array) const;  // returns array size or -1
 	virtual int GetCharacteristicDifferenceArray (const double*& array) const;  // returns array size or -1
@@ -828,10 +831,13 @@ public:
 
 	virtual int CompareTo (const RGPersistent* p) const;
 	virtual unsigned HashNumber (unsigned long Base) const;
+	virtual unsigned long FullHashNumber () const;
 	virtual Boolean IsEqualTo (const RGPersistent* p) const;
 
 	virtual void Write (RGFile& textOutput, const RGString& indent);
-	static void SetILSHistoryNumberOfCharacteristics (int n) { mILSHistory.SetNumberOfCharacteristics (n); mLadderILSHistory.SetNumberOfCharacteristics (n); }
+	static void SetILSHistoryNumberOfCharacteristics (int n);
+	static void SetILSHistories (ILSHistory& history, ILSHistory& ladderHistory);	// for the analysis on the calling thread; sized here
+	static RGMutex& GetILSHistoryMutex () { return mILSHistoryMutex; }	// hold while testing candidates against, or adding to, the ILS history
 
 protected:
 	BaseLaneStandard* mLink;
@@ -842,8 +848,12 @@ protected:
 	RGString Msg;
 	RGString mFamilyName;
 	RGString mDyeName;
-	static ILSHistory mILSHistory;
-	static ILSHistory mLadderILSHistory;
+	static RGThreadStatic<ILSHistory*> mILSHistory;	// of the directory being analyzed, so that each analysis keeps its own
+	static RGThreadStatic<ILSHistory*> mLadderILSHistory;
+	static ILSHistory DefaultILSHistory;
+	static ILSHistory DefaultLadderILSHistory;
+	static int ILSHistoryNumberOfCharacteristics;
+	static RGMutex mILSHistoryMutex;
 };
 
 
@@ -897,6 +907,7 @@ public:
 
 	virtual int CompareTo (const RGPersistent* p) const;
 	virtual unsigned HashNumber (unsigned long Base) const;
+	virtual unsigned long FullHashNumber () const;
 	virtual Boolean IsEqualTo (const RGPersistent* p) const;
 
 	virtual void Write (RGFile& textOutput, const RGString& indent);
@@ -988,7 +999,6 @@ protected:
 	RGHashTable MarkerSets;  // contains objects of type PopulationMarkerSet*
 	Boolean Valid;
 	RGString ErrorString;
-	PopulationMarkerSet mTargetSet;
 	LaneStandardCollection* mLaneStandardCollection;
 	RGString TheWholeSheBang;
 	RGString mILSData;
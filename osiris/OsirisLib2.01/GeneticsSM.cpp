@@ -217,7 +217,7 @@ bool Locus :: ReportSmartNoticeObjects (RGTextOutput& text, const RGString& inde
 	if (NumberOfSmartNoticeObjects () > 0) {
 
 		int msgLevel = GetHighestMessageLevelWithRestrictionSM ();
-		RGDListIterator it (*mSmartMessageReporters);
+		RGDListIterator it (GetSmartMessageReporterList ());
 		SmartMessageReporter* nextNotice;
 		text.SetOutputLevel (msgLevel);
 		RGString indent2 = indent + "\t";
@@ -284,7 +284,6 @@ int Locus :: AddAllSmartMessageReporters () {
 	int nMsgs = 0;
 	SmartMessageReporter* newMsg;
 	SmartMessage* nextSmartMsg;
-	SmartMessageData target;
 	SmartMessageData* smd;
 
 	for (i=0; i<size; i++) {
@@ -297,8 +296,7 @@ int Locus :: AddAllSmartMessageReporters () {
 		if (!nextSmartMsg->EvaluateReport (mMessageArray))
 			continue;
 
-		target.SetIndex (i);
-		smd = (SmartMessageData*) mMessageDataTable->Find (&target);
+		smd = FindMessageData (i);
 		newMsg = new SmartMessageReporter;
 		newMsg->SetSmartMessage (nextSmartMsg);
 		
@@ -323,7 +321,6 @@ int Locus :: AddAllSmartMessageReporters (SmartMessagingComm& comm, int numHighe
 	int nMsgs = 0;
 	SmartMessageReporter* newMsg;
 	SmartMessage* nextSmartMsg;
-	SmartMessageData target;
 	SmartMessageData* smd;
 	bool editable;
 	bool enabled;
@@ -367,8 +364,7 @@ int Locus :: AddAllSmartMessageReporters (SmartMessagingComm& comm, int numHighe
 		if (!report && !displayExport)
 			continue;
 
-		target.SetIndex (i);
-		smd = (SmartMessageData*) mMessageDataTable->Find (&target);
+		smd = FindMessageData (i);
 		newMsg = new SmartMessageReporter;
 		newMsg->SetSmartMessage (nextSmartMsg);
 		
@@ -442,7 +438,7 @@ Boolean Locus :: ReportXMLSmartNoticeObjects (RGTextOutput& text, RGTextOutput&
 	if (NumberOfSmartNoticeObjects () > 0) {
 
 		int msgLevel = GetHighestMessageLevelWithRestrictionSM ();
-		RGDListIterator it (*mSmartMessageReporters);
+		RGDListIterator it (GetSmartMessageReporterList ());
 		SmartMessageReporter* nextNotice;
 		text.SetOutputLevel (msgLevel);
 		tempText.SetOutputLevel (1);
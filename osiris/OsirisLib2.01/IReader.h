@@ -33,6 +33,8 @@
  * File Description:
  *          IReader - abstract interface class to provide a function
  *          to read a number of bytes from an offset
+ *          and, optionally, a pointer to the bytes themselves, valid
+ *          for the lifetime of the reader, so that they need not be copied
  */
 #ifndef __I_READER_H__
 #define __I_READER_H__
@@ -46,6 +48,10 @@ public:
   IReader() {}
   virtual ~IReader() {}
   virtual bool Read(void *pData, UINT32 nOffset, size_t nBytes) = 0;
+  virtual const UINT8 *GetView(UINT32, size_t)
+  {
+    return NULL; // the bytes must be read
+  }
 };
 
 #endif
@@ -41,7 +41,7 @@
 
 using namespace std;
 
-int LeastMedianOfSquares::MinimumNumberOfSamples = 4;
+RGThreadStatic<int> LeastMedianOfSquares::MinimumNumberOfSamples (4);
 
 
 DualPoint :: DualPoint (const DualPoint& pt) {
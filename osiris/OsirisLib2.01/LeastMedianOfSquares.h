@@ -41,6 +41,7 @@
 
 
 #include <list>
+#include "rgthread.h"
 
 using namespace std;
 
@@ -145,7 +146,7 @@ protected:
 	double mMedianResidual;
 	double mOutlierThreshold;
 
-	static int MinimumNumberOfSamples;
+	static RGThreadStatic<int> MinimumNumberOfSamples;
 };
 
 
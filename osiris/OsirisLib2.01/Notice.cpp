@@ -40,6 +40,7 @@
 
 #include "Notice.h"
 #include "rgdlist.h"
+#include "rgarena.h"
 #include "rghashtable.h"
 #include "rgidwrapper.h"
 #include "rgindexedlabel.h"
@@ -49,11 +50,11 @@
 
 using namespace std;
 
-int Notice::CurrentLinkNumber = 0;
+NoticeNumbers Notice::DefaultNumbers;
+RGThreadStatic<NoticeNumbers*> Notice::CurrentNumbers (&Notice::DefaultNumbers);
 int Notice::sSubject = 1;
 int Notice::MessageTrigger = 15;
 int Notice::SeverityTrigger = 15;
-int Notice::CurrentMsgNumber = 0;
 int NoticeWarehouse::ReferenceCount = 0;
 NoticeWarehouse* NoticeWarehouse::OneAndOnlySelf = NULL;
 Boolean NoticeWarehouse::DebugFlag = FALSE;
@@ -91,6 +92,18 @@ Notice :: ~Notice () {
 }
 
 
+void* Notice :: operator new (size_t nbytes) {
+
+	return RGArena::Allocate (nbytes);
+}
+
+
+void Notice :: operator delete (void* p) {
+
+	RGArena::Free (p);
+}
+
+
 void Notice :: Report (RGTextOutput& text, const RGString& indent, const RGString& separator) {
 
 	text << CLevel (GetMessageLevel ()) << indent << AssembleString (separator) << "\n" << PLevel ();
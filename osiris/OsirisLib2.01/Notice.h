@@ -41,10 +41,21 @@
 #include "RGTextOutput.h"
 #include "rgfile.h"
 #include "rghashtable.h"
+#include "rgthread.h"
 
 
 class NoticeBook;
 
+
+struct NoticeNumbers {	// the link and message numbers handed out by one analysis
+
+	NoticeNumbers () : mLinkNumber (0), mMsgNumber (0) {}
+
+	int mLinkNumber;
+	int mMsgNumber;
+};
+
+
 struct DataEnd {
 
 	DataEnd () {}
@@ -60,6 +71,9 @@ public:
 	Notice (const Notice& note);
 	virtual ~Notice () = 0;
 
+	void* operator new (size_t);
+	void operator delete (void*);
+
 	void SetMessageNumber (int n) { mMessageNumber = n; }
 	int GetMessageNumber () const { return mMessageNumber; }
 
@@ -100,8 +114,10 @@ public:
 	virtual unsigned HashNumber (unsigned long Base) const;
 
 	static int LoadType () { return -1; }
-	static int GetNextLinkNumber () { CurrentLinkNumber++; return CurrentLinkNumber; }
-	static int GetNextMessageNumber () { CurrentMsgNumber++; return CurrentMsgNumber; }
+	static int GetNextLinkNumber () { return ++CurrentNumbers->mLinkNumber; }
+	static int GetNextMessageNumber () { return ++CurrentNumbers->mMsgNumber; }
+	static void SetNoticeNumbers (NoticeNumbers& numbers) { CurrentNumbers = &numbers; }	// for the analysis on the calling thread
+	static NoticeNumbers& GetNoticeNumbers () { return *CurrentNumbers; }
 
 	static int GetSubjectCategory () { return sSubject; }
 
@@ -123,11 +139,11 @@ protected:
 	Boolean mEnded;
 	int mMessageNumber;
 
-	static int CurrentLinkNumber;
+	static RGThreadStatic<NoticeNumbers*> CurrentNumbers;	// of the directory being analyzed, so that each analysis numbers from 1
+	static NoticeNumbers DefaultNumbers;
 	static int sSubject;
 	static int MessageTrigger;
 	static int SeverityTrigger;
-	static int CurrentMsgNumber;
 };
 
 
@@ -39,13 +39,14 @@
 using namespace std;
 
 
-OsirisInputFile :: OsirisInputFile (bool debug) : mDebug (debug), mInputFile (NULL), mCriticalOutputLevel (15), mMinSampleRFU (0.0),
+OsirisInputFile :: OsirisInputFile (bool debug) : mDebug (debug), mInputFile (NULL), mInputString (NULL), mInputPosition (0), mCriticalOutputLevel (15), mMinSampleRFU (0.0),
 mMinLadderRFU (0.0), mMinLaneStandardRFU (0.0), mMinInterlocusRFU (0.0), mMinLadderInterlocusRFU (0.0), mSampleDetectionThreshold (-1.0), 
-mUseRawData (true), mUserNamedSettingsFiles (true), mIsLadderFreeAnalysis (false) {
+mUseRawData (true), mUserNamedSettingsFiles (true), mIsLadderFreeAnalysis (false), mIsIncrementalAnalysis (false), mNumberOfAnalysisThreads (0) {
 
 	mInputLinesIterator = new RGDListIterator (mInputLines);
 	mAnalysisThresholds = new list<channelThreshold*>;
 	mDetectionThresholds = new list<channelThreshold*>;
+	mBatchRuns = new list<batchRun*>;
 }
 
 
@@ -83,6 +84,14 @@ OsirisInputFile :: ~OsirisInputFile () {
 
 		mDetectionThresholds->clear ();
 		delete mDetectionThresholds;
+
+	list<batchRun*>::iterator runIterator;
+
+	for (runIterator = mBatchRuns->begin (); runIterator != mBatchRuns->end (); runIterator++)
+		delete *runIterator;
+
+	mBatchRuns->clear ();
+	delete mBatchRuns;
 }
 
 
@@ -106,6 +115,17 @@ int OsirisInputFile :: ReadAllInputs (const RGString& inputFileName) {
 }
 
 
+int OsirisInputFile :: ReadAllInputsFromString (const RGString& inputs) {
+
+	int status;
+	mInputString = &inputs;
+	mInputPosition = 0;
+	status = ReadAllInputs ();
+	mInputString = NULL;
+	return status;
+}
+
+
 int OsirisInputFile :: ReadAllInputs () {
 	
 	// reads either named file or stdin, depending on debug flag
@@ -242,7 +262,11 @@ int OsirisInputFile :: ReadLine () {
 
 	while (true) {
 
-		cin >> noskipws >> T;
+		if (!ReadCharacter (T)) {
+
+			cout << "Found end of input before end of line:  " << thisLine.GetData () << endl;
+			return -1;
+		}
 
 		if (T == '\n')
 			continue;
@@ -325,6 +349,14 @@ int OsirisInputFile :: AssignString () {
 		status = 0;
 	}
 
+	else if (mStringLeft == "IncrementalAnalysis") {
+
+		if (mStringRight == "true")
+			mIsIncrementalAnalysis = true;
+
+		status = 0;
+	}
+
 	else if (mStringLeft == "LadderDirectory") {
 
 		SetEmbeddedSlashesToForward (mStringRight);
@@ -406,6 +438,17 @@ int OsirisInputFile :: AssignString () {
 		status = 0;
 	}
 
+	else if (mStringLeft == "AnalysisThreads") {
+
+		mNumberOfAnalysisThreads = mStringRight.ConvertToInteger ();
+
+		if (mNumberOfAnalysisThreads < 0)
+			mNumberOfAnalysisThreads = 0;
+
+		cout << "Analysis threads = " << mNumberOfAnalysisThreads << endl;
+		status = 0;
+	}
+
 	else if (mStringLeft == "RawDataString") {
 
 		if (!(mStringRight.Length () == 0)) {
@@ -518,6 +561,57 @@ int OsirisInputFile :: AssignString () {
 		}
 	}
 
+	else if (mStringLeft == "ServerSocket") {
+
+		mServerSocketName = mStringRight;
+		status = 0;
+	}
+
+	else if (mStringLeft == "SubmitToServer") {
+
+		mSubmitToServerName = mStringRight;
+		status = 0;
+	}
+
+	else if (mStringLeft == "BatchRun") {
+
+		//  <input directory>, <report directory>[, <lab settings file>]
+
+		RGString fields [3];
+		size_t start = 0;
+		size_t comma;
+		int nFields = 0;
+
+		while ((nFields < 2) && mStringRight.FindNextSubstring (start, ",", comma)) {
+
+			if (comma > start)
+				fields [nFields] = mStringRight.ExtractSubstring (start, comma - 1);
+
+			start = comma + 1;
+			nFields++;
+		}
+
+		if (start < mStringRight.Length ())
+			fields [nFields] = mStringRight.ExtractSubstring (start, mStringRight.Length () - 1);
+
+		nFields++;
+
+		for (int i=0; i<nFields; i++) {
+
+			RemoveLeadingAndTrailingBlanks (fields [i]);
+			SetEmbeddedSlashesToForward (fields [i]);
+		}
+
+		if ((nFields < 2) || (fields [0].Length () == 0) || (fields [1].Length () == 0))
+			status = -1;
+
+		else {
+
+			mBatchRuns->push_back (new batchRun (fields [0], fields [1], fields [2]));
+			status = 0;
+		}
+	}
+
 	else if (mStringLeft == "#")
 		status = 0;
 
@@ -546,7 +640,7 @@ int OsirisInputFile :: AssembleInputs () {
 	RGString labSettings1;
 	RGString labSettings2;
 	
-	if (mInputDirectory.Length () == 0) {
+	if ((mInputDirectory.Length () == 0) && mBatchRuns->empty () && !IsServer ()) {
 
 		cout << "Input directory is unspecified." << endl;
 		status = -1;
@@ -558,7 +652,7 @@ int OsirisInputFile :: AssembleInputs () {
 		status = -1;
 	}
 
-	if (mReportDirectory.Length () == 0) {
+	if ((mReportDirectory.Length () == 0) && mBatchRuns->empty () && !IsServer ()) {
 
 		cout << "Report directory is unspecified." << endl;
 		status = -1;
@@ -694,6 +788,40 @@ RGString* OsirisInputFile :: GetNextInputLine () {
 }
 
 
+void OsirisInputFile :: GetInputLinesForRun (const batchRun& run, RGDList& lines) {
+
+	RGString keys [3];
+	RGString values [3];
+	keys [0] = "InputDirectory";
+	values [0] = run.mInputDirectory;
+	keys [1] = "ReportDirectory";
+	values [1] = run.mReportDirectory;
+	keys [2] = "LabSettings";
+	values [2] = (run.mLabSettingsName.Length () > 0) ? run.mLabSettingsName : mFinalLabSettingsName;
+
+	GetInputLinesReplacing (3, keys, values, lines);
+	lines.Append (new RGString (";"));
+}
+
+
+void OsirisInputFile :: GetInputLinesForBatch (const RGString& labSettingsName, const list<batchRun*>& runs, RGDList& lines) {
+
+	RGString key ("LabSettings");
+	RGString line;
+	list<batchRun*>::const_iterator runIterator;
+	GetInputLinesReplacing (1, &key, &labSettingsName, lines);
+
+	for (runIterator = runs.begin (); runIterator != runs.end (); runIterator++) {
+
+		line = "";
+		line << "BatchRun = " << (*runIterator)->mInputDirectory << ", " << (*runIterator)->mReportDirectory << ";";
+		lines.Append (new RGString (line));
+	}
+
+	lines.Append (new RGString (";"));
+}
+
+
 void OsirisInputFile :: OutputAnalysisThresholdOverrides (RGString& output) {
 
 	list<channelThreshold*>::iterator cIterator;
@@ -722,6 +850,84 @@ void OsirisInputFile :: OutputDetectionThresholdOverrides (RGString& output) {
 
 
 
+void OsirisInputFile :: GetInputLinesReplacing (int nKeys, const RGString* keys, const RGString* values, RGDList& lines) {
+
+	//  Copies the input lines, less batch runs, server sockets and the terminating line, with the line for each key replaced by
+	//  one with the given value, or added at the end if there was none
+
+	RGDListIterator it (mInputLines);
+	RGString* nextLine;
+	RGString key;
+	RGString line;
+	size_t equalsPosition;
+	bool* found = new bool [nKeys];
+	int i;
+
+	for (i=0; i<nKeys; i++)
+		found [i] = false;
+
+	while (nextLine = (RGString*) it ()) {
+
+		equalsPosition = 0;
+
+		if (!nextLine->FindNextSubstring (0, "=", equalsPosition) || (equalsPosition == 0))
+			continue;
+
+		key = nextLine->ExtractSubstring (0, equalsPosition - 1);
+		RemoveLeadingAndTrailingBlanks (key);
+
+		if ((key.Length () == 0) || (key == "BatchRun") || (key == "ServerSocket") || (key == "SubmitToServer"))
+			continue;
+
+		for (i=0; i<nKeys; i++) {
+
+			if (key == keys [i])
+				break;
+		}
+
+		if (i < nKeys) {
+
+			line = "";
+			line << keys [i] << " = " << values [i] << ";";
+			lines.Append (new RGString (line));
+			found [i] = true;
+		}
+
+		else
+			lines.Append (new RGString (*nextLine));
+	}
+
+	for (i=0; i<nKeys; i++) {
+
+		if (!found [i]) {
+
+			line = "";
+			line << keys [i] << " = " << values [i] << ";";
+			lines.Append (new RGString (line));
+		}
+	}
+
+	delete[] found;
+}
+
+
+bool OsirisInputFile :: ReadCharacter (char& T) {
+
+	if (mInputString != NULL) {
+
+		if (mInputPosition >= mInputString->Length ())
+			return false;
+
+		T = mInputString->GetCharacter (mInputPosition);
+		mInputPosition++;
+		return true;
+	}
+
+	cin >> noskipws >> T;
+	return !cin.fail ();
+}
+
+
 void OsirisInputFile :: RemoveLeadingAndTrailingBlanks (RGString& string) {
 
 	char T;
@@ -31,6 +31,11 @@
 // OsirisInputFile is class to input basic settings that determine location and identity of configuration files plus data input files, etc.
 // Assumes each line ends with a ";" and last line has nothing on it but a ";"
 //
+// A batch of runs is specified by repeating "BatchRun = <input directory>, <report directory>[, <lab settings file>];"
+//
+// "ServerSocket = <socket path>;" makes the program a resident analysis server, and "SubmitToServer = <socket path>;" has the
+// server analyze the rest of the input
+//
 
 #ifndef _OSIRISINPUTFILE_H_
 #define _OSIRISINPUTFILE_H_
@@ -40,6 +45,17 @@
 #include "rgdlist.h"
 #include "ParameterServer.h"
 
+struct batchRun {
+
+	batchRun () {}
+	batchRun (const RGString& input, const RGString& report, const RGString& labSettings) : mInputDirectory (input), mReportDirectory (report), mLabSettingsName (labSettings) {}
+
+	RGString mInputDirectory;
+	RGString mReportDirectory;
+	RGString mLabSettingsName;	// empty if the run uses the lab settings of the batch
+};
+
+
 class OsirisInputFile {
 
 public:
@@ -48,6 +64,7 @@ public:
 
 	int ReadAllInputs (const RGString& inputFileName);
 	int ReadAllInputs ();  // reads stdin
+	int ReadAllInputsFromString (const RGString& inputs);	// inputs has the lines of an input file
 	int ReadLine ();
 	int AssignString ();
 	void OutputAllData ();
@@ -73,6 +90,13 @@ public:
 
 	list<channelThreshold*>* GetAnalysisThresholdOverrideList () { return mAnalysisThresholds; }
 	list<channelThreshold*>* GetDetectionThresholdOverrideList () { return mDetectionThresholds; }
+	list<batchRun*>* GetBatchRuns () { return mBatchRuns; }
+	bool IsBatchAnalysis () const { return !mBatchRuns->empty (); }
+	RGString GetServerSocketName () const { return mServerSocketName; }
+	RGString GetSubmitToServerName () const { return mSubmitToServerName; }
+	bool IsServer () const { return (mServerSocketName.Length () > 0); }
+	bool IsSubmitToServer () const { return (mSubmitToServerName.Length () > 0); }
+	RGString GetInputText () const { return mCumulativeStringWithNewLines; }
 
 	RGString GetOverrideString () const { return mOverrideString; }
 	bool OverrideStringIsEmpty () const { return (mOverrideString.Length () == 0); }
@@ -88,9 +112,13 @@ public:
 	bool UseRawData () const { return mUseRawData; }
 	bool UserNamedSettingsFiles () const { return mUserNamedSettingsFiles; }
 	bool IsLadderFreeAnalysis () const { return mIsLadderFreeAnalysis; }
+	bool IsIncrementalAnalysis () const { return mIsIncrementalAnalysis; }	// reuse the saved results of unchanged samples
+	int GetNumberOfAnalysisThreads () const { return mNumberOfAnalysisThreads; }	// 0 means one per processor
 
 	void ResetInputLines ();
 	RGString* GetNextInputLine ();
+	void GetInputLinesForRun (const batchRun& run, RGDList& lines);	// the input lines for analyzing run by itself
+	void GetInputLinesForBatch (const RGString& labSettingsName, const list<batchRun*>& runs, RGDList& lines);	// runs all use labSettingsName
 
 	void OutputAnalysisThresholdOverrides (RGString& output);
 	void OutputDetectionThresholdOverrides (RGString& output);
@@ -98,6 +126,8 @@ public:
 protected:
 	bool mDebug;
 	RGFile* mInputFile;
+	const RGString* mInputString;	// read instead of stdin when not NULL
+	size_t mInputPosition;
 	RGString mCumulativeStringWithNewLines;
 	RGString mCumulativeStringWithoutNewLines;
 	RGString mOutputString;
@@ -130,6 +160,8 @@ protected:
 	RGString mFinalStdSettingsName;
 
 	RGString mOverrideString;
+	RGString mServerSocketName;
+	RGString mSubmitToServerName;
 
 	int mCriticalOutputLevel;
 	double mMinSampleRFU;
@@ -142,10 +174,15 @@ protected:
 	bool mUseRawData;
 	bool mUserNamedSettingsFiles;
 	bool mIsLadderFreeAnalysis;
+	bool mIsIncrementalAnalysis;
+	int mNumberOfAnalysisThreads;
 
 	list<channelThreshold*>* mAnalysisThresholds;
 	list<channelThreshold*>* mDetectionThresholds;
+	list<batchRun*>* mBatchRuns;
 
+	bool ReadCharacter (char& T);	// false at end of input
+	void GetInputLinesReplacing (int nKeys, const RGString* keys, const RGString* values, RGDList& lines);
 	void RemoveLeadingAndTrailingBlanks (RGString& string);
 	void SetEmbeddedSlashesToForward (RGString& string);
 	RGString SplitUsingColon (const RGString& target, RGString& right);  // returns what's on left of colon, and empty if no colon
@@ -62,7 +62,7 @@
 
 static ParameterServerKill g_kill;
 
-int ParameterServer :: ReferenceCount = 0;
+volatile long ParameterServer :: ReferenceCount = 0;
 ParameterServer* ParameterServer :: OneAndOnlySelf = NULL;
 
 
@@ -224,7 +224,7 @@ void locusSpecificLimitsStruct :: Reset () {
 
 ParameterServer :: ParameterServer () {
 
-	if (ParameterServer::ReferenceCount == 0) {
+	if (RGAtomicGet (&ParameterServer::ReferenceCount) == 0) {
 
 		Changed = FALSE;
 		mSet = NULL;
@@ -242,13 +242,13 @@ ParameterServer :: ParameterServer () {
 		mDetectionThresholds = new list<channelThreshold*>;
 	}
 
-	ParameterServer::ReferenceCount++;
+	RGAtomicIncrement (&ParameterServer::ReferenceCount);
 }
 
 
 ParameterServer :: ParameterServer (const RGString& xmlString) : mValid (true) {
 
-	if (ParameterServer::ReferenceCount == 0) {
+	if (RGAtomicGet (&ParameterServer::ReferenceCount) == 0) {
 
 		Changed = TRUE;
 		mStandardPositiveControlName = new RGString;
@@ -261,7 +261,7 @@ ParameterServer :: ParameterServer (const RGString& xmlString) : mValid (true) {
 		mSampleNonStandardStutterThresholds = new list<locusSpecificNonStandardStutterStruct*>;
 	}
 
-	ParameterServer::ReferenceCount++;
+	RGAtomicIncrement (&ParameterServer::ReferenceCount);
 
 	RGString XMLString (xmlString);
 	mSet = new GenotypeSet (xmlString, false);
@@ -302,9 +302,7 @@ ParameterServer :: ParameterServer (const RGString& xmlString) : mValid (true) {
 
 ParameterServer :: ~ParameterServer () {
 
-	ParameterServer::ReferenceCount--;
-
-	if (ReferenceCount <= 0) {
+	if (RGAtomicDecrement (&ParameterServer::ReferenceCount) <= 0) {
 
 		delete mSet;
 		delete LadderIDs;
@@ -357,7 +355,7 @@ void* ParameterServer :: operator new (size_t nbytes) {
 
 	void* p;
 	
-	if (ParameterServer::ReferenceCount > 0) {
+	if (RGAtomicGet (&ParameterServer::ReferenceCount) > 0) {
 		
 		return ParameterServer::OneAndOnlySelf;
 	}
@@ -370,7 +368,7 @@ void* ParameterServer :: operator new (size_t nbytes) {
 
 void ParameterServer :: operator delete (void* ptr) {
 
-	if (ParameterServer::ReferenceCount <= 0)
+	if (RGAtomicGet (&ParameterServer::ReferenceCount) <= 0)
 		free (ptr);
 }
 
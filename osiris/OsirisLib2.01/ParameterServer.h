@@ -58,6 +58,7 @@
 #include "RGLogBook.h"
 #include "SmartMessage.h"
 #include "BaseGenetics.h"
+#include "rgthread.h"
 //#include "rgparray.h"
 
 #include <list>
@@ -207,6 +208,8 @@ public:
 	void ReportIfChanged (RGTextOutput& text, const RGString& indent);
 
 	void WriteSettingsToDotOAR (RGLogBook& outputFile);
+	const RGString& GetLabSettingsString () const { return *mLabSettingsString; }
+	const RGString& GetStandardSettingsString () const { return *mStandardSettingsString; }
 
 	GenotypeSet* GetGenotypeCollection () { return mSet; }
 	RGString GetStandardPositiveControlName () const { return *mStandardPositiveControlName; }
@@ -265,8 +268,8 @@ public:
   static void UnescapeXML (RGString& target);
 
 protected:
-	static int ReferenceCount;
-	static ParameterServer* OneAndOnlySelf;
+	static volatile long ReferenceCount;	// atomic:  samples may be analyzed concurrently
+	static ParameterServer* OneAndOnlySelf;	// one per process, shared by every AnalysisContext
 
 	GenotypeSet* mSet;
 	bool mValid;
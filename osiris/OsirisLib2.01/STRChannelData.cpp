@@ -49,28 +49,28 @@
 #include "STRSmartNotices.h"
 
 
-bool STRChannelData::UseHermiteCubicSplineForNormalization = true;
-
-double STRLaneStandardChannelData::minLaneStandardRFU = 150.0;
-double STRLadderChannelData::minLadderRFU = 150.0;
-double STRLadderChannelData::minInterlocusRFU = 150;
-double STRSampleChannelData::minSampleRFU = 150.0;
-double STRSampleChannelData::minInterlocusRFU = 150;
-double STRSampleChannelData::sampleDetectionThreshold = 150.0;
-bool STRSampleChannelData::UseOldBaselineEstimation = false;
-double* STRSampleChannelData::ChannelSpecificMinRFU = NULL;
-double* STRSampleChannelData::ChannelSpecificDetectionThresholds = NULL;
-int* STRSampleChannelData::ChannelSpecificMinRFUOverrides = NULL;
-int* STRSampleChannelData::ChannelSpecificDetectionOverrides = NULL;
-
-double STRLaneStandardChannelData::maxLaneStandardRFU = -1.0;
-double STRLadderChannelData::maxLadderRFU = -1.0;
-double STRSampleChannelData::maxSampleRFU = -1.0;
-
-double STRLaneStandardChannelData::ILSStutterThreshold;
-double STRLaneStandardChannelData::ILSAdenylationThreshold;
-double STRLaneStandardChannelData::ILSFractionalFilter = -1.0;
-bool STRLaneStandardChannelData::TestIsOn = false;
+RGThreadStatic<bool> STRChannelData::UseHermiteCubicSplineForNormalization (true);
+
+RGThreadStatic<double> STRLaneStandardChannelData::minLaneStandardRFU (150.0);
+RGThreadStatic<double> STRLadderChannelData::minLadderRFU (150.0);
+RGThreadStatic<double> STRLadderChannelData::minInterlocusRFU (150);
+RGThreadStatic<double> STRSampleChannelData::minSampleRFU (150.0);
+RGThreadStatic<double> STRSampleChannelData::minInterlocusRFU (150);
+RGThreadStatic<double> STRSampleChannelData::sampleDetectionThreshold (150.0);
+RGThreadStatic<bool> STRSampleChannelData::UseOldBaselineEstimation (false);
+RGThreadStatic<double*> STRSampleChannelData::ChannelSpecificMinRFU (NULL);
+RGThreadStatic<double*> STRSampleChannelData::ChannelSpecificDetectionThresholds (NULL);
+RGThreadStatic<int*> STRSampleChannelData::ChannelSpecificMinRFUOverrides (NULL);
+RGThreadStatic<int*> STRSampleChannelData::ChannelSpecificDetectionOverrides (NULL);
+
+RGThreadStatic<double> STRLaneStandardChannelData::maxLaneStandardRFU (-1.0);
+RGThreadStatic<double> STRLadderChannelData::maxLadderRFU (-1.0);
+RGThreadStatic<double> STRSampleChannelData::maxSampleRFU (-1.0);
+
+RGThreadStatic<double> STRLaneStandardChannelData::ILSStutterThreshold;
+RGThreadStatic<double> STRLaneStandardChannelData::ILSAdenylationThreshold;
+RGThreadStatic<double> STRLaneStandardChannelData::ILSFractionalFilter (-1.0);
+RGThreadStatic<bool> STRLaneStandardChannelData::TestIsOn (false);
 
 
 PERSISTENT_DEFINITION (STRChannelData, _STRCHANNELDATA_, "STRChannelData")
@@ -3498,6 +3498,7 @@ bool STRLaneStandardChannelData :: AddILSToHistoryList () {
 		i++;
 	}
 
+	RGLock historyLock (LaneStandard::GetILSHistoryMutex ());
 	bool result = mLaneStandard->AddILSToHistory (times);
 	delete[] times;
 	return result;
@@ -3537,6 +3538,7 @@ ILSCandidate* STRLaneStandardChannelData :: TestILSStartAndEndSignals (DataSigna
 
 	// Now test that all the peaks are there, with the proper spacing...
 
+	RGLock historyLock (LaneStandard::GetILSHistoryMutex ());
 	mLaneStandard->ResetStartAndEndTimesForILSTests (startTime, endTime, startSignal);
 	possibleILSPeaks.Append (startSignal);
 	nextStartSignal = startSignal;
@@ -3588,6 +3590,7 @@ ILSCandidate* STRLaneStandardChannelData :: TestLadderILSStartAndEndSignals (Dat
 
 	// Now test that all the peaks are there, with the proper spacing...
 
+	RGLock historyLock (LaneStandard::GetILSHistoryMutex ());
 	mLaneStandard->ResetStartAndEndTimesForLadderILSTests (startTime, endTime, startSignal);
 	possibleILSPeaks.Append (startSignal);
 	nextStartSignal = startSignal;
@@ -152,7 +152,7 @@ protected:
 	double MinimumFractionOfAveragePeak;
 	double MaximumMultipleOfAveragePeak;
 
-	static bool UseHermiteCubicSplineForNormalization;
+	static RGThreadStatic<bool> UseHermiteCubicSplineForNormalization;
 };
 
 
@@ -274,12 +274,12 @@ protected:
 
 	//******************************************************************************************************************************************************************************
 
-	static double minLaneStandardRFU;
-	static double maxLaneStandardRFU;
-	static double ILSStutterThreshold;
-	static double ILSAdenylationThreshold;
-	static double ILSFractionalFilter;
-	static bool TestIsOn;
+	static RGThreadStatic<double> minLaneStandardRFU;
+	static RGThreadStatic<double> maxLaneStandardRFU;
+	static RGThreadStatic<double> ILSStutterThreshold;
+	static RGThreadStatic<double> ILSAdenylationThreshold;
+	static RGThreadStatic<double> ILSFractionalFilter;
+	static RGThreadStatic<bool> TestIsOn;
 };
 
 
@@ -343,9 +343,9 @@ public:
 	static double GetMinInterlocusRFU () { return minInterlocusRFU; }
 
 protected:
-	static double minLadderRFU;
-	static double maxLadderRFU;
-	static double minInterlocusRFU;
+	static RGThreadStatic<double> minLadderRFU;
+	static RGThreadStatic<double> maxLadderRFU;
+	static RGThreadStatic<double> minInterlocusRFU;
 };
 
 
@@ -449,15 +449,15 @@ public:
 
 protected:
 	list<ProspectiveIntervalForNormalization*> mProspectiveList;
-	static double minSampleRFU;
-	static double maxSampleRFU;
-	static double minInterlocusRFU;
-	static double sampleDetectionThreshold;
-	static bool UseOldBaselineEstimation;
-	static double* ChannelSpecificMinRFU;
-	static double* ChannelSpecificDetectionThresholds;
-	static int* ChannelSpecificMinRFUOverrides;
-	static int* ChannelSpecificDetectionOverrides;
+	static RGThreadStatic<double> minSampleRFU;
+	static RGThreadStatic<double> maxSampleRFU;
+	static RGThreadStatic<double> minInterlocusRFU;
+	static RGThreadStatic<double> sampleDetectionThreshold;
+	static RGThreadStatic<bool> UseOldBaselineEstimation;
+	static RGThreadStatic<double*> ChannelSpecificMinRFU;
+	static RGThreadStatic<double*> ChannelSpecificDetectionThresholds;
+	static RGThreadStatic<int*> ChannelSpecificMinRFUOverrides;
+	static RGThreadStatic<int*> ChannelSpecificDetectionOverrides;
 
 	bool FindNextFitDataIntervalBelowThreshold (double threshold, int start, int end, int& beginInterval, int& endInterval, DataSignal* fitData);
 	bool FindNextFitDataIntervalBelowThreshold (double threshold, int start, int end, int& beginInterval, int& endInterval, DataSignal* fitData, DataSignal* fitNegData);
@@ -2167,7 +2167,9 @@ int STRLaneStandardChannelData :: AnalyzeLaneStandardChannelRecursivelyUsingDens
 
 	else if (useStartAndEndPointsForLadders) {
 
+		LaneStandard::GetILSHistoryMutex ().Lock ();
 		mLaneStandard->ResetIdealCharacteristicsAndIntervalsForLadderILS (altSpacing, NULL, LatitudeFactorForLadderILS);  // later, replace 0.02 with user specified factor
+		LaneStandard::GetILSHistoryMutex ().Unlock ();
 		cout << "Attempting to use Ladder ILS End Point Algorithm...\n";
 
 		if (TestAllLadderILSStartAndEndSignals (ilsHistoryList, correlation)) {
@@ -3259,6 +3261,7 @@ int STRLaneStandardChannelData :: FitAllNegativeCharacteristicsSM (RGTextOutput&
 			negArray [i] = -negArray [i];
 	}
 
+	negativePeaks->InvalidateMomentTables ();
 	negativePeaks->ResetCharacteristicsFromRight (trace, text, detectionRFU, print);
 
 	Endl endLine;
@@ -3298,6 +3301,7 @@ int STRLaneStandardChannelData :: FitAllNegativeCharacteristicsSM (RGTextOutput&
 	if (prevSignal == NULL) {
 
 		delete signature;
+		delete negativePeaks;
 		return 0;
 	}
 
@@ -3379,6 +3383,7 @@ int STRLaneStandardChannelData :: FitAllNegativeCharacteristicsSM (RGTextOutput&
 	//cout << "Done testing 'too close'" << endl;
 
 	delete signature;
+	delete negativePeaks;
 //	ProjectNeighboringSignalsAndTest (1.0, 1.0);
 	return 0;
 }
@@ -5574,6 +5579,7 @@ int STRSampleChannelData :: FitAllNegativeCharacteristicsSM (RGTextOutput& text,
 			negArray [i] = -negArray [i];
 	}
 
+	negativePeaks->InvalidateMomentTables ();
 	negativePeaks->ResetCharacteristicsFromRight (trace, text, detectionRFU, print);
 
 	Endl endLine;
@@ -5619,6 +5625,7 @@ int STRSampleChannelData :: FitAllNegativeCharacteristicsSM (RGTextOutput& text,
 	if (prevSignal == NULL) {
 
 		delete signature;
+		delete negativePeaks;
 		return 0;
 	}
 
@@ -5700,6 +5707,7 @@ int STRSampleChannelData :: FitAllNegativeCharacteristicsSM (RGTextOutput& text,
 	//cout << "Done testing 'too close'" << endl;
 
 	delete signature;
+	delete negativePeaks;
 //	ProjectNeighboringSignalsAndTest (1.0, 1.0);
 	return 0;
 }
@@ -6421,6 +6429,8 @@ int STRSampleChannelData :: AnalyzeDynamicBaselineAndNormalizeRawDataSM (int sta
 		dynamicBaseline = mBaseLine->EvaluateSequenceNext ();
 	}
 
+	((SampledData*)mData)->InvalidateMomentTables ();
+
 	//cout << "Normalization successful" << endl;
 	return 1;
 }
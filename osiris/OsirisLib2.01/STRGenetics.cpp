@@ -141,7 +141,7 @@ void STRBaseAllele :: SaveAll (RGVOutStream& f) const {
 
 
 STRBaseLocus :: STRBaseLocus () : BaseLocus (), MinimumBP (-1), MaximumBP (-1), LowerBoundGridLSIndex (-1.0),
-UpperBoundGridLSIndex (-1.0), MinimumGridTime (-1.0), MaximumGridTime (-1.0), CoreRepeatNumber (4),
+UpperBoundGridLSIndex (-1.0), CoreRepeatNumber (4),
 LowerBoundGridLSBasePair (-1.0), UpperBoundGridLSBasePair (-1.0), mNoExtension (false), mStutter0 (-1.0), mStutterBasePair0 (-1.0), mStutterSlope (-1.0), mPlusStutter0 (-1.0), mPlusStutterBasePair0 (-1.0), mPlusStutterSlope (-1.0) {
 
 	//mSampleLocusSpecificStutterThreshold = Locus::GetSampleStutterThreshold ();
@@ -163,7 +163,7 @@ LowerBoundGridLSBasePair (-1.0), UpperBoundGridLSBasePair (-1.0), mNoExtension (
 
 
 STRBaseLocus :: STRBaseLocus (const RGString& xmlInput) : BaseLocus (xmlInput), LowerBoundGridLSIndex (-1.0),
-UpperBoundGridLSIndex (-1.0), MinimumGridTime (-1.0), MaximumGridTime (-1.0), LowerBoundGridLSBasePair (-1.0), 
+UpperBoundGridLSIndex (-1.0), LowerBoundGridLSBasePair (-1.0), 
 UpperBoundGridLSBasePair (-1.0), mNoExtension (false), mStutter0 (-1.0), mStutterBasePair0 (-1.0), mStutterSlope (-1.0), mPlusStutter0 (-1.0), mPlusStutterBasePair0 (-1.0), mPlusStutterSlope (-1.0) {
 
 	mSampleLocusSpecificStutterThreshold = Locus::GetSampleStutterThreshold ();
@@ -416,6 +416,8 @@ Boolean STRBaseLocus :: ExtractGridSignals (RGDList& channelSignalList, const La
 	int i2;
 	double c1;
 	double c2;
+	double minimumGridTime;	// not members:  ladders fitted concurrently share the base locus
+	double maximumGridTime;
 	Notice* newNotice;
 
 	if (lsSize < 0) {
@@ -439,13 +441,13 @@ Boolean STRBaseLocus :: ExtractGridSignals (RGDList& channelSignalList, const La
 		i2 = i1 + 1;
 		c2 = LowerBoundGridLSIndex - i1;
 		c1 = 1.0 - c2;
-		MinimumGridTime = c1 * ls->GetLaneStandardTimeForCharacteristicNumber (i1) + 
+		minimumGridTime = c1 * ls->GetLaneStandardTimeForCharacteristicNumber (i1) + 
 			c2 * ls->GetLaneStandardTimeForCharacteristicNumber (i2);
 //		cout << "Not using base pairs for minimum of locus " << LocusName << endl;
 	}
 
 	else
-		MinimumGridTime = lsData->GetTimeForSpecifiedID (LowerBoundGridLSBasePair);
+		minimumGridTime = lsData->GetTimeForSpecifiedID (LowerBoundGridLSBasePair);
 
 	if (UpperBoundGridLSBasePair < 0.0) {
 
@@ -460,13 +462,13 @@ Boolean STRBaseLocus :: ExtractGridSignals (RGDList& channelSignalList, const La
 		i2 = i1 + 1;
 		c2 = UpperBoundGridLSIndex - i1;
 		c1 = 1.0 - c2;
-		MaximumGridTime = c1 * ls->GetLaneStandardTimeForCharacteristicNumber (i1) + 
+		maximumGridTime = c1 * ls->GetLaneStandardTimeForCharacteristicNumber (i1) + 
 			c2 * ls->GetLaneStandardTimeForCharacteristicNumber (i2);
 //		cout << "Not using base pairs for maximum of locus " << LocusName << endl;
 	}
 
 	else
-		MaximumGridTime = lsData->GetTimeForSpecifiedID (UpperBoundGridLSBasePair);
+		maximumGridTime = lsData->GetTimeForSpecifiedID (UpperBoundGridLSBasePair);
 
 	RGDListIterator it (channelSignalList);
 	DataSignal* nextSignal;
@@ -479,9 +481,9 @@ Boolean STRBaseLocus :: ExtractGridSignals (RGDList& channelSignalList, const La
 
 		nextMean = nextSignal->GetMean ();
 
-		if (nextMean >= MinimumGridTime) {
+		if (nextMean >= minimumGridTime) {
 
-			if (nextMean <= MaximumGridTime) {
+			if (nextMean <= maximumGridTime) {
 
 				it.RemoveCurrentItem ();
 				locusDataSignalList.Append (nextSignal);
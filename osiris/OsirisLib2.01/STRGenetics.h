@@ -155,8 +155,6 @@ protected:
 	int MaximumBP;  // Maximum allele found associated with locus
 	double LowerBoundGridLSIndex;  // Minimum index (or fraction) in Internal Lane Standard to bound ladder alleles
 	double UpperBoundGridLSIndex;  // Maximum index (or fraction) in Internal Lane Standard to bound ladder alleles
-	double MinimumGridTime;
-	double MaximumGridTime;
 	int CoreRepeatNumber;
 	double LowerBoundGridLSBasePair;
 	double UpperBoundGridLSBasePair;
@@ -59,6 +59,8 @@ Boolean STRBaseLocus :: ExtractGridSignalsSM (RGDList& channelSignalList, const
 	int i2;
 	double c1;
 	double c2;
+	double minimumGridTime;	// not members:  ladders fitted concurrently share the base locus
+	double maximumGridTime;
 
 	smNPeaksForLocusUnavailable nPeaksUnavailableForLocus;
 	smLocusTooFewPeaks locusHasTooFewPeaks;
@@ -85,13 +87,13 @@ Boolean STRBaseLocus :: ExtractGridSignalsSM (RGDList& channelSignalList, const
 		i2 = i1 + 1;
 		c2 = LowerBoundGridLSIndex - i1;
 		c1 = 1.0 - c2;
-		MinimumGridTime = c1 * ls->GetLaneStandardTimeForCharacteristicNumber (i1) + 
+		minimumGridTime = c1 * ls->GetLaneStandardTimeForCharacteristicNumber (i1) + 
 			c2 * ls->GetLaneStandardTimeForCharacteristicNumber (i2);
 //		cout << "Not using base pairs for minimum of locus " << LocusName << endl;
 	}
 
 	else
-		MinimumGridTime = lsData->GetTimeForSpecifiedID (LowerBoundGridLSBasePair);
+		minimumGridTime = lsData->GetTimeForSpecifiedID (LowerBoundGridLSBasePair);
 
 	if (UpperBoundGridLSBasePair < 0.0) {
 
@@ -106,13 +108,13 @@ Boolean STRBaseLocus :: ExtractGridSignalsSM (RGDList& channelSignalList, const
 		i2 = i1 + 1;
 		c2 = UpperBoundGridLSIndex - i1;
 		c1 = 1.0 - c2;
-		MaximumGridTime = c1 * ls->GetLaneStandardTimeForCharacteristicNumber (i1) + 
+		maximumGridTime = c1 * ls->GetLaneStandardTimeForCharacteristicNumber (i1) + 
 			c2 * ls->GetLaneStandardTimeForCharacteristicNumber (i2);
 //		cout << "Not using base pairs for maximum of locus " << LocusName << endl;
 	}
 
 	else
-		MaximumGridTime = lsData->GetTimeForSpecifiedID (UpperBoundGridLSBasePair);
+		maximumGridTime = lsData->GetTimeForSpecifiedID (UpperBoundGridLSBasePair);
 
 	RGDListIterator it (channelSignalList);
 	DataSignal* nextSignal;
@@ -125,9 +127,9 @@ Boolean STRBaseLocus :: ExtractGridSignalsSM (RGDList& channelSignalList, const
 
 		nextMean = nextSignal->GetMean ();
 
-		if (nextMean >= MinimumGridTime) {
+		if (nextMean >= minimumGridTime) {
 
-			if (nextMean <= MaximumGridTime) {
+			if (nextMean <= maximumGridTime) {
 
 	//			it.RemoveCurrentItem ();
 				locusDataSignalList.Append (nextSignal);
@@ -53,6 +53,8 @@
 #include "xmlwriter.h"
 #include "SmartMessage.h"
 #include "SmartNotice.h"
+#include "rgthread.h"
+#include "SampleResultCache.h"
 #include <list>
 #include <iostream>
 #include <time.h>
@@ -64,7 +66,10 @@ bool* STRLCAnalysis::InitialMatrix = NULL;
 RGString STRLCAnalysis::OverrideString;
 RGString STRLCAnalysis::OutputSubDirectory;
 RGString STRLCAnalysis::MsgBookBuildTime;
-bool STRLCAnalysis::CollectILSHistory = false;
+RGThreadStatic<bool> STRLCAnalysis::CollectILSHistory (false);
+RGThreadStatic<int> STRLCAnalysis::NumberOfAnalysisThreads (0);
+RGThreadStatic<bool> STRLCAnalysis::IncrementalAnalysis (false);
+RGThreadStatic<bool> STRLCAnalysis::ResumeAnalysis (false);
 
 
 PERSISTENT_DEFINITION (STRLCAnalysis, _STRLCANALYSIS_, "STRLCAnalysis")
@@ -86,7 +91,7 @@ bool DoesStringContainOneOfSubset (const RGString& target, RGDList& subset) {
 }
 
 
-STRLCAnalysis :: STRLCAnalysis () : SmartMessagingObject (), WorkingFile (NULL), mCollection (NULL) {
+STRLCAnalysis :: STRLCAnalysis () : SmartMessagingObject (), mCollection (NULL), WorkingFile (NULL), mProgress (NULL) {
 
 	InitializeSmartMessages ();
 	mValid = false;
@@ -94,7 +99,7 @@ STRLCAnalysis :: STRLCAnalysis () : SmartMessagingObject (), WorkingFile (NULL),
 
 
 STRLCAnalysis :: STRLCAnalysis (PopulationCollection* collection, const RGString& parentDirectoryForReports, const RGString& messageBookPath) :
-SmartMessagingObject (), mCollection (collection), mParentDirectoryForReports (parentDirectoryForReports), WorkingFile (NULL) {
+SmartMessagingObject (), mCollection (collection), mParentDirectoryForReports (parentDirectoryForReports), WorkingFile (NULL), mProgress (NULL) {
 
 	RGString MessageBookName = messageBookPath + "/OsirisMessageBook2.xml";
 	RGFile messages (MessageBookName, "rt");
@@ -123,6 +128,7 @@ SmartMessagingObject (), mCollection (collection), mParentDirectoryForReports (p
 	}
 
 	InitializeSmartMessages ();
+	mAnalysisContext.Capture ();
 	mValid = true;
 }
 
@@ -1958,8 +1964,42 @@ int STRLCAnalysis :: NumberOfNoticeObjects () {
 
 void STRLCAnalysis :: SetTableLink (int linkNumber) {
 
-	RGString temp;
-	temp.Convert (linkNumber, 10);
-	mTableLink = "&" + temp + "&";
+	mTableLink = "&" + SampleResultCache::FormatLinkNumber (linkNumber) + "&";
+}
+
+
+int STRLCAnalysis :: GetNumberOfAnalysisThreads (int nJobs) {
+
+	int nThreads = NumberOfAnalysisThreads;
+
+	if (nThreads <= 0)
+		nThreads = RGThread::GetNumberOfProcessors ();
+
+	if (nThreads > nJobs)
+		nThreads = nJobs;
+
+	if (nThreads < 1)
+		nThreads = 1;
+
+	return nThreads;
+}
+
+
+int STRLCAnalysis :: GetNumberOfChannelThreads (int nAnalysisThreads) {
+
+	//  threads not needed to analyze whole ladders or samples are used to fit their channels
+
+	int nThreads = NumberOfAnalysisThreads;
+
+	if (nThreads <= 0)
+		nThreads = RGThread::GetNumberOfProcessors ();
+
+	if (nAnalysisThreads > 1)
+		nThreads /= nAnalysisThreads;
+
+	if (nThreads < 1)
+		nThreads = 1;
+
+	return nThreads;
 }
 
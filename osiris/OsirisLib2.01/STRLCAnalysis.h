@@ -40,6 +40,7 @@
 #include "Notice.h"
 #include "rgpersist.h"
 #include "SmartMessagingObject.h"
+#include "AnalysisContext.h"
 
 #include <string>
 #include <math.h>
@@ -49,12 +50,26 @@ using namespace std;
 
 class SmartMessage;
 class SmartNotice;
+struct SampleAnalysisJob;
+struct SampleAnalysisContext;
 
 const int _STRLCANALYSIS_ = 1507;
 
 PERSISTENT_PREDECLARATION (STRLCAnalysis)
 
 
+class AnalysisProgress {	// told of the progress of analyses as they are reported
+
+public:
+	AnalysisProgress () {}
+	virtual ~AnalysisProgress () {}
+
+	virtual void ReportProgress (const RGString& inputDirectory, double percentComplete) = 0;
+	virtual void ReportRunComplete (const RGString& inputDirectory, const RGString& reportDirectory, int status) = 0;
+};
+
+
+
 class STRLCAnalysis : public SmartMessagingObject {
 
 	PERSISTENT_DECLARATION (STRLCAnalysis)
@@ -65,6 +80,7 @@ public:
 	STRLCAnalysis (PopulationCollection* collection, const RGString& parentDirectoryForReports, const RGString& messageBookPath, bool isSmartMsgAnalysis);  // Smart message constructor
 	STRLCAnalysis (const RGString& ladderInformationDirectory, const RGString& markerSetName, const RGString& parentDirectoryForReports, const RGString& messageBookPath, bool isSmartMsgAnalysis);  // Smart message constructor2
 	STRLCAnalysis (const RGString& ladderInformationDirectory, const RGString& markerSetName, const RGString& parentDirectoryForReports, const RGString& messageBookPath, bool isSmartMsgAnalysis, bool isFileInput);  // Smart message constructor3
+	STRLCAnalysis (const STRLCAnalysis& loaded, const RGString& parentDirectoryForReports);  // shares the kit, message book and settings loaded by another analysis
 	virtual ~STRLCAnalysis ();
 
 	// Non-message functions***************************************************************************************************************************
@@ -74,6 +90,10 @@ public:
 	void SetXMLCommandLineString (const RGString& cmdString) { mCommandLineString = cmdString; }
 	void SetTableLink (int linkNumber);
 
+	const AnalysisContext& GetAnalysisContext () const { return mAnalysisContext; }	// the settings in effect when this was constructed
+	void SetAnalysisContext (const AnalysisContext& context) { mAnalysisContext = context; }
+	void SetProgress (AnalysisProgress* progress) { mProgress = progress; }	// NULL if progress is only written to cout
+
 	static void SetMaximumNumberOfChannels (int maxChannels) { mMaximumNumberOfChannels = maxChannels; }
 	static int GetMaximumNumberOfChannels () { return mMaximumNumberOfChannels; }
 
@@ -101,7 +121,18 @@ public:
 	int AnalyzeIncrementallySM (const RGString& prototypeInputDirectory, const RGString& markerSet, int outputLevel, const RGString& graphicsDirectory, const RGString& commandInputs);
 	int AnalyzeIncrementallySMLF (const RGString& prototypeInputDirectory, const RGString& markerSet, int outputLevel, const RGString& graphicsDirectory, const RGString& commandInputs);
 
+	int ProcessSampleJobsSM (SampleAnalysisContext& context);	// analyzes and reports samples from the context queue until none remain
+	void AnalyzeSampleSM (SampleAnalysisJob& job, SampleAnalysisContext& context);
+	void ReportSampleSM (SampleAnalysisJob& job, SampleAnalysisContext& context);	// must be called in sample order
+	void ReportSampleResultSM (SampleAnalysisJob& job, SampleAnalysisContext& context);	// reports the job's result, renumbered, in its place
+	void GetSharedObjectsSM (const SampleAnalysisContext& context, vector<SmartMessagingObject*>& sharedObjects);	// whose triggers are saved with results
+
+	int ProcessLadderJobsSM (SampleAnalysisContext& context);	// fits and reports ladders from the context queue until none remain
+	void AnalyzeLadderSM (SampleAnalysisJob& job, SampleAnalysisContext& context);
+	void ReportLadderSM (SampleAnalysisJob& job, SampleAnalysisContext& context);	// must be called in ladder order
+
 	int GetObjectScope () const { return 6; }
+	bool IsSharedBetweenSamples () const { return true; }
 
 	bool EvaluateSmartMessagesForStage (int stage);
 	bool EvaluateSmartMessagesForStage (SmartMessagingComm& comm, int numHigherObjects, int stage);
@@ -110,7 +141,7 @@ public:
 	bool EvaluateAllReports (bool* const reportMatrix);
 	bool TestAllMessagesForCall ();
 	bool EvaluateAllReportLevels (int* const reportLevelMatrix);
-	int NumberOfSmartNoticeObjects () const { return mSmartMessageReporters->Entries (); }
+	int NumberOfSmartNoticeObjects () const { return (mSmartMessageReporters != NULL) ? mSmartMessageReporters->Entries () : 0; }
 
 	virtual void OutputDebugID (SmartMessagingComm& comm, int numHigherObjects);
 	virtual int AddAllSmartMessageReporters ();
@@ -136,6 +167,16 @@ public:
 	static RGString GetOutputSubDirectory () { return OutputSubDirectory; }
 	static void SetCollectILSHistory (bool s) { CollectILSHistory = s; }
 
+	static void SetNumberOfAnalysisThreads (int n) { NumberOfAnalysisThreads = n; }
+	static int GetNumberOfAnalysisThreads () { return NumberOfAnalysisThreads; }
+	static int GetNumberOfAnalysisThreads (int nJobs);	// number of threads to use for nJobs jobs
+	static int GetNumberOfChannelThreads (int nAnalysisThreads);	// number of threads to fit the channels of each job
+
+	static void SetIncrementalAnalysis (bool s) { IncrementalAnalysis = s; }
+	static bool GetIncrementalAnalysis () { return IncrementalAnalysis; }
+	static void SetResumeAnalysis (bool s) { ResumeAnalysis = s; }
+	static bool GetResumeAnalysis () { return ResumeAnalysis; }
+
 protected:
 	PopulationCollection* mCollection;
 	RGString mParentDirectoryForReports;
@@ -152,6 +193,8 @@ protected:
 	RGString WorkingFileName;
 	RGFile* WorkingFile;
 	RGDList mBaseLocusList;	// This is the list of BaseLoci - the directory level equivalent of Locus links
+	AnalysisContext mAnalysisContext;	// made current on every thread that analyzes this directory
+	AnalysisProgress* mProgress;
 
 	// Smart Message Data*****************************************************************************************************************
 	//************************************************************************************************************************************
@@ -172,7 +215,10 @@ protected:
 	static RGString OverrideString;
 	static RGString OutputSubDirectory;
 	static RGString MsgBookBuildTime;
-	static bool CollectILSHistory;
+	static RGThreadStatic<bool> CollectILSHistory;
+	static RGThreadStatic<int> NumberOfAnalysisThreads;	// 0 means one per processor
+	static RGThreadStatic<bool> IncrementalAnalysis;	// reuse the saved results of unchanged samples
+	static RGThreadStatic<bool> ResumeAnalysis;	// reuse the results saved by an analysis that did not finish
 };
 
 
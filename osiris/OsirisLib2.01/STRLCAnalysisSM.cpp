@@ -61,6 +61,9 @@
 #include "OsirisVersion.h"
 #include "TracePrequalification.h"
 #include "LeastMedianOfSquares.h"
+#include "SampleAnalysisQueue.h"
+#include "SampleResultCache.h"
+#include "rgarena.h"
 #include <list>
 #include <iostream>
 #include <time.h>
@@ -72,7 +75,7 @@ using namespace std;
 
 
 STRLCAnalysis :: STRLCAnalysis (PopulationCollection* collection, const RGString& parentDirectoryForReports, const RGString& messageBookPath, bool isSmartMsgAnalysis) :
-SmartMessagingObject (), mCollection (collection), mParentDirectoryForReports (parentDirectoryForReports), WorkingFile (NULL) {
+SmartMessagingObject (), mCollection (collection), mParentDirectoryForReports (parentDirectoryForReports), WorkingFile (NULL), mProgress (NULL) {
 
 	RGString MessageBookName;
 	mValid = false;
@@ -128,12 +131,13 @@ SmartMessagingObject (), mCollection (collection), mParentDirectoryForReports (p
 	}
 
 	InitializeSmartMessages ();
+	mAnalysisContext.Capture ();
 	mValid = true;
 }
 
 
 STRLCAnalysis :: STRLCAnalysis (const RGString& ladderInformationDirectory, const RGString& markerSetName, const RGString& parentDirectoryForReports, const RGString& messageBookPath, bool isSmartMsgAnalysis) :
-SmartMessagingObject (), mCollection (NULL), mParentDirectoryForReports (parentDirectoryForReports), WorkingFile (NULL) {
+SmartMessagingObject (), mCollection (NULL), mParentDirectoryForReports (parentDirectoryForReports), WorkingFile (NULL), mProgress (NULL) {
 
 	RGString MessageBookName;
 	mValid = false;
@@ -203,12 +207,13 @@ SmartMessagingObject (), mCollection (NULL), mParentDirectoryForReports (parentD
 	}
 
 	InitializeSmartMessages ();
+	mAnalysisContext.Capture ();
 	mValid = true;
 }
 
 
 STRLCAnalysis :: STRLCAnalysis (const RGString& ladderInformationDirectory, const RGString& markerSetName, const RGString& parentDirectoryForReports, const RGString& messageBookPath, bool isSmartMsgAnalysis, bool isFileInput) :
-SmartMessagingObject (), mCollection (NULL), mParentDirectoryForReports (parentDirectoryForReports), WorkingFile (NULL) {
+SmartMessagingObject (), mCollection (NULL), mParentDirectoryForReports (parentDirectoryForReports), WorkingFile (NULL), mProgress (NULL) {
 
 	RGString MessageBookName;
 	mValid = false;
@@ -287,12 +292,31 @@ SmartMessagingObject (), mCollection (NULL), mParentDirectoryForReports (parentD
 	}
 
 	InitializeSmartMessages ();
+	mAnalysisContext.Capture ();
 	mValid = true;
 }
 
 
+STRLCAnalysis :: STRLCAnalysis (const STRLCAnalysis& loaded, const RGString& parentDirectoryForReports) :
+SmartMessagingObject (), mCollection (loaded.mCollection), mParentDirectoryForReports (parentDirectoryForReports),
+mMessageBookName (loaded.mMessageBookName), WorkingFile (NULL), mAnalysisContext (loaded.mAnalysisContext), mProgress (NULL) {
+
+	//  The collection and message book remain owned by loaded, which must outlive this
+
+	PreInitializeSmartMessages ();
+	InitializeSmartMessages ();
+	mValid = loaded.mValid;
+}
+
+
 int STRLCAnalysis :: AnalyzeIncrementallySM (const RGString& prototypeInputDirectory, const RGString& markerSet, int outputLevel, const RGString& graphicsDirectory, const RGString& commandInputs) {
 
+	AnalysisContextScope settings (mAnalysisContext);	// this analysis's settings, whatever other analyses have set
+	ILSHistory ilsHistory;
+	ILSHistory ladderILSHistory;
+	LaneStandard::SetILSHistories (ilsHistory, ladderILSHistory);
+	NoticeNumbers noticeNumbers;
+	Notice::SetNoticeNumbers (noticeNumbers);
 	Boolean print = TRUE;
 	smDefaultsAreOverridden defaultsAreOverridden;
 	smUseSampleNamesForControlSampleTestsPreset useSampleNamesForControlSampleTests;
@@ -528,26 +552,17 @@ int STRLCAnalysis :: AnalyzeIncrementallySM (const RGString& prototypeInputDirec
 	int ChannelNumber = 1;
 	SampleDirectory->Initialize ();
 	int NSampleFiles = SampleDirectory->GetNumberOfFilesInDirectory ();
-	double Progress;
 	int SamplesProcessed = 0;
 
 	TestCharacteristic* testPeak = new STRTestControlCharacteristic ();
 	testPeak->SetTestForNegative (TestCharacteristic::GetGlobalTestForNegative ());
-	RGString LaneNumber;
-	RGString StartDate;
-	RGString StartTime;
 	RGString Extension;
 	int NumFiles = 0;
 	RGString FileNumber;
-	int NSamples;
-	int status;
-	RGString CurrentMarkerSet;
 
-	CoreBioComponent* bioComponent;
 	CoreBioComponent* ladderBioComponent;
 
 	RGString FileName;
-	RGString FullPathName;  // = DirectoryName + "/" + FileName;
 //	int length;
 	fsaFileData* data;
 	pServer->SetDoubleGaussianSigmaRatio (4.0);
@@ -878,11 +893,9 @@ int STRLCAnalysis :: AnalyzeIncrementallySM (const RGString& prototypeInputDirec
 
 	PlotString << xmlwriter::EscAscii (pServer->GetStandardPositiveControlName (), &pResult) << "</StdPosControlName>\n\t</parameters>\n";
 
-	RGString stringData;
 
 	testPeak->Report (ExcelText, "", "\t");
 
-	int NChannels;
 
 	Boolean cycled;
 	RGString LadderFileName;
@@ -905,10 +918,7 @@ int STRLCAnalysis :: AnalyzeIncrementallySM (const RGString& prototypeInputDirec
 	cout << "Ready to read ladders..." << endl;
 	cycled = FALSE;
 	RGString NoticeStr;
-	RGTextOutput* SampleOutput;
-	RGString FitDataName;
 //	RGString OsirisGraphics (graphicsDirectory);
-	bool ladderOK;
 	bool hasPosControl = false;
 	bool hasNegControl = false;
 	bool foundALadder = true;
@@ -984,7 +994,6 @@ int STRLCAnalysis :: AnalyzeIncrementallySM (const RGString& prototypeInputDirec
 	else
 		cout << "Not using End Point Algorithm for Ladder ILS Analysis...\n";
 
-	bool ignoreNoise;
 
 	//if (OsirisGraphics.GetLastCharacter () != '/')
 	//	OsirisGraphics += "/";
@@ -997,7 +1006,6 @@ int STRLCAnalysis :: AnalyzeIncrementallySM (const RGString& prototypeInputDirec
 
 //	RGString GraphicsDirectory = OsirisGraphics + OutputDirectoryBase;
 	RGString GraphicsDirectory = FullPathForReports;
-	RGString idString;
 
 	cout << "Expected dye names:  ";
 
@@ -1017,8 +1025,6 @@ int STRLCAnalysis :: AnalyzeIncrementallySM (const RGString& prototypeInputDirec
 	SmartMessagingComm commSM;
 	commSM.SMOStack [0] = (SmartMessagingObject*) this;
 	int numHigherObjects = 2;
-	bool isFirstLadder = true;
-	RGString ABIModelNumber;
 	int nLadders = 0;
 	//ChannelData::SetTestForDualSignal (false);
 	ChannelData::SetTestForDualSignal (true);    // 01/24/2017 This is a test because ladders are missing split peaks that should not be missed.  It used to be set to true.
@@ -1042,274 +1048,133 @@ int STRLCAnalysis :: AnalyzeIncrementallySM (const RGString& prototypeInputDirec
 	else
 		cout << "\n";
 
-	RGString commentField;
-
-	while (SampleDirectory->GetNextLadderFile (LadderFileName, cycled) && !cycled) {
-
-		FullPathName = DirectoryName + "/" + LadderFileName;
-		cout << "Found ladder name " << (char*)FullPathName.GetData () << endl;
-		nLadders++;
-
-		if (WorkingFile != NULL) {
-
-			WorkingFile->Write (FullPathName + "\n");
-			WorkingFile->Flush ();
-		}
-
-		data = new fsaFileData (FullPathName);
-		NumFiles++;
-		ladderOK = true;
-		//cout << "Beginning file:  " << NumFiles << endl;
-
-		if (!data->IsValid ()) {
-
-			NoticeStr << "Oops, " << LadderFileName.GetData () << " is not valid...Skipping";
-			cout << NoticeStr << endl;
-			NoticeStr << "\n";
-			ExcelText.Write (1, NoticeStr);
-			text << NoticeStr;
-			delete data;
-			continue;
-		}
-
-		ExcelText.SetOutputLevel (1);
-		text << endLine << endLine;
-		ExcelText << endLine << endLine;
-
-		text << "File Name:" << endLine;
-		text << "    " << LadderFileName.GetData () << endLine;
-
-		ExcelText << "File Name:" << endLine;
-		ExcelText << "    " << LadderFileName.GetData () << endLine;
-
-		stringData = data->GetInstrumentModelNumber ();
-		text << "ABI model number:  " << stringData << endLine;
-		ExcelText << "ABI model number:  " << stringData << endLine;
-		ABIModelNumber = stringData;
-
-		stringData = data->GetInstrumentName ();
-		text << "Instrument Name:  " << stringData << endLine;
-		ExcelText << "Instrument Name:  " << stringData << endLine;
-
-		NChannels = data->GetNumberOfDataChannels ();
-		text << "Number of channels of data = " << NChannels << endLine;
-		ExcelText << "Number of channels of data = " << NChannels << endLine;
-
-		stringData = data->GetDyeSetName ();
-		text << "Dye set name:  " << stringData << endLine;
-		ExcelText << "Dye set name:  " << stringData << endLine;
-
-		if (expectedNumberOfChannels > NChannels) {
-
-			cout << "MARKERSET MISMATCH...EXPECTING " << expectedNumberOfChannels << " CHANNELS AND FILE CONTAINS " << NChannels << " CHANNELS" << endl;
-			cout << "ENDING..." << endl;
-
-			text << "MARKERSET MISMATCH...EXPECTING " << expectedNumberOfChannels << " CHANNELS AND FILE CONTAINS " << NChannels << " CHANNELS" << endLine;
-			text << "ENDING..." << endLine;
-
-			ExcelText << "MARKERSET MISMATCH...EXPECTING " << expectedNumberOfChannels << " CHANNELS AND FILE CONTAINS " << NChannels << " CHANNELS" << endLine;
-			ExcelText << "ENDING..." << endLine;
-
-			XMLExcelLinks << CLevel (1) << "\t\t<Sample>\n\t\t\t<Name>Marker Set Mismatch</Name>\n\t\t\t<Type></Type>\n\t\t</Sample>\n" << PLevel ();
-			XMLExcelLinks << CLevel (1) << "\t</Table>\n" << PLevel ();
-			XMLExcelLinks << CLevel (1) << "</OsirisAnalysisReport>" << endLine << PLevel ();
-			return -150;
-		}
-
-		for (i=1; i<=expectedNumberOfChannels; i++) {
-
-			stringData = data->GetDyeNameForDataChannel (i);
-			text << "Dye name for channel " << i << ":  " << stringData << endLine;
-			ExcelText << "Dye name for channel " << i << ":  " << stringData << endLine;
-		}
-
-		StartDate = data->GetCollectionStartDate ();
-		StartTime = data->GetCollectionStartTime ();
-		LaneNumber = data->GetCapillaryNumber ();
-
-		text << "Start date for data collection:  " << StartDate << endLine;
-		text << "Start time for data collection:  " << StartTime << endLine;
-		text << "Lane number for sample:  " << LaneNumber << endLine;
-
-		ExcelText << "Start date for data collection:  " << StartDate << endLine;
-		ExcelText << "Start time for data collection:  " << StartTime << endLine;
-		ExcelText << "Lane number for sample:  " << LaneNumber << endLine;
-
-		NSamples = data->GetNumberOfDataElementsForDataChannel (expectedNumberOfChannels);
-		text << "Number of samples for data channel " << expectedNumberOfChannels << ":  " << NSamples << endLine;
-		ExcelText << "Number of samples for data channel " << expectedNumberOfChannels << ":  " << NSamples << endLine;
-		ExcelText.ResetOutputLevel ();
-
-		ladderBioComponent = new STRLadderCoreBioComponent (data->GetName ());
-		ladderBioComponent->SetSampleName (data->GetSampleName ());
-		ladderBioComponent->SetFileName (LadderFileName);
-		commSM.SMOStack [1] = (SmartMessagingObject*) ladderBioComponent;
-		ladderBioComponent->SetMessageValue (sampleIsLadder, true);
-
-		if (isFirstLadder) {
-
-			isFirstLadder = false;
-			ladderBioComponent->ReevaluateNoiseThresholdBasedOnMachineType (ABIModelNumber);
-		}
-
-		commentField = data->GetComment ();
-		ladderBioComponent->SetComments (commentField);
-
-		ignoreNoise = ladderBioComponent->GetIgnoreNoiseAboveDetectionInSmoothingFlag ();
-		SampledData::SetIgnoreNoiseAnalysisAboveDetectionInSmoothing (ignoreNoise);
-
-		status = ladderBioComponent->AnalyzeGridSM (*data, GridData);	// after this, stage 2 is complete; skip stage 3;
-
-		if (status >= 0)
-			ladderBioComponent->GetAllAmbientData (data);
-
-		//
-		// End Stage 1 here!!!
-		//
-		
-		ladderBioComponent->SetMessageValue (stage1Successful, true);
-		ladderBioComponent->EvaluateSmartMessagesAndTriggersForStage (commSM, numHigherObjects, 1, true, false);
-
-//		ladderBioComponent->EvaluateSmartMessagesForStage (commSM, numHigherObjects, 1, true, false);
-//		ladderBioComponent->SetTriggersForAllMessages (commSM, numHigherObjects, 1, true, false);
-
-		if ((status >= 0) && (ladderBioComponent->AnalyzeGridLociSM (GridData->mText, GridData->mExcelText, GridData->mMsg, print) < 0)) {
-
-			// ErrorString already populated; if status is already negative, we'll come here anyway
-			status = -4;
-		}
-
-		if (status == 0) {
-
-			ladderBioComponent->SetProgress (6);
-		}
-
-		ladderBioComponent->MakeNonCoreLadderArtifactsNoncritical ();
-
-		//
-		// End Stage 2 here!!!
-		//
-
-		ladderBioComponent->SetMessageValue (stage2Successful, true);
-		ladderBioComponent->EvaluateSmartMessagesAndTriggersForStage (commSM, numHigherObjects, 2, true, false);
+	//
+	//  The results of samples are saved only by an incremental or a resumed analysis.  A saved result is reused only if the sample
+	//  file and everything else its analysis depends on, including the ladder files, are unchanged.
+	//
 
-//		ladderBioComponent->EvaluateSmartMessagesForStage (commSM, numHigherObjects, 2, true, false);
-//		ladderBioComponent->SetTriggersForAllMessages (commSM, numHigherObjects, 2, true, false);
+	bool saveResults = IncrementalAnalysis || ResumeAnalysis;
+	ContentFingerprint directoryFingerprint;
 
-		CurrentMarkerSet = markerSetName;
+	if (saveResults) {
 
-		if (printGraphics) {
-			
-			FitDataName = GraphicsDirectory + "/Fit" + LadderFileName + ".txt";
-			SampleOutput = new RGTextOutput (FitDataName, FALSE);
+		directoryFingerprint.Append (OSIRIS_FULLNAME);
+		directoryFingerprint.Append (STRLCAnalysis::GetMsgBookBuildTime ());
+		directoryFingerprint.Append (commandInputs);
+		directoryFingerprint.Append (PlotString);
+		directoryFingerprint.Append (STRLCAnalysis::GetOverrideString ());
+		directoryFingerprint.Append (pServer->GetLabSettingsString ());
+		directoryFingerprint.Append (pServer->GetStandardSettingsString ());
+		directoryFingerprint.Append (mCollection->GetGridData ());
+		directoryFingerprint.AppendFile (mMessageBookName);
+	}
 
-			if (SampleOutput->FileIsValid ())
-				ladderBioComponent->WriteRawDataAndFitData (*SampleOutput, data);
+	{
+		// Ladders are handed out in directory order to the analysis threads, like the samples below.  Each ladder is added to the
+		// ladder list, and to the ladder ILS history, when all preceding ladders have been reported, so that both are the same as
+		// if the ladders had been fitted one at a time.  The ladder list is not modified after this.
 
-			else
-				cout << "Could not write graphics info to file " << FitDataName << ".  Skipping..." << endl;
+		SampleAnalysisQueue ladderQueue;
+		SampleAnalysisContext ladderContext;
+		SampleAnalysisJob* ladderJob;
+		LadderAnalysisThread** ladderThreads;
+		int nThreads;
 
-			delete SampleOutput;
-			SampleOutput = NULL;
-		}
+		while (SampleDirectory->GetNextLadderFile (LadderFileName, cycled) && !cycled) {
 
-		SamplesProcessed++;
-		Progress = 100.0 * (double)SamplesProcessed / (double)NSampleFiles;
-		cout << "Progress = " << Progress << "%." << endl;
+			nLadders++;
+			NumFiles++;
+			ladderQueue.Append (new SampleAnalysisJob (nLadders, LadderFileName));
 
-		delete data;
-		data = NULL;
-		
-		if ((status < 0) || (ladderBioComponent->GridQualityTestSM () < 0)) {
+			if (saveResults) {
 
-			ladderOK = false;
-			RGString ladderName = "-- " + ladderBioComponent->GetSampleName ();
-			ladderBioComponent->SetMessageValue (ladderFailed, true);
-			ladderBioComponent->AppendDataForSmartMessage (ladderFailed, ladderName);
+				directoryFingerprint.Append (LadderFileName);
+				directoryFingerprint.AppendFile (DirectoryName + "/" + LadderFileName);
+			}
 		}
 
-		ladderBioComponent->SetMessageValue (stage3Successful, true);
-		ladderBioComponent->EvaluateSmartMessagesAndTriggersForStage (commSM, numHigherObjects, 3, true, false);
+		// The noise threshold depends on the instrument of the first valid ladder, so it is set before any ladder is fitted
 
-		//
-		// Now end stages 4 and, for peaks only, stage 5
-		//
+		for (i=0; i<nLadders; i++) {
 
-		ladderBioComponent->SetMessageValue (stage4Successful, true);
-		ladderBioComponent->EvaluateSmartMessagesAndTriggersForStage (commSM, numHigherObjects, 4, true, false);
+			ladderJob = ladderQueue.GetJob (i);
+			data = new fsaFileData (DirectoryName + "/" + ladderJob->mFileName);
+			ladderJob->mData = data;
 
-		if (ladderOK)
-			ladderBioComponent->RemoveInterlocusSignalsSM ();
+			if (data->IsValid ()) {
 
-//		ladderBioComponent->EvaluateSmartMessagesForStage (commSM, numHigherObjects, 4, true, false);
-//		ladderBioComponent->SetTriggersForAllMessages (commSM, numHigherObjects, 4, true, false);
+				if (data->GetNumberOfDataChannels () >= expectedNumberOfChannels) {
 
-		if ((ladderOK) && (ladderBioComponent->GridQualityTestSMPart2 (commSM, numHigherObjects) < 0)) {
+					ladderBioComponent = new STRLadderCoreBioComponent (data->GetName ());
+					ladderBioComponent->ReevaluateNoiseThresholdBasedOnMachineType (data->GetInstrumentModelNumber ());
+					ladderJob->mBioComponent = ladderBioComponent;
+				}
 
-			ladderOK = false;
-			RGString ladderName = "-- " + ladderBioComponent->GetSampleName ();
-			ladderBioComponent->SetMessageValue (ladderFailed, true);
-			ladderBioComponent->AppendDataForSmartMessage (ladderFailed, ladderName);
+				break;
+			}
 		}
 
-//		ladderBioComponent->FilterSmartNoticesBelowMinBioID ();  // Already done earlier and too late now anyhow...signals are all wrapped up in GridQualityTestSM
-		ladderBioComponent->OrganizeNoticeObjectsSM ();
-
-		//
-		// Finish stage 5 for grid and add all (non-signal) SmartMessageReporters
-		//
-
-		ladderBioComponent->SetMessageValue (stage5Successful, true);
-		ladderBioComponent->EvaluateSmartMessagesAndTriggersForStage (commSM, numHigherObjects, 5, false, false);	// this is for non-signals only
-
-//		ladderBioComponent->EvaluateSmartMessagesForStage (commSM, numHigherObjects, 5, false, false);	// this is for non-signals only
-//		ladderBioComponent->SetTriggersForAllMessages (commSM, numHigherObjects, 5, false, false);	// these are for non-signals only (signals have already been done)
-		ladderBioComponent->AddAllSmartMessageReporters (commSM, numHigherObjects);	// this does non-signals only; signals have already been done
-
-		ladderBioComponent->WriteXMLGraphicDataSM (GraphicsDirectory, LadderFileName, data, 4, PlotString);
-		ladderBioComponent->PrepareLociForOutput ();
-		ladderBioComponent->ReportGridTableRow (ExcelSummary);
-		ladderBioComponent->ReportGridTableRowWithLinks (ExcelLinks);
-		ladderBioComponent->ReportXMLSmartGridTableRowWithLinks (XMLExcelLinks, tempXMLExcelLinks);
-		ladderBioComponent->ReportAllSmartNoticeObjects (tempExcelSummary, "", " ", FALSE);
-		ladderBioComponent->ReportAllSmartNoticeObjects (tempExcelLinks, "", " ", TRUE);
-
-		if (!ladderOK) {
-
-			NoticeStr = "BIOCOMPONENT COULD NOT ANALYZE LADDER.  Skipping...";
-			cout << NoticeStr << "Return = " << status << endl;
-			ExcelText << CLevel (1) << NoticeStr << "\n";
-			text << NoticeStr << "\n";
-			ExcelText << ladderBioComponent->GetError () << PLevel ();
-			text << ladderBioComponent->GetError ();
-
-			delete ladderBioComponent;
-			ladderBioComponent = NULL;
+		nThreads = GetNumberOfAnalysisThreads (nLadders);
+		CoreBioComponent::SetNumberOfChannelThreads (GetNumberOfChannelThreads (nThreads));
+		cout << "Fitting " << nLadders << " ladders using " << nThreads << " analysis thread(s)..." << endl;
+
+		ladderContext.mQueue = &ladderQueue;
+		ladderContext.mUseSpoolFiles = (nThreads > 1);
+		ladderContext.mDirectoryName = DirectoryName;
+		ladderContext.mGraphicsDirectory = GraphicsDirectory;
+		ladderContext.mPlotString = PlotString;
+		ladderContext.mSpoolName = FullPathForReports + "/temp" + OutputFileName + "Ladder";
+		ladderContext.mMarkerSetName = markerSetName;
+		ladderContext.mOutputLevel = outputLevel;
+		ladderContext.mPrint = print;
+		ladderContext.mPrintGraphics = printGraphics;
+		ladderContext.mLadderList = &LadderList;
+		ladderContext.mTestPeak = testPeak;
+		ladderContext.mText = &text;
+		ladderContext.mExcelText = &ExcelText;
+		ladderContext.mMessage = &Message;
+		ladderContext.mPullupFractions = nonLaserOffScalePullupFractions;
+		ladderContext.mPullupMatrix = pullupMatrixFile;
+		ladderContext.mExcelSummary = &ExcelSummary;
+		ladderContext.mExcelLinks = &ExcelLinks;
+		ladderContext.mXMLExcelLinks = &XMLExcelLinks;
+		ladderContext.mTempXMLExcelLinks = &tempXMLExcelLinks;
+		ladderContext.mTempExcelSummary = &tempExcelSummary;
+		ladderContext.mTempExcelLinks = &tempExcelLinks;
+		ladderContext.mSamplesProcessed = SamplesProcessed;
+		ladderContext.mNumberOfSampleFiles = NSampleFiles;
+		ladderContext.mExpectedNumberOfChannels = expectedNumberOfChannels;
+		ladderContext.mMinimumILSBPForLoci = oldLeastBPForSamples;
+		ladderContext.mFirstSignalID = DataSignal::GetSignalIDCount ();
+		ladderContext.mAnalysisContext.Capture ();
+
+		ladderThreads = new LadderAnalysisThread* [nThreads];
+
+		for (i=1; i<nThreads; i++) {
+
+			ladderThreads [i] = new LadderAnalysisThread (this, &ladderContext);
+
+			if (!ladderThreads [i]->Start ())
+				cout << "Could not start analysis thread " << i << ".  Continuing with fewer threads..." << endl;
 		}
 
-		else {
-
-			LadderList.Append (ladderBioComponent);
-			NoticeStr = "";
-			NoticeStr << CurrentMarkerSet.GetData () << " ladder fit was successful";
-			cout << NoticeStr << endl;
-			NoticeStr << "\n";
-			ExcelText.Write (1, NoticeStr);
-			text << NoticeStr;
+		ProcessLadderJobsSM (ladderContext);
 
-			if (CollectILSHistory) {
+		for (i=1; i<nThreads; i++)
+			delete ladderThreads [i];	// joins thread
 
-				ladderBioComponent->AddILSToHistory ();
-				cout << "Ladder ILS added to history..." << endl;
-			}
+		delete[] ladderThreads;
 
-			//  Find minILSBP for ladder locus and save
+		ladderContext.mAnalysisContext.MakeCurrent ();
+		DataSignal::SetSignalIDOffset (0);
+		DataSignal::SetSignalIDCount (ladderContext.mFirstSignalID + ladderContext.mSignalIDsUsed);
+		ladderQueue.ApplySharedUpdates ();
 
-			int temp = ladderBioComponent->GetMinimumILSBPForLoci ();
+		SamplesProcessed = ladderContext.mSamplesProcessed;
+		oldLeastBPForSamples = ladderContext.mMinimumILSBPForLoci;
 
-			if (temp < oldLeastBPForSamples)
-				oldLeastBPForSamples = temp;
-		}
+		if (ladderContext.mStatus < 0)
+			return ladderContext.mStatus;
 	}
 
 	cout << "Processed all ladders.  Number of ladders = " << LadderList.Entries () << endl;
@@ -1318,9 +1183,6 @@ int STRLCAnalysis :: AnalyzeIncrementallySM (const RGString& prototypeInputDirec
 	CoreBioComponent::SetMinBioIDForArtifacts (oldLeastBPForSamples);
 	cout << "Minimum ILS BP for reporting alleles and artifacts = " << oldLeastBPForSamples << "\n";
 	RGString SampleName;
-	bool sampleOK;
-	bool populatedBaseLocusList = false;
-	bool possibleMixture;
 
 	if (LadderList.Entries () == 0) {
 
@@ -1390,435 +1252,1118 @@ int STRLCAnalysis :: AnalyzeIncrementallySM (const RGString& prototypeInputDirec
 
 	// Modify below functions to accumlate partial work, as possible, in spite of "errors", and report
 
-	while (SampleDirectory->GetNextOrderedSampleFile (FileName)) {
+	{
+		// Samples are handed out in directory order to the analysis threads.  Each thread reports its sample when all preceding
+		// samples have been reported, so that the output is the same as if the samples had been analyzed one at a time.
 
-		sampleOK = true;
-		FullPathName = DirectoryName + "/" + FileName;
+		SampleAnalysisQueue sampleQueue;
+		SampleAnalysisContext sampleContext;
+		SampleAnalysisThread** analysisThreads;
+		SampleResultCache* resultCache = NULL;
+		int nSampleJobs = 0;
+		int nThreads;
 
-		if (WorkingFile != NULL) {
+		while (SampleDirectory->GetNextOrderedSampleFile (FileName)) {
 
-			WorkingFile->Write (FullPathName + "\n");
-			WorkingFile->Flush ();
+			nSampleJobs++;
+			sampleQueue.Append (new SampleAnalysisJob (nSampleJobs, FileName));
 		}
 
-		data = new fsaFileData (FullPathName);
-		bioComponent = new STRSampleCoreBioComponent (data->GetName ());
-		bioComponent->SetSampleName (data->GetSampleName ());
-		bioComponent->SetFileName (FileName);
-		Locus::SetCallOnLadderAdenylation (bioComponent->GetMessageValue (callOnLadderAdenylation));
-		Locus::SetSingleSourceSample (false);
-
-		commentField = data->GetComment ();
-		bioComponent->SetComments (commentField);
+		nThreads = GetNumberOfAnalysisThreads (nSampleJobs);
+		CoreBioComponent::SetNumberOfChannelThreads (GetNumberOfChannelThreads (nThreads));
 
-		if (GetMessageValue (useSampleNamesForControlSampleTests))
-			bioComponent->SetControlIdName (bioComponent->GetDataSampleName ());
+		cout << "Analyzing " << nSampleJobs << " samples using " << nThreads << " analysis thread(s)..." << endl;
 
-		else
-			bioComponent->SetControlIdName (FileName);
+		// The result of each sample is saved as soon as the sample is reported, so that an analysis that does not finish can be resumed
 
-		commSM.SMOStack [1] = (SmartMessagingObject*) bioComponent;
+		if (saveResults) {
 
-		if (bioComponent->PrepareSampleForAnalysisSM (*data, SampleData) < 0) {
+			cout << "Reusing the saved results of unchanged samples..." << endl;
+			resultCache = new SampleResultCache (FullPathForReports + "/SampleResults", directoryFingerprint.GetHexString ());
+		}
 
-			sampleOK = false;
-			NoticeStr = "";
-			NoticeStr << "COULD NOT INITIALIZE AND PREPARE FOR ANALYSIS, FOR FILE:  " << FileName << "\n";
-			ExcelText << CLevel (1) << NoticeStr << bioComponent->GetError ();
-			ExcelText << "COULD NOT ANALYZE FSA FILE:  " << FullPathName << ".  Skipping..." << "\n" << PLevel ();
-			cout << NoticeStr.GetData () << endl;
-			NoticeStr = "";
-			bioComponent->SetMessageValue (sampleFailed, true);
+		sampleContext.mQueue = &sampleQueue;
+		sampleContext.mUseSpoolFiles = (nThreads > 1) || (resultCache != NULL);	// the output of each sample is saved in its result
+		sampleContext.mCache = resultCache;
+		sampleContext.mReuseResults = saveResults;
+		sampleContext.mDirectoryName = DirectoryName;
+		sampleContext.mGraphicsDirectory = GraphicsDirectory;
+		sampleContext.mPlotString = PlotString;
+		sampleContext.mSpoolName = FullPathForReports + "/temp" + OutputFileName + "Sample";
+		sampleContext.mMarkerSetName = markerSetName;
+		sampleContext.mOutputLevel = outputLevel;
+		sampleContext.mPrint = print;
+		sampleContext.mPrintGraphics = printGraphics;
+		sampleContext.mMakeMixturesDefaultType = makeMixturesDefaultType;
+		sampleContext.mUseSampleNamesForControlSampleTests = GetMessageValue (useSampleNamesForControlSampleTests);
+		sampleContext.mLadderList = &LadderList;
+		sampleContext.mServer = pServer;
+		sampleContext.mGenotypes = pGenotypes;
+		sampleContext.mTestPeak = testPeak;
+		sampleContext.mText = &text;
+		sampleContext.mExcelText = &ExcelText;
+		sampleContext.mMessage = &Message;
+		sampleContext.mPullupFractions = nonLaserOffScalePullupFractions;
+		sampleContext.mPullupMatrix = pullupMatrixFile;
+		sampleContext.mExcelSummary = &ExcelSummary;
+		sampleContext.mExcelLinks = &ExcelLinks;
+		sampleContext.mXMLExcelLinks = &XMLExcelLinks;
+		sampleContext.mTempXMLExcelLinks = &tempXMLExcelLinks;
+		sampleContext.mTempExcelSummary = &tempExcelSummary;
+		sampleContext.mTempExcelLinks = &tempExcelLinks;
+		sampleContext.mHasPositiveControl = hasPosControl;
+		sampleContext.mHasNegativeControl = hasNegControl;
+		sampleContext.mSamplesProcessed = SamplesProcessed;
+		sampleContext.mNumberOfSampleFiles = NSampleFiles;
+		sampleContext.mFirstSignalID = DataSignal::GetSignalIDCount ();
+		sampleContext.mAnalysisContext.Capture ();
+
+		analysisThreads = new SampleAnalysisThread* [nThreads];
+
+		for (i=1; i<nThreads; i++) {
+
+			analysisThreads [i] = new SampleAnalysisThread (this, &sampleContext);
+
+			if (!analysisThreads [i]->Start ())
+				cout << "Could not start analysis thread " << i << ".  Continuing with fewer threads..." << endl;
 		}
 
-		if (sampleOK && !populatedBaseLocusList) {
+		ProcessSampleJobsSM (sampleContext);
 
-			populatedBaseLocusList = true;
-			bioComponent->AppendAllBaseLociToList (mBaseLocusList);
-		}
+		for (i=1; i<nThreads; i++)
+			delete analysisThreads [i];	// joins thread
 
-		if (sampleOK && printGraphics) {
+		delete[] analysisThreads;
 
-			FitDataName = GraphicsDirectory + "/Fit" + FileName + ".txt";
-			SampleOutput = new RGTextOutput (FitDataName, FALSE);
+		sampleContext.mAnalysisContext.MakeCurrent ();
+		DataSignal::SetSignalIDOffset (0);
+		DataSignal::SetSignalIDCount (sampleContext.mFirstSignalID + sampleContext.mSignalIDsUsed);
+		sampleQueue.ApplySharedUpdates ();
 
-			if (SampleOutput->FileIsValid ())
-				bioComponent->WriteRawDataAndFitData (*SampleOutput, data);
+		if (resultCache != NULL) {
+
+			if (IncrementalAnalysis)
+				resultCache->RemoveUnusedResults ();
 
 			else
-				cout << "Could not write graphics info for file " << FitDataName << ".  Skipping..." << endl;
+				resultCache->RemoveAllResults ();	// the resumed analysis is complete
 
-			delete SampleOutput;
-			SampleOutput = NULL;
+			delete resultCache;
 		}
 
-		if (sampleOK && (bioComponent->PreliminarySampleAnalysisSM (LadderList, SampleData) < 0)) {
+		hasPosControl = sampleContext.mHasPositiveControl;
+		hasNegControl = sampleContext.mHasNegativeControl;
+		SamplesProcessed = sampleContext.mSamplesProcessed;
+	}
 
-			sampleOK = false;
-			NoticeStr = "";
-			NoticeStr << "COULD NOT PERFORM PRELIMINARY ANALYSIS, FILE:  " << FileName << "\n";
-			ExcelText << CLevel (1) << NoticeStr << bioComponent->GetError () << "\n";
-			ExcelText << "COULD NOT ANALYZE FSA FILE:  " << FullPathName << ".  Skipping..." << "\n" << PLevel ();
-			NoticeStr = "";
-			bioComponent->SetMessageValue (sampleFailed, true);
-		}
+	if (!hasPosControl) {
 
-		else
-			bioComponent->GetAllAmbientData (data);
+		SetMessageValue (noPosCtrlFound, true);
+	}
 
-		//cout << "Preliminary Analysis Complete" << endl;
+	if (!hasNegControl) {
 
-		bioComponent->SetNegativeControlFalseSM ();
-		bioComponent->SetPositiveControlFalseSM ();
-		idString = bioComponent->GetControlIdName ();
-		Locus::SetDisableAdenylationFilter (false);
-		Locus::SetDisableStutterFilter (false);
-		ChannelData::SetDisableAdenylationFilter (false);
-		ChannelData::SetDisableStutterFilter (false);
-		possibleMixture = false;
-	//	cout << "ID String = " << (char*) idString.GetData () << " for file name " << (char*) FileName.GetData () << endl;
-		Locus::SetControlSample (false);
+		SetMessageValue (noNegCtrlFound, true);
+	}
 
-		if (sampleOK && pServer->ControlDoesTargetStringContainASynonymCaseIndep (idString)) {
+finishOutput:
 
-			if (pServer->NegControlDoesTargetStringContainASynonymCaseIndep (idString)) {
+	delete SampleDirectory;
+	delete pullupMatrixFile;
+	pullupMatrixFile = NULL;
 
-				hasNegControl = true;;
-				bioComponent->SetNegativeControlTrueSM ();
-				bioComponent->SetMessageValue (sampleIsNegCtrl, true);
-				Locus::SetSingleSourceSample (true);
-				Locus::SetControlSample (true);
-			}
+	for (i=1; i<=5; i++) {
 
-			else if (pServer->PosControlDoesTargetStringContainASynonymCaseIndep (idString)) {
+		EvaluateSmartMessagesForStage (commSM, 1, i);
+		SetTriggersForAllMessages (commSM, 1, i);
+	}
 
-				hasPosControl = true;
-				bioComponent->SetPositiveControlTrueSM ();
-				bioComponent->SetMessageValue (sampleIsPosCtrl, true);
-				Locus::SetSingleSourceSample (true);
-				Locus::SetControlSample (true);
-			}
+	numHigherObjects = 1;
 
-			bioComponent->SetPossibleMixtureIDFalseSM ();
-			bioComponent->SetMessageValue (sampleSatisfiesMixtureCriteria, false);
-		}
+	//
+	// Add all SmartMessageReporters for file level
+	//
 
-		//else if (bioComponent->IsLabPositiveControl (idString, pGenotypes)) {
+	AddAllSmartMessageReporters (commSM, numHigherObjects);
 
-		//	hasPosControl = true;
-		//	bioComponent->SetPositiveControlTrueSM ();
-		//	bioComponent->SetMessageValue (sampleIsPosCtrl, true);
-		//	bioComponent->SetPossibleMixtureIDFalseSM ();
-		//	bioComponent->SetMessageValue (sampleSatisfiesMixtureCriteria, false);
-		//}
+	ExcelSummary << CLevel (1) << "\n" << PLevel ();
+	ExcelLinks << CLevel (1) << "\n" << PLevel ();
+
+	XMLExcelLinks << CLevel (1) << "\t</Table>\n" << PLevel ();
+	ReportXMLSmartNoticeObjects (XMLExcelLinks, tempXMLExcelLinks, " ");
+	XMLExcelLinks << CLevel (1) << "\t<Messages>\n" << PLevel ();
+
+	tempXMLOutputSummaryLinks.Flush ();
+	tempXMLOutputSummaryLinks.Close ();
+	RGFile tempInputXMLSummaryLinks (tempXMLSummaryFullPathWithLinks, "rt");
+
+	if (!tempInputXMLSummaryLinks.isValid ()) {
+
+		cout << "Could not complete output xml summary; temporary file unavailable..." << endl;
+		return -5;
+	}
+
+	RGString in3;
+	in3.ReadTextFile (tempInputXMLSummaryLinks);
+	XMLExcelLinks << CLevel (1) << in3;
+	XMLExcelLinks << "\t</Messages>\n" << PLevel ();
+	SmartMessagingObject::ReportAllExportSpecifications (XMLExcelLinks);
+
+	// First add directory alerts and then...Merge here to get messages...
+
+	XMLExcelLinks << CLevel (1) << "</OsirisAnalysisReport>" << endLine << PLevel ();
+	SmartMessagingObject::ClearExportSpecifications ();
+
+	tempInputXMLSummaryLinks.Close ();
+	
+	ReportSmartNoticeObjects (ExcelSummary, "", " ", FALSE);
+	ReportSmartNoticeObjects (ExcelLinks, "", " ", TRUE);
+
+	tempOutputSummary.Flush ();
+	tempOutputSummary.Close ();
+	tempOutputSummaryLinks.Flush ();
+	tempOutputSummaryLinks.Close ();
+
+	LadderList.ClearAndDelete ();
+	delete SampleData;
+	delete GridData;
+	delete testPeak;
+
+	RGFile tempInputSummary (tempSummaryFullPath, "rt");
+	RGFile tempInputSummaryLinks (tempSummaryFullPathWithLinks, "rt");
+
+	if (!tempInputSummary.isValid ()) {
+
+		cout << "Could not complete output summary; temporary file unavailable..." << endl;
+		return -5;
+	}
+
+	if (!tempInputSummaryLinks.isValid ()) {
+
+		cout << "Could not complete output summary; temporary file unavailable..." << endl;
+		return -5;
+	}
+	
+	RGString in1;
+	RGString in2;
+
+	in1.ReadTextFile (tempInputSummary);
+	in2.ReadTextFile (tempInputSummaryLinks);
+
+	tempInputSummary.Close ();
+	tempInputSummaryLinks.Close ();
+
+	// delete temporary files
+
+	remove (tempSummaryFullPath.GetData ());
+	remove (tempSummaryFullPathWithLinks.GetData ());
+	remove (tempXMLSummaryFullPathWithLinks.GetData ());
+
+	ExcelSummary.SetOutputLevel (1);
+	ExcelLinks.SetOutputLevel (1);
+
+	ExcelSummary << in1 << "\n";
+	ExcelLinks << in2 << "\n";
+	
+	OutputFile.Flush ();
+	OutputFile.Close ();
+
+	if (!foundALadder)
+		return -20;
+
+	return 0;
+}
+
+
+int STRLCAnalysis :: ProcessSampleJobsSM (SampleAnalysisContext& context) {
+
+	SampleAnalysisJob* job;
+	int nJobs = 0;
+
+	while ((job = context.mQueue->GetNextJob ()) != NULL) {
+
+		RGArenaScope arena;	// released after the sample is reported and deleted
+
+		if (context.mCache != NULL) {
+
+			job->mResult = new SampleResult;
+			job->mResult->mFingerprint = context.mCache->GetFingerprint (context.mDirectoryName + "/" + job->mFileName, job->mFileName);
+
+			if (job->mResult->mFingerprint.Length () == 0) {
+
+				delete job->mResult;	// the sample is analyzed, and fails, as usual
+				job->mResult = NULL;
+			}
+
+			else if (context.mReuseResults && context.mCache->Load (*job->mResult))
+				job->mReusesResult = true;
+
+			else {
+
+				RGString fingerprint = job->mResult->mFingerprint;
+				delete job->mResult;	// may be partly loaded
+				job->mResult = new SampleResult;
+				job->mResult->mFingerprint = fingerprint;
+			}
+		}
+
+		if (job->mReusesResult) {
+
+			cout << "Reusing saved result for sample:  " << job->mFileName << endl;
+			context.mAnalysisContext.MakeCurrent ();
+		}
+
+		else
+			AnalyzeSampleSM (*job, context);
+
+		context.mQueue->WaitForTurn (*job);
+		ReportSampleSM (*job, context);
+		context.mQueue->EndTurn ();
+
+		SmartMessagingObject::SetSharedUpdateLog (NULL);
+		delete job->mData;
+		delete job->mBioComponent;	// releases off scale data of this thread
+		delete job->mResult;
+		job->mData = NULL;
+		job->mBioComponent = NULL;
+		job->mResult = NULL;
+		nJobs++;
+	}
+
+	return nJobs;
+}
+
+
+void STRLCAnalysis :: AnalyzeSampleSM (SampleAnalysisJob& job, SampleAnalysisContext& context) {
+
+	smSampleUnanalyzable sampleFailed;
+	smSampleIsPosCtrl sampleIsPosCtrl;
+	smSampleIsNegCtrl sampleIsNegCtrl;
+	smSampleSatisfiesPossibleMixtureIDCriteria sampleSatisfiesMixtureCriteria;
+	smDisableLowLevelFiltersForKnownMixturesPreset disableLowLevelFilters;
+	smStage1Successful stage1Successful;
+	smStage2Successful stage2Successful;
+	smStage3Successful stage3Successful;
+	smStage4Successful stage4Successful;
+	smStage5Successful stage5Successful;
+	smDisableStutterFilter disableStutterFilter;
+	smDisableAdenylationFilter disableAdenylationFilter;
+	smCallOnLadderAdenylationPreset callOnLadderAdenylation;
+
+	ParameterServer* pServer = context.mServer;
+	GenotypesForAMarkerSet* pGenotypes = context.mGenotypes;
+	const RGString& FileName = job.mFileName;
+	RGString FullPathName = context.mDirectoryName + "/" + FileName;
+	RGString NoticeStr;
+	RGString commentField;
+	RGString idString;
+	RGString FitDataName;
+	RGTextOutput* SampleOutput;
+	bool sampleOK = true;
+	bool possibleMixture;
+	int numHigherObjects = 2;
+	fsaFileData* data;
+	CoreBioComponent* bioComponent;
+
+	//
+	//  Every sample starts from the settings in effect before the first sample and records its triggers of objects shared
+	//  by all samples, to be applied in sample order when all samples are done
+	//
+
+	context.mAnalysisContext.MakeCurrent ();
+	SmartMessagingObject::SetSharedUpdateLog (&job.mSharedUpdates);
+
+	if (context.mUseSpoolFiles && (job.OpenSpoolFiles (context) < 0))
+		cout << "Could not open temporary output files for sample:  " << FileName << endl;
+
+	RGTextOutput& text = (job.mText != NULL) ? *job.mText : *context.mText;
+	RGLogBook& ExcelText = (job.mExcelText != NULL) ? *job.mExcelText : *context.mExcelText;
+	OsirisMsg& Message = (job.mMessage != NULL) ? *job.mMessage : *context.mMessage;
+
+	if (context.mUseSpoolFiles) {
+
+		CoreBioComponent::SetNonLaserOffScalePUCoeffsFile (job.mPullupFractions);
+		CoreBioComponent::SetPullupMatrixFile (job.mPullupMatrix);
+	}
+
+	SampleDataStruct SampleData (mCollection, context.mMarkerSetName, context.mTestPeak, context.mTestPeak, text, ExcelText, Message, context.mPrint);
+	SmartMessagingComm commSM;
+	commSM.SMOStack [0] = (SmartMessagingObject*) this;
+
+	if (WorkingFile != NULL) {
+
+		RGLock lock (context.mWorkingFileMutex);
+		WorkingFile->Write (FullPathName + "\n");
+		WorkingFile->Flush ();
+	}
+
+	data = new fsaFileData (FullPathName);
+	bioComponent = new STRSampleCoreBioComponent (data->GetName ());
+	job.mData = data;
+	job.mBioComponent = bioComponent;
+	bioComponent->SetSampleName (data->GetSampleName ());
+	bioComponent->SetFileName (FileName);
+	Locus::SetCallOnLadderAdenylation (bioComponent->GetMessageValue (callOnLadderAdenylation));
+	Locus::SetSingleSourceSample (false);
+
+	commentField = data->GetComment ();
+	bioComponent->SetComments (commentField);
+
+	if (context.mUseSampleNamesForControlSampleTests)
+		bioComponent->SetControlIdName (bioComponent->GetDataSampleName ());
+
+	else
+		bioComponent->SetControlIdName (FileName);
+
+	commSM.SMOStack [1] = (SmartMessagingObject*) bioComponent;
+
+	if (bioComponent->PrepareSampleForAnalysisSM (*data, &SampleData) < 0) {
+
+		sampleOK = false;
+		NoticeStr = "";
+		NoticeStr << "COULD NOT INITIALIZE AND PREPARE FOR ANALYSIS, FOR FILE:  " << FileName << "\n";
+		ExcelText << CLevel (1) << NoticeStr << bioComponent->GetError ();
+		ExcelText << "COULD NOT ANALYZE FSA FILE:  " << FullPathName << ".  Skipping..." << "\n" << PLevel ();
+		cout << NoticeStr.GetData () << endl;
+		NoticeStr = "";
+		bioComponent->SetMessageValue (sampleFailed, true);
+	}
+
+	job.mSamplePrepared = sampleOK;	// the first prepared sample populates the base locus list when it is reported
+
+	if (sampleOK && context.mPrintGraphics) {
+
+		FitDataName = context.mGraphicsDirectory + "/Fit" + FileName + ".txt";
+		SampleOutput = new RGTextOutput (FitDataName, FALSE);
+
+		if (SampleOutput->FileIsValid ())
+			bioComponent->WriteRawDataAndFitData (*SampleOutput, data);
+
+		else
+			cout << "Could not write graphics info for file " << FitDataName << ".  Skipping..." << endl;
+
+		delete SampleOutput;
+		SampleOutput = NULL;
+	}
+
+	if (sampleOK && (bioComponent->PreliminarySampleAnalysisSM (*context.mLadderList, &SampleData) < 0)) {
+
+		sampleOK = false;
+		NoticeStr = "";
+		NoticeStr << "COULD NOT PERFORM PRELIMINARY ANALYSIS, FILE:  " << FileName << "\n";
+		ExcelText << CLevel (1) << NoticeStr << bioComponent->GetError () << "\n";
+		ExcelText << "COULD NOT ANALYZE FSA FILE:  " << FullPathName << ".  Skipping..." << "\n" << PLevel ();
+		NoticeStr = "";
+		bioComponent->SetMessageValue (sampleFailed, true);
+	}
+
+	else
+		bioComponent->GetAllAmbientData (data);
+
+	bioComponent->SetNegativeControlFalseSM ();
+	bioComponent->SetPositiveControlFalseSM ();
+	idString = bioComponent->GetControlIdName ();
+	Locus::SetDisableAdenylationFilter (false);
+	Locus::SetDisableStutterFilter (false);
+	ChannelData::SetDisableAdenylationFilter (false);
+	ChannelData::SetDisableStutterFilter (false);
+	possibleMixture = false;
+	Locus::SetControlSample (false);
+
+	if (sampleOK && pServer->ControlDoesTargetStringContainASynonymCaseIndep (idString)) {
+
+		if (pServer->NegControlDoesTargetStringContainASynonymCaseIndep (idString)) {
+
+			job.mIsNegativeControl = true;
+			bioComponent->SetNegativeControlTrueSM ();
+			bioComponent->SetMessageValue (sampleIsNegCtrl, true);
+			Locus::SetSingleSourceSample (true);
+			Locus::SetControlSample (true);
+		}
+
+		else if (pServer->PosControlDoesTargetStringContainASynonymCaseIndep (idString)) {
+
+			job.mIsPositiveControl = true;
+			bioComponent->SetPositiveControlTrueSM ();
+			bioComponent->SetMessageValue (sampleIsPosCtrl, true);
+			Locus::SetSingleSourceSample (true);
+			Locus::SetControlSample (true);
+		}
+
+		bioComponent->SetPossibleMixtureIDFalseSM ();
+		bioComponent->SetMessageValue (sampleSatisfiesMixtureCriteria, false);
+	}
+
+	else if (sampleOK && bioComponent->GetMessageValue (disableLowLevelFilters)) {
+
+		if (pServer->DoesTargetStringContainMixtureCriteriaCaseIndep (idString, context.mMakeMixturesDefaultType)) {
+
+			bioComponent->SetPossibleMixtureIDTrueSM ();
+			bioComponent->SetMessageValue (sampleSatisfiesMixtureCriteria, true);
+			possibleMixture = true;
+			Locus::SetSingleSourceSample (false);
+			cout << "Sample is being treated as a mixture\n";
+		}
+
+		else {
+
+			bioComponent->SetPossibleMixtureIDFalseSM ();
+			bioComponent->SetMessageValue (sampleSatisfiesMixtureCriteria, false);
+			possibleMixture = false;
+			Locus::SetSingleSourceSample (true);
+			cout << "Sample is being treated as a single source sample\n";
+		}
+	}
+
+	//
+	// End stage 1 for sample
+	//
+
+	bioComponent->SetMessageValue (stage1Successful, true);
+	bioComponent->EvaluateSmartMessagesAndTriggersForStage (commSM, numHigherObjects, 1, true, false);
+
+	if (possibleMixture) {
+
+		// Have to wait until stage 1 complete to evaluate disable stutter and adenylation messages below
+
+		Locus::SetDisableAdenylationFilter (bioComponent->GetMessageValue (disableAdenylationFilter));
+		ChannelData::SetDisableAdenylationFilter (bioComponent->GetMessageValue (disableAdenylationFilter));
+		Locus::SetDisableStutterFilter (bioComponent->GetMessageValue (disableStutterFilter));
+		ChannelData::SetDisableStutterFilter (bioComponent->GetMessageValue (disableStutterFilter));
+	}
+
+	if (sampleOK && (bioComponent->AnalyzeSampleLociSM (text, ExcelText, Message, TRUE) < 0)) {
+
+		NoticeStr = "";
+		NoticeStr << "COULD NOT ANALYZE LOCI FOR FILE:  " << FileName << "\n";
+		ExcelText << CLevel (1) << NoticeStr << bioComponent->GetError () << "\n";
+		ExcelText << "COULD NOT ANALYZE FSA FILE:  " << FullPathName << ".  Skipping..." << "\n" << PLevel ();
+		NoticeStr = "";
+	}
+
+	if (sampleOK)
+		bioComponent->TestFractionalFiltersSM ();	// first tests for stutter and adenylation; then removes peaks below fractional filter(s)
+
+	bioComponent->SetMessageValue (stage2Successful, true);
+	bioComponent->EvaluateSmartMessagesAndTriggersForStage (commSM, numHigherObjects, 2, true, false);
+
+	if (sampleOK) 
+		bioComponent->MakePreliminaryCallsSM (pGenotypes);
+
+	if (sampleOK)
+		bioComponent->MeasureAllInterlocusSignalAttributesSM ();	// at this point, easily resolved ambiguities already removed
+
+	bioComponent->SetMessageValue (stage3Successful, true);
+	bioComponent->EvaluateSmartMessagesAndTriggersForStage (commSM, numHigherObjects, 3, true, false);
+
+	// Now, resolve ambiguities based on calculations from end of stage 3:
+
+	if (sampleOK) {
+
+		bioComponent->ResolveAmbiguousInterlocusSignalsUsingSmartMessageDataSM ();	// Removes ambiguous signals from loci or assigns them and records message
+		bioComponent->FilterSmartNoticesBelowMinBioID ();
+	}
+
+	if (sampleOK)
+		bioComponent->SignalQualityTestSM ();
+
+	bioComponent->SetMessageValue (stage4Successful, true);
+	bioComponent->EvaluateSmartMessagesAndTriggersForStage (commSM, numHigherObjects, 4, true, false);
+
+	// The following records, at the locus level, interlocus peaks to right and left for purposes of reporting
+
+	if (sampleOK)
+		bioComponent->RemoveInterlocusSignalsSM ();
+
+	bioComponent->EvaluateSmartMessagesAndTriggersForStage (commSM, numHigherObjects, 5, false, true);
+	bioComponent->AddAllSmartMessageReportersForSignals (commSM, numHigherObjects);	// still in wrong place???
+
+	if (sampleOK)
+		bioComponent->SampleQualityTestSM (pGenotypes);
+
+	if (sampleOK)
+		bioComponent->TestPositiveControlSM (pGenotypes);
+
+	bioComponent->OrganizeNoticeObjectsSM ();  // Have to do this here, before last evaluation and adding smart message reporters!!
+
+	bioComponent->SetMessageValue (stage5Successful, true);
+	bioComponent->EvaluateSmartMessagesAndTriggersForStage (commSM, numHigherObjects, 5, false, false);	// These do not include signals...already done
+
+	if (!sampleOK)
+		bioComponent->LocatePositiveControlName (pGenotypes);
+
+	bioComponent->AddAllSmartMessageReporters (commSM, numHigherObjects);	// These do not include signals...already done
+}
+
+
+void STRLCAnalysis :: ReportSampleSM (SampleAnalysisJob& job, SampleAnalysisContext& context) {
+
+	CoreBioComponent* bioComponent = job.mBioComponent;
+	SampleResult* result = job.mResult;
+	NoticeNumbers& numbers = Notice::GetNoticeNumbers ();
+	NoticeNumbers firstNumbers = numbers;
+	vector<SmartMessagingObject*> sharedObjects;
+	double Progress;
+
+	if (job.mReusesResult) {
+
+		ReportSampleResultSM (job, context);
+		return;
+	}
+
+	if (result != NULL) {
+
+		//
+		//  The sample's output is saved in its result, with its signal id's, links and message numbers counted from reserved
+		//  bases, and then reported from the result like any other saved result
+		//
+
+		job.MoveSpoolFilesToResult ();
+
+		if (job.OpenReportSpools (context) < 0)
+			cout << "Could not open temporary output files for sample:  " << job.mFileName << endl;
+
+		numbers.mLinkNumber = SampleResultCache::LinkNumberBase;
+		numbers.mMsgNumber = SampleResultCache::MessageNumberBase;
+		DataSignal::SetSignalIDOffset (SampleResultCache::SignalIDBase - context.mFirstSignalID);
+	}
+
+	else {
+
+		//
+		//  Append the sample's spooled analysis output first, so that all output files are in the same order as for a serial analysis
+		//
+
+		job.AppendSpoolFiles (context);
+
+		if (job.mIsPositiveControl)
+			context.mHasPositiveControl = true;
+
+		if (job.mIsNegativeControl)
+			context.mHasNegativeControl = true;
+
+		if (job.mSamplePrepared && !context.mPopulatedBaseLocusList) {
+
+			context.mPopulatedBaseLocusList = true;
+			bioComponent->AppendAllBaseLociToList (mBaseLocusList);
+		}
+
+		// Signal id's are numbered as if all preceding samples had been analyzed on this thread
+
+		DataSignal::SetSignalIDOffset (context.mSignalIDsUsed);
+	}
+
+	if (bioComponent->SampleIsValid ()) {
+
+		bioComponent->ReportSampleData (job.GetReportOutput (context, SampleResult::ReportTabOutput));
+		bioComponent->WriteXMLGraphicDataSM (context.mGraphicsDirectory, job.mFileName, job.mData, 4, context.mPlotString);
+	}
+
+	bioComponent->PrepareLociForOutput ();
+	bioComponent->ReportSampleTableRow (job.GetReportOutput (context, SampleResult::SummaryOutput));
+	bioComponent->ReportSampleTableRowWithLinks (job.GetReportOutput (context, SampleResult::SummaryLinksOutput));
+	bioComponent->ReportXMLSmartSampleTableRowWithLinks (job.GetReportOutput (context, SampleResult::XMLSummaryOutput),
+		job.GetReportOutput (context, SampleResult::TempXMLSummaryOutput));
+
+	bioComponent->ReportAllSmartNoticeObjects (job.GetReportOutput (context, SampleResult::TempSummaryOutput), "", " ", FALSE);
+	bioComponent->ReportAllSmartNoticeObjects (job.GetReportOutput (context, SampleResult::TempSummaryLinksOutput), "", " ", TRUE);
+
+	if (result != NULL) {
+
+		result->mSamplePrepared = job.mSamplePrepared;
+		result->mIsPositiveControl = job.mIsPositiveControl;
+		result->mIsNegativeControl = job.mIsNegativeControl;
+		result->mSignalIDsUsed = DataSignal::GetSignalIDCount () - context.mFirstSignalID;
+		result->mLinkNumbersUsed = numbers.mLinkNumber - SampleResultCache::LinkNumberBase;
+		result->mMessageNumbersUsed = numbers.mMsgNumber - SampleResultCache::MessageNumberBase;
+		numbers = firstNumbers;
+		DataSignal::SetSignalIDOffset (0);
+		job.MoveReportSpoolsToResult ();
+
+		if (bioComponent->SampleIsValid ()) {
+
+			RGFile graphics (context.GetGraphicsFileName (job.mFileName), "rt");
+
+			if (graphics.isValid ()) {
+
+				result->mOutputs [SampleResult::GraphicsOutput].ReadTextFile (graphics);
+				result->mHasGraphics = true;
+			}
+		}
+
+		// A result that updates objects other than those shared by all samples cannot be reused, and is not saved
+
+		GetSharedObjectsSM (context, sharedObjects);
+
+		if (job.mSharedUpdates.Save (result->mSharedUpdates, sharedObjects) < 0)
+			cout << "Could not save result for sample:  " << job.mFileName << endl;
+
+		else if (context.mCache->Save (*result) < 0)
+			cout << "Could not save result for sample:  " << job.mFileName << endl;
+
+		ReportSampleResultSM (job, context);
+		return;
+	}
+
+	context.mSignalIDsUsed += DataSignal::GetSignalIDCount () - context.mFirstSignalID;
+	DataSignal::SetSignalIDOffset (0);
+
+	context.mSamplesProcessed++;
+	Progress = 100.0 * (double)context.mSamplesProcessed / (double)context.mNumberOfSampleFiles;
+	cout << "Progress = " << Progress << "%." << endl;
+
+	if (mProgress != NULL)
+		mProgress->ReportProgress (context.mDirectoryName, Progress);
+}
+
+
+void STRLCAnalysis :: ReportSampleResultSM (SampleAnalysisJob& job, SampleAnalysisContext& context) {
+
+	//
+	//  The result's reserved numbers are replaced by the next signal id's, links and message numbers of this analysis, so that
+	//  the sample is reported exactly as if it had just been analyzed
+	//
+
+	SampleResult* result = job.mResult;
+	NoticeNumbers& numbers = Notice::GetNoticeNumbers ();
+	unsigned long lastSignalID = context.mFirstSignalID + context.mSignalIDsUsed;
+	vector<SmartMessagingObject*> sharedObjects;
+	double Progress;
+
+	job.AppendResult (context, lastSignalID, numbers.mLinkNumber, numbers.mMsgNumber);
+
+	if (result->mHasGraphics) {
+
+		RGFile graphics (context.GetGraphicsFileName (job.mFileName), "wt");
+
+		if (graphics.isValid ())	// graphics have no signal id's, links or message numbers to renumber
+			graphics.Write (result->mOutputs [SampleResult::GraphicsOutput].GetData (), result->mOutputs [SampleResult::GraphicsOutput].Length ());
+	}
+
+	context.mSignalIDsUsed += result->mSignalIDsUsed;
+	numbers.mLinkNumber += result->mLinkNumbersUsed;
+	numbers.mMsgNumber += result->mMessageNumbersUsed;
+
+	if (result->mIsPositiveControl)
+		context.mHasPositiveControl = true;
+
+	if (result->mIsNegativeControl)
+		context.mHasNegativeControl = true;
+
+	if (result->mSamplePrepared && !context.mPopulatedBaseLocusList) {
+
+		context.mPopulatedBaseLocusList = true;
+		((CoreBioComponent*) context.mLadderList->First ())->AppendAllBaseLociToList (mBaseLocusList);	// samples link to the same base loci
+	}
+
+	if (job.mReusesResult) {
+
+		GetSharedObjectsSM (context, sharedObjects);
+
+		if (job.mSharedUpdates.Restore (result->mSharedUpdates, sharedObjects) < 0)
+			cout << "Could not restore directory messages of sample:  " << job.mFileName << endl;
+	}
+
+	context.mSamplesProcessed++;
+	Progress = 100.0 * (double)context.mSamplesProcessed / (double)context.mNumberOfSampleFiles;
+	cout << "Progress = " << Progress << "%." << endl;
+
+	if (mProgress != NULL)
+		mProgress->ReportProgress (context.mDirectoryName, Progress);
+}
+
+
+void STRLCAnalysis :: GetSharedObjectsSM (const SampleAnalysisContext& context, vector<SmartMessagingObject*>& sharedObjects) {
+
+	RGDList baseLoci;
+	SmartMessagingObject* nextObject;
+
+	sharedObjects.clear ();
+	sharedObjects.push_back (this);
+	((CoreBioComponent*) context.mLadderList->First ())->AppendAllBaseLociToList (baseLoci);
+	RGDListIterator it (baseLoci);
+
+	while (nextObject = (SmartMessagingObject*) it ())
+		sharedObjects.push_back (nextObject);
+
+	baseLoci.Clear ();
+}
 
-		//else if (sampleOK && bioComponent->GetMessageValue (disableLowLevelFilters)) {
 
-		else if (sampleOK && bioComponent->GetMessageValue (disableLowLevelFilters)) {
+int STRLCAnalysis :: ProcessLadderJobsSM (SampleAnalysisContext& context) {
 
-			if (pServer->DoesTargetStringContainMixtureCriteriaCaseIndep (idString, makeMixturesDefaultType)) {
+	SampleAnalysisJob* job;
+	int nJobs = 0;
 
-				bioComponent->SetPossibleMixtureIDTrueSM ();
-				bioComponent->SetMessageValue (sampleSatisfiesMixtureCriteria, true);
-				possibleMixture = true;
-				Locus::SetSingleSourceSample (false);
-				cout << "Sample is being treated as a mixture\n";
-			}
+	while ((job = context.mQueue->GetNextJob ()) != NULL) {
 
-			else {
+		AnalyzeLadderSM (*job, context);
+		context.mQueue->WaitForTurn (*job);
+		ReportLadderSM (*job, context);
+		context.mQueue->EndTurn ();
 
-				bioComponent->SetPossibleMixtureIDFalseSM ();
-				bioComponent->SetMessageValue (sampleSatisfiesMixtureCriteria, false);
-				possibleMixture = false;
-				Locus::SetSingleSourceSample (true);
-				cout << "Sample is being treated as a single source sample\n";
-			}
-		}
+		SmartMessagingObject::SetSharedUpdateLog (NULL);
+		delete job->mData;
+		delete job->mBioComponent;	// NULL if the ladder was added to the ladder list
+		job->mData = NULL;
+		job->mBioComponent = NULL;
+		nJobs++;
+	}
 
-		//
-		// End stage 1 for sample
-		//
+	return nJobs;
+}
 
-		bioComponent->SetMessageValue (stage1Successful, true);
-		bioComponent->EvaluateSmartMessagesAndTriggersForStage (commSM, numHigherObjects, 1, true, false);
 
-		if (possibleMixture) {
+void STRLCAnalysis :: AnalyzeLadderSM (SampleAnalysisJob& job, SampleAnalysisContext& context) {
 
-			// Have to wait until stage 1 complete to evaluate disable stutter and adenylation messages below
+	smLadderFailed ladderFailed;
+	smSampleIsLadder sampleIsLadder;
+	smStage1Successful stage1Successful;
+	smStage2Successful stage2Successful;
+	smStage3Successful stage3Successful;
+	smStage4Successful stage4Successful;
+	smStage5Successful stage5Successful;
 
-			Locus::SetDisableAdenylationFilter (bioComponent->GetMessageValue (disableAdenylationFilter));
-			ChannelData::SetDisableAdenylationFilter (bioComponent->GetMessageValue (disableAdenylationFilter));
-			Locus::SetDisableStutterFilter (bioComponent->GetMessageValue (disableStutterFilter));
-			ChannelData::SetDisableStutterFilter (bioComponent->GetMessageValue (disableStutterFilter));
-		}
+	const RGString& LadderFileName = job.mFileName;
+	RGString FullPathName = context.mDirectoryName + "/" + LadderFileName;
+	RGString NoticeStr;
+	RGString stringData;
+	RGString commentField;
+	RGString FitDataName;
+	RGTextOutput* SampleOutput;
+	Endl endLine;
+	int expectedNumberOfChannels = context.mExpectedNumberOfChannels;
+	int NChannels;
+	int NSamples;
+	int status;
+	int i;
+	bool ignoreNoise;
+	bool ladderOK = true;
+	int numHigherObjects = 2;
+	fsaFileData* data;
+	CoreBioComponent* ladderBioComponent;
 
-		//cout << "Stage 1 complete" << endl;
+	//
+	//  Every ladder starts from the settings in effect before the first ladder and records its triggers of objects shared
+	//  by all samples, to be applied in ladder order when all ladders are done
+	//
 
-//		bioComponent->EvaluateSmartMessagesForStage (commSM, numHigherObjects, 1, true, false);
-//		bioComponent->SetTriggersForAllMessages (commSM, numHigherObjects, 1, true, false);
+	context.mAnalysisContext.MakeCurrent ();
+	SmartMessagingObject::SetSharedUpdateLog (&job.mSharedUpdates);
 
-		if (sampleOK && (bioComponent->AnalyzeSampleLociSM (text, ExcelText, Message, TRUE) < 0)) {
+	if (context.mUseSpoolFiles && (job.OpenSpoolFiles (context) < 0))
+		cout << "Could not open temporary output files for ladder:  " << LadderFileName << endl;
 
-			NoticeStr = "";
-			NoticeStr << "COULD NOT ANALYZE LOCI FOR FILE:  " << FileName << "\n";
-			ExcelText << CLevel (1) << NoticeStr << bioComponent->GetError () << "\n";
-			ExcelText << "COULD NOT ANALYZE FSA FILE:  " << FullPathName << ".  Skipping..." << "\n" << PLevel ();
-			NoticeStr = "";
-		}
+	RGTextOutput& text = (job.mText != NULL) ? *job.mText : *context.mText;
+	RGLogBook& ExcelText = (job.mExcelText != NULL) ? *job.mExcelText : *context.mExcelText;
+	OsirisMsg& Message = (job.mMessage != NULL) ? *job.mMessage : *context.mMessage;
 
-		//cout << "Sample locus analysis complete" << endl;
+	if (context.mUseSpoolFiles) {
 
-		//
-		// Question:  do we put the SmartMessage activation before or after relevant code.  The intent was that the code performs
-		// tests, then the SmartMessages perform the logic and then the code cleans up the results.  We probably have to reorganize
-		// somewhat!!!
-		//
+		CoreBioComponent::SetNonLaserOffScalePUCoeffsFile (job.mPullupFractions);
+		CoreBioComponent::SetPullupMatrixFile (job.mPullupMatrix);
+	}
 
-		if (sampleOK)
-			bioComponent->TestFractionalFiltersSM ();	// first tests for stutter and adenylation; then removes peaks below fractional filter(s)
+	GridDataStruct GridData (mCollection, context.mMarkerSetName, context.mTestPeak, text, ExcelText, Message, context.mPrint);
+	SmartMessagingComm commSM;
+	commSM.SMOStack [0] = (SmartMessagingObject*) this;
+	cout << "Found ladder name " << (char*)FullPathName.GetData () << endl;
 
-		bioComponent->SetMessageValue (stage2Successful, true);
-		bioComponent->EvaluateSmartMessagesAndTriggersForStage (commSM, numHigherObjects, 2, true, false);
+	if (WorkingFile != NULL) {
 
-		//cout << "Stage 2 complete" << endl;
+		RGLock lock (context.mWorkingFileMutex);
+		WorkingFile->Write (FullPathName + "\n");
+		WorkingFile->Flush ();
+	}
 
-//		bioComponent->EvaluateSmartMessagesForStage (commSM, numHigherObjects, 2, true, false);
-//		bioComponent->SetTriggersForAllMessages (commSM, numHigherObjects, 2, true, false);
+	if (job.mData == NULL)
+		job.mData = new fsaFileData (FullPathName);
 
-		if (sampleOK) 
-			bioComponent->MakePreliminaryCallsSM (pGenotypes);
+	data = job.mData;
 
-		//cout << "Preliminary Calls complete" << endl;
+	if (!data->IsValid ()) {
 
-		//cout << "Preliminary calls done" << endl;
-		
-//		if (sampleOK)
-//			bioComponent->ValidateAndCorrectCrossChannelAnalysesSM ();
+		NoticeStr << "Oops, " << LadderFileName.GetData () << " is not valid...Skipping";
+		cout << NoticeStr << endl;
+		NoticeStr << "\n";
+		ExcelText.Write (1, NoticeStr);
+		text << NoticeStr;
+		return;
+	}
 
-//		if (sampleOK)	// Resolution now occurs after end of stage 3, below.
-//			bioComponent->ResolveAmbiguousInterlocusSignalsSM ();	// at this point, easily resolved ambiguities already removed
+	ExcelText.SetOutputLevel (1);
+	text << endLine << endLine;
+	ExcelText << endLine << endLine;
 
-		if (sampleOK)
-			bioComponent->MeasureAllInterlocusSignalAttributesSM ();	// at this point, easily resolved ambiguities already removed
+	text << "File Name:" << endLine;
+	text << "    " << LadderFileName.GetData () << endLine;
 
-		bioComponent->SetMessageValue (stage3Successful, true);
-		bioComponent->EvaluateSmartMessagesAndTriggersForStage (commSM, numHigherObjects, 3, true, false);
+	ExcelText << "File Name:" << endLine;
+	ExcelText << "    " << LadderFileName.GetData () << endLine;
 
-		//cout << "Stage 3 complete" << endl;
+	stringData = data->GetInstrumentModelNumber ();
+	text << "ABI model number:  " << stringData << endLine;
+	ExcelText << "ABI model number:  " << stringData << endLine;
 
-//		bioComponent->EvaluateSmartMessagesForStage (commSM, numHigherObjects, 3, true, false);
-//		bioComponent->SetTriggersForAllMessages (commSM, numHigherObjects, 3, true, false);
+	stringData = data->GetInstrumentName ();
+	text << "Instrument Name:  " << stringData << endLine;
+	ExcelText << "Instrument Name:  " << stringData << endLine;
 
-		// Now, resolve ambiguities based on calculations from end of stage 3:
+	NChannels = data->GetNumberOfDataChannels ();
+	text << "Number of channels of data = " << NChannels << endLine;
+	ExcelText << "Number of channels of data = " << NChannels << endLine;
 
-		if (sampleOK) {
+	stringData = data->GetDyeSetName ();
+	text << "Dye set name:  " << stringData << endLine;
+	ExcelText << "Dye set name:  " << stringData << endLine;
 
-			bioComponent->ResolveAmbiguousInterlocusSignalsUsingSmartMessageDataSM ();	// Removes ambiguous signals from loci or assigns them and records message
-			bioComponent->FilterSmartNoticesBelowMinBioID ();
-		}
+	if (expectedNumberOfChannels > NChannels) {
 
-		if (sampleOK)
-			bioComponent->SignalQualityTestSM ();
+		cout << "MARKERSET MISMATCH...EXPECTING " << expectedNumberOfChannels << " CHANNELS AND FILE CONTAINS " << NChannels << " CHANNELS" << endl;
+		cout << "ENDING..." << endl;
 
-		bioComponent->SetMessageValue (stage4Successful, true);
-		bioComponent->EvaluateSmartMessagesAndTriggersForStage (commSM, numHigherObjects, 4, true, false);
+		text << "MARKERSET MISMATCH...EXPECTING " << expectedNumberOfChannels << " CHANNELS AND FILE CONTAINS " << NChannels << " CHANNELS" << endLine;
+		text << "ENDING..." << endLine;
 
-		//cout << "Stage 4 complete" << endl;
+		ExcelText << "MARKERSET MISMATCH...EXPECTING " << expectedNumberOfChannels << " CHANNELS AND FILE CONTAINS " << NChannels << " CHANNELS" << endLine;
+		ExcelText << "ENDING..." << endLine;
+		job.mStatus = -150;	// the xml summary is ended when the ladder is reported
+		return;
+	}
 
-		// The following records, at the locus level, interlocus peaks to right and left for purposes of reporting
+	for (i=1; i<=expectedNumberOfChannels; i++) {
 
-		if (sampleOK)
-			bioComponent->RemoveInterlocusSignalsSM ();
+		stringData = data->GetDyeNameForDataChannel (i);
+		text << "Dye name for channel " << i << ":  " << stringData << endLine;
+		ExcelText << "Dye name for channel " << i << ":  " << stringData << endLine;
+	}
 
-		//	Put residual displacement test here...02/11/2014
+	stringData = data->GetCollectionStartDate ();
+	text << "Start date for data collection:  " << stringData << endLine;
+	ExcelText << "Start date for data collection:  " << stringData << endLine;
 
-//		bioComponent->EvaluateSmartMessagesForStage (commSM, numHigherObjects, 4, true, false);
-//		bioComponent->SetTriggersForAllMessages (commSM, numHigherObjects, 4, true, false);
+	stringData = data->GetCollectionStartTime ();
+	text << "Start time for data collection:  " << stringData << endLine;
+	ExcelText << "Start time for data collection:  " << stringData << endLine;
 
-		bioComponent->EvaluateSmartMessagesAndTriggersForStage (commSM, numHigherObjects, 5, false, true);
-		bioComponent->AddAllSmartMessageReportersForSignals (commSM, numHigherObjects);	// still in wrong place???
+	stringData = data->GetCapillaryNumber ();
+	text << "Lane number for sample:  " << stringData << endLine;
+	ExcelText << "Lane number for sample:  " << stringData << endLine;
 
-		if (sampleOK)
-			bioComponent->SampleQualityTestSM (pGenotypes);
+	NSamples = data->GetNumberOfDataElementsForDataChannel (expectedNumberOfChannels);
+	text << "Number of samples for data channel " << expectedNumberOfChannels << ":  " << NSamples << endLine;
+	ExcelText << "Number of samples for data channel " << expectedNumberOfChannels << ":  " << NSamples << endLine;
+	ExcelText.ResetOutputLevel ();
 
-		//
-		//  Put peak height accumulation algorithm here (12/16/2016)
-		//
+	if (job.mBioComponent == NULL)
+		job.mBioComponent = new STRLadderCoreBioComponent (data->GetName ());	// unless created to set the noise threshold
 
-		//if (sampleOK)
-		//	bioComponent->WriteDataToHeightFileSM ();
+	ladderBioComponent = job.mBioComponent;
+	ladderBioComponent->SetSampleName (data->GetSampleName ());
+	ladderBioComponent->SetFileName (LadderFileName);
+	commSM.SMOStack [1] = (SmartMessagingObject*) ladderBioComponent;
+	ladderBioComponent->SetMessageValue (sampleIsLadder, true);
 
-		//cout << "Sample quality test complete" << endl;
+	commentField = data->GetComment ();
+	ladderBioComponent->SetComments (commentField);
 
-		if (sampleOK)
-			bioComponent->TestPositiveControlSM (pGenotypes);
+	ignoreNoise = ladderBioComponent->GetIgnoreNoiseAboveDetectionInSmoothingFlag ();
+	SampledData::SetIgnoreNoiseAnalysisAboveDetectionInSmoothing (ignoreNoise);
 
-		// Moved this section because it requires setting artifact for signal, which must precede stage 4 and it should only depend on removing extraneous
-		// signals from each locus, which should be done in "SignalQualityTest" above.
-		//if (sampleOK)
-		//	bioComponent->TestPositiveControlSM (pGenotypes);
+	status = ladderBioComponent->AnalyzeGridSM (*data, &GridData);	// after this, stage 2 is complete; skip stage 3;
 
-		bioComponent->OrganizeNoticeObjectsSM ();  // Have to do this here, before last evaluation and adding smart message reporters!!
+	if (status >= 0)
+		ladderBioComponent->GetAllAmbientData (data);
 
-		bioComponent->SetMessageValue (stage5Successful, true);
-		bioComponent->EvaluateSmartMessagesAndTriggersForStage (commSM, numHigherObjects, 5, false, false);	// These do not include signals...already done
+	//
+	// End Stage 1 here!!!
+	//
+	
+	ladderBioComponent->SetMessageValue (stage1Successful, true);
+	ladderBioComponent->EvaluateSmartMessagesAndTriggersForStage (commSM, numHigherObjects, 1, true, false);
 
-		//cout << "Stage 5 complete" << endl;
+	if ((status >= 0) && (ladderBioComponent->AnalyzeGridLociSM (GridData.mText, GridData.mExcelText, GridData.mMsg, context.mPrint) < 0)) {
+
+		// ErrorString already populated; if status is already negative, we'll come here anyway
+		status = -4;
+	}
 
-//		bioComponent->EvaluateSmartMessagesForStage (commSM, numHigherObjects, 5, false, false);	// These do not include signals...already done
-//		bioComponent->SetTriggersForAllMessages (commSM, numHigherObjects, 5, false, false);
+	if (status == 0) {
 
-		if (!sampleOK)
-			bioComponent->LocatePositiveControlName (pGenotypes);
+		ladderBioComponent->SetProgress (6);
+	}
 
-		bioComponent->AddAllSmartMessageReporters (commSM, numHigherObjects);	// These do not include signals...already done
+	ladderBioComponent->MakeNonCoreLadderArtifactsNoncritical ();
 
-		if (bioComponent->SampleIsValid ()) {
+	//
+	// End Stage 2 here!!!
+	//
 
-			bioComponent->ReportSampleData(ExcelText);
-			bioComponent->WriteXMLGraphicDataSM (GraphicsDirectory, FileName, data, 4, PlotString);
-		}
+	ladderBioComponent->SetMessageValue (stage2Successful, true);
+	ladderBioComponent->EvaluateSmartMessagesAndTriggersForStage (commSM, numHigherObjects, 2, true, false);
 
-		bioComponent->PrepareLociForOutput ();
-		bioComponent->ReportSampleTableRow (ExcelSummary);
-		bioComponent->ReportSampleTableRowWithLinks (ExcelLinks);
-		bioComponent->ReportXMLSmartSampleTableRowWithLinks (XMLExcelLinks, tempXMLExcelLinks);
+	if (context.mPrintGraphics) {
+		
+		FitDataName = context.mGraphicsDirectory + "/Fit" + LadderFileName + ".txt";
+		SampleOutput = new RGTextOutput (FitDataName, FALSE);
 
-		bioComponent->ReportAllSmartNoticeObjects (tempExcelSummary, "", " ", FALSE);
-		bioComponent->ReportAllSmartNoticeObjects (tempExcelLinks, "", " ", TRUE);
-		//cout << "All data reported" << endl;
+		if (SampleOutput->FileIsValid ())
+			ladderBioComponent->WriteRawDataAndFitData (*SampleOutput, data);
 
-		SamplesProcessed++;
-		Progress = 100.0 * (double)SamplesProcessed / (double)NSampleFiles;
-		cout << "Progress = " << Progress << "%." << endl;
-		delete data;
-		delete bioComponent;
-		data = NULL;
-		bioComponent = NULL;
-		//cout << "Clean up time and on to the next" << endl;
+		else
+			cout << "Could not write graphics info to file " << FitDataName << ".  Skipping..." << endl;
+
+		delete SampleOutput;
+		SampleOutput = NULL;
 	}
 
-	if (!hasPosControl) {
+	delete data;
+	data = NULL;
+	job.mData = NULL;
+	
+	if ((status < 0) || (ladderBioComponent->GridQualityTestSM () < 0)) {
 
-		SetMessageValue (noPosCtrlFound, true);
+		ladderOK = false;
+		RGString ladderName = "-- " + ladderBioComponent->GetSampleName ();
+		ladderBioComponent->SetMessageValue (ladderFailed, true);
+		ladderBioComponent->AppendDataForSmartMessage (ladderFailed, ladderName);
 	}
 
-	if (!hasNegControl) {
+	ladderBioComponent->SetMessageValue (stage3Successful, true);
+	ladderBioComponent->EvaluateSmartMessagesAndTriggersForStage (commSM, numHigherObjects, 3, true, false);
 
-		SetMessageValue (noNegCtrlFound, true);
-	}
+	//
+	// Now end stages 4 and, for peaks only, stage 5
+	//
 
-finishOutput:
+	ladderBioComponent->SetMessageValue (stage4Successful, true);
+	ladderBioComponent->EvaluateSmartMessagesAndTriggersForStage (commSM, numHigherObjects, 4, true, false);
 
-	delete SampleDirectory;
-	delete pullupMatrixFile;
-	pullupMatrixFile = NULL;
+	if (ladderOK)
+		ladderBioComponent->RemoveInterlocusSignalsSM ();
 
-	for (i=1; i<=5; i++) {
+	if ((ladderOK) && (ladderBioComponent->GridQualityTestSMPart2 (commSM, numHigherObjects) < 0)) {
 
-		EvaluateSmartMessagesForStage (commSM, 1, i);
-		SetTriggersForAllMessages (commSM, 1, i);
+		ladderOK = false;
+		RGString ladderName = "-- " + ladderBioComponent->GetSampleName ();
+		ladderBioComponent->SetMessageValue (ladderFailed, true);
+		ladderBioComponent->AppendDataForSmartMessage (ladderFailed, ladderName);
 	}
 
-	numHigherObjects = 1;
+	ladderBioComponent->OrganizeNoticeObjectsSM ();
 
 	//
-	// Add all SmartMessageReporters for file level
+	// Finish stage 5 for grid and add all (non-signal) SmartMessageReporters
 	//
 
-	AddAllSmartMessageReporters (commSM, numHigherObjects);
+	ladderBioComponent->SetMessageValue (stage5Successful, true);
+	ladderBioComponent->EvaluateSmartMessagesAndTriggersForStage (commSM, numHigherObjects, 5, false, false);	// this is for non-signals only
+	ladderBioComponent->AddAllSmartMessageReporters (commSM, numHigherObjects);	// this does non-signals only; signals have already been done
+	job.mLadderFitSucceeded = ladderOK;
 
-	ExcelSummary << CLevel (1) << "\n" << PLevel ();
-	ExcelLinks << CLevel (1) << "\n" << PLevel ();
+	//
+	// The tables of the ladder are written when the ladder is reported; its notices go to the spooled analysis output
+	//
 
-	XMLExcelLinks << CLevel (1) << "\t</Table>\n" << PLevel ();
-	ReportXMLSmartNoticeObjects (XMLExcelLinks, tempXMLExcelLinks, " ");
-	XMLExcelLinks << CLevel (1) << "\t<Messages>\n" << PLevel ();
+	if (!ladderOK) {
 
-	tempXMLOutputSummaryLinks.Flush ();
-	tempXMLOutputSummaryLinks.Close ();
-	RGFile tempInputXMLSummaryLinks (tempXMLSummaryFullPathWithLinks, "rt");
+		NoticeStr = "BIOCOMPONENT COULD NOT ANALYZE LADDER.  Skipping...";
+		cout << NoticeStr << "Return = " << status << endl;
+		ExcelText << CLevel (1) << NoticeStr << "\n";
+		text << NoticeStr << "\n";
+		ExcelText << ladderBioComponent->GetError () << PLevel ();
+		text << ladderBioComponent->GetError ();
+	}
 
-	if (!tempInputXMLSummaryLinks.isValid ()) {
+	else {
 
-		cout << "Could not complete output xml summary; temporary file unavailable..." << endl;
-		return -5;
+		NoticeStr = "";
+		NoticeStr << context.mMarkerSetName.GetData () << " ladder fit was successful";
+		cout << NoticeStr << endl;
+		NoticeStr << "\n";
+		ExcelText.Write (1, NoticeStr);
+		text << NoticeStr;
 	}
+}
 
-	RGString in3;
-	in3.ReadTextFile (tempInputXMLSummaryLinks);
-	XMLExcelLinks << CLevel (1) << in3;
-	XMLExcelLinks << "\t</Messages>\n" << PLevel ();
-	SmartMessagingObject::ReportAllExportSpecifications (XMLExcelLinks);
-
-	// First add directory alerts and then...Merge here to get messages...
 
-	XMLExcelLinks << CLevel (1) << "</OsirisAnalysisReport>" << endLine << PLevel ();
-	SmartMessagingObject::ClearExportSpecifications ();
+void STRLCAnalysis :: ReportLadderSM (SampleAnalysisJob& job, SampleAnalysisContext& context) {
 
-	tempInputXMLSummaryLinks.Close ();
-	
-	ReportSmartNoticeObjects (ExcelSummary, "", " ", FALSE);
-	ReportSmartNoticeObjects (ExcelLinks, "", " ", TRUE);
+	CoreBioComponent* ladderBioComponent = job.mBioComponent;
+	double Progress;
+	Endl endLine;
 
-	tempOutputSummary.Flush ();
-	tempOutputSummary.Close ();
-	tempOutputSummaryLinks.Flush ();
-	tempOutputSummaryLinks.Close ();
+	if (context.mStatus < 0) {
 
-	LadderList.ClearAndDelete ();
-	delete SampleData;
-	delete GridData;
-	delete testPeak;
+		job.DiscardSpoolFiles ();	// a preceding ladder ended the analysis
+		return;
+	}
 
-	RGFile tempInputSummary (tempSummaryFullPath, "rt");
-	RGFile tempInputSummaryLinks (tempSummaryFullPathWithLinks, "rt");
+	job.AppendSpoolFiles (context);
 
-	if (!tempInputSummary.isValid ()) {
+	if (job.mStatus < 0) {
 
-		cout << "Could not complete output summary; temporary file unavailable..." << endl;
-		return -5;
+		*context.mXMLExcelLinks << CLevel (1) << "\t\t<Sample>\n\t\t\t<Name>Marker Set Mismatch</Name>\n\t\t\t<Type></Type>\n\t\t</Sample>\n" << PLevel ();
+		*context.mXMLExcelLinks << CLevel (1) << "\t</Table>\n" << PLevel ();
+		*context.mXMLExcelLinks << CLevel (1) << "</OsirisAnalysisReport>" << endLine << PLevel ();
+		context.mStatus = job.mStatus;
+		return;
 	}
 
-	if (!tempInputSummaryLinks.isValid ()) {
+	if (ladderBioComponent == NULL)
+		return;	// the file could not be read
 
-		cout << "Could not complete output summary; temporary file unavailable..." << endl;
-		return -5;
-	}
-	
-	RGString in1;
-	RGString in2;
+	context.mSamplesProcessed++;
+	Progress = 100.0 * (double)context.mSamplesProcessed / (double)context.mNumberOfSampleFiles;
+	cout << "Progress = " << Progress << "%." << endl;
 
-	in1.ReadTextFile (tempInputSummary);
-	in2.ReadTextFile (tempInputSummaryLinks);
+	if (mProgress != NULL)
+		mProgress->ReportProgress (context.mDirectoryName, Progress);
 
-	tempInputSummary.Close ();
-	tempInputSummaryLinks.Close ();
+	// Signal id's are numbered as if all preceding ladders had been fitted on this thread
 
-	// delete temporary files
+	DataSignal::SetSignalIDOffset (context.mSignalIDsUsed);
 
-	remove (tempSummaryFullPath.GetData ());
-	remove (tempSummaryFullPathWithLinks.GetData ());
-	remove (tempXMLSummaryFullPathWithLinks.GetData ());
+	ladderBioComponent->WriteXMLGraphicDataSM (context.mGraphicsDirectory, job.mFileName, NULL, 4, context.mPlotString);
+	ladderBioComponent->PrepareLociForOutput ();
+	ladderBioComponent->ReportGridTableRow (*context.mExcelSummary);
+	ladderBioComponent->ReportGridTableRowWithLinks (*context.mExcelLinks);
+	ladderBioComponent->ReportXMLSmartGridTableRowWithLinks (*context.mXMLExcelLinks, *context.mTempXMLExcelLinks);
+	ladderBioComponent->ReportAllSmartNoticeObjects (*context.mTempExcelSummary, "", " ", FALSE);
+	ladderBioComponent->ReportAllSmartNoticeObjects (*context.mTempExcelLinks, "", " ", TRUE);
 
-	ExcelSummary.SetOutputLevel (1);
-	ExcelLinks.SetOutputLevel (1);
+	context.mSignalIDsUsed += DataSignal::GetSignalIDCount () - context.mFirstSignalID;
+	DataSignal::SetSignalIDOffset (0);
 
-	ExcelSummary << in1 << "\n";
-	ExcelLinks << in2 << "\n";
-	
-	OutputFile.Flush ();
-	OutputFile.Close ();
+	if (!job.mLadderFitSucceeded)
+		return;
 
-	if (!foundALadder)
-		return -20;
+	context.mLadderList->Append (ladderBioComponent);
+	job.mBioComponent = NULL;	// now owned by the ladder list
 
-	return 0;
+	if (CollectILSHistory) {
+
+		ladderBioComponent->AddILSToHistory ();
+		cout << "Ladder ILS added to history..." << endl;
+	}
+
+	//  Find minILSBP for ladder locus and save
+
+	int temp = ladderBioComponent->GetMinimumILSBPForLoci ();
+
+	if (temp < context.mMinimumILSBPForLoci)
+		context.mMinimumILSBPForLoci = temp;
 }
 
 
 int STRLCAnalysis :: AnalyzeIncrementallySMLF (const RGString& prototypeInputDirectory, const RGString& markerSet, int outputLevel, const RGString& graphicsDirectory, const RGString& commandInputs) {
 
+	AnalysisContextScope settings (mAnalysisContext);	// this analysis's settings, whatever other analyses have set
+	ILSHistory ilsHistory;
+	ILSHistory ladderILSHistory;
+	LaneStandard::SetILSHistories (ilsHistory, ladderILSHistory);
+	NoticeNumbers noticeNumbers;
+	Notice::SetNoticeNumbers (noticeNumbers);
 	cout << "Ladder Free Analysis Function...\n";
 	
 	Boolean print = TRUE;
@@ -2511,6 +3056,7 @@ int STRLCAnalysis :: AnalyzeIncrementallySMLF (const RGString& prototypeInputDir
 
 	while (SampleDirectory->GetNextOrderedSampleFile (FileName)) {
 
+		RGArenaScope arena;	// released after the sample is reported and deleted
 		sampleOK = true;
 		FullPathName = DirectoryName + "/" + FileName;
 
@@ -2816,6 +3362,10 @@ int STRLCAnalysis :: AnalyzeIncrementallySMLF (const RGString& prototypeInputDir
 		SamplesProcessed++;
 		Progress = 100.0 * (double)SamplesProcessed / (double)NSampleFiles;
 		cout << "Progress = " << Progress << "%." << endl;
+
+		if (mProgress != NULL)
+			mProgress->ReportProgress (DirectoryName, Progress);
+
 		delete data;
 		delete bioComponent;
 		data = NULL;
@@ -3016,7 +3566,6 @@ int STRLCAnalysis :: AddAllSmartMessageReporters () {
 	int nMsgs = 0;
 	SmartMessageReporter* newMsg;
 	SmartMessage* nextSmartMsg;
-	SmartMessageData target;
 	SmartMessageData* smd;
 
 	RGDListIterator loci (mBaseLocusList);
@@ -3035,8 +3584,7 @@ int STRLCAnalysis :: AddAllSmartMessageReporters () {
 		if (!nextSmartMsg->EvaluateReport (mMessageArray))
 			continue;
 
-		target.SetIndex (i);
-		smd = (SmartMessageData*) mMessageDataTable->Find (&target);
+		smd = FindMessageData (i);
 		newMsg = new SmartMessageReporter;
 		newMsg->SetSmartMessage (nextSmartMsg);
 		
@@ -3061,7 +3609,6 @@ int STRLCAnalysis :: AddAllSmartMessageReporters (SmartMessagingComm& comm, int
 	int nMsgs = 0;
 	SmartMessageReporter* newMsg;
 	SmartMessage* nextSmartMsg;
-	SmartMessageData target;
 	SmartMessageData* smd;
 
 	bool editable;
@@ -3109,8 +3656,7 @@ int STRLCAnalysis :: AddAllSmartMessageReporters (SmartMessagingComm& comm, int
 		if (!report && !displayExport)
 			continue;
 
-		target.SetIndex (i);
-		smd = (SmartMessageData*) mMessageDataTable->Find (&target);
+		smd = FindMessageData (i);
 		newMsg = new SmartMessageReporter;
 		newMsg->SetSmartMessage (nextSmartMsg);
 		
@@ -3158,7 +3704,7 @@ Boolean STRLCAnalysis :: ReportSmartNoticeObjects (RGTextOutput& text, const RGS
 	if ((NumberOfSmartNoticeObjects () > 0) || (nBaseMsgs > 0)) {
 
 		int msgLevel = GetHighestMessageLevelWithRestrictionSM ();
-		RGDListIterator it (*mSmartMessageReporters);
+		RGDListIterator it (GetSmartMessageReporterList ());
 		SmartMessageReporter* nextNotice;
 		text.SetOutputLevel (msgLevel);
 
@@ -3206,7 +3752,7 @@ Boolean STRLCAnalysis :: ReportSmartNoticeObjects (RGTextOutput& text, const RGS
 	if ((NumberOfSmartNoticeObjects () > 0) || (nBaseMsgs > 0)) {
 
 		int msgLevel = GetHighestMessageLevelWithRestrictionSM ();
-		RGDListIterator it (*mSmartMessageReporters);
+		RGDListIterator it (GetSmartMessageReporterList ());
 		SmartMessageReporter* nextNotice;
 		text.SetOutputLevel (msgLevel);
 		RGString indent2 = indent + "\t";
@@ -3272,7 +3818,7 @@ Boolean STRLCAnalysis :: ReportXMLSmartNoticeObjects (RGTextOutput& text, RGText
 	if ((NumberOfSmartNoticeObjects () > 0) || (nBaseMsgs > 0)) {
 
 		int msgLevel = GetHighestMessageLevelWithRestrictionSM ();
-		RGDListIterator it (*mSmartMessageReporters);
+		RGDListIterator it (GetSmartMessageReporterList ());
 		SmartMessageReporter* nextNotice;
 //		text.SetOutputLevel (msgLevel);
 		tempText.SetOutputLevel (1);
@@ -3431,7 +3977,9 @@ void STRLCAnalysis :: ClearAllInitializationMatrices () {
 void STRLCAnalysis :: PreInitializeSmartMessages () {
 
 	mMessageArray = NULL;
+	mValueArray = NULL;
 	mMessageDataTable = NULL;
 	mSmartMessageReporters = NULL;
+	mUnenabledMessageReporters = NULL;
 }
 
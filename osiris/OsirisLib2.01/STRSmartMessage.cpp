@@ -61,12 +61,12 @@ bool mValid;
 
 
 
-ConditionalTriggerUnit :: ConditionalTriggerUnit () : RGPersistent (), mValid (false), mTriggerExpression (NULL) {
+ConditionalTriggerUnit :: ConditionalTriggerUnit () : RGPersistent (), mValid (false), mTriggerExpression (NULL), mTriggerProgram (NULL) {
 
 }
 
 
-ConditionalTriggerUnit :: ConditionalTriggerUnit (const RGString& triggerExpression) : RGPersistent (), mValid (false), mTriggerExpression (NULL) {
+ConditionalTriggerUnit :: ConditionalTriggerUnit (const RGString& triggerExpression) : RGPersistent (), mValid (false), mTriggerExpression (NULL), mTriggerProgram (NULL) {
 
 	// Assumes that the first character of triggerExpression is '('?
 	size_t rightParensLocation;
@@ -125,6 +125,7 @@ ConditionalTriggerUnit :: ConditionalTriggerUnit (const RGString& triggerExpress
 
 ConditionalTriggerUnit :: ~ConditionalTriggerUnit () {
 
+	delete mTriggerProgram;
 	delete mTriggerExpression;
 	mTriggerNames.ClearAndDelete ();
 	list<TriggerInfo*>::const_iterator c1Iterator;
@@ -178,6 +179,12 @@ int ConditionalTriggerUnit :: Initialize (int msgScope, SmartMessage* sourceMess
 		status = -1;
 	}
 
+	delete mTriggerProgram;
+	mTriggerProgram = NULL;
+
+	if (mTriggerExpression != NULL)
+		mTriggerProgram = new ExpressionProgram (mTriggerExpression);
+
 	return status;
 }
 
@@ -195,6 +202,8 @@ int ConditionalTriggerUnit :: Compile () {
 		return -1;
 	}
 
+	delete mTriggerProgram;
+	mTriggerProgram = new ExpressionProgram (mTriggerExpression);
 	return 0;
 }
 
@@ -211,8 +220,8 @@ bool ConditionalTriggerUnit :: SetAllTriggers (SmartMessagingComm& comm, int num
 	SmartMessagingObject* primeSMO = comm.SMOStack [lastObject];
 	SmartMessagingObject* targetSMO;
 
-	if (mTriggerExpression != NULL)
-		condition = mTriggerExpression->Evaluate (comm, numHigherObjects);
+	if (mTriggerProgram != NULL)
+		condition = mTriggerProgram->Evaluate (comm, numHigherObjects);
 
 	if (condition) {
 
@@ -231,7 +240,7 @@ bool ConditionalTriggerUnit :: SetAllTriggers (SmartMessagingComm& comm, int num
 
 				if (scope == targetSMO->GetObjectScope ()) {
 
-					targetSMO->SetMessageValue (scope, index, true);
+					targetSMO->SetMessageValueOnTrigger (scope, index);
 					break;
 				}
 			}
@@ -256,8 +265,8 @@ bool ConditionalTriggerUnit :: SetAllTriggers (SmartMessagingComm& comm, int num
 	SmartMessagingObject* primeSMO = comm.SMOStack [lastObject];
 	SmartMessagingObject* targetSMO;
 
-	if (mTriggerExpression != NULL)
-		condition = mTriggerExpression->Evaluate (comm, numHigherObjects);
+	if (mTriggerProgram != NULL)
+		condition = mTriggerProgram->Evaluate (comm, numHigherObjects);
 
 	if (condition) {
 
@@ -276,10 +285,7 @@ bool ConditionalTriggerUnit :: SetAllTriggers (SmartMessagingComm& comm, int num
 
 				if (scope == targetSMO->GetObjectScope ()) {
 
-					targetSMO->SetMessageValue (scope, index, true);
-
-					if (targetSMO->AcceptsDataOnTrigger (index))
-						targetSMO->AppendDataForSmartMessage (scope, index, intBP, alleleName);
+					targetSMO->SetMessageValueOnTrigger (scope, index, intBP, alleleName);
 
 					break;
 				}
@@ -311,6 +317,10 @@ mReportExpression (NULL),
 mAlternateReportExpression (NULL), 
 mCallExpression (NULL),
 mRestrictionExpression (NULL),
+mReportProgram (NULL),
+mAlternateReportProgram (NULL),
+mCallProgram (NULL),
+mRestrictionProgram (NULL),
 mEditable (true),
 mDisplayExportInfo (false),
 mExportReportMirrorsOarReport (true) {
@@ -325,6 +335,10 @@ mReportExpression (NULL),
 mAlternateReportExpression (NULL), 
 mCallExpression (NULL),
 mRestrictionExpression (NULL),
+mReportProgram (NULL),
+mAlternateReportProgram (NULL),
+mCallProgram (NULL),
+mRestrictionProgram (NULL),
 mEditable (true),
 mDisplayExportInfo (false),
 mExportReportMirrorsOarReport (true) {
@@ -346,6 +360,10 @@ mReportExpression (sm.mReportExpression),
 mAlternateReportExpression (sm.mAlternateReportExpression),
 mCallExpression (sm.mCallExpression),
 mRestrictionExpression (sm.mRestrictionExpression),
+mReportProgram (NULL),
+mAlternateReportProgram (NULL),
+mCallProgram (NULL),
+mRestrictionProgram (NULL),
 mEditable (sm.mEditable),
 mDisplayExportInfo (sm.mDisplayExportInfo),
 mExportReportMirrorsOarReport (sm.mExportReportMirrorsOarReport) {
@@ -361,12 +379,16 @@ mExportReportMirrorsOarReport (sm.mExportReportMirrorsOarReport) {
 
 	if (sm.mRestrictionExpression != NULL)
 		mRestrictionExpression = sm.mRestrictionExpression->MakeCopy ();
+
+	if ((sm.mReportProgram != NULL) || (sm.mAlternateReportProgram != NULL) || (sm.mCallProgram != NULL) || (sm.mRestrictionProgram != NULL))
+		CompileExpressionPrograms ();
 }
 
 
 
 STRBaseSmartMessage :: ~STRBaseSmartMessage () {
 
+	ClearExpressionPrograms ();
 	delete mReportExpression;
 	delete mAlternateReportExpression;
 	delete mCallExpression;
@@ -734,6 +756,36 @@ int STRBaseSmartMessage :: Configure (const RGString& inputString) {
 
 
 
+void STRBaseSmartMessage :: CompileExpressionPrograms () {
+
+	//  flattens the initialized expressions for evaluation
+
+	ClearExpressionPrograms ();
+
+	if (mReportExpression != NULL)
+		mReportProgram = new ExpressionProgram (mReportExpression);
+
+	if (mAlternateReportExpression != NULL)
+		mAlternateReportProgram = new ExpressionProgram (mAlternateReportExpression);
+
+	if (mCallExpression != NULL)
+		mCallProgram = new ExpressionProgram (mCallExpression);
+
+	if (mRestrictionExpression != NULL)
+		mRestrictionProgram = new ExpressionProgram (mRestrictionExpression);
+}
+
+
+void STRBaseSmartMessage :: ClearExpressionPrograms () {
+
+	delete mReportProgram;
+	delete mAlternateReportProgram;
+	delete mCallProgram;
+	delete mRestrictionProgram;
+	mReportProgram = mAlternateReportProgram = mCallProgram = mRestrictionProgram = NULL;
+}
+
+
 bool STRBaseSmartMessage :: CompileAll () {
 	
 	// compiles expressions
@@ -781,7 +833,10 @@ bool STRBaseSmartMessage :: CompileAll () {
 		if (ctu->Compile () < 0)
 			status = false;
 	}
-	
+
+	//  Initialize rebuilds these once message names are resolved; messages that skip initialization keep them
+
+	CompileExpressionPrograms ();
 	return status;
 }
 
@@ -826,6 +881,8 @@ int STRBaseSmartMessage :: Initialize () {
 			status = -1;
 	}
 
+	CompileExpressionPrograms ();
+
 	// Now we have to initialize the triggers...
 
 	TriggerInfo* nextLink;
@@ -982,8 +1039,8 @@ int STRBaseSmartMessage :: EvaluateReportLevel (const bool* msgMatrix) const {
 
 	bool altAns = false;
 
-	if (mAlternateReportExpression != NULL)
-		altAns = mAlternateReportExpression->EvaluateLocal (msgMatrix);
+	if (mAlternateReportProgram != NULL)
+		altAns = mAlternateReportProgram->EvaluateLocal (msgMatrix);
 
 	if (altAns)
 		return mAlternateReportLevel;
@@ -992,6 +1049,16 @@ int STRBaseSmartMessage :: EvaluateReportLevel (const bool* msgMatrix) const {
 }
 
 
+bool STRBaseSmartMessage :: GetReportLevelSpecification (SmartMessageReportLevel& spec) const {
+
+	spec.mElement = mWhichElementWithinDataArray;
+	spec.mReportLevel = mReportLevel;
+	spec.mAlternateReportLevel = mAlternateReportLevel;
+	spec.mAlternateReport = mAlternateReportProgram;
+	return true;
+}
+
+
 int STRBaseSmartMessage :: EvaluateReportLevel (SmartMessagingComm& comm, int numHigherObjects) const {
 
 	int i;
@@ -1011,8 +1078,8 @@ int STRBaseSmartMessage :: EvaluateReportLevel (SmartMessagingComm& comm, int nu
 
 			bool altAns = false;
 
-			if (mAlternateReportExpression != NULL)
-				altAns = mAlternateReportExpression->Evaluate (comm, numHigherObjects);
+			if (mAlternateReportProgram != NULL)
+				altAns = mAlternateReportProgram->Evaluate (comm, numHigherObjects);
 
 			if (altAns)
 				return mAlternateReportLevel;
@@ -1030,8 +1097,8 @@ bool STRBaseSmartMessage :: EvaluateReport (const bool* msgMatrix) const {
 	if (!msgMatrix [mWhichElementWithinDataArray])
 		return false;
 
-	if (mReportExpression != NULL)
-		return mReportExpression->EvaluateLocal (msgMatrix);
+	if (mReportProgram != NULL)
+		return mReportProgram->EvaluateLocal (msgMatrix);
 
 	return true;
 }
@@ -1054,8 +1121,8 @@ bool STRBaseSmartMessage :: EvaluateReport (SmartMessagingComm& comm, int numHig
 			if (!ans)
 				return false;
 
-			if (mReportExpression != NULL)
-				return mReportExpression->Evaluate (comm, numHigherObjects);
+			if (mReportProgram != NULL)
+				return mReportProgram->Evaluate (comm, numHigherObjects);
 
 			return true;
 		}
@@ -1076,8 +1143,8 @@ bool STRBaseSmartMessage :: EvaluateReportContingent (SmartMessagingComm& comm,
 
 		if (mScope == smo->GetObjectScope ()) {
 
-			if (mReportExpression != NULL)
-				return mReportExpression->Evaluate (comm, numHigherObjects);
+			if (mReportProgram != NULL)
+				return mReportProgram->Evaluate (comm, numHigherObjects);
 
 			return true;
 		}
@@ -1092,8 +1159,8 @@ bool STRBaseSmartMessage :: EvaluateCall (const bool* msgMatrix) const {
 	if (!msgMatrix [mWhichElementWithinDataArray])
 		return true;
 
-	if (mCallExpression != NULL)
-		return mCallExpression->EvaluateLocal (msgMatrix);
+	if (mCallProgram != NULL)
+		return mCallProgram->EvaluateLocal (msgMatrix);
 
 	return true;
 }
@@ -1116,8 +1183,8 @@ bool STRBaseSmartMessage :: EvaluateCall (SmartMessagingComm& comm, int numHighe
 			if (!ans)
 				return true;
 
-			if (mCallExpression != NULL)
-				return mCallExpression->Evaluate (comm, numHigherObjects);
+			if (mCallProgram != NULL)
+				return mCallProgram->Evaluate (comm, numHigherObjects);
 
 			return true;
 		}
@@ -1132,8 +1199,8 @@ bool STRBaseSmartMessage :: EvaluateRestriction (const bool* msgMatrix) const {
 	if (!msgMatrix [mWhichElementWithinDataArray])
 		return false;
 
-	if (mRestrictionExpression != NULL)
-		return mRestrictionExpression->EvaluateLocal (msgMatrix);
+	if (mRestrictionProgram != NULL)
+		return mRestrictionProgram->EvaluateLocal (msgMatrix);
 
 	return false;
 }
@@ -1156,8 +1223,8 @@ bool STRBaseSmartMessage :: EvaluateRestriction (SmartMessagingComm& comm, int n
 			if (!ans)
 				return false;
 
-			if (mRestrictionExpression != NULL)
-				return mRestrictionExpression->Evaluate (comm, numHigherObjects);
+			if (mRestrictionProgram != NULL)
+				return mRestrictionProgram->Evaluate (comm, numHigherObjects);
 
 			return false;
 		}
@@ -1482,7 +1549,7 @@ bool STRBaseSmartMessage :: SetAllTriggers (SmartMessagingComm& comm, int numHig
 
 					if (scope == targetSMO->GetObjectScope ()) {
 
-						targetSMO->SetMessageValue (scope, index, true);
+						targetSMO->SetMessageValueOnTrigger (scope, index);
 						break;
 					}
 				}
@@ -1537,10 +1604,7 @@ bool STRBaseSmartMessage :: SetAllTriggers (SmartMessagingComm& comm, int numHig
 
 					if (scope == targetSMO->GetObjectScope ()) {
 
-						targetSMO->SetMessageValue (scope, index, true);
-
-						if (targetSMO->AcceptsDataOnTrigger (index))
-							targetSMO->AppendDataForSmartMessage (scope, index, intBP, alleleName);
+						targetSMO->SetMessageValueOnTrigger (scope, index, intBP, alleleName);
 
 						break;
 					}
@@ -1561,6 +1625,12 @@ bool STRBaseSmartMessage :: SetAllTriggers (SmartMessagingComm& comm, int numHig
 }
 
 
+bool STRBaseSmartMessage :: HasTriggers () const {
+
+	return (!mTriggers.empty () || (mConditionalTriggerUnits.Entries () > 0));
+}
+
+
 bool STRBaseSmartMessage :: AddDataItem (const RGString& data, RGHashTable* dataArray) const {
 
 	SmartMessageData test (mWhichElementWithinDataArray);
@@ -1686,16 +1756,27 @@ void STRBaseSmartMessage :: SetMessageValue (bool* const msgMatrix, int* const v
 
 size_t STRBaseSmartMessage :: StoreSize () const {
 
-	size_t size = SmartMessage::StoreSize () + 2 * sizeof (int) + 3 * sizeof (Expression*);
+	size_t size = SmartMessage::StoreSize () + 7 * sizeof (int);
 	size += mReportCriterion.StoreSize ();
 	size += mAlternateReportCriterion.StoreSize () + mCallCriterion.StoreSize ();
 	size += mTriggerNames.StoreSize ();
+	size += mRestrictionCriterion.StoreSize () + mExportProtocolList.StoreSize ();
+	list<DebugInfo*>::const_iterator c1Iterator;
+
+	for (c1Iterator = mWatchInfo.begin (); c1Iterator != mWatchInfo.end (); c1Iterator++)
+		size += (*c1Iterator)->mName->StoreSize ();
+
 	return size;
 }
 
 
 void STRBaseSmartMessage :: RestoreAll (RGFile& f) {
 
+	int value;
+	int n;
+	int i;
+	DebugInfo* debugInfo;
+
 	SmartMessage::RestoreAll (f);
 	mReportCriterion.RestoreAll (f);
 	f.Read (mReportLevel);
@@ -1704,11 +1785,35 @@ void STRBaseSmartMessage :: RestoreAll (RGFile& f) {
 	mCallCriterion.RestoreAll (f);
 	mTriggerNames.ClearAndDelete ();
 	mTriggerNames.RestoreAll (f);
+	f.Read (mRestrictionLevel);
+	mRestrictionCriterion.RestoreAll (f);
+	f.Read (value);
+	mEditable = (value != 0);
+	f.Read (value);
+	mDisplayExportInfo = (value != 0);
+	f.Read (value);
+	mExportReportMirrorsOarReport = (value != 0);
+	mExportProtocolList.RestoreAll (f);
+	ClearDebugList ();
+	f.Read (n);
+
+	for (i=0; i<n; i++) {
+
+		debugInfo = new DebugInfo;
+		debugInfo->mName->RestoreAll (f);
+		debugInfo->mIndex = debugInfo->mScope = 0;
+		mWatchInfo.push_back (debugInfo);
+	}
 }
 
 
 void STRBaseSmartMessage :: RestoreAll (RGVInStream& f) {
 
+	int value;
+	int n;
+	int i;
+	DebugInfo* debugInfo;
+
 	SmartMessage::RestoreAll (f);
 	mReportCriterion.RestoreAll (f);
 	f >> mReportLevel;
@@ -1717,11 +1822,32 @@ void STRBaseSmartMessage :: RestoreAll (RGVInStream& f) {
 	mCallCriterion.RestoreAll (f);
 	mTriggerNames.ClearAndDelete ();
 	mTriggerNames.RestoreAll (f);
+	f >> mRestrictionLevel;
+	mRestrictionCriterion.RestoreAll (f);
+	f >> value;
+	mEditable = (value != 0);
+	f >> value;
+	mDisplayExportInfo = (value != 0);
+	f >> value;
+	mExportReportMirrorsOarReport = (value != 0);
+	mExportProtocolList.RestoreAll (f);
+	ClearDebugList ();
+	f >> n;
+
+	for (i=0; i<n; i++) {
+
+		debugInfo = new DebugInfo;
+		debugInfo->mName->RestoreAll (f);
+		debugInfo->mIndex = debugInfo->mScope = 0;
+		mWatchInfo.push_back (debugInfo);
+	}
 }
 
 
 void STRBaseSmartMessage :: SaveAll (RGFile& f) const {
 
+	list<DebugInfo*>::const_iterator c1Iterator;
+
 	SmartMessage::SaveAll (f);
 	mReportCriterion.SaveAll (f);
 	f.Write (mReportLevel);
@@ -1729,11 +1855,23 @@ void STRBaseSmartMessage :: SaveAll (RGFile& f) const {
 	mAlternateReportCriterion.SaveAll (f);
 	mCallCriterion.SaveAll (f);
 	mTriggerNames.SaveAll (f);
+	f.Write (mRestrictionLevel);
+	mRestrictionCriterion.SaveAll (f);
+	f.Write ((int) mEditable);
+	f.Write ((int) mDisplayExportInfo);
+	f.Write ((int) mExportReportMirrorsOarReport);
+	mExportProtocolList.SaveAll (f);
+	f.Write ((int) mWatchInfo.size ());
+
+	for (c1Iterator = mWatchInfo.begin (); c1Iterator != mWatchInfo.end (); c1Iterator++)
+		(*c1Iterator)->mName->SaveAll (f);
 }
 
 
 void STRBaseSmartMessage :: SaveAll (RGVOutStream& f) const {
 
+	list<DebugInfo*>::const_iterator c1Iterator;
+
 	SmartMessage::SaveAll (f);
 	mReportCriterion.SaveAll (f);
 	f << mReportLevel;
@@ -1741,6 +1879,16 @@ void STRBaseSmartMessage :: SaveAll (RGVOutStream& f) const {
 	mAlternateReportCriterion.SaveAll (f);
 	mCallCriterion.SaveAll (f);
 	mTriggerNames.SaveAll (f);
+	f << mRestrictionLevel;
+	mRestrictionCriterion.SaveAll (f);
+	f << (int) mEditable;
+	f << (int) mDisplayExportInfo;
+	f << (int) mExportReportMirrorsOarReport;
+	mExportProtocolList.SaveAll (f);
+	f << (int) mWatchInfo.size ();
+
+	for (c1Iterator = mWatchInfo.begin (); c1Iterator != mWatchInfo.end (); c1Iterator++)
+		(*c1Iterator)->mName->SaveAll (f);
 }
 
 
@@ -2076,29 +2224,33 @@ void STRBaseSmartMessage :: ClearDebugList () {
 
 
 
-STRSmartMessage :: STRSmartMessage () : STRBaseSmartMessage (), mTestExpression (NULL) {
+STRSmartMessage :: STRSmartMessage () : STRBaseSmartMessage (), mTestExpression (NULL), mTestProgram (NULL) {
 
 }
 
 
 STRSmartMessage :: STRSmartMessage (int integerData, const RGString& name) : STRBaseSmartMessage (integerData, name), 
-mTestExpression (NULL) {
+mTestExpression (NULL), mTestProgram (NULL) {
 
 }
 
 
 
 STRSmartMessage :: STRSmartMessage (const STRSmartMessage& sm) : STRBaseSmartMessage (sm), mTestCriterion (sm.mTestCriterion),
-mTestExpression (sm.mTestExpression) {
+mTestExpression (sm.mTestExpression), mTestProgram (NULL) {
 
 	if (sm.mTestExpression != NULL)
 		mTestExpression = sm.mTestExpression->MakeCopy ();
+
+	if ((sm.mTestProgram != NULL) && (mTestExpression != NULL))
+		mTestProgram = new ExpressionProgram (mTestExpression);
 }
 
 
 
 STRSmartMessage :: ~STRSmartMessage () {
 
+	delete mTestProgram;
 	delete mTestExpression;
 }
 
@@ -2165,6 +2317,12 @@ bool STRSmartMessage :: CompileAll () {
 
 		if (mTestExpression == NULL)
 			status = false;
+
+		else {
+
+			delete mTestProgram;
+			mTestProgram = new ExpressionProgram (mTestExpression);
+		}
 	}
 
 	if (!STRBaseSmartMessage::CompileAll ())
@@ -2188,6 +2346,9 @@ int STRSmartMessage :: Initialize () {
 
 		if (result < 0)
 			status = -1;
+
+		delete mTestProgram;
+		mTestProgram = new ExpressionProgram (mTestExpression);
 	}
 
 	result = STRBaseSmartMessage::Initialize ();
@@ -2249,9 +2410,9 @@ bool STRSmartMessage :: Evaluate (SmartMessagingComm& comm, int numHigherObjects
 
 			ans = smo->GetMessageValue (mWhichElementWithinDataArray);
 
-			if ((mTestExpression != NULL) && !(ans && mShareWithCluster)) {
+			if ((mTestProgram != NULL) && !(ans && mShareWithCluster)) {
 
-				ans = mTestExpression->Evaluate (comm, numHigherObjects);
+				ans = mTestProgram->Evaluate (comm, numHigherObjects);
 				smo->SetMessageValue (mScope, mWhichElementWithinDataArray, ans, false);
 			}
 
@@ -2268,6 +2429,17 @@ bool STRSmartMessage :: Evaluate (SmartMessagingComm& comm, int numHigherObjects
 }
 
 
+const ExpressionProgram* STRSmartMessage :: GetIncrementalTestProgram () const {
+
+	//  Evaluate has further effects if debugging or if a true value is shared with a cluster of peaks
+
+	if (mDebugOn || mShareWithCluster)
+		return NULL;
+
+	return mTestProgram;
+}
+
+
 size_t STRSmartMessage :: StoreSize () const {
 
 	size_t size = STRBaseSmartMessage::StoreSize () + sizeof (Expression*);
@@ -45,6 +45,7 @@
 #include <list>
 
 class Expression;
+class ExpressionProgram;
 
 const int _STRSMARTMESSAGE_ = 2000;
 const int _STRBASESMARTMESSAGE_ = 2004;
@@ -99,6 +100,7 @@ protected:
 	bool mValid;
 	RGString mExpressionString;
 	Expression* mTriggerExpression;
+	ExpressionProgram* mTriggerProgram;
 	RGDList mTriggerNames;
 	list<TriggerInfo*> mTriggers;
 };
@@ -137,6 +139,9 @@ public:
 
 	virtual int EvaluateReportLevel (const bool* msgMatrix) const;
 	virtual int EvaluateReportLevel (SmartMessagingComm& comm, int numHigherObjects) const;
+	virtual bool GetReportLevelSpecification (SmartMessageReportLevel& spec) const;
+	virtual bool EvaluationCanChangeState () const { return false; }
+	virtual bool HasTriggers () const;
 
 	virtual bool EvaluateReport (const bool* msgMatrix) const;
 	virtual bool EvaluateReport (SmartMessagingComm& comm, int numHigherObjects) const;
@@ -207,6 +212,11 @@ protected:
 	Expression* mCallExpression;
 	Expression* mRestrictionExpression;
 
+	ExpressionProgram* mReportProgram;
+	ExpressionProgram* mAlternateReportProgram;
+	ExpressionProgram* mCallProgram;
+	ExpressionProgram* mRestrictionProgram;
+
 	bool mEditable;
 	bool mDisplayExportInfo;
 	bool mExportReportMirrorsOarReport;
@@ -214,6 +224,8 @@ protected:
 
 	void ClearTriggerList ();
 	void ClearDebugList ();
+	void CompileExpressionPrograms ();
+	void ClearExpressionPrograms ();
 };
 
 
@@ -237,6 +249,8 @@ public:
 
 	virtual bool Evaluate (bool* const msgMatrix, RGDList& subObjects) const;
 	virtual bool Evaluate (SmartMessagingComm& comm, int numHigherObjects) const;
+	virtual bool EvaluationCanChangeState () const { return (mTestProgram != NULL) || mDebugOn; }
+	virtual const ExpressionProgram* GetIncrementalTestProgram () const;
 
 	virtual size_t StoreSize () const;
 
@@ -248,6 +262,7 @@ public:
 protected:
 	RGString mTestCriterion;  // expression to be evaluated; if empty, this is a primitive, hard set by code
 	Expression* mTestExpression;
+	ExpressionProgram* mTestProgram;
 };
 
 
@@ -274,6 +289,7 @@ public:
 
 	virtual bool Evaluate (bool* const msgMatrix, RGDList& subObjects) const;
 	virtual bool Evaluate (SmartMessagingComm& comm, int numHigherObjects) const;
+	virtual bool EvaluationCanChangeState () const { return true; }
 	virtual void SetMessageValue (bool* const msgMatrix, int* const valueMatrix, int index, bool value);
 
 	virtual size_t StoreSize () const;
@@ -314,6 +330,7 @@ public:
 
 	virtual bool Evaluate (bool* const msgMatrix, RGDList& subObjects) const;
 	virtual bool Evaluate (SmartMessagingComm& comm, int numHigherObjects) const;
+	virtual bool EvaluationCanChangeState () const { return true; }
 	virtual void SetMessageValue (bool* const msgMatrix, int* const valueMatrix, int index, bool value);
 
 	virtual size_t StoreSize () const;
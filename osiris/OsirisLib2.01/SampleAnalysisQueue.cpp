@@ -0,0 +1,653 @@
+/*
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+*  FileName: SampleAnalysisQueue.cpp
+*  Author:   Robert Goor
+*
+*/
+//
+//  class SampleAnalysisQueue hands out the ladders, and then the samples, of a directory to the threads of
+//  STRLCAnalysis::AnalyzeIncrementallySM and makes the threads report them in directory order; class ChannelFitQueue
+//  fits the channels of one ladder or sample concurrently
+//
+
+#include "SampleAnalysisQueue.h"
+#include "STRLCAnalysis.h"
+#include "fsaFileData.h"
+#include "CoreBioComponent.h"
+#include "ChannelData.h"
+#include "DataSignal.h"
+#include "DirectoryManager.h"
+#include "rgarena.h"
+#include <stdio.h>
+
+
+SampleAnalysisContext :: SampleAnalysisContext () : mQueue (NULL), mUseSpoolFiles (false), mCache (NULL), mReuseResults (false), mOutputLevel (1),
+mPrint (TRUE), mPrintGraphics (false), mMakeMixturesDefaultType (false), mUseSampleNamesForControlSampleTests (false), mLadderList (NULL),
+mServer (NULL), mGenotypes (NULL), mTestPeak (NULL), mText (NULL), mExcelText (NULL), mMessage (NULL), mPullupFractions (NULL),
+mPullupMatrix (NULL), mExcelSummary (NULL), mExcelLinks (NULL), mXMLExcelLinks (NULL), mTempXMLExcelLinks (NULL),
+mTempExcelSummary (NULL), mTempExcelLinks (NULL), mHasPositiveControl (false), mHasNegativeControl (false),
+mPopulatedBaseLocusList (false), mSamplesProcessed (0), mNumberOfSampleFiles (0), mFirstSignalID (0), mSignalIDsUsed (0),
+mExpectedNumberOfChannels (0), mMinimumILSBPForLoci (0), mStatus (0) {
+
+}
+
+
+RGLogBook* SampleAnalysisContext :: GetReportOutput (int output) const {
+
+	switch (output) {
+
+		case SampleResult::ReportTabOutput:
+			return mExcelText;
+
+		case SampleResult::SummaryOutput:
+			return mExcelSummary;
+
+		case SampleResult::SummaryLinksOutput:
+			return mExcelLinks;
+
+		case SampleResult::XMLSummaryOutput:
+			return mXMLExcelLinks;
+
+		case SampleResult::TempXMLSummaryOutput:
+			return mTempXMLExcelLinks;
+
+		case SampleResult::TempSummaryOutput:
+			return mTempExcelSummary;
+
+		case SampleResult::TempSummaryLinksOutput:
+			return mTempExcelLinks;
+	}
+
+	return NULL;
+}
+
+
+RGString SampleAnalysisContext :: GetGraphicsFileName (const RGString& fileName) const {
+
+	RGString name = fileName;
+
+	if (name.ExtractLastCharacters (4) == DirectoryManager::GetDataFileTypeWithDot ())
+		name.ExtractAndRemoveLastCharacters (4);
+
+	return mGraphicsDirectory + "/" + name + ".plt";
+}
+
+
+SampleAnalysisJob :: SampleAnalysisJob (int number, const RGString& fileName) : mNumber (number), mFileName (fileName), mData (NULL),
+mBioComponent (NULL), mSamplePrepared (false), mIsPositiveControl (false), mIsNegativeControl (false), mLadderFitSucceeded (false),
+mStatus (0), mResult (NULL), mReusesResult (false), mText (NULL), mTabFile (NULL),
+mExcelText (NULL), mMessage (NULL), mPullupFractions (NULL), mPullupMatrix (NULL) {
+
+	int i;
+
+	for (i=0; i<SampleResult::NumberOfReportOutputs; i++) {
+
+		mReportFiles [i] = NULL;
+		mReportSpools [i] = NULL;
+	}
+}
+
+
+SampleAnalysisJob :: ~SampleAnalysisJob () {
+
+	CloseSpoolFiles ();
+	CloseReportSpools ();
+	delete mResult;
+	delete mData;
+	delete mBioComponent;
+}
+
+
+int SampleAnalysisJob :: OpenSpoolFiles (const SampleAnalysisContext& context) {
+
+	mSpoolName = context.mSpoolName;
+	mSpoolName << mNumber;
+	mText = new RGTextOutput (mSpoolName + "Console.txt", FALSE);
+	mTabFile = new RGFile (mSpoolName + ".tab", "wt");
+	mExcelText = new RGLogBook (mTabFile, context.mOutputLevel, FALSE);
+	mMessage = new OsirisMsg (mTabFile, "\t", 10);
+
+	if (context.mPullupFractions != NULL)
+		mPullupFractions = new RGTextOutput (mSpoolName + "Pullup.tab", FALSE);
+
+	if (context.mPullupMatrix != NULL)
+		mPullupMatrix = new RGTextOutput (mSpoolName + "Matrix.txt", FALSE);
+
+	if (!mText->FileIsValid () || !mTabFile->isValid () || ((mPullupFractions != NULL) && !mPullupFractions->FileIsValid ()) ||
+		((mPullupMatrix != NULL) && !mPullupMatrix->FileIsValid ()))
+		return -1;
+
+	return 0;
+}
+
+
+void SampleAnalysisJob :: AppendSpoolFiles (SampleAnalysisContext& context) {
+
+	if (mText == NULL)
+		return;
+
+	CloseSpoolFiles ();
+	AppendSpoolFile (mSpoolName + "Console.txt", context.mText);
+	AppendSpoolFile (mSpoolName + ".tab", context.mExcelText);
+
+	if (context.mPullupFractions != NULL)
+		AppendSpoolFile (mSpoolName + "Pullup.tab", context.mPullupFractions);
+
+	if (context.mPullupMatrix != NULL)
+		AppendSpoolFile (mSpoolName + "Matrix.txt", context.mPullupMatrix);
+}
+
+
+void SampleAnalysisJob :: DiscardSpoolFiles () {
+
+	if (mText == NULL)
+		return;
+
+	CloseSpoolFiles ();
+	remove ((mSpoolName + "Console.txt").GetData ());
+	remove ((mSpoolName + ".tab").GetData ());
+	remove ((mSpoolName + "Pullup.tab").GetData ());
+	remove ((mSpoolName + "Matrix.txt").GetData ());
+}
+
+
+void SampleAnalysisJob :: MoveSpoolFilesToResult () {
+
+	if ((mText == NULL) || (mResult == NULL))
+		return;
+
+	CloseSpoolFiles ();
+	ReadSpoolFile (mSpoolName + "Console.txt", mResult->mOutputs [SampleResult::ConsoleOutput]);
+	ReadSpoolFile (mSpoolName + ".tab", mResult->mOutputs [SampleResult::AnalysisTabOutput]);
+	ReadSpoolFile (mSpoolName + "Pullup.tab", mResult->mOutputs [SampleResult::PullupFractionsOutput]);
+	ReadSpoolFile (mSpoolName + "Matrix.txt", mResult->mOutputs [SampleResult::PullupMatrixOutput]);
+}
+
+
+int SampleAnalysisJob :: OpenReportSpools (const SampleAnalysisContext& context) {
+
+	int i;
+	int status = 0;
+	RGLogBook* target;
+
+	for (i=0; i<SampleResult::NumberOfReportOutputs; i++) {
+
+		target = context.GetReportOutput (SampleResult::FirstReportOutput + i);
+
+		if (target == NULL)
+			continue;
+
+		mReportFiles [i] = RGFile::CreateTemporaryFile ();
+		mReportSpools [i] = (RGLogBook*) target->CreateSpool (mReportFiles [i]);
+		mReportSpools [i]->CopyOutputLevels (*target);
+		mReportSpools [i]->MarkNumbers (SampleResultCache::SignalIDBase + 1, SampleResultCache::MessageNumberBase + SampleResultCache::NumberRange);
+
+		if (!mReportFiles [i]->isValid ())
+			status = -1;
+	}
+
+	return status;
+}
+
+
+void SampleAnalysisJob :: MoveReportSpoolsToResult () {
+
+	int i;
+
+	if (mResult == NULL)
+		return;
+
+	for (i=0; i<SampleResult::NumberOfReportOutputs; i++) {
+
+		if (mReportFiles [i] == NULL)
+			continue;
+
+		delete mReportSpools [i];	// flushes spool
+		mReportSpools [i] = NULL;
+		mReportFiles [i]->SeekToBegin ();
+		mResult->mOutputs [SampleResult::FirstReportOutput + i].ReadTextFile (*mReportFiles [i]);
+	}
+
+	CloseReportSpools ();
+}
+
+
+RGLogBook& SampleAnalysisJob :: GetReportOutput (const SampleAnalysisContext& context, int output) {
+
+	RGLogBook* spool = mReportSpools [output - SampleResult::FirstReportOutput];
+
+	if (spool != NULL)
+		return *spool;
+
+	return *context.GetReportOutput (output);
+}
+
+
+void SampleAnalysisJob :: AppendResult (SampleAnalysisContext& context, unsigned long lastSignalID, int lastLinkNumber, int lastMessageNumber) {
+
+	//
+	//  Writes every output of the result, except its graphics, with its reserved numbers replaced by the next numbers of this
+	//  analysis.  Output levels were already applied when the result was spooled.
+	//
+
+	RGTextOutput* targets [SampleResult::GraphicsOutput];
+	int i;
+
+	if (mResult == NULL)
+		return;
+
+	targets [SampleResult::ConsoleOutput] = context.mText;
+	targets [SampleResult::AnalysisTabOutput] = context.mExcelText;
+	targets [SampleResult::PullupFractionsOutput] = context.mPullupFractions;
+	targets [SampleResult::PullupMatrixOutput] = context.mPullupMatrix;
+
+	for (i=SampleResult::FirstReportOutput; i<SampleResult::GraphicsOutput; i++)
+		targets [i] = context.GetReportOutput (i);
+
+	for (i=0; i<SampleResult::GraphicsOutput; i++) {
+
+		if ((targets [i] != NULL) && (mResult->mOutputs [i].Length () > 0))
+			targets [i]->Write (SampleResultCache::Renumber (mResult->mOutputs [i], lastSignalID, lastLinkNumber, lastMessageNumber));
+	}
+}
+
+
+void SampleAnalysisJob :: CloseReportSpools () {
+
+	int i;
+
+	for (i=0; i<SampleResult::NumberOfReportOutputs; i++) {
+
+		delete mReportSpools [i];
+		delete mReportFiles [i];	// temporary files are removed when closed
+		mReportSpools [i] = NULL;
+		mReportFiles [i] = NULL;
+	}
+}
+
+
+void SampleAnalysisJob :: CloseSpoolFiles () {
+
+	delete mText;
+	delete mExcelText;
+	delete mMessage;
+	delete mPullupFractions;
+	delete mPullupMatrix;
+	mText = NULL;
+	mExcelText = NULL;
+	mMessage = NULL;
+	mPullupFractions = NULL;
+	mPullupMatrix = NULL;
+
+	if (mTabFile != NULL) {
+
+		mTabFile->Flush ();
+		mTabFile->Close ();
+		delete mTabFile;
+		mTabFile = NULL;
+	}
+}
+
+
+void SampleAnalysisJob :: AppendSpoolFile (const RGString& spoolName, RGTextOutput* target) {
+
+	RGFile spool (spoolName, "rt");
+
+	if (spool.isValid ()) {
+
+		RGString contents;
+		contents.ReadTextFile (spool);
+		spool.Close ();
+
+		if (target != NULL)
+			target->Write (contents);	// unconditional:  output level was already applied when the spool was written
+	}
+
+	remove (spoolName.GetData ());
+}
+
+
+void SampleAnalysisJob :: ReadSpoolFile (const RGString& spoolName, RGString& contents) {
+
+	RGFile spool (spoolName, "rt");
+	contents = "";
+
+	if (spool.isValid ()) {
+
+		contents.ReadTextFile (spool);
+		spool.Close ();
+	}
+
+	remove (spoolName.GetData ());
+}
+
+
+SampleAnalysisQueue :: SampleAnalysisQueue () : mNextJob (0), mCurrentTurn (0) {
+
+}
+
+
+SampleAnalysisQueue :: ~SampleAnalysisQueue () {
+
+	vector<SampleAnalysisJob*>::iterator it;
+
+	for (it = mJobs.begin (); it != mJobs.end (); it++)
+		delete *it;
+
+	mJobs.clear ();
+}
+
+
+SampleAnalysisJob* SampleAnalysisQueue :: GetNextJob () {
+
+	RGLock lock (mMutex);
+
+	if (mNextJob >= (int) mJobs.size ())
+		return NULL;
+
+	SampleAnalysisJob* job = mJobs [mNextJob];
+	mNextJob++;
+	return job;
+}
+
+
+void SampleAnalysisQueue :: WaitForTurn (const SampleAnalysisJob& job) {
+
+	RGLock lock (mMutex);
+
+	while (mJobs [mCurrentTurn] != &job)
+		mTurnChanged.Wait (mMutex);
+}
+
+
+void SampleAnalysisQueue :: EndTurn () {
+
+	RGLock lock (mMutex);
+	mCurrentTurn++;
+	mTurnChanged.Broadcast ();
+}
+
+
+void SampleAnalysisQueue :: ApplySharedUpdates () {
+
+	vector<SampleAnalysisJob*>::iterator it;
+
+	for (it = mJobs.begin (); it != mJobs.end (); it++)
+		(*it)->mSharedUpdates.Apply ();
+}
+
+
+void SampleAnalysisThread :: Run () {
+
+	mAnalysis->ProcessSampleJobsSM (*mContext);
+}
+
+
+void LadderAnalysisThread :: Run () {
+
+	mAnalysis->ProcessLadderJobsSM (*mContext);
+}
+
+
+ChannelFitJob :: ChannelFitJob (int channel, ChannelData* data) : mChannel (channel), mData (data), mStatus (0), mSignalIDsUsed (0),
+mText (NULL), mExcelText (NULL), mMessage (NULL), mTextFile (NULL), mExcelFile (NULL) {
+
+}
+
+
+ChannelFitJob :: ~ChannelFitJob () {
+
+	CloseSpoolFiles ();
+}
+
+
+int ChannelFitJob :: OpenSpoolFiles (const RGTextOutput& text, const RGTextOutput& excelText) {
+
+	mTextFile = RGFile::CreateTemporaryFile ();
+	mText = text.CreateSpool (mTextFile);
+
+	if (&excelText == &text) {
+
+		mExcelText = mText;
+		mMessage = new OsirisMsg (mTextFile, "\t", 10);
+	}
+
+	else {
+
+		mExcelFile = RGFile::CreateTemporaryFile ();
+		mExcelText = excelText.CreateSpool (mExcelFile);
+		mMessage = new OsirisMsg (mExcelFile, "\t", 10);
+	}
+
+	if (!mTextFile->isValid () || ((mExcelFile != NULL) && !mExcelFile->isValid ()))
+		return -1;
+
+	return 0;
+}
+
+
+void ChannelFitJob :: AppendSpoolFiles (RGTextOutput& text, RGTextOutput& excelText) {
+
+	if (mTextFile == NULL)
+		return;
+
+	if (mExcelText != mText)
+		delete mExcelText;
+
+	delete mText;	// flushes spool
+	delete mMessage;
+	mText = NULL;
+	mExcelText = NULL;
+	mMessage = NULL;
+
+	AppendSpoolFile (mTextFile, text);
+
+	if (mExcelFile != NULL)
+		AppendSpoolFile (mExcelFile, excelText);
+
+	CloseSpoolFiles ();
+}
+
+
+void ChannelFitJob :: CloseSpoolFiles () {
+
+	if (mExcelText != mText)
+		delete mExcelText;
+
+	delete mText;
+	delete mMessage;
+	delete mTextFile;	// temporary files are removed when closed
+	delete mExcelFile;
+	mText = NULL;
+	mExcelText = NULL;
+	mMessage = NULL;
+	mTextFile = NULL;
+	mExcelFile = NULL;
+}
+
+
+void ChannelFitJob :: AppendSpoolFile (RGFile* spool, RGTextOutput& target) {
+
+	RGString contents;
+	spool->SeekToBegin ();
+	contents.ReadTextFile (*spool);
+	target.Write (contents);	// unconditional:  output level was already applied when the spool was written
+}
+
+
+ChannelFitQueue :: ChannelFitQueue (RGTextOutput& text, RGTextOutput& excelText, OsirisMsg& msg, Boolean print) : mNextJob (0),
+mText (text), mExcelText (excelText), mMessage (msg), mPrint (print), mFirstSignalID (0), mUsesArenas (false) {
+
+}
+
+
+ChannelFitQueue :: ~ChannelFitQueue () {
+
+	vector<ChannelFitJob*>::iterator it;
+
+	for (it = mJobs.begin (); it != mJobs.end (); it++)
+		delete *it;
+
+	mJobs.clear ();
+}
+
+
+void ChannelFitQueue :: FitAll (int nThreads) {
+
+	//
+	//  Each channel is fitted starting from the same settings and signal id count.  Afterwards, the output is
+	//  appended and the new signal ids are offset in channel order, and the calling thread takes the settings
+	//  left by the last channel, as if the channels had been fitted one at a time.
+	//
+
+	vector<ChannelFitJob*>::iterator it;
+	set<DataSignal*>::iterator signalIt;
+	ChannelFitJob* job;
+	ChannelFitThread** threads;
+	int i;
+
+	if (nThreads > 1) {
+
+		for (it = mJobs.begin (); it != mJobs.end (); it++) {
+
+			if ((*it)->OpenSpoolFiles (mText, mExcelText) < 0) {
+
+				nThreads = 1;	// fit in the calling thread, writing directly to the outputs
+				break;
+			}
+		}
+
+		if (nThreads <= 1) {
+
+			for (it = mJobs.begin (); it != mJobs.end (); it++)
+				(*it)->CloseSpoolFiles ();
+		}
+	}
+
+	SmartMessageUpdateLog* sharedUpdates = SmartMessagingObject::GetSharedUpdateLog ();
+	mAnalysisContext.Capture ();
+	mFirstSignalID = DataSignal::GetSignalIDCount ();
+	mUsesArenas = (RGArena::GetCurrent () != NULL);
+	threads = new ChannelFitThread* [nThreads];
+
+	for (i=1; i<nThreads; i++) {
+
+		threads [i] = new ChannelFitThread (this);
+		threads [i]->Start ();	// if the thread could not be started, the remaining threads fit its channels
+	}
+
+	FitJobs ();
+
+	for (i=1; i<nThreads; i++)
+		delete threads [i];	// joins thread
+
+	delete[] threads;
+
+	unsigned long signalIDsUsed = 0;
+
+	if (!mJobs.empty ())
+		mJobs.back ()->mAnalysisContext.MakeCurrent ();
+
+	SmartMessagingObject::SetSharedUpdateLog (sharedUpdates);
+
+	for (it = mJobs.begin (); it != mJobs.end (); it++) {
+
+		job = *it;
+		job->AppendSpoolFiles (mText, mExcelText);
+
+		for (signalIt = job->mCreatedSignals.begin (); signalIt != job->mCreatedSignals.end (); signalIt++)
+			(*signalIt)->OffsetSignalID (mFirstSignalID, signalIDsUsed);
+
+		job->mCreatedSignals.clear ();
+		signalIDsUsed += job->mSignalIDsUsed;
+
+		if (sharedUpdates != NULL)
+			job->mSharedUpdates.MoveTo (*sharedUpdates);
+
+		else
+			job->mSharedUpdates.Apply ();
+	}
+
+	DataSignal::SetSignalIDCount (mFirstSignalID + signalIDsUsed);
+}
+
+
+void ChannelFitQueue :: FitJobs () {
+
+	ChannelFitJob* job;
+	RGTextOutput* text;
+	RGTextOutput* excelText;
+	OsirisMsg* msg;
+
+	while (job = GetNextJob ()) {
+
+		mAnalysisContext.MakeCurrent ();
+		SmartMessagingObject::SetSharedUpdateLog (&job->mSharedUpdates);
+		DataSignal::SetCreatedSignals (&job->mCreatedSignals);
+
+		if (job->mText != NULL) {
+
+			text = job->mText;
+			excelText = job->mExcelText;
+			msg = job->mMessage;
+		}
+
+		else {
+
+			text = &mText;
+			excelText = &mExcelText;
+			msg = &mMessage;
+		}
+
+		if (job->mData->FitAllCharacteristicsSM (*text, *excelText, *msg, mPrint) < 0)
+			job->mStatus = -job->mChannel;
+
+		DataSignal::SetCreatedSignals (NULL);
+		job->mSignalIDsUsed = DataSignal::GetSignalIDCount () - mFirstSignalID;
+		job->mAnalysisContext.Capture ();
+	}
+}
+
+
+ChannelFitJob* ChannelFitQueue :: GetNextJob () {
+
+	RGLock lock (mMutex);
+
+	if (mNextJob >= (int) mJobs.size ())
+		return NULL;
+
+	ChannelFitJob* job = mJobs [mNextJob];
+	mNextJob++;
+	return job;
+}
+
+
+void ChannelFitThread :: Run () {
+
+	RGArenaScope arena (mQueue->UsesArenas ());	// released when the thread ends; the signals it fitted keep its blocks
+	mQueue->FitJobs ();
+}
+
@@ -0,0 +1,321 @@
+/*
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+*  FileName: SampleAnalysisQueue.h
+*  Author:   Robert Goor
+*
+*/
+//
+//  class SampleAnalysisQueue hands out the ladders, and then the samples, of a directory to the threads of
+//  STRLCAnalysis::AnalyzeIncrementallySM and makes the threads report them in directory order.  Each ladder or sample is a
+//  SampleAnalysisJob.  When jobs are analyzed concurrently, each job writes its analysis output to temporary spool files, which
+//  are appended to the directory output files when it is the job's turn to report, so that all output is identical to that of
+//  a serial analysis.
+//
+//  When the context has a SampleResultCache, each sample job is given a SampleResult, which receives all of the sample's output,
+//  spooled, so that it can be saved in the cache and reported again by a later analysis without analyzing the sample.
+//
+//  class ChannelFitQueue fits the channels of one ladder or sample concurrently, with each channel's output spooled and
+//  its signal ids renumbered so that the results are identical to those of fitting the channels one at a time.  When the
+//  sample's objects are allocated from an RGArena, each fitting thread allocates from an arena of its own.
+//
+
+#ifndef _SAMPLEANALYSISQUEUE_H_
+#define _SAMPLEANALYSISQUEUE_H_
+
+#include "rgstring.h"
+#include "rgfile.h"
+#include "rgdlist.h"
+#include "rgthread.h"
+#include "RGLogBook.h"
+#include "OsirisMsg.h"
+#include "SmartMessagingObject.h"
+#include "AnalysisContext.h"
+#include "SampleResultCache.h"
+
+#include <vector>
+#include <set>
+
+using namespace std;
+
+class fsaFileData;
+class ChannelData;
+class DataSignal;
+class CoreBioComponent;
+class ParameterServer;
+class GenotypesForAMarkerSet;
+class TestCharacteristic;
+class STRLCAnalysis;
+class SampleAnalysisQueue;
+
+
+struct SampleAnalysisContext {
+
+	SampleAnalysisContext ();
+	~SampleAnalysisContext () {}
+
+	RGLogBook* GetReportOutput (int output) const;	// output is a SampleResult report output
+	RGString GetGraphicsFileName (const RGString& fileName) const;	// as written by WriteXMLGraphicDataSM
+
+	SampleAnalysisQueue* mQueue;
+	AnalysisContext mAnalysisContext;	// settings in effect when the analysis of each sample begins
+	bool mUseSpoolFiles;
+	SampleResultCache* mCache;	// saves the result of each sample as it is reported
+	bool mReuseResults;	// saved results of unchanged samples are reported instead of analyzing the samples
+	RGMutex mWorkingFileMutex;
+
+	RGString mDirectoryName;
+	RGString mGraphicsDirectory;
+	RGString mPlotString;
+	RGString mSpoolName;	// job number and file type are appended
+	RGString mMarkerSetName;
+	int mOutputLevel;
+	Boolean mPrint;
+	bool mPrintGraphics;
+	bool mMakeMixturesDefaultType;
+	bool mUseSampleNamesForControlSampleTests;
+
+	RGDList* mLadderList;	// ladders are appended in ladder order; the list is not modified while samples are analyzed
+	ParameterServer* mServer;
+	GenotypesForAMarkerSet* mGenotypes;
+	TestCharacteristic* mTestPeak;
+
+	RGTextOutput* mText;
+	RGLogBook* mExcelText;
+	OsirisMsg* mMessage;
+	RGTextOutput* mPullupFractions;
+	RGTextOutput* mPullupMatrix;
+	RGLogBook* mExcelSummary;
+	RGLogBook* mExcelLinks;
+	RGLogBook* mXMLExcelLinks;
+	RGLogBook* mTempXMLExcelLinks;
+	RGLogBook* mTempExcelSummary;
+	RGLogBook* mTempExcelLinks;
+
+	// The following are only changed by the thread whose turn it is to report
+
+	bool mHasPositiveControl;
+	bool mHasNegativeControl;
+	bool mPopulatedBaseLocusList;
+	int mSamplesProcessed;
+	int mNumberOfSampleFiles;
+	unsigned long mFirstSignalID;
+	unsigned long mSignalIDsUsed;
+	int mExpectedNumberOfChannels;
+	int mMinimumILSBPForLoci;
+	int mStatus;	// negative when remaining jobs must not be reported
+
+private:
+	SampleAnalysisContext (const SampleAnalysisContext&);
+	SampleAnalysisContext& operator= (const SampleAnalysisContext&);
+};
+
+
+struct SampleAnalysisJob {
+
+	SampleAnalysisJob (int number, const RGString& fileName);
+	~SampleAnalysisJob ();
+
+	int OpenSpoolFiles (const SampleAnalysisContext& context);
+	void AppendSpoolFiles (SampleAnalysisContext& context);
+	void DiscardSpoolFiles ();
+	void MoveSpoolFilesToResult ();	// instead of appending them
+
+	int OpenReportSpools (const SampleAnalysisContext& context);
+	void MoveReportSpoolsToResult ();
+	RGLogBook& GetReportOutput (const SampleAnalysisContext& context, int output);	// the report spool, if open
+	void AppendResult (SampleAnalysisContext& context, unsigned long lastSignalID, int lastLinkNumber, int lastMessageNumber);
+
+	int mNumber;
+	RGString mFileName;
+	fsaFileData* mData;
+	CoreBioComponent* mBioComponent;
+	bool mSamplePrepared;	// the sample could be read and prepared for analysis
+	bool mIsPositiveControl;
+	bool mIsNegativeControl;
+	bool mLadderFitSucceeded;
+	int mStatus;	// negative if the job ends the analysis of the directory
+	SmartMessageUpdateLog mSharedUpdates;
+	SampleResult* mResult;	// NULL unless the context has a cache
+	bool mReusesResult;	// mResult was saved by an earlier analysis
+
+	RGTextOutput* mText;
+	RGFile* mTabFile;	// shared by mExcelText and mMessage
+	RGLogBook* mExcelText;
+	OsirisMsg* mMessage;
+	RGTextOutput* mPullupFractions;
+	RGTextOutput* mPullupMatrix;
+
+protected:
+	RGString mSpoolName;
+	RGFile* mReportFiles [SampleResult::NumberOfReportOutputs];
+	RGLogBook* mReportSpools [SampleResult::NumberOfReportOutputs];
+
+	void CloseSpoolFiles ();
+	void CloseReportSpools ();
+	static void AppendSpoolFile (const RGString& spoolName, RGTextOutput* target);
+	static void ReadSpoolFile (const RGString& spoolName, RGString& contents);
+
+private:
+	SampleAnalysisJob (const SampleAnalysisJob&);
+	SampleAnalysisJob& operator= (const SampleAnalysisJob&);
+};
+
+
+class SampleAnalysisQueue {
+
+public:
+	SampleAnalysisQueue ();
+	~SampleAnalysisQueue ();
+
+	void Append (SampleAnalysisJob* job) { mJobs.push_back (job); }	// only before analysis starts
+	int NumberOfJobs () const { return (int) mJobs.size (); }
+	SampleAnalysisJob* GetJob (int i) { return mJobs [i]; }	// i from 0
+
+	SampleAnalysisJob* GetNextJob ();	// NULL when all jobs have been handed out
+	void WaitForTurn (const SampleAnalysisJob& job);
+	void EndTurn ();
+
+	void ApplySharedUpdates ();	// in sample order, after all samples have been analyzed
+
+protected:
+	vector<SampleAnalysisJob*> mJobs;
+	int mNextJob;
+	int mCurrentTurn;
+	RGMutex mMutex;
+	RGCondition mTurnChanged;
+
+private:
+	SampleAnalysisQueue (const SampleAnalysisQueue&);
+	SampleAnalysisQueue& operator= (const SampleAnalysisQueue&);
+};
+
+
+class SampleAnalysisThread : public RGThread {
+
+public:
+	SampleAnalysisThread (STRLCAnalysis* analysis, SampleAnalysisContext* context) : RGThread (), mAnalysis (analysis), mContext (context) {}
+	virtual ~SampleAnalysisThread () { Join (); }
+
+protected:
+	STRLCAnalysis* mAnalysis;
+	SampleAnalysisContext* mContext;
+
+	virtual void Run ();
+};
+
+
+class LadderAnalysisThread : public SampleAnalysisThread {
+
+public:
+	LadderAnalysisThread (STRLCAnalysis* analysis, SampleAnalysisContext* context) : SampleAnalysisThread (analysis, context) {}
+	virtual ~LadderAnalysisThread () { Join (); }
+
+protected:
+	virtual void Run ();
+};
+
+
+struct ChannelFitJob {
+
+	ChannelFitJob (int channel, ChannelData* data);
+	~ChannelFitJob ();
+
+	int OpenSpoolFiles (const RGTextOutput& text, const RGTextOutput& excelText);
+	void AppendSpoolFiles (RGTextOutput& text, RGTextOutput& excelText);
+	void CloseSpoolFiles ();	// discards any spooled output
+
+	int mChannel;
+	ChannelData* mData;
+	int mStatus;
+	unsigned long mSignalIDsUsed;
+	set<DataSignal*> mCreatedSignals;	// signals constructed by the fit that still exist
+	SmartMessageUpdateLog mSharedUpdates;
+	AnalysisContext mAnalysisContext;	// settings in effect when the fit ends
+
+	RGTextOutput* mText;
+	RGTextOutput* mExcelText;
+	OsirisMsg* mMessage;
+
+protected:
+	RGFile* mTextFile;
+	RGFile* mExcelFile;
+
+	static void AppendSpoolFile (RGFile* spool, RGTextOutput& target);
+
+private:
+	ChannelFitJob (const ChannelFitJob&);
+	ChannelFitJob& operator= (const ChannelFitJob&);
+};
+
+
+class ChannelFitQueue {
+
+public:
+	ChannelFitQueue (RGTextOutput& text, RGTextOutput& excelText, OsirisMsg& msg, Boolean print);
+	~ChannelFitQueue ();
+
+	void Append (ChannelFitJob* job) { mJobs.push_back (job); }	// in channel order, before FitAll
+	int NumberOfJobs () const { return (int) mJobs.size (); }
+	ChannelFitJob* GetJob (int i) { return mJobs [i]; }	// i from 0
+
+	void FitAll (int nThreads);	// the calling thread is one of the nThreads
+	void FitJobs ();	// fits jobs until none remain
+	bool UsesArenas () const { return mUsesArenas; }	// the other threads fit in arenas, as the calling thread does
+
+protected:
+	vector<ChannelFitJob*> mJobs;
+	int mNextJob;
+	RGMutex mMutex;
+	RGTextOutput& mText;
+	RGTextOutput& mExcelText;
+	OsirisMsg& mMessage;
+	Boolean mPrint;
+	AnalysisContext mAnalysisContext;	// settings in effect when each fit begins
+	unsigned long mFirstSignalID;
+	bool mUsesArenas;
+
+	ChannelFitJob* GetNextJob ();
+
+private:
+	ChannelFitQueue (const ChannelFitQueue&);
+	ChannelFitQueue& operator= (const ChannelFitQueue&);
+};
+
+
+class ChannelFitThread : public RGThread {
+
+public:
+	ChannelFitThread (ChannelFitQueue* queue) : RGThread (), mQueue (queue) {}
+	virtual ~ChannelFitThread () { Join (); }
+
+protected:
+	ChannelFitQueue* mQueue;
+
+	virtual void Run ();
+};
+
+
+#endif  /*  _SAMPLEANALYSISQUEUE_H_  */
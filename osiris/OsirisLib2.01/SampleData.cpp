@@ -114,6 +114,13 @@ double* SampleData :: GetRawDataForDataChannel (int channelNumber, int& numDataP
 }
 
 
+double* SampleData :: GetRawDataForAllDataChannels (int numberOfChannels, int& numDataPoints) {
+
+	numDataPoints = 0;
+	return NULL;
+}
+
+
 int SampleData :: GetNumberOfDataElementsForAmbientChannel (int channelNumber) {
 
 	return 0;
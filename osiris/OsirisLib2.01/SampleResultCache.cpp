@@ -0,0 +1,429 @@
+/*
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+*  FileName: SampleResultCache.cpp
+*  Author:   Robert Goor
+*
+*/
+//
+//  class ContentFingerprint accumulates a 64-bit FNV-1a hash of strings and of file contents; class SampleResultCache keeps
+//  the result of each sample of a directory, in the output directory, for incremental analysis
+//
+
+#include "SampleResultCache.h"
+#include "rgfile.h"
+#include "rgdirectory.h"
+#include "RGTextOutput.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+//
+//  The reserved numbers of the three kinds are consecutive, so that a report spool marks them all with one range, and fit in a long
+//
+
+const unsigned long SampleResultCache::SignalIDBase = 2113000000;
+const int SampleResultCache::LinkNumberBase = 2123000000;
+const int SampleResultCache::MessageNumberBase = 2133000000;
+const int SampleResultCache::NumberRange = 10000000;
+
+static const char* ResultHeader = "OsirisSampleResult 2";	// results of version 1 have no number marks
+
+
+ContentFingerprint :: ContentFingerprint () {
+
+	mHash = 14695981039346656037ULL;
+}
+
+
+void ContentFingerprint :: Append (const char* data, size_t length) {
+
+	const unsigned char* next = (const unsigned char*) data;
+	const unsigned char* end = next + length;
+
+	while (next < end) {
+
+		mHash ^= *next;
+		mHash *= 1099511628211ULL;
+		next++;
+	}
+}
+
+
+void ContentFingerprint :: Append (const RGString& text) {
+
+	// The length is included, so that consecutive strings cannot run together
+
+	RGString length;
+	length << (unsigned long) text.Length () << ":";
+	Append (length.GetData (), length.Length ());
+	Append (text.GetData (), text.Length ());
+}
+
+
+bool ContentFingerprint :: AppendFile (const RGString& fullPathName) {
+
+	RGFile file (fullPathName, "rb");
+
+	if (!file.isValid ())
+		return false;
+
+	const size_t bufferSize = 65536;
+	char* buffer = new char [bufferSize];
+	long remaining = file.GetSizeOfFile ();
+	size_t n;
+	bool status = true;
+	RGString length;
+	length << remaining << ":";
+	Append (length.GetData (), length.Length ());
+
+	while (remaining > 0) {
+
+		n = ((size_t) remaining < bufferSize) ? (size_t) remaining : bufferSize;
+
+		if (!file.Read (buffer, n)) {
+
+			status = false;
+			break;
+		}
+
+		Append (buffer, n);
+		remaining -= (long) n;
+	}
+
+	delete[] buffer;
+	return status;
+}
+
+
+RGString ContentFingerprint :: GetHexString () const {
+
+	char hex [17];
+	const char* digits = "0123456789abcdef";
+	UINT64 hash = mHash;
+	int i;
+
+	for (i=15; i>=0; i--) {
+
+		hex [i] = digits [hash & 0xf];
+		hash >>= 4;
+	}
+
+	hex [16] = '\0';
+	return RGString (hex);
+}
+
+
+SampleResult :: SampleResult () : mSamplePrepared (false), mIsPositiveControl (false), mIsNegativeControl (false), mHasGraphics (false),
+mSignalIDsUsed (0), mLinkNumbersUsed (0), mMessageNumbersUsed (0) {
+
+}
+
+
+SampleResultCache :: SampleResultCache (const RGString& cacheDirectory, const RGString& directoryFingerprint) :
+mCacheDirectory (cacheDirectory), mDirectoryFingerprint (directoryFingerprint) {
+
+	if (!RGDirectory::FileOrDirectoryExists (mCacheDirectory))
+		RGDirectory::MakeDirectory (mCacheDirectory);
+}
+
+
+RGString SampleResultCache :: GetFingerprint (const RGString& fullPathName, const RGString& fileName) const {
+
+	ContentFingerprint fingerprint;
+	RGString empty;
+	fingerprint.Append (mDirectoryFingerprint);
+	fingerprint.Append (fileName);
+
+	if (!fingerprint.AppendFile (fullPathName))
+		return empty;
+
+	return fingerprint.GetHexString ();
+}
+
+
+bool SampleResultCache :: Load (SampleResult& result) {
+
+	//
+	//  A result is a header line, the fingerprint, a line of flags and counts and then the shared updates and each output,
+	//  each preceded by a line with its length
+	//
+
+	RGString path = GetResultPath (result.mFingerprint);
+	RGFile file (path, "rb");
+
+	if (!file.isValid ())
+		return false;
+
+	RGString contents;
+	contents.ReadTextFile (file);
+	file.Close ();
+
+	const char* begin = contents.GetData ();
+	const char* end = begin + contents.Length ();
+	const char* next = begin;
+	char* after;
+	size_t headerLength = strlen (ResultHeader);
+	size_t fingerprintLength = result.mFingerprint.Length ();
+	long fields [7];
+	long length;
+	int i;
+	size_t position;
+	RGString* section;
+
+	if ((contents.Length () < headerLength + fingerprintLength + 2) || (strncmp (next, ResultHeader, headerLength) != 0))
+		return false;
+
+	next += headerLength + 1;
+
+	if (strncmp (next, result.mFingerprint.GetData (), fingerprintLength) != 0)
+		return false;
+
+	next += fingerprintLength + 1;
+
+	for (i=0; i<7; i++) {
+
+		if (next >= end)
+			return false;
+
+		fields [i] = strtol (next, &after, 10);
+		next = after;
+	}
+
+	result.mSamplePrepared = (fields [0] != 0);
+	result.mIsPositiveControl = (fields [1] != 0);
+	result.mIsNegativeControl = (fields [2] != 0);
+	result.mHasGraphics = (fields [3] != 0);
+	result.mSignalIDsUsed = (unsigned long) fields [4];
+	result.mLinkNumbersUsed = (int) fields [5];
+	result.mMessageNumbersUsed = (int) fields [6];
+
+	for (i=-1; i<SampleResult::NumberOfOutputs; i++) {
+
+		section = (i < 0) ? &result.mSharedUpdates : &result.mOutputs [i];
+
+		if (next >= end)
+			return false;
+
+		length = strtol (next, &after, 10);
+		next = after + 1;
+
+		if ((length < 0) || (next + length > end))
+			return false;
+
+		if (length > 0) {
+
+			position = next - begin;
+			*section = contents.ExtractSubstring (position, position + length - 1);
+		}
+
+		else
+			*section = "";
+
+		next += length;
+	}
+
+	SetUsed (result.mFingerprint);
+	return true;
+}
+
+
+int SampleResultCache :: Save (const SampleResult& result) {
+
+	//
+	//  The result is written to a temporary file that replaces any earlier result, so that a result that is only partly
+	//  written is never found
+	//
+
+	RGString path = GetResultPath (result.mFingerprint);
+	RGString tempPath = path + ".tmp";
+	RGFile file (tempPath, "wb");
+	RGString line;
+	const RGString* section;
+	int i;
+
+	if (!file.isValid ())
+		return -1;
+
+	line << ResultHeader << "\n" << result.mFingerprint << "\n" << (int) result.mSamplePrepared << " " << (int) result.mIsPositiveControl;
+	line << " " << (int) result.mIsNegativeControl << " " << (int) result.mHasGraphics << " " << result.mSignalIDsUsed << " ";
+	line << result.mLinkNumbersUsed << " " << result.mMessageNumbersUsed << "\n";
+	file.Write (line.GetData (), line.Length ());
+
+	for (i=-1; i<SampleResult::NumberOfOutputs; i++) {
+
+		section = (i < 0) ? &result.mSharedUpdates : &result.mOutputs [i];
+		line = "";
+		line << (unsigned long) section->Length () << "\n";
+		file.Write (line.GetData (), line.Length ());
+		file.Write (section->GetData (), section->Length ());
+	}
+
+	file.Flush ();
+
+	if (file.Error ()) {
+
+		file.Close ();
+		remove (tempPath.GetData ());
+		return -1;
+	}
+
+	file.Close ();
+	remove (path.GetData ());
+
+	if (rename (tempPath.GetData (), path.GetData ()) != 0) {
+
+		remove (tempPath.GetData ());
+		return -1;
+	}
+
+	SetUsed (result.mFingerprint);
+	return 0;
+}
+
+
+void SampleResultCache :: RemoveUnusedResults () {
+
+	RemoveResults (true);
+}
+
+
+void SampleResultCache :: RemoveAllResults () {
+
+	RemoveResults (false);
+	RGDirectory::RemoveEmptyDirectory (mCacheDirectory);	// fails, harmlessly, if other files were put there
+}
+
+
+void SampleResultCache :: RemoveResults (bool keepUsedResults) {
+
+	RGDirectory directory (mCacheDirectory);
+	RGString name;
+	RGString fingerprint;
+	RGString suffix (".result");
+	RGString tempSuffix (".result.tmp");
+	set<string> unused;
+	set<string>::iterator it;
+
+	if (!directory.IsValid ())
+		return;
+
+	while (directory.ReadNextDirectory (name)) {
+
+		if ((name.Length () > tempSuffix.Length ()) && (name.ExtractLastCharacters (tempSuffix.Length ()) == tempSuffix)) {
+
+			unused.insert (name.GetData ());	// left by an analysis that did not finish saving a result
+			continue;
+		}
+
+		if ((name.Length () <= suffix.Length ()) || !(name.ExtractLastCharacters (suffix.Length ()) == suffix))
+			continue;
+
+		fingerprint = name;
+		fingerprint.ExtractAndRemoveLastCharacters (suffix.Length ());
+
+		if (!keepUsedResults || (mUsedResults.find (fingerprint.GetData ()) == mUsedResults.end ()))
+			unused.insert (name.GetData ());
+	}
+
+	for (it = unused.begin (); it != unused.end (); it++)
+		remove ((mCacheDirectory + "/" + it->c_str ()).GetData ());
+}
+
+
+RGString SampleResultCache :: Renumber (const RGString& text, unsigned long lastSignalID, int lastLinkNumber, int lastMessageNumber) {
+
+	//
+	//  Only the numbers between RGTextOutput::NumberMarks are replaced, so that numbers in sample names, file names and other
+	//  text are written as they are
+	//
+
+	const char* begin = text.GetData ();
+	const char* end = begin + text.Length ();
+	const char* next = begin;
+	const char* copied = begin;
+	const char* mark;
+	char* after;
+	long value;
+	char number [24];
+	string renumbered;
+
+	while ((next = (const char*) memchr (next, RGTextOutput::NumberMark, end - next)) != NULL) {
+
+		mark = next;
+		value = strtol (mark + 1, &after, 10);
+		next = mark + 1;
+
+		if ((after == mark + 1) || (after >= end) || (*after != RGTextOutput::NumberMark))
+			continue;
+
+		if ((value > (long) SignalIDBase) && (value <= (long) SignalIDBase + NumberRange))
+			sprintf (number, "%lu", lastSignalID + (unsigned long) (value - SignalIDBase));
+
+		else if ((value > LinkNumberBase) && (value <= LinkNumberBase + NumberRange))
+			sprintf (number, "%d", lastLinkNumber + (int) (value - LinkNumberBase));
+
+		else if ((value > MessageNumberBase) && (value <= MessageNumberBase + NumberRange))
+			sprintf (number, "%d", lastMessageNumber + (int) (value - MessageNumberBase));
+
+		else
+			continue;
+
+		renumbered.append (copied, mark - copied);
+		renumbered.append (number);
+		next = after + 1;
+		copied = next;
+	}
+
+	if (copied == begin)
+		return text;
+
+	renumbered.append (copied, end - copied);
+	return RGString (renumbered.c_str ());
+}
+
+
+RGString SampleResultCache :: FormatLinkNumber (int linkNumber) {
+
+	//  Table links are formatted before they are written, so a reserved link number is marked here, as a report spool would mark it
+
+	RGString number;
+	number.Convert (linkNumber, 10);
+
+	if ((linkNumber <= LinkNumberBase) || (linkNumber > LinkNumberBase + NumberRange))
+		return number;
+
+	RGString marked;
+	marked << RGTextOutput::NumberMark << number << RGTextOutput::NumberMark;
+	return marked;
+}
+
+
+void SampleResultCache :: SetUsed (const RGString& fingerprint) {
+
+	RGLock lock (mMutex);
+	mUsedResults.insert (fingerprint.GetData ());
+}
@@ -0,0 +1,129 @@
+/*
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+*  FileName: SampleResultCache.h
+*  Author:   Robert Goor
+*
+*/
+//
+//  class ContentFingerprint accumulates a 64-bit FNV-1a hash of strings and of file contents, to recognize inputs that are
+//  unchanged since an earlier analysis.
+//
+//  class SampleResultCache keeps the result of each sample of a directory, in the output directory, so that an incremental
+//  analysis reuses the results of samples whose data, ladders and settings are unchanged.  A SampleResult holds all output
+//  of a sample, with the signal ids, table links and message numbers it uses counted from reserved bases and marked as they
+//  are written.  Only the marked numbers are renumbered whenever the result is reported, so that a reused sample is reported
+//  exactly as if it had been analyzed again.
+//  An incremental or a resumed analysis saves each result as soon as the sample is reported, as a checkpoint from which an
+//  analysis that did not finish is resumed.
+//
+
+#ifndef _SAMPLERESULTCACHE_H_
+#define _SAMPLERESULTCACHE_H_
+
+#include "rgstring.h"
+#include "rgdefs.h"
+#include "rgthread.h"
+
+#include <set>
+#include <string>
+
+using namespace std;
+
+
+class ContentFingerprint {
+
+public:
+	ContentFingerprint ();
+	~ContentFingerprint () {}
+
+	void Append (const char* data, size_t length);
+	void Append (const RGString& text);
+	bool AppendFile (const RGString& fullPathName);	// false if the file could not be read
+	RGString GetHexString () const;
+
+protected:
+	UINT64 mHash;
+};
+
+
+struct SampleResult {
+
+	enum { ConsoleOutput, AnalysisTabOutput, PullupFractionsOutput, PullupMatrixOutput,	// written while the sample is analyzed
+		ReportTabOutput, SummaryOutput, SummaryLinksOutput, XMLSummaryOutput, TempXMLSummaryOutput, TempSummaryOutput,
+		TempSummaryLinksOutput,	// written when the sample is reported
+		GraphicsOutput, NumberOfOutputs };
+
+	enum { FirstReportOutput = ReportTabOutput, NumberOfReportOutputs = GraphicsOutput - ReportTabOutput };
+
+	SampleResult ();
+	~SampleResult () {}
+
+	RGString mFingerprint;	// of the sample file and everything else its analysis depends on
+	bool mSamplePrepared;
+	bool mIsPositiveControl;
+	bool mIsNegativeControl;
+	bool mHasGraphics;
+	unsigned long mSignalIDsUsed;
+	int mLinkNumbersUsed;
+	int mMessageNumbersUsed;
+	RGString mSharedUpdates;	// as saved by SmartMessageUpdateLog
+	RGString mOutputs [NumberOfOutputs];
+};
+
+
+class SampleResultCache {
+
+public:
+	SampleResultCache (const RGString& cacheDirectory, const RGString& directoryFingerprint);
+	~SampleResultCache () {}
+
+	RGString GetFingerprint (const RGString& fullPathName, const RGString& fileName) const;	// empty if the file could not be read
+	bool Load (SampleResult& result);	// true if a result with the fingerprint of result was saved earlier
+	int Save (const SampleResult& result);
+	void RemoveUnusedResults ();	// removes results that were neither loaded nor saved by this analysis
+	void RemoveAllResults ();	// and the cache directory, when the analysis is complete and its results are not to be kept
+
+	static RGString Renumber (const RGString& text, unsigned long lastSignalID, int lastLinkNumber, int lastMessageNumber);
+	static RGString FormatLinkNumber (int linkNumber);	// for a table link, marked if it is reserved
+
+	static const unsigned long SignalIDBase;	// the ids of a result are SignalIDBase + 1, SignalIDBase + 2, ...
+	static const int LinkNumberBase;
+	static const int MessageNumberBase;
+	static const int NumberRange;	// of each kind of number in one result
+
+protected:
+	RGString mCacheDirectory;
+	RGString mDirectoryFingerprint;
+	set<string> mUsedResults;
+	RGMutex mMutex;
+
+	RGString GetResultPath (const RGString& fingerprint) const { return mCacheDirectory + "/" + fingerprint + ".result"; }
+	void SetUsed (const RGString& fingerprint);
+	void RemoveResults (bool keepUsedResults);
+};
+
+
+#endif  /*  _SAMPLERESULTCACHE_H_  */
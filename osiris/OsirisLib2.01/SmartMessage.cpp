@@ -34,8 +34,12 @@
 
 #include "SmartMessage.h"
 #include "rgtokenizer.h"
+#include "rgarena.h"
 #include "SmartNotice.h"
 #include "STRLCAnalysis.h"
+#include "Expression.h"
+#include "rgthread.h"
+#include "SmartMessageBookCache.h"
 
 
 
@@ -59,6 +63,14 @@ RGFile* SmartMessage :: DebugFile = NULL;
 RGTextOutput* SmartMessage :: DebugTextOutput = NULL;
 RGString SmartMessage :: MsgBookText;
 int SmartMessage :: SeverityTrigger = 15;
+SmartMessageReportLevel** SmartMessage :: ReportLevelTables = NULL;
+SmartMessageStageList* SmartMessage :: EvaluationLists = NULL;
+SmartMessageStageList* SmartMessage :: TriggerLists = NULL;
+unsigned long** SmartMessage :: EvaluationDependents = NULL;
+volatile long SmartMessage :: EvaluationsPerformed = 0;
+volatile long SmartMessage :: EvaluationsSkipped = 0;
+volatile long SmartMessage :: TriggerSetsPerformed = 0;
+volatile long SmartMessage :: TriggerSetsSkipped = 0;
 SmartMessageKill SmartMessage :: kill;
 
 
@@ -133,8 +145,8 @@ SmartMessage :: ~SmartMessage () {
 
 size_t SmartMessage :: StoreSize () const {
 
-	size_t size = 8 * sizeof (int) + mName.StoreSize () + mDescription.StoreSize ();
-	size += mMessageText.StoreSize () + mAdditionalTextForData.StoreSize () + mSeparatorText.StoreSize ();
+	size_t size = RGPersistent::StoreSize () + 12 * sizeof (int) + mName.StoreSize () + mDescription.StoreSize ();
+	size += mMessageText.StoreSize () + mAdditionalTextForData.StoreSize () + mSeparatorText.StoreSize () + mClosingText.StoreSize ();
 	return size;
 }
 
@@ -153,6 +165,12 @@ unsigned SmartMessage :: HashNumber (unsigned long Base) const {
 }
 
 
+unsigned long SmartMessage :: FullHashNumber () const {
+
+	return mName.FullHashNumber ();
+}
+
+
 Boolean SmartMessage :: IsEqualTo (const RGPersistent* p) const {
 
 	SmartMessage* sm = (SmartMessage*) p;
@@ -163,6 +181,9 @@ Boolean SmartMessage :: IsEqualTo (const RGPersistent* p) const {
 
 void SmartMessage :: RestoreAll (RGFile& f) {
 
+	int value;
+
+	RGPersistent::RestoreAll (f);
 	f.Read (mStage);
 	f.Read (mIntegerData);
 	mName.RestoreAll (f);
@@ -171,6 +192,7 @@ void SmartMessage :: RestoreAll (RGFile& f) {
 	mMessageText.RestoreAll (f);
 	mAdditionalTextForData.RestoreAll (f);
 	mSeparatorText.RestoreAll (f);
+	mClosingText.RestoreAll (f);
 	f.Read (mScope);
 	f.Read (mWhichElementWithinDataArray);
 	f.Read (mWhichElementWithinValueArray);
@@ -178,11 +200,17 @@ void SmartMessage :: RestoreAll (RGFile& f) {
 	f.Read (mCompiled);
 	f.Read (mAcceptData);
 	f.Read (mShareWithCluster);
+	f.Read (mAllowPeakEdit);
+	f.Read (value);
+	mDebugOn = (value != 0);
 }
 
 
 void SmartMessage :: RestoreAll (RGVInStream& f) {
 
+	int value;
+
+	RGPersistent::RestoreAll (f);
 	f >> mStage;
 	f >> mIntegerData;
 	mName.RestoreAll (f);
@@ -191,6 +219,7 @@ void SmartMessage :: RestoreAll (RGVInStream& f) {
 	mMessageText.RestoreAll (f);
 	mAdditionalTextForData.RestoreAll (f);
 	mSeparatorText.RestoreAll (f);
+	mClosingText.RestoreAll (f);
 	f >> mScope;
 	f >> mWhichElementWithinDataArray;
 	f >> mWhichElementWithinValueArray;
@@ -198,11 +227,15 @@ void SmartMessage :: RestoreAll (RGVInStream& f) {
 	f >> mCompiled;
 	f >> mAcceptData;
 	f >> mShareWithCluster;
+	f >> mAllowPeakEdit;
+	f >> value;
+	mDebugOn = (value != 0);
 }
 
 
 void SmartMessage :: SaveAll (RGFile& f) const {
 
+	RGPersistent::SaveAll (f);
 	f.Write (mStage);
 	f.Write (mIntegerData);
 	mName.SaveAll (f);
@@ -211,6 +244,7 @@ void SmartMessage :: SaveAll (RGFile& f) const {
 	mMessageText.SaveAll (f);
 	mAdditionalTextForData.SaveAll (f);
 	mSeparatorText.SaveAll (f);
+	mClosingText.SaveAll (f);
 	f.Write (mScope);
 	f.Write (mWhichElementWithinDataArray);
 	f.Write (mWhichElementWithinValueArray);
@@ -218,11 +252,14 @@ void SmartMessage :: SaveAll (RGFile& f) const {
 	f.Write (mCompiled);
 	f.Write (mAcceptData);
 	f.Write (mShareWithCluster);
+	f.Write (mAllowPeakEdit);
+	f.Write ((int) mDebugOn);
 }
 
 
 void SmartMessage :: SaveAll (RGVOutStream& f) const {
 
+	RGPersistent::SaveAll (f);
 	f << mStage;
 	f << mIntegerData;
 	mName.SaveAll (f);
@@ -231,6 +268,7 @@ void SmartMessage :: SaveAll (RGVOutStream& f) const {
 	mMessageText.SaveAll (f);
 	mAdditionalTextForData.SaveAll (f);
 	mSeparatorText.SaveAll (f);
+	mClosingText.SaveAll (f);
 	f << mScope;
 	f << mWhichElementWithinDataArray;
 	f << mWhichElementWithinValueArray;
@@ -238,6 +276,8 @@ void SmartMessage :: SaveAll (RGVOutStream& f) const {
 	f << mCompiled;
 	f << mAcceptData;
 	f << mShareWithCluster;
+	f << mAllowPeakEdit;
+	f << (int) mDebugOn;
 }
 
 
@@ -1184,6 +1224,8 @@ void SmartMessage :: ClearAllMessages () {
 
 	delete[] StageStartIndex;
 	delete[] StageEndIndex;
+	ClearReportLevelTables ();
+	ClearStageLists ();
 
 	if (DebugMode != 0) {
 
@@ -1222,6 +1264,12 @@ int SmartMessage :: GetEndIndexForListAndStage (int list, int stage) {
 
 int SmartMessage :: LoadAllMessagesV4 (const RGString& inputString, SmartMessage* prototype) {
 
+	return LoadAllMessagesV4 (inputString, prototype, "");
+}
+
+
+int SmartMessage :: LoadAllMessagesV4 (const RGString& inputString, SmartMessage* prototype, const RGString& cacheFullPathName) {
+
 	RGString declarationString;
 	RGString msgString;
 	RGString overallString (inputString);
@@ -1254,6 +1302,25 @@ int SmartMessage :: LoadAllMessagesV4 (const RGString& inputString, SmartMessage
 		STRLCAnalysis::SetMsgBookBuildTime (buildString);
 	}
 
+	//
+	//  The declarations are most of the work of loading the book, so they are restored from the cache when it was saved for this
+	//  book; the stage dynamics are always read from the book, by AssembleMessagesV4
+	//
+
+	bool useCache = (cacheFullPathName.Length () > 0);
+	SmartMessageBookCache cache (cacheFullPathName, inputString, buildString);
+	RGDList declaredMessages;
+	RGDListIterator declaredIt (declaredMessages);
+
+	if (useCache && cache.Restore (DebugMode, startIndex, declaredMessages)) {
+
+		while (nextMsg = (SmartMessage*) declaredIt ())
+			OverAllMessageTable->Append (nextMsg);
+
+		declaredMessages.Clear ();
+		return AssembleMessagesV4 (overallString, startIndex, prototype);
+	}
+
 	if (debugSearch.FindNextTag (startIndex, endIndex, debugString)) {
 
 		debugInt = debugString.ConvertToInteger ();
@@ -1285,11 +1352,17 @@ int SmartMessage :: LoadAllMessagesV4 (const RGString& inputString, SmartMessage
 		nextMsg = prototype->GetNewMessageV4 (msgString);
 		OverAllMessageTable->Append (nextMsg);
 //		OverAllMessageList.Append (nextMsg);
+		declaredMessages.Append (nextMsg);
 
 		if (!nextMsg->IsValid ())
 			status = -1;
 	}
 
+	if ((status == 0) && useCache)
+		cache.Save (DebugMode, startIndex, declaredMessages);	// fails harmlessly if the cache directory cannot be written
+
+	declaredMessages.Clear ();
+
 	if (status < 0)
 		return status;
 
@@ -1331,6 +1404,8 @@ int SmartMessage :: InitializeAllMessages () {
 			status = -1;
 	}
 
+	BuildReportLevelTables ();
+	BuildStageLists ();
 	return status;
 }
 
@@ -1354,11 +1429,39 @@ bool SmartMessage :: EvaluateAllMessages (SmartMessagingComm& comm, int numHighe
 	int endIndex = GetEndIndexForListAndStage (scope, stage);
 	int i;
 
-	for (i=startIndex; i<=endIndex; i++) {
+	if ((EvaluationLists == NULL) || (numHigherObjects < 1) || (stage < 0) || (stage > LastStage)) {
+
+		for (i=startIndex; i<=endIndex; i++) {
+
+			MessageArrays [scope][i]->Evaluate (comm, numHigherObjects);
+		}
+
+		return true;
+	}
+
+	//  Only messages whose evaluation can change something are visited.  A tracked test expression is skipped if none of its
+	//  inputs has changed in the object since initialization and the message is still false:  the expression is then false, as
+	//  it was for the initial values, and evaluating it would store the value the message already has
+
+	const SmartMessageStageList& list = EvaluationLists [scope];
+	const SmartMessageStageEntry* next = list.mEntries + list.mStageStart [stage];
+	const SmartMessageStageEntry* last = list.mEntries + list.mStageStart [stage + 1];
+	SmartMessagingObject* smo = comm.SMOStack [numHigherObjects - 1];
+	const bool* msgArray = smo->GetMessageArray ();
+	bool tracking = (msgArray != NULL) && (smo->GetObjectScope () == scope);
+	long performed = 0;
 
-		MessageArrays [scope][i]->Evaluate (comm, numHigherObjects);
+	for (; next<last; next++) {
+
+		if (tracking && (next->mInputMask != 0) && ((smo->GetChangedEvaluationInputs () & next->mInputMask) == 0) && !msgArray [next->mElement])
+			continue;
+
+		next->mMessage->Evaluate (comm, numHigherObjects);
+		performed++;
 	}
 
+	RGAtomicAdd (&EvaluationsPerformed, performed);
+	RGAtomicAdd (&EvaluationsSkipped, (long)(endIndex - startIndex + 1) - performed);
 	return true;
 }
 
@@ -1395,9 +1498,34 @@ bool SmartMessage :: SetTriggersForAllMessages (SmartMessagingComm& comm, int nu
 	int endIndex = GetEndIndexForListAndStage (scope, stage);
 	int i;
 
-	for (i=startIndex; i<=endIndex; i++)
-		MessageArrays [scope][i]->SetAllTriggers (comm, numHigherObjects, stage, intBP, alleleName);
+	if ((TriggerLists == NULL) || (numHigherObjects < 1) || (stage < 0) || (stage > LastStage)) {
+
+		for (i=startIndex; i<=endIndex; i++)
+			MessageArrays [scope][i]->SetAllTriggers (comm, numHigherObjects, stage, intBP, alleleName);
+
+		return true;
+	}
+
+	//  A message sets its triggers only if it is true in the object at the top of the stack, so messages without triggers and
+	//  false messages are passed over without a call
+
+	const SmartMessageStageList& list = TriggerLists [scope];
+	const SmartMessageStageEntry* next = list.mEntries + list.mStageStart [stage];
+	const SmartMessageStageEntry* last = list.mEntries + list.mStageStart [stage + 1];
+	const bool* msgArray = comm.SMOStack [numHigherObjects - 1]->GetMessageArray ();
+	long performed = 0;
+
+	for (; next<last; next++) {
 
+		if (msgArray [next->mElement]) {
+
+			next->mMessage->SetAllTriggers (comm, numHigherObjects, stage, intBP, alleleName);
+			performed++;
+		}
+	}
+
+	RGAtomicAdd (&TriggerSetsPerformed, performed);
+	RGAtomicAdd (&TriggerSetsSkipped, (long)(endIndex - startIndex + 1) - performed);
 	return true;
 }
 
@@ -1408,9 +1536,31 @@ bool SmartMessage :: SetTriggersForAllMessages (SmartMessagingComm& comm, int nu
 	int endIndex = GetEndIndexForListAndStage (scope, stage);
 	int i;
 
-	for (i=startIndex; i<=endIndex; i++)
-		MessageArrays [scope][i]->SetAllTriggers (comm, numHigherObjects, stage);
+	if ((TriggerLists == NULL) || (numHigherObjects < 1) || (stage < 0) || (stage > LastStage)) {
+
+		for (i=startIndex; i<=endIndex; i++)
+			MessageArrays [scope][i]->SetAllTriggers (comm, numHigherObjects, stage);
+
+		return true;
+	}
+
+	const SmartMessageStageList& list = TriggerLists [scope];
+	const SmartMessageStageEntry* next = list.mEntries + list.mStageStart [stage];
+	const SmartMessageStageEntry* last = list.mEntries + list.mStageStart [stage + 1];
+	const bool* msgArray = comm.SMOStack [numHigherObjects - 1]->GetMessageArray ();
+	long performed = 0;
+
+	for (; next<last; next++) {
+
+		if (msgArray [next->mElement]) {
 
+			next->mMessage->SetAllTriggers (comm, numHigherObjects, stage);
+			performed++;
+		}
+	}
+
+	RGAtomicAdd (&TriggerSetsPerformed, performed);
+	RGAtomicAdd (&TriggerSetsSkipped, (long)(endIndex - startIndex + 1) - performed);
 	return true;
 }
 
@@ -1474,15 +1624,277 @@ bool SmartMessage :: EvaluateAllReportLevels (const bool* msgMatrix, int* const
 	int size = MessageArraySize [scope];
 	int i;
 
+	if (ReportLevelTables == NULL) {
+
+		for (i=0; i<size; i++) {
+
+			reportLevelMatrix [i] = MessageArrays [scope][i]->EvaluateReportLevel (msgMatrix);
+		}
+
+		return true;
+	}
+
+	const SmartMessageReportLevel* table = ReportLevelTables [scope];
+	const SmartMessageReportLevel* next;
+
 	for (i=0; i<size; i++) {
 
-		reportLevelMatrix [i] = MessageArrays [scope][i]->EvaluateReportLevel (msgMatrix);
+		next = table + i;
+
+		if (next->mMessage != NULL)
+			reportLevelMatrix [i] = next->mMessage->EvaluateReportLevel (msgMatrix);
+
+		else if (!msgMatrix [next->mElement])
+			reportLevelMatrix [i] = -1;
+
+		else if ((next->mAlternateReport != NULL) && next->mAlternateReport->EvaluateLocal (msgMatrix))
+			reportLevelMatrix [i] = next->mAlternateReportLevel;
+
+		else
+			reportLevelMatrix [i] = next->mReportLevel;
 	}
 
 	return true;
 }
 
 
+void SmartMessage :: BuildReportLevelTables () {
+
+	//  Collects the report levels of each scope's messages into one array, so that EvaluateAllReportLevels can run through
+	//  them without a virtual call per message
+
+	ClearReportLevelTables ();
+
+	if (!Initialized)
+		return;
+
+	int i;
+	int j;
+	int size;
+	SmartMessage* msg;
+	ReportLevelTables = new SmartMessageReportLevel* [NumberOfMessageTables + 1];
+	ReportLevelTables [0] = NULL;
+
+	for (i=1; i<=NumberOfMessageTables; i++) {
+
+		size = MessageArraySize [i];
+		ReportLevelTables [i] = new SmartMessageReportLevel [size + 1];
+
+		for (j=0; j<size; j++) {
+
+			SmartMessageReportLevel& next = ReportLevelTables [i][j];
+			msg = MessageArrays [i][j];
+			next.mElement = j;
+			next.mReportLevel = -1;
+			next.mAlternateReportLevel = -1;
+			next.mAlternateReport = NULL;
+			next.mMessage = NULL;
+
+			if (!msg->GetReportLevelSpecification (next))
+				next.mMessage = msg;
+		}
+	}
+}
+
+
+void SmartMessage :: ClearReportLevelTables () {
+
+	if (ReportLevelTables == NULL)
+		return;
+
+	int i;
+
+	for (i=1; i<=NumberOfMessageTables; i++)
+		delete[] ReportLevelTables [i];
+
+	delete[] ReportLevelTables;
+	ReportLevelTables = NULL;
+}
+
+
+void SmartMessage :: BuildStageLists () {
+
+	//  Lists, for each scope and stage, the messages whose evaluation can change an object and the messages with triggers.
+	//  Up to _SMARTMESSAGETRACKEDEVALUATIONS_ test expressions per scope are tracked:  those that read only messages of their
+	//  own scope and that are false for the initial message values.  EvaluationDependents [scope][element] has the bits of the
+	//  tracked expressions that read the element, which SmartMessagingObject sets when the element changes
+
+	ClearStageLists ();
+
+	if (!Initialized)
+		return;
+
+	int i;
+	int j;
+	int k;
+	int stage;
+	int size;
+	int tracked;
+	int nEvaluations;
+	int nTriggers;
+	SmartMessage* msg;
+	const ExpressionProgram* program;
+	const ExpressionInstruction* instructions;
+	bool* initialValues;
+	unsigned long bit;
+
+	EvaluationLists = new SmartMessageStageList [NumberOfMessageTables + 1];
+	TriggerLists = new SmartMessageStageList [NumberOfMessageTables + 1];
+	EvaluationDependents = new unsigned long* [NumberOfMessageTables + 1];
+	EvaluationLists [0].mEntries = TriggerLists [0].mEntries = NULL;
+	EvaluationLists [0].mStageStart = TriggerLists [0].mStageStart = NULL;
+	EvaluationDependents [0] = NULL;
+
+	for (i=1; i<=NumberOfMessageTables; i++) {
+
+		size = MessageArraySize [i];
+		EvaluationLists [i].mEntries = new SmartMessageStageEntry [size + 1];
+		EvaluationLists [i].mStageStart = new int [LastStage + 2];
+		TriggerLists [i].mEntries = new SmartMessageStageEntry [size + 1];
+		TriggerLists [i].mStageStart = new int [LastStage + 2];
+		EvaluationDependents [i] = new unsigned long [size + 1];
+		initialValues = new bool [size + 1];
+
+		for (j=0; j<size; j++) {
+
+			EvaluationDependents [i][j] = 0;
+			initialValues [j] = MessageArrays [i][j]->GetInitialValue ();
+		}
+
+		nEvaluations = nTriggers = tracked = 0;
+
+		for (stage=0; stage<=LastStage; stage++) {
+
+			EvaluationLists [i].mStageStart [stage] = nEvaluations;
+			TriggerLists [i].mStageStart [stage] = nTriggers;
+
+			for (j=GetStartIndexForListAndStage (i, stage); j<=GetEndIndexForListAndStage (i, stage); j++) {
+
+				msg = MessageArrays [i][j];
+
+				if (msg->HasTriggers ()) {
+
+					SmartMessageStageEntry& trigger = TriggerLists [i].mEntries [nTriggers++];
+					trigger.mMessage = msg;
+					trigger.mElement = j;
+					trigger.mInputMask = 0;
+				}
+
+				if (!msg->EvaluationCanChangeState ())
+					continue;
+
+				bit = 0;
+				program = msg->GetIncrementalTestProgram ();
+
+				if ((program != NULL) && (tracked < _SMARTMESSAGETRACKEDEVALUATIONS_) && ReadsOnlyScope (program, i) && !program->EvaluateLocal (initialValues)) {
+
+					bit = 1UL << tracked;
+					tracked++;
+					instructions = program->GetInstructions ();
+
+					for (k=0; k<program->GetLength (); k++) {
+
+						if (instructions [k].mOperation == ExpressionProgram::PushMessage)
+							EvaluationDependents [i][instructions [k].mIndex] |= bit;
+					}
+				}
+
+				SmartMessageStageEntry& evaluation = EvaluationLists [i].mEntries [nEvaluations++];
+				evaluation.mMessage = msg;
+				evaluation.mElement = j;
+				evaluation.mInputMask = bit;
+			}
+		}
+
+		EvaluationLists [i].mStageStart [LastStage + 1] = nEvaluations;
+		TriggerLists [i].mStageStart [LastStage + 1] = nTriggers;
+		delete[] initialValues;
+	}
+}
+
+
+void SmartMessage :: ClearStageLists () {
+
+	if (EvaluationLists == NULL)
+		return;
+
+	int i;
+
+	for (i=1; i<=NumberOfMessageTables; i++) {
+
+		delete[] EvaluationLists [i].mEntries;
+		delete[] EvaluationLists [i].mStageStart;
+		delete[] TriggerLists [i].mEntries;
+		delete[] TriggerLists [i].mStageStart;
+		delete[] EvaluationDependents [i];
+	}
+
+	delete[] EvaluationLists;
+	delete[] TriggerLists;
+	delete[] EvaluationDependents;
+	EvaluationLists = NULL;
+	TriggerLists = NULL;
+	EvaluationDependents = NULL;
+}
+
+
+bool SmartMessage :: ReadsOnlyScope (const ExpressionProgram* program, int scope) {
+
+	if (!program->IsCompiled ())
+		return false;
+
+	const ExpressionInstruction* instructions = program->GetInstructions ();
+	int size = MessageArraySize [scope];
+	int k;
+
+	for (k=0; k<program->GetLength (); k++) {
+
+		if (instructions [k].mOperation != ExpressionProgram::PushMessage)
+			continue;
+
+		if ((instructions [k].mScope != scope) || (instructions [k].mIndex < 0) || (instructions [k].mIndex >= size))
+			return false;
+	}
+
+	return true;
+}
+
+
+long SmartMessage :: GetNumberOfEvaluationsPerformed () {
+
+	return RGAtomicGet (&EvaluationsPerformed);
+}
+
+
+long SmartMessage :: GetNumberOfEvaluationsSkipped () {
+
+	return RGAtomicGet (&EvaluationsSkipped);
+}
+
+
+long SmartMessage :: GetNumberOfTriggerSetsPerformed () {
+
+	return RGAtomicGet (&TriggerSetsPerformed);
+}
+
+
+long SmartMessage :: GetNumberOfTriggerSetsSkipped () {
+
+	return RGAtomicGet (&TriggerSetsSkipped);
+}
+
+
+void SmartMessage :: ResetEvaluationCounters () {
+
+	//  not while samples are being analyzed
+
+	EvaluationsPerformed = 0;
+	EvaluationsSkipped = 0;
+	TriggerSetsPerformed = 0;
+	TriggerSetsSkipped = 0;
+}
+
+
 int SmartMessage :: GetSizeOfArrayForScope (int scope) {
 
 	if (Initialized) {
@@ -1561,7 +1973,7 @@ int SmartMessage :: LoadAndActivateAllMessages (const RGString& messageFullPathF
 	inputString.ReadTextFile (inputFile);
 	SmartMessage::MsgBookText = inputString;
 
-	int status = SmartMessage::LoadAllMessagesV4 (inputString, prototype);
+	int status = SmartMessage::LoadAllMessagesV4 (inputString, prototype, SmartMessageBookCache::GetCacheFullPathName (messageFullPathFileName));
 
 	if (status < 0) {
 
@@ -1786,6 +2198,18 @@ SmartMessageReporter :: ~SmartMessageReporter () {
 }
 
 
+void* SmartMessageReporter :: operator new (size_t nbytes) {
+
+	return RGArena::Allocate (nbytes);
+}
+
+
+void SmartMessageReporter :: operator delete (void* p) {
+
+	RGArena::Free (p);
+}
+
+
 void SmartMessageReporter :: SetPriorityLevel (int prio) { 
 	
 	mPriorityLevel = prio;
@@ -49,10 +49,13 @@
 //#include "Genetics.h"
 
 class SmartNotice;
+class SmartMessage;
+class ExpressionProgram;
 
 
 const int _SMARTMESSAGEDATA_ = 2002;
 const int _SMARTMESSAGEREPORTER_ = 2003;
+const int _SMARTMESSAGETRACKEDEVALUATIONS_ = 32;	// test expressions per scope whose inputs are tracked; see SmartMessage::BuildStageLists
 
 PERSISTENT_PREDECLARATION (SmartMessageData)
 PERSISTENT_PREDECLARATION (SmartMessageReporter)
@@ -76,6 +79,31 @@ struct SmartMessageThresholdStruct {
 };
 
 
+struct SmartMessageReportLevel {
+
+	int mElement;
+	int mReportLevel;
+	int mAlternateReportLevel;
+	const ExpressionProgram* mAlternateReport;
+	const SmartMessage* mMessage;  // non-NULL if the report level must be found by calling EvaluateReportLevel
+};
+
+
+struct SmartMessageStageEntry {
+
+	SmartMessage* mMessage;
+	int mElement;
+	unsigned long mInputMask;  // the message's bit among the tracked test expressions of its scope, or 0 if it is always evaluated
+};
+
+
+struct SmartMessageStageList {
+
+	SmartMessageStageEntry* mEntries;
+	int* mStageStart;  // the entries for stage s run from mStageStart [s] up to mStageStart [s+1]
+};
+
+
 
 class SmartMessage : public RGPersistent {
 
@@ -174,11 +202,16 @@ public:
 	virtual bool DisplayExportInfo () const = 0;
 
 	virtual int GetReportLevel (bool* msgMatrix) const = 0;
+	virtual bool GetReportLevelSpecification (SmartMessageReportLevel& spec) const { return false; }
+	virtual bool EvaluationCanChangeState () const { return true; }  // false if Evaluate (comm, numHigherObjects) never changes an object
+	virtual bool HasTriggers () const { return true; }
+	virtual const ExpressionProgram* GetIncrementalTestProgram () const { return NULL; }  // non-NULL if Evaluate (comm, numHigherObjects) only stores this program's value in the message
 	virtual void SetMessageValue (bool* const msgMatrix, int* const valueMatrix, int index, bool value) = 0;
 
 	virtual size_t StoreSize () const;
 	virtual int CompareTo (const RGPersistent*) const;
 	virtual unsigned HashNumber (unsigned long Base) const;
+	virtual unsigned long FullHashNumber () const;
 	virtual Boolean IsEqualTo (const RGPersistent*) const;
 
 	virtual void RestoreAll (RGFile&);
@@ -195,6 +228,7 @@ public:
 
 	// The following are for the new Version 4.x style Smart MessageBook...
 	static int LoadAllMessagesV4 (const RGString& inputString, SmartMessage* prototype);
+	static int LoadAllMessagesV4 (const RGString& inputString, SmartMessage* prototype, const RGString& cacheFullPathName);  // restores the declarations from the cache, if it is current
 	virtual SmartMessage* GetNewMessageV4 (const RGString& inputString) const = 0;
 	virtual int ConfigureV4 (const RGString& inputString, size_t startIndex) = 0;
 
@@ -219,6 +253,12 @@ public:
 	static bool IsInitialized () { return Initialized; }
 	static int GetSizeOfArrayForScope (int scope);
 	static int GetSizeOfValueArrayForScope (int scope);
+	static unsigned long GetDependentEvaluations (int scope, int element) { return (EvaluationDependents != NULL) ? EvaluationDependents [scope][element] : ~0UL; }
+	static long GetNumberOfEvaluationsPerformed ();
+	static long GetNumberOfEvaluationsSkipped ();
+	static long GetNumberOfTriggerSetsPerformed ();
+	static long GetNumberOfTriggerSetsSkipped ();
+	static void ResetEvaluationCounters ();
 	static SmartMessage* GetSmartMessageForScopeAndElement (int scope, int element) { return MessageArrays [scope][element]; }
 	static bool CreateDebugFile (const RGString& fullPathDebugName);
 	static bool OutputDebugString (const RGString& string);
@@ -247,6 +287,9 @@ protected:
 	int mAllowPeakEdit;
 	bool mDebugOn;
 
+	//  The message book, loaded once per process and shared by every AnalysisContext; the message classes keep their indices
+	//  into these tables in class statics
+
 	static RGHashTable* OverAllMessageTable;
 	static RGDList OverAllMessageList;
 	static int NumberOfMessageTables;
@@ -263,8 +306,21 @@ protected:
 	static RGTextOutput* DebugTextOutput;
 	static RGString MsgBookText;
 	static int SeverityTrigger;
+	static SmartMessageReportLevel** ReportLevelTables;
+	static SmartMessageStageList* EvaluationLists;
+	static SmartMessageStageList* TriggerLists;
+	static unsigned long** EvaluationDependents;
+	static volatile long EvaluationsPerformed;
+	static volatile long EvaluationsSkipped;
+	static volatile long TriggerSetsPerformed;
+	static volatile long TriggerSetsSkipped;
 
 	static int AssembleMessages ();
+	static void BuildReportLevelTables ();
+	static void ClearReportLevelTables ();
+	static void BuildStageLists ();
+	static void ClearStageLists ();
+	static bool ReadsOnlyScope (const ExpressionProgram* program, int scope);
 	static int AssembleMessagesV4 (const RGString& inputString, size_t startIndex, SmartMessage* prototype);
 	static int ImportMessageDynamicDataV4 (const RGString& inputString, size_t startIndex, SmartMessage* prototype);
 	static SmartMessageKill kill;
@@ -313,6 +369,9 @@ public:
 	SmartMessageReporter (const SmartMessageReporter& smr);
 	virtual ~SmartMessageReporter ();
 
+	void* operator new (size_t);
+	void operator delete (void*);
+
 	void SetSmartMessage (const SmartMessage* prototype) { mPrototype = prototype; }
 	void SetData (const SmartMessageData* data) { mData = data; }
 	void SetMessageCount (int msgCount) { mMessageCount = msgCount; }
@@ -0,0 +1,422 @@
+/*
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+*  FileName: SmartMessageBookCache.cpp
+*  Author:   Robert Goor
+*
+*/
+//
+//  class MappedFileInStream restores RGPersistent objects from a file mapped into memory; class SmartMessageBookCache keeps the
+//  message declarations of a message book in a binary file beside the book
+//
+
+#include "SmartMessageBookCache.h"
+#include "SampleResultCache.h"
+#include "rgfile.h"
+#include "rgdirectory.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#ifdef _WINDOWS
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+
+const int SmartMessageBookCache::Version = 1;
+
+static const char CacheHeader [8] = "OsMBkC\n";	// seven characters and the null
+static const size_t ChecksumLength = 16;	// the hex digits of a ContentFingerprint
+
+
+MappedFileInStream :: MappedFileInStream (const RGString& fullPathName) : mData (NULL), mSize (0), mOffset (0), mStatus (0),
+mMapped (false) {
+
+	if (!MapFile (fullPathName) && !ReadFile (fullPathName))
+		mStatus = ios::badbit;
+}
+
+
+MappedFileInStream :: ~MappedFileInStream () {
+
+	if (mData == NULL)
+		return;
+
+	if (!mMapped) {
+
+		delete[] (char*) mData;
+		return;
+	}
+
+#ifdef _WINDOWS
+	UnmapViewOfFile (mData);
+#else
+	munmap ((void*) mData, mSize);
+#endif
+}
+
+
+int MappedFileInStream :: Get () {
+
+	unsigned char c;
+
+	if (mOffset >= mSize) {
+
+		mStatus |= ios::eofbit;
+		return EOF;
+	}
+
+	c = (unsigned char) mData [mOffset];
+	mOffset++;
+	return (int) c;
+}
+
+
+RGVInStream& MappedFileInStream :: GetString (char* s, size_t N) {
+
+	//  copies up to N characters, stopping after a null
+
+	size_t i;
+
+	for (i=0; i<N; i++) {
+
+		if (mOffset >= mSize) {
+
+			mStatus |= ios::eofbit | ios::failbit;
+			break;
+		}
+
+		s [i] = mData [mOffset];
+		mOffset++;
+
+		if (s [i] == '\0')
+			break;
+	}
+
+	return *this;
+}
+
+
+bool MappedFileInStream :: MapFile (const RGString& fullPathName) {
+
+	//  the file is mapped read only and private; the mapping remains valid after the file is closed
+
+	void* p = NULL;
+
+#ifdef _WINDOWS
+	HANDLE hFile = CreateFileW (fullPathName.GetWData (), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	HANDLE hMapping = NULL;
+	LARGE_INTEGER size;
+
+	if (hFile == INVALID_HANDLE_VALUE)
+		return false;
+
+	if (GetFileSizeEx (hFile, &size) && (size.QuadPart > 0) && ((UINT64)size.QuadPart <= (UINT64)((size_t)-1)))
+		hMapping = CreateFileMappingW (hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+
+	if (hMapping != NULL) {
+
+		p = MapViewOfFile (hMapping, FILE_MAP_READ, 0, 0, 0);
+		CloseHandle (hMapping);
+	}
+
+	CloseHandle (hFile);
+
+	if (p == NULL)
+		return false;
+
+	mSize = (size_t) size.QuadPart;
+#else
+	int fd = open (fullPathName.GetData (), O_RDONLY);
+	struct stat st;
+
+	if (fd < 0)
+		return false;
+
+	if ((fstat (fd, &st) == 0) && (st.st_size > 0) && ((UINT64)st.st_size <= (UINT64)((size_t)-1))) {
+
+		p = mmap (NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+		if (p == MAP_FAILED)
+			p = NULL;
+	}
+
+	close (fd);
+
+	if (p == NULL)
+		return false;
+
+	mSize = (size_t) st.st_size;
+#endif
+
+	mData = (const char*) p;
+	mMapped = true;
+	return true;
+}
+
+
+bool MappedFileInStream :: ReadFile (const RGString& fullPathName) {
+
+	//  used if the file cannot be mapped
+
+	RGFile file (fullPathName, "rb");
+
+	if (!file.isValid ())
+		return false;
+
+	long size = file.GetSizeOfFile ();
+
+	if (size <= 0)
+		return false;
+
+	char* data = new char [size];
+
+	if (!file.Read (data, (size_t) size)) {
+
+		delete[] data;
+		return false;
+	}
+
+	mData = data;
+	mSize = (size_t) size;
+	return true;
+}
+
+
+void MappedFileInStream :: Read (void* p, size_t n) {
+
+	if ((mData == NULL) || (n > mSize - mOffset)) {
+
+		mStatus |= ios::eofbit | ios::failbit;
+		return;
+	}
+
+	memcpy (p, mData + mOffset, n);
+	mOffset += n;
+}
+
+
+SmartMessageBookCache :: SmartMessageBookCache (const RGString& cacheFullPathName, const RGString& messageBookText, const RGString& buildTime) :
+mCacheFullPathName (cacheFullPathName), mBuildTime (buildTime) {
+
+	ContentFingerprint fingerprint;
+	fingerprint.Append (messageBookText);
+	mFingerprint = fingerprint.GetHexString ();
+}
+
+
+RGString SmartMessageBookCache :: GetCacheFullPathName (const RGString& messageBookFullPathName) {
+
+	//
+	//  The cache is kept in the user's cache directory rather than beside the book, which may be read only or shared by several
+	//  users.  Its name includes a fingerprint of the book's full path, so that each book has its own cache.  Returns an empty
+	//  string if there is no cache directory, in which case the book is always parsed.
+	//
+
+	RGString cacheDirectory;
+	ContentFingerprint pathFingerprint;
+	const char* bookPath = messageBookFullPathName.GetData ();
+	const char* bookName = strrchr (bookPath, '/');
+	const char* env;
+
+#ifdef _WINDOWS
+	const char* backslash = strrchr (bookPath, '\\');
+
+	if ((bookName == NULL) || ((backslash != NULL) && (backslash > bookName)))
+		bookName = backslash;
+
+	env = getenv ("LOCALAPPDATA");
+
+	if ((env == NULL) || (*env == '\0'))
+		return RGString ();
+
+	cacheDirectory = env;
+	cacheDirectory += "\\Osiris";
+#else
+	env = getenv ("XDG_CACHE_HOME");
+
+	if ((env != NULL) && (*env == '/'))
+		cacheDirectory = env;
+
+	else {
+
+		env = getenv ("HOME");
+
+		if ((env == NULL) || (*env != '/'))
+			return RGString ();
+
+		cacheDirectory = env;
+		cacheDirectory += "/.cache";
+
+		if (!RGDirectory::FileOrDirectoryExists (cacheDirectory) && !RGDirectory::MakeDirectory (cacheDirectory))
+			return RGString ();
+	}
+
+	cacheDirectory += "/osiris";
+#endif
+
+	if (!RGDirectory::FileOrDirectoryExists (cacheDirectory) && !RGDirectory::MakeDirectory (cacheDirectory))
+		return RGString ();
+
+	if (bookName == NULL)
+		bookName = bookPath;
+
+	else
+		bookName++;
+
+	pathFingerprint.Append (messageBookFullPathName);
+
+#ifdef _WINDOWS
+	return cacheDirectory + "\\" + bookName + "." + pathFingerprint.GetHexString () + ".cache";
+#else
+	return cacheDirectory + "/" + bookName + "." + pathFingerprint.GetHexString () + ".cache";
+#endif
+}
+
+
+bool SmartMessageBookCache :: Restore (int& debugMode, size_t& declarationsEnd, RGDList& messages) const {
+
+	//
+	//  The checksum at the end of the cache is tested before anything is restored, so that the lengths in a damaged or partly
+	//  written file are never trusted
+	//
+
+	MappedFileInStream cache (mCacheFullPathName);
+	ContentFingerprint checksum;
+	char header [sizeof (CacheHeader)];
+	int version;
+	int wordSize;
+	RGString fingerprint;
+	RGString buildTime;
+	int mode = 0;
+	unsigned long end = 0;
+	size_t contentsSize;
+
+	if (!cache.good () || (cache.GetSize () < sizeof (CacheHeader) + ChecksumLength))
+		return false;
+
+	contentsSize = cache.GetSize () - ChecksumLength;
+	checksum.Append (cache.GetData (), contentsSize);
+
+	if (memcmp (cache.GetData () + contentsSize, checksum.GetHexString ().GetData (), ChecksumLength) != 0)
+		return false;
+
+	cache.Get (header, sizeof (CacheHeader));
+	cache >> version;
+	cache >> wordSize;
+
+	if (!cache.good () || (memcmp (header, CacheHeader, sizeof (CacheHeader)) != 0) || (version != Version) || (wordSize != (int) sizeof (unsigned long)))
+		return false;
+
+	fingerprint.RestoreAll (cache);
+	buildTime.RestoreAll (cache);
+
+	if (!cache.good () || (fingerprint != mFingerprint.GetData ()) || (buildTime != mBuildTime.GetData ()))
+		return false;
+
+	cache >> mode;
+	cache >> end;
+	messages.RestoreAll (cache);
+
+	if (!cache.good () || (cache.GetOffset () != contentsSize)) {
+
+		messages.ClearAndDelete ();
+		return false;
+	}
+
+	debugMode = mode;
+	declarationsEnd = (size_t) end;
+	return true;
+}
+
+
+int SmartMessageBookCache :: Save (int debugMode, size_t declarationsEnd, const RGDList& messages) const {
+
+	//
+	//  The cache is written to a temporary file that replaces any earlier cache, so that a cache that is only partly written is
+	//  never found.  The checksum of everything written is appended last.
+	//
+
+	RGString tempPath = mCacheFullPathName + ".tmp";
+	RGFile* file = new RGFile (tempPath, "wb");
+	ContentFingerprint checksum;
+	bool failed;
+
+	if (!file->isValid ()) {
+
+		delete file;
+		return -1;
+	}
+
+	file->Write (CacheHeader, sizeof (CacheHeader));
+	file->Write (Version);
+	file->Write ((int) sizeof (unsigned long));
+	mFingerprint.SaveAll (*file);
+	mBuildTime.SaveAll (*file);
+	file->Write (debugMode);
+	file->Write ((unsigned long) declarationsEnd);
+	messages.SaveAll (*file);
+	file->Flush ();
+	failed = (file->Error () != 0);
+	delete file;
+
+	if (!failed) {
+
+		MappedFileInStream written (tempPath);
+		failed = !written.good ();
+
+		if (!failed)
+			checksum.Append (written.GetData (), written.GetSize ());
+	}
+
+	if (!failed) {
+
+		file = new RGFile (tempPath, "ab");
+		failed = !file->isValid () || !file->Write (checksum.GetHexString ().GetData (), ChecksumLength) || !file->Flush ();
+		delete file;
+	}
+
+	if (failed) {
+
+		remove (tempPath.GetData ());
+		return -1;
+	}
+
+	remove (mCacheFullPathName.GetData ());
+
+	if (rename (tempPath.GetData (), mCacheFullPathName.GetData ()) != 0) {
+
+		remove (tempPath.GetData ());
+		return -1;
+	}
+
+	return 0;
+}
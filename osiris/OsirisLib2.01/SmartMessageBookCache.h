@@ -0,0 +1,127 @@
+/*
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+*  FileName: SmartMessageBookCache.h
+*  Author:   Robert Goor
+*
+*/
+//
+//  class MappedFileInStream is an RGVInStream over a file that is mapped into memory, from which RGPersistent objects saved
+//  with SaveAll (RGFile&) are restored with RestoreAll (RGVInStream&).
+//
+//  class SmartMessageBookCache keeps the message declarations of a message book in a binary file in the user's cache
+//  directory, so that they are restored instead of parsed from the XML when the book is loaded again.  The cache is used only if it was written
+//  by this version of the cache, for a book with the same content fingerprint and build time, and if its checksum is
+//  intact; otherwise the book is parsed and the cache is written again.
+//
+
+#ifndef _SMARTMESSAGEBOOKCACHE_H_
+#define _SMARTMESSAGEBOOKCACHE_H_
+
+#include "rgstring.h"
+#include "rgdlist.h"
+#include "rgvstream.h"
+#include "rgdefs.h"
+
+
+class MappedFileInStream : public RGVInStream {
+
+public:
+	MappedFileInStream (const RGString& fullPathName);
+	virtual ~MappedFileInStream ();
+
+	bool isValid () const { return mData != NULL; }
+	bool IsMapped () const { return mMapped; }
+	const char* GetData () const { return mData; }
+	size_t GetSize () const { return mSize; }
+	size_t GetOffset () const { return mOffset; }
+
+	virtual int eof () { return mStatus & ios::eofbit; }
+	virtual int fail () { return mStatus & (ios::failbit | ios::badbit); }
+	virtual int bad () { return mStatus & ios::badbit; }
+	virtual int good () { return mStatus == 0; }
+	virtual int rdstate () { return mStatus; }
+	virtual void clear (int v = 0) { mStatus = v; }
+
+	virtual int Get ();
+	virtual RGVInStream& Get (char& c) { Read (&c, sizeof (char)); return *this; }
+	virtual RGVInStream& Get (unsigned char& c) { Read (&c, sizeof (unsigned char)); return *this; }
+	virtual RGVInStream& Get (char* p, size_t N) { Read (p, N * sizeof (char)); return *this; }
+	virtual RGVInStream& Get (short* p, size_t N) { Read (p, N * sizeof (short)); return *this; }
+	virtual RGVInStream& Get (int* p, size_t N) { Read (p, N * sizeof (int)); return *this; }
+	virtual RGVInStream& Get (long* p, size_t N) { Read (p, N * sizeof (long)); return *this; }
+	virtual RGVInStream& Get (float* p, size_t N) { Read (p, N * sizeof (float)); return *this; }
+	virtual RGVInStream& Get (double* p, size_t N) { Read (p, N * sizeof (double)); return *this; }
+	virtual RGVInStream& Get (unsigned char* p, size_t N) { Read (p, N * sizeof (unsigned char)); return *this; }
+	virtual RGVInStream& Get (unsigned short* p, size_t N) { Read (p, N * sizeof (unsigned short)); return *this; }
+	virtual RGVInStream& Get (unsigned int* p, size_t N) { Read (p, N * sizeof (unsigned int)); return *this; }
+	virtual RGVInStream& Get (unsigned long* p, size_t N) { Read (p, N * sizeof (unsigned long)); return *this; }
+	virtual RGVInStream& GetString (char* s, size_t N);
+
+	virtual RGVInStream& operator>>(char& x) { Read (&x, sizeof (x)); return *this; }
+	virtual RGVInStream& operator>>(short& x) { Read (&x, sizeof (x)); return *this; }
+	virtual RGVInStream& operator>>(int& x) { Read (&x, sizeof (x)); return *this; }
+	virtual RGVInStream& operator>>(long& x) { Read (&x, sizeof (x)); return *this; }
+	virtual RGVInStream& operator>>(float& x) { Read (&x, sizeof (x)); return *this; }
+	virtual RGVInStream& operator>>(double& x) { Read (&x, sizeof (x)); return *this; }
+	virtual RGVInStream& operator>>(unsigned char& x) { Read (&x, sizeof (x)); return *this; }
+	virtual RGVInStream& operator>>(unsigned short& x) { Read (&x, sizeof (x)); return *this; }
+	virtual RGVInStream& operator>>(unsigned int& x) { Read (&x, sizeof (x)); return *this; }
+	virtual RGVInStream& operator>>(unsigned long& x) { Read (&x, sizeof (x)); return *this; }
+
+protected:
+	const char* mData;
+	size_t mSize;
+	size_t mOffset;
+	int mStatus;
+	bool mMapped;	// otherwise, mData was read into the heap because the file could not be mapped
+
+	bool MapFile (const RGString& fullPathName);
+	bool ReadFile (const RGString& fullPathName);
+	void Read (void* p, size_t n);	// past the end, sets eof and fail and leaves p unchanged
+};
+
+
+class SmartMessageBookCache {
+
+public:
+	SmartMessageBookCache (const RGString& cacheFullPathName, const RGString& messageBookText, const RGString& buildTime);
+	~SmartMessageBookCache () {}
+
+	bool Restore (int& debugMode, size_t& declarationsEnd, RGDList& messages) const;	// false if the cache is missing or out of date
+	int Save (int debugMode, size_t declarationsEnd, const RGDList& messages) const;
+
+	static RGString GetCacheFullPathName (const RGString& messageBookFullPathName);	// empty if there is no user cache directory
+
+	static const int Version;	// change whenever the saved form of a message changes
+
+protected:
+	RGString mCacheFullPathName;
+	RGString mFingerprint;
+	RGString mBuildTime;
+};
+
+
+#endif  /*  _SMARTMESSAGEBOOKCACHE_H_  */
@@ -33,11 +33,231 @@
 //
 
 #include "SmartMessagingObject.h"
+#include <stdlib.h>
 
 RGHashTable SmartMessagingObject :: ExportSpecifications;
+RGThreadStatic<SmartMessageUpdateLog*> SmartMessagingObject :: SharedUpdateLog (NULL);
+RGDList SmartMessagingObject :: EmptyReporterList;
 
 ABSTRACT_DEFINITION (SmartMessagingObject)
 
+
+SmartMessageUpdateLog :: SmartMessageUpdateLog () {
+
+}
+
+
+SmartMessageUpdateLog :: ~SmartMessageUpdateLog () {
+
+	Clear ();
+}
+
+
+void SmartMessageUpdateLog :: AppendTrigger (SmartMessagingObject* target, int scope, int index) {
+
+	SmartMessageTriggerRecord* record = new SmartMessageTriggerRecord;
+	record->mTarget = target;
+	record->mScope = scope;
+	record->mIndex = index;
+	record->mHasData = false;
+	record->mValue = 0;
+	mTriggers.push_back (record);
+}
+
+
+void SmartMessageUpdateLog :: AppendTrigger (SmartMessagingObject* target, int scope, int index, int value, const RGString& text) {
+
+	SmartMessageTriggerRecord* record = new SmartMessageTriggerRecord;
+	record->mTarget = target;
+	record->mScope = scope;
+	record->mIndex = index;
+	record->mHasData = true;
+	record->mValue = value;
+	record->mText = text;
+	mTriggers.push_back (record);
+}
+
+
+void SmartMessageUpdateLog :: AppendExportSpecification (SmartMessage* sm) {
+
+	mExportSpecifications.push_back (sm);
+}
+
+
+void SmartMessageUpdateLog :: Apply () {
+
+	list<SmartMessageTriggerRecord*>::const_iterator c1Iterator;
+	list<SmartMessage*>::const_iterator c2Iterator;
+	SmartMessageTriggerRecord* record;
+
+	for (c1Iterator = mTriggers.begin (); c1Iterator != mTriggers.end (); c1Iterator++) {
+
+		record = *c1Iterator;
+
+		if (record->mHasData)
+			record->mTarget->SetMessageValueOnTrigger (record->mScope, record->mIndex, record->mValue, record->mText);
+
+		else
+			record->mTarget->SetMessageValueOnTrigger (record->mScope, record->mIndex);
+	}
+
+	for (c2Iterator = mExportSpecifications.begin (); c2Iterator != mExportSpecifications.end (); c2Iterator++)
+		SmartMessagingObject::InsertExportSpecificationsIntoTable (*c2Iterator);
+
+	Clear ();
+}
+
+
+void SmartMessageUpdateLog :: MoveTo (SmartMessageUpdateLog& log) {
+
+	log.mTriggers.splice (log.mTriggers.end (), mTriggers);
+	log.mExportSpecifications.splice (log.mExportSpecifications.end (), mExportSpecifications);
+}
+
+
+void SmartMessageUpdateLog :: Clear () {
+
+	list<SmartMessageTriggerRecord*>::const_iterator c1Iterator;
+
+	for (c1Iterator = mTriggers.begin (); c1Iterator != mTriggers.end (); c1Iterator++)
+		delete *c1Iterator;
+
+	mTriggers.clear ();
+	mExportSpecifications.clear ();
+}
+
+
+int SmartMessageUpdateLog :: Save (RGString& text, const vector<SmartMessagingObject*>& sharedObjects) const {
+
+	//
+	//  One line per trigger:  target, scope, index, whether it has data, value and length of text, followed by the text on
+	//  the next line; then one line per export specification:  scope and element of the message
+	//
+
+	list<SmartMessageTriggerRecord*>::const_iterator c1Iterator;
+	list<SmartMessage*>::const_iterator c2Iterator;
+	SmartMessageTriggerRecord* record;
+	int target;
+	int n = (int) sharedObjects.size ();
+	int scope;
+	int element;
+
+	text = "";
+	text << (int) mTriggers.size () << "\n";
+
+	for (c1Iterator = mTriggers.begin (); c1Iterator != mTriggers.end (); c1Iterator++) {
+
+		record = *c1Iterator;
+
+		for (target=0; target<n; target++) {
+
+			if (sharedObjects [target] == record->mTarget)
+				break;
+		}
+
+		if (target == n)
+			return -1;
+
+		text << target << " " << record->mScope << " " << record->mIndex << " " << (int) record->mHasData << " " << record->mValue;
+		text << " " << (int) record->mText.Length () << "\n" << record->mText << "\n";
+	}
+
+	text << (int) mExportSpecifications.size () << "\n";
+
+	for (c2Iterator = mExportSpecifications.begin (); c2Iterator != mExportSpecifications.end (); c2Iterator++) {
+
+		element = SmartMessage::GetMessageIndex (*c2Iterator, scope);
+
+		if (element < 0)
+			return -1;
+
+		text << scope << " " << element << "\n";
+	}
+
+	return 0;
+}
+
+
+int SmartMessageUpdateLog :: Restore (const RGString& text, const vector<SmartMessagingObject*>& sharedObjects) {
+
+	const char* begin = text.GetData ();
+	const char* next = begin;
+	const char* end = begin + text.Length ();
+	size_t position;
+	char* after;
+	long fields [6];
+	int nTriggers;
+	int nExports;
+	int i;
+	int j;
+	SmartMessageTriggerRecord* record;
+	SmartMessage* sm;
+
+	nTriggers = (int) strtol (next, &after, 10);
+	next = after + 1;
+
+	for (i=0; i<nTriggers; i++) {
+
+		for (j=0; j<6; j++) {
+
+			if (next >= end)
+				return -1;
+
+			fields [j] = strtol (next, &after, 10);
+			next = after;
+		}
+
+		next++;	// end of line
+
+		if ((fields [0] < 0) || (fields [0] >= (long) sharedObjects.size ()) || (fields [5] < 0) || (next + fields [5] > end))
+			return -1;
+
+		record = new SmartMessageTriggerRecord;
+		record->mTarget = sharedObjects [fields [0]];
+		record->mScope = (int) fields [1];
+		record->mIndex = (int) fields [2];
+		record->mHasData = (fields [3] != 0);
+		record->mValue = (int) fields [4];
+
+		if (fields [5] > 0) {
+
+			position = next - begin;
+			record->mText = text.ExtractSubstring (position, position + fields [5] - 1);
+		}
+
+		mTriggers.push_back (record);
+		next += fields [5] + 1;
+	}
+
+	if (next >= end)
+		return -1;
+
+	nExports = (int) strtol (next, &after, 10);
+	next = after;
+
+	for (i=0; i<nExports; i++) {
+
+		for (j=0; j<2; j++) {
+
+			if (next >= end)
+				return -1;
+
+			fields [j] = strtol (next, &after, 10);
+			next = after;
+		}
+
+		sm = SmartMessage::GetSmartMessageForScopeAndElement ((int) fields [0], (int) fields [1]);
+
+		if (sm == NULL)
+			return -1;
+
+		mExportSpecifications.push_back (sm);
+	}
+
+	return 0;
+}
+
+
 /*
 	SmartMessagingObject ();
 	SmartMessagingObject (const SmartMessagingObject& smo);
@@ -78,13 +298,13 @@ protected:
 */
 
 
-SmartMessagingObject :: SmartMessagingObject () : RGPersistent (), mStageCompleted (0), mTriggerStageCompleted (0), 
+SmartMessagingObject :: SmartMessagingObject () : RGPersistent (), mChangedEvaluationInputs (~0UL), mStageCompleted (0), mTriggerStageCompleted (0), 
 mHighestSeverityLevel (-1), mHighestMessageLevel (-1) {
 
 }
 
 
-SmartMessagingObject :: SmartMessagingObject (const SmartMessagingObject& smo) : RGPersistent (smo), mStageCompleted (smo.mStageCompleted),
+SmartMessagingObject :: SmartMessagingObject (const SmartMessagingObject& smo) : RGPersistent (smo), mChangedEvaluationInputs (~0UL), mStageCompleted (smo.mStageCompleted),
 mTriggerStageCompleted (smo.mTriggerStageCompleted), mHighestSeverityLevel (smo.mHighestSeverityLevel), mHighestMessageLevel (smo.mHighestMessageLevel) {
 
 }
@@ -103,7 +323,11 @@ void SmartMessagingObject :: SetMessageValue (int scope, int location, bool valu
 	if (myScope == scope) {
 
 		SmartMessage* msg = SmartMessage::GetSmartMessageForScopeAndElement (scope, location);
-		msg->SetMessageValue (mMessageArray, mValueArray, location, value);
+		bool previous = mMessageArray [location];
+		msg->SetMessageValue (mMessageArray, GetValueArray (msg), location, value);
+
+		if (mMessageArray [location] != previous)
+			NoteMessageChange (scope, location);
 	}
 }
 
@@ -131,8 +355,13 @@ void SmartMessagingObject :: SetMessageValue (int scope, int location, bool valu
 	if (useVirtualMethod)
 		SetMessageValue (scope, location, value);
 
-	else if (scope == GetObjectScope ())
+	else if (scope == GetObjectScope ()) {
+
+		if (mMessageArray [location] != value)
+			NoteMessageChange (scope, location);
+
 		mMessageArray [location] = value;
+	}
 }
 
 
@@ -151,12 +380,48 @@ bool SmartMessagingObject :: GetMessageValue (const SmartNotice& notice) const {
 }
 
 
+void SmartMessagingObject :: SetMessageValueOnTrigger (int scope, int location) {
+
+	SmartMessageUpdateLog* log = SharedUpdateLog;
+
+	if ((log != NULL) && IsSharedBetweenSamples ()) {
+
+		log->AppendTrigger (this, scope, location);
+		return;
+	}
+
+	SetMessageValue (scope, location, true);
+}
+
+
+void SmartMessagingObject :: SetMessageValueOnTrigger (int scope, int location, int value, const RGString& text) {
+
+	SmartMessageUpdateLog* log = SharedUpdateLog;
+
+	if ((log != NULL) && IsSharedBetweenSamples ()) {
+
+		log->AppendTrigger (this, scope, location, value, text);
+		return;
+	}
+
+	SetMessageValue (scope, location, true);
+
+	if (AcceptsDataOnTrigger (location))
+		AppendDataForSmartMessage (scope, location, value, text);
+}
+
+
 int SmartMessagingObject :: GetIntegerValue (int location) const {
 
 	int size = SmartMessage::GetSizeOfValueArrayForScope (GetObjectScope ());
 
-	if ((location < size) && (location >= 0))
+	if ((location < size) && (location >= 0)) {
+
+		if (mValueArray == NULL)
+			return 0;
+
 		return mValueArray [location];
+	}
 
 	else {
 
@@ -241,13 +506,12 @@ void SmartMessagingObject :: SetDataForSmartMessage (const SmartNotice& notice,
 
 		int index = notice.GetMessageIndex ();
 		int scope = notice.GetScope ();
-		SmartMessageData target (index);
-		SmartMessageData* smd = (SmartMessageData*) mMessageDataTable->Find (&target);
+		SmartMessageData* smd = FindMessageData (index);
 
 		if (smd == NULL) {
 
 			smd = new SmartMessageData (index, scope, text);
-			mMessageDataTable->Insert (smd);
+			GetMessageDataTable ()->Insert (smd);
 		}
 
 		else {
@@ -267,13 +531,12 @@ void SmartMessagingObject :: AppendDataForSmartMessage (const SmartNotice& notic
 
 		int index = notice.GetMessageIndex ();
 		int scope = notice.GetScope ();
-		SmartMessageData target (index);
-		SmartMessageData* smd = (SmartMessageData*) mMessageDataTable->Find (&target);
+		SmartMessageData* smd = FindMessageData (index);
 
 		if (smd == NULL) {
 
 			smd = new SmartMessageData (index, scope, text);
-			mMessageDataTable->Insert (smd);
+			GetMessageDataTable ()->Insert (smd);
 		}
 
 		else {
@@ -330,13 +593,12 @@ void SmartMessagingObject :: AppendDataForSmartMessage (int scope, int index, in
 		if (chosenText.Length () == 0)
 			return;
 
-		SmartMessageData target (index);
-		SmartMessageData* smd = (SmartMessageData*) mMessageDataTable->Find (&target);
+		SmartMessageData* smd = FindMessageData (index);
 
 		if (smd == NULL) {
 
 			smd = new SmartMessageData (index, scope, chosenText);
-			mMessageDataTable->Insert (smd);
+			GetMessageDataTable ()->Insert (smd);
 		}
 
 		else {
@@ -353,8 +615,7 @@ bool SmartMessagingObject::SmartMessageHasData (const SmartNotice& notice) const
 
 		int index = notice.GetMessageIndex ();
 		int scope = notice.GetScope ();
-		SmartMessageData target (index);
-		SmartMessageData* smd = (SmartMessageData*)mMessageDataTable->Find (&target);
+		SmartMessageData* smd = FindMessageData (index);
 
 		if (smd == NULL) {
 
@@ -373,14 +634,20 @@ bool SmartMessagingObject::SmartMessageHasData (const SmartNotice& notice) const
 
 void SmartMessagingObject :: ClearSmartNoticeObjects () {
 
-	mSmartMessageReporters->ClearAndDelete ();
-	mUnenabledMessageReporters->ClearAndDelete ();
+	if (mSmartMessageReporters != NULL)
+		mSmartMessageReporters->ClearAndDelete ();
+
+	if (mUnenabledMessageReporters != NULL)
+		mUnenabledMessageReporters->ClearAndDelete ();
+
 	mHighestSeverityLevel = mHighestMessageLevel = -1;
 	int size = SmartMessage::GetSizeOfArrayForScope (GetObjectScope ());
 	int i;
 
 	for (i=0; i<size; i++)
 		mMessageArray [i] = false;
+
+	mChangedEvaluationInputs = ~0UL;
 }
 
 
@@ -391,10 +658,16 @@ int SmartMessagingObject :: AddSmartMessageReporter (SmartMessageReporter* smr)
 
 	if (!isEnabled) {
 
+		if (mUnenabledMessageReporters == NULL)
+			mUnenabledMessageReporters = new RGDList;
+
 		mUnenabledMessageReporters->Prepend (smr);
 		return 0;
 	}
 
+	if (mSmartMessageReporters == NULL)
+		mSmartMessageReporters = new RGDList;
+
 	if (mSmartMessageReporters->Entries () == 0) {
 
 		mHighestSeverityLevel = msgLevel;
@@ -447,6 +720,12 @@ void SmartMessagingObject :: MergeAllSmartMessageReporters () {
 
 	SmartMessageReporter* nextSMR;
 
+	if ((mUnenabledMessageReporters == NULL) || (mUnenabledMessageReporters->Entries () == 0))
+		return;
+
+	if (mSmartMessageReporters == NULL)
+		mSmartMessageReporters = new RGDList;
+
 	while (nextSMR = (SmartMessageReporter*) mUnenabledMessageReporters->GetFirst ())
 		mSmartMessageReporters->Prepend (nextSMR);
 }
@@ -454,6 +733,14 @@ void SmartMessagingObject :: MergeAllSmartMessageReporters () {
 
 void SmartMessagingObject :: InsertExportSpecificationsIntoTable (SmartMessage* sm) {
 
+	SmartMessageUpdateLog* log = SharedUpdateLog;
+
+	if (log != NULL) {
+
+		log->AppendExportSpecification (sm);
+		return;
+	}
+
 	if (ExportSpecifications.Contains (sm))
 		return;
 
@@ -497,38 +784,26 @@ void SmartMessagingObject :: InitializeSmartMessages () {
 
 		int scope = GetObjectScope ();
 		int size = SmartMessage::GetSizeOfArrayForScope (scope);
-		int i;
 		mMessageArray = new bool [size];
 		InitializeMessageData ();
+		mChangedEvaluationInputs = 0;
 		
 		// Removed below code because "InitializeMessageData ()" performs initialization to specified initial values
 		//for (i=0; i<size; i++)
 		//	mMessageArray [i] = false;
 
-		size = SmartMessage::GetSizeOfValueArrayForScope (scope);
-
-		if (size > 0) {
-
-			mValueArray = new int [size];
-
-			for (i=0; i<size; i++)
-				mValueArray [i] = 0;
-		}
-
-		else {
-
-			mValueArray = new int [1];
-			mValueArray [0] = 0;
-		}
-
-		mMessageDataTable = new RGHashTable (29);
-		mSmartMessageReporters = new RGDList;
-		mUnenabledMessageReporters = new RGDList;
+		//  The value array, the data table and the reporter lists are only needed by a minority of objects, so they are
+		//  allocated when first used
+		mValueArray = NULL;
+		mMessageDataTable = NULL;
+		mSmartMessageReporters = NULL;
+		mUnenabledMessageReporters = NULL;
 	}
 
 	else {
 
 		mMessageArray = NULL;
+		mValueArray = NULL;
 		mMessageDataTable = NULL;
 		mSmartMessageReporters = NULL;
 		mUnenabledMessageReporters = NULL;
@@ -550,53 +825,43 @@ void SmartMessagingObject :: InitializeSmartMessages (const SmartMessagingObject
 
 			for (i=0; i<size; i++)
 				mMessageArray [i] = false;
+
+			mChangedEvaluationInputs = ~0UL;
 		}
 
 		else {
 
 			for (i=0; i<size; i++)
 				mMessageArray [i] = smo.mMessageArray [i];
+
+			mChangedEvaluationInputs = smo.mChangedEvaluationInputs;
 		}
 
 		size = SmartMessage::GetSizeOfValueArrayForScope (scope);
+		mValueArray = NULL;
 
-		if (size > 0) {
+		if ((size > 0) && (smo.mValueArray != NULL)) {
 
 			mValueArray = new int [size];
 
-			if (smo.mValueArray == NULL) {
-
-				for (i=0; i<size; i++)
-					mValueArray [i] = 0;
-			}
-
-			else {
-
-				for (i=0; i<size; i++)
-					mValueArray [i] = smo.mValueArray [i];
-			}
-		}
-
-		else {
-
-			mValueArray = new int [1];
-			mValueArray [0] = 0;
+			for (i=0; i<size; i++)
+				mValueArray [i] = smo.mValueArray [i];
 		}
 
-		if (smo.mMessageDataTable == NULL)
-			mMessageDataTable = new RGHashTable (29);
+		if ((smo.mMessageDataTable == NULL) || (smo.mMessageDataTable->Entries () == 0))
+			mMessageDataTable = NULL;
 
 		else
 			mMessageDataTable = new RGHashTable (*smo.mMessageDataTable);
 
-		if (smo.mSmartMessageReporters == NULL)
-			mSmartMessageReporters = new RGDList;
+		if ((smo.mSmartMessageReporters == NULL) || (smo.mSmartMessageReporters->Entries () == 0))
+			mSmartMessageReporters = NULL;
 
 		else
 			mSmartMessageReporters = new RGDList (*smo.mSmartMessageReporters);
 
-		if (smo.mUnenabledMessageReporters == NULL)
-			mUnenabledMessageReporters = new RGDList;
+		if ((smo.mUnenabledMessageReporters == NULL) || (smo.mUnenabledMessageReporters->Entries () == 0))
+			mUnenabledMessageReporters = NULL;
 
 		else
 			mUnenabledMessageReporters = new RGDList (*smo.mUnenabledMessageReporters);
@@ -605,6 +870,7 @@ void SmartMessagingObject :: InitializeSmartMessages (const SmartMessagingObject
 	else {
 
 		mMessageArray = NULL;
+		mValueArray = NULL;
 		mMessageDataTable = NULL;
 		mSmartMessageReporters = NULL;
 		mUnenabledMessageReporters = NULL;
@@ -618,13 +884,65 @@ void SmartMessagingObject :: CleanupSmartMessages () {
 
 		delete[] mMessageArray;
 		delete[] mValueArray;
-		mMessageDataTable->ClearAndDelete ();
-		delete mMessageDataTable;
-		mSmartMessageReporters->ClearAndDelete ();
-		delete mSmartMessageReporters;
-		mUnenabledMessageReporters->ClearAndDelete ();
-		delete mUnenabledMessageReporters;
+
+		if (mMessageDataTable != NULL) {
+
+			mMessageDataTable->ClearAndDelete ();
+			delete mMessageDataTable;
+		}
+
+		if (mSmartMessageReporters != NULL) {
+
+			mSmartMessageReporters->ClearAndDelete ();
+			delete mSmartMessageReporters;
+		}
+
+		if (mUnenabledMessageReporters != NULL) {
+
+			mUnenabledMessageReporters->ClearAndDelete ();
+			delete mUnenabledMessageReporters;
+		}
 	}
 }
 
 
+SmartMessageData* SmartMessagingObject :: FindMessageData (int index) const {
+
+	if (mMessageDataTable == NULL)
+		return NULL;
+
+	SmartMessageData target (index);
+	return (SmartMessageData*) mMessageDataTable->Find (&target);
+}
+
+
+RGHashTable* SmartMessagingObject :: GetMessageDataTable () {
+
+	if (mMessageDataTable == NULL)
+		mMessageDataTable = new RGHashTable (29);
+
+	return mMessageDataTable;
+}
+
+
+int* SmartMessagingObject :: GetValueArray (const SmartMessage* msg) {
+
+	//  Only counting messages write to the value array, so other messages are given whatever is there, possibly NULL
+
+	if ((mValueArray != NULL) || (msg->NumberOfIntegerValueCellsNeeded () == 0))
+		return mValueArray;
+
+	int size = SmartMessage::GetSizeOfValueArrayForScope (GetObjectScope ());
+
+	if (size <= 0)
+		return mValueArray;
+
+	mValueArray = new int [size];
+
+	for (int i=0; i<size; i++)
+		mValueArray [i] = 0;
+
+	return mValueArray;
+}
+
+
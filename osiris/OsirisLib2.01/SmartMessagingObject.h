@@ -41,6 +41,10 @@
 #include "SmartMessage.h"
 #include "SmartNotice.h"
 #include "RGLogBook.h"
+#include "rgthread.h"
+
+#include <list>
+#include <vector>
 
 const int SmartMessagingCommDepth = 7;
 
@@ -53,6 +57,47 @@ struct SmartMessagingComm {
 };
 
 
+struct SmartMessageTriggerRecord {
+
+	SmartMessagingObject* mTarget;
+	int mScope;
+	int mIndex;
+	bool mHasData;
+	int mValue;
+	RGString mText;
+};
+
+
+//
+//  SmartMessageUpdateLog records the triggers and export specifications that the analysis of one sample directs to objects
+//  shared by all samples (BaseLocus and STRLCAnalysis), so that samples analyzed concurrently update those objects in sample order
+//
+
+class SmartMessageUpdateLog {
+
+public:
+	SmartMessageUpdateLog ();
+	~SmartMessageUpdateLog ();
+
+	void AppendTrigger (SmartMessagingObject* target, int scope, int index);
+	void AppendTrigger (SmartMessagingObject* target, int scope, int index, int value, const RGString& text);
+	void AppendExportSpecification (SmartMessage* sm);
+
+	void Apply ();	// calling thread must not be logging
+	void MoveTo (SmartMessageUpdateLog& log);	// appends all records to log, leaving this log empty
+	void Clear ();
+
+	// Targets are saved as their positions in sharedObjects, so that a log can be restored in a later analysis
+
+	int Save (RGString& text, const vector<SmartMessagingObject*>& sharedObjects) const;	// -1 if a target is not in sharedObjects
+	int Restore (const RGString& text, const vector<SmartMessagingObject*>& sharedObjects);	// appends the saved records; -1 if text is invalid
+
+protected:
+	list<SmartMessageTriggerRecord*> mTriggers;
+	list<SmartMessage*> mExportSpecifications;
+};
+
+
 class SmartMessagingObject : public RGPersistent {
 
 ABSTRACT_DECLARATION (SmartMessagingObject)
@@ -71,9 +116,15 @@ public:
 
 	virtual void OutputDebugID (SmartMessagingComm& comm, int numHigherObjects) = 0;
 	virtual RGString GetDebugIDIndent () const;
+	virtual bool IsSharedBetweenSamples () const { return false; }
+
+	void SetMessageValueOnTrigger (int scope, int location);
+	void SetMessageValueOnTrigger (int scope, int location, int value, const RGString& text);
 
 	bool GetMessageValue (const SmartNotice& notice) const;
 	bool GetMessageValue (int location) const { return mMessageArray [location]; }
+	const bool* GetMessageArray () const { return mMessageArray; }
+	unsigned long GetChangedEvaluationInputs () const { return mChangedEvaluationInputs; }
 	int GetIntegerValue (int location) const;
 	bool AcceptsDataOnTrigger (int index);
 	bool AcceptsDataOnEvaluation (int index);
@@ -92,7 +143,7 @@ public:
 
 	virtual void ClearSmartNoticeObjects ();
 
-	int NumberOfSmartNoticeObjects () const { return mSmartMessageReporters->Entries (); }
+	int NumberOfSmartNoticeObjects () const { return (mSmartMessageReporters != NULL) ? mSmartMessageReporters->Entries () : 0; }
 	virtual int AddSmartMessageReporter (SmartMessageReporter* smr);
 	virtual int AddAllSmartMessageReporters () = 0;
 	virtual int AddAllSmartMessageReporters (SmartMessagingComm& comm, int numHigherObjects) = 0;
@@ -104,12 +155,16 @@ public:
 	static void ClearExportSpecifications ();
 	static void ReportAllExportSpecifications (RGLogBook& oar);
 
+	static void SetSharedUpdateLog (SmartMessageUpdateLog* log) { SharedUpdateLog = log; }
+	static SmartMessageUpdateLog* GetSharedUpdateLog () { return SharedUpdateLog; }
+
 protected:
 	bool* mMessageArray;
-	int* mValueArray;
-	RGHashTable* mMessageDataTable;
-	RGDList* mSmartMessageReporters;
+	int* mValueArray;						// allocated when a counting message is first set
+	RGHashTable* mMessageDataTable;			// allocated when message data is first stored
+	RGDList* mSmartMessageReporters;		// allocated when a reporter is first added
 	RGDList* mUnenabledMessageReporters;
+	unsigned long mChangedEvaluationInputs;	// bits of the tracked test expressions with an input that may differ from its initial value
 
 	int mStageCompleted;
 	int mTriggerStageCompleted;
@@ -118,10 +173,18 @@ protected:
 	int mHighestMessageLevel;
 
 	static RGHashTable ExportSpecifications;
+	static RGThreadStatic<SmartMessageUpdateLog*> SharedUpdateLog;
+	static RGDList EmptyReporterList;
 
 	void InitializeSmartMessages ();
 	void InitializeSmartMessages (const SmartMessagingObject& smo);
 	void CleanupSmartMessages ();
+
+	SmartMessageData* FindMessageData (int index) const;
+	RGHashTable* GetMessageDataTable ();
+	int* GetValueArray (const SmartMessage* msg);
+	void NoteMessageChange (int scope, int location) { mChangedEvaluationInputs |= SmartMessage::GetDependentEvaluations (scope, location); }
+	RGDList& GetSmartMessageReporterList () const { return (mSmartMessageReporters != NULL) ? *mSmartMessageReporters : EmptyReporterList; }
 };
 
 
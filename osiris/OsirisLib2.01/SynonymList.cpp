@@ -36,12 +36,12 @@
 #include "rgtokenizer.h"
 
 
-SynonymList :: SynonymList () : mIt (mList), mValid (true) {
+SynonymList :: SynonymList () : mValid (true) {
 
 }
 
 
-SynonymList :: SynonymList (const RGString& tagName, const RGString& xmlString) : mIt (mList), mValid (true) {
+SynonymList :: SynonymList (const RGString& tagName, const RGString& xmlString) : mValid (true) {
 
 	RGString startTag = "<" + tagName + ">";
 	RGString endTag = "</" + tagName + ">";
@@ -95,9 +95,9 @@ void SynonymList :: AddSynonym (const char* str) {
 bool SynonymList :: DoesTargetStringEqualASynonym (const RGString& target) {
 
 	RGString* nextString;
-	mIt.Reset ();
+	RGDListIterator it (mList);
 
-	while (nextString = (RGString*) mIt()) {
+	while (nextString = (RGString*) it ()) {
 
 		if (target.IsEqualTo (nextString))
 			return true;
@@ -110,10 +110,10 @@ bool SynonymList :: DoesTargetStringEqualASynonym (const RGString& target) {
 bool SynonymList :: DoesTargetStringContainASynonym (const RGString& target) {
 
 	RGString* nextString;
-	mIt.Reset ();
+	RGDListIterator it (mList);
 	size_t pos = 0;
 
-	while (nextString = (RGString*) mIt()) {
+	while (nextString = (RGString*) it ()) {
 
 		if (target.FindSubstring (*nextString, pos))
 			return true;
@@ -127,11 +127,11 @@ bool SynonymList :: DoesTargetStringEqualASynonymCaseIndep (const RGString& targ
 
 	RGString lcTarget (target);
 	lcTarget.ToLower ();
-	mIt.Reset ();
+	RGDListIterator it (mList);
 	RGString test;
 	RGString* nextString;
 
-	while (nextString = (RGString*) mIt ()) {
+	while (nextString = (RGString*) it ()) {
 
 		test = *nextString;
 		test.ToLower ();
@@ -147,11 +147,11 @@ bool SynonymList :: DoesTargetStringEqualASynonymCaseIndep (const RGString& targ
 
 bool SynonymList :: DoesTargetStringContainASynonymCaseIndep (const RGString& target) {
 
-	mIt.Reset ();
+	RGDListIterator it (mList);
 	RGString* nextString;
 	size_t pos = 0;
 
-	while (nextString = (RGString*) mIt ()) {
+	while (nextString = (RGString*) it ()) {
 
 		if (target.FindSubstringCaseIndependent (*nextString, pos))
 			return true;
@@ -60,7 +60,6 @@ public:
 
 protected:
 	RGDList mList;
-	RGDListIterator mIt;
 	bool mValid;
 };
 
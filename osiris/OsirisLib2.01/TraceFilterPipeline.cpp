@@ -0,0 +1,300 @@
+/*
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+*  FileName: TraceFilterPipeline.cpp
+*  Author:   Robert Goor
+*
+*/
+//
+//  class TraceFilterPipeline, which smooths a trace with a chain of array passes
+//
+
+#include "TraceFilterPipeline.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+static int KeepLevelChanges (const double* input, double* output, bool* changeArray, int first, int last, double noiseLevel) {
+
+	//  restores the input samples from first up to last that differ from their average by more than noiseLevel, and returns how many
+
+	int changed = 0;
+	bool isChanged;
+	int i;
+
+	for (i=first; i<last; i++) {
+
+		isChanged = (fabs (output [i] - input [i]) > noiseLevel);
+
+		if (changeArray != NULL)
+			changeArray [i] = isChanged;
+
+		if (isChanged) {
+
+			output [i] = input [i];
+			changed++;
+		}
+	}
+
+	return changed;
+}
+
+
+TraceFilterPipeline :: TraceFilterPipeline () : mScratch (NULL), mScratchSize (0), mChanged (0) {
+
+}
+
+
+TraceFilterPipeline :: ~TraceFilterPipeline () {
+
+	delete[] mScratch;
+}
+
+
+void TraceFilterPipeline :: AppendMovingAverage (int window) {
+
+	TraceFilterPass pass;
+	pass.mType = TraceFilterPass::MovingAveragePass;
+	pass.mHalfWindow = (window > 0) ? (window + 1 - window%2) / 2 : 0;
+	pass.mNoiseLevel = pass.mNoiseLevelStart = pass.mSplitTime = 0.0;
+	pass.mChangeArray = NULL;
+	mPasses.push_back (pass);
+}
+
+
+void TraceFilterPipeline :: AppendTripleMovingAverage (int minWindow) {
+
+	if (minWindow == 1) {
+
+		AppendMovingAverage (minWindow);
+		return;
+	}
+
+	int win3 = minWindow;
+
+	if (win3%2 == 0)
+		win3++;
+
+	int win2 = GetNextTripleWindow (win3);
+	int win1 = GetNextTripleWindow (win2);
+	AppendMovingAverage (win1);
+	AppendMovingAverage (win2);
+	AppendMovingAverage (win3);
+}
+
+
+void TraceFilterPipeline :: AppendLevelChangeAveraging (int halfWidth, double noiseLevel, double noiseLevelStart, double splitTime, bool* changeArray) {
+
+	TraceFilterPass pass;
+	pass.mType = TraceFilterPass::LevelChangeAveragingPass;
+	pass.mHalfWindow = halfWidth;
+	pass.mNoiseLevel = noiseLevel;
+	pass.mNoiseLevelStart = noiseLevelStart;
+	pass.mSplitTime = splitTime;
+	pass.mChangeArray = changeArray;
+	mPasses.push_back (pass);
+}
+
+
+void TraceFilterPipeline :: Clear () {
+
+	mPasses.clear ();
+	mChanged = 0;
+}
+
+
+void TraceFilterPipeline :: Filter (const double* input, int numSamples, double* output) {
+
+	//
+	//  The passes alternate between output and the scratch array, starting with whichever makes the last pass write to output
+	//
+
+	int nPasses = NumberOfPasses ();
+	const double* source = input;
+	double* target;
+	int i;
+
+	mChanged = 0;
+
+	if (numSamples <= 0)
+		return;
+
+	if (nPasses == 0) {
+
+		memcpy (output, input, numSamples * sizeof (double));
+		return;
+	}
+
+	if ((nPasses > 1) && (mScratchSize < numSamples)) {
+
+		delete[] mScratch;
+		mScratch = new double [numSamples];
+		mScratchSize = numSamples;
+	}
+
+	for (i=0; i<nPasses; i++) {
+
+		target = ((nPasses - i) % 2 == 1) ? output : mScratch;
+		const TraceFilterPass& pass = mPasses [i];
+
+		if (pass.mType == TraceFilterPass::MovingAveragePass)
+			MovingAverage (source, numSamples, pass.mHalfWindow, target);
+
+		else
+			mChanged += LevelChangeAveraging (source, numSamples, pass, target);
+
+		source = target;
+	}
+}
+
+
+int TraceFilterPipeline :: GetNextTripleWindow (int window) {
+
+	//  the odd integer nearest 1.4303 * window from above or below
+
+	double temp = 1.4303 * (double)window;
+	int high = (int)ceil (temp);
+	int low = (int)floor (temp);
+
+	if (high%2 != 0)
+		return high;
+
+	if (low%2 == 0)
+		return low + 1;
+
+	return low;
+}
+
+
+void TraceFilterPipeline :: MovingAverage (const double* input, int numSamples, int halfWindow, double* output) {
+
+	//
+	//  The average is updated with the sample entering the window and the sample leaving it, as SampledData::CreateMovingAverageFilteredSignal
+	//  did, so that rounding is the same.  The loop is split where samples start to leave the window and where they stop entering
+	//  it, so that no iteration tests the ends of the trace.
+	//
+
+	double factor = 1.0 / (double) (2 * halfWindow + 1);
+	int noneLeaving = (halfWindow + 1 < numSamples) ? halfWindow + 1 : numSamples;	// samples before this one have nothing leave
+	int allEntering = numSamples - halfWindow;	// samples before this one have a sample enter
+	double temp = 0.0;
+	double currentAve;
+	int i;
+
+	for (i=0; (i<=halfWindow) && (i<numSamples); i++)
+		temp += input [i];
+
+	currentAve = output [0] = temp * factor;
+
+	for (i=1; (i<noneLeaving) && (i<allEntering); i++) {
+
+		currentAve += factor * input [i + halfWindow];
+		output [i] = currentAve;
+	}
+
+	for (; i<noneLeaving; i++)
+		output [i] = currentAve;
+
+	for (; i<allEntering; i++) {
+
+		currentAve += factor * (input [i + halfWindow] - input [i - halfWindow - 1]);
+		output [i] = currentAve;
+	}
+
+	for (; i<numSamples; i++) {
+
+		currentAve -= factor * input [i - halfWindow - 1];
+		output [i] = currentAve;
+	}
+}
+
+
+int TraceFilterPipeline :: LevelChangeAveraging (const double* input, int numSamples, const TraceFilterPass& pass, double* output) {
+
+	//
+	//  The average has a fixed divisor, so it is smaller near the ends of the trace.  A sample that differs from the average by more
+	//  than the noise level for its part of the trace is kept unchanged, because it is probably at a level change.
+	//
+
+	int halfWidth = pass.mHalfWindow;
+	int startPt = (halfWidth < numSamples) ? halfWidth : numSamples;
+	int endPt = numSamples - halfWidth - 1;
+	int timeSplit = (int) floor (pass.mSplitTime);
+	double divisor = (double) (2 * halfWidth + 1);
+	double previous;
+	double sum;
+	int upperLimit;
+	int changed;
+	int i;
+	int j;
+
+	for (i=0; i<startPt; i++) {
+
+		upperLimit = (i + halfWidth < numSamples) ? i + halfWidth : numSamples - 1;
+		sum = 0.0;
+
+		for (j=0; j<=upperLimit; j++)
+			sum += input [j];
+
+		output [i] = sum / divisor;
+	}
+
+	if (startPt <= endPt) {
+
+		sum = 0.0;
+
+		for (j=startPt-halfWidth; j<=startPt+halfWidth; j++)
+			sum += input [j];
+
+		previous = sum;
+		output [startPt] = sum / divisor;
+
+		for (i=startPt+1; i<=endPt; i++) {
+
+			previous = previous - input [i - halfWidth - 1] + input [i + halfWidth];
+			output [i] = previous / divisor;
+		}
+	}
+
+	for (i=(endPt + 1 > startPt) ? endPt + 1 : startPt; i<numSamples; i++) {
+
+		sum = 0.0;
+
+		for (j=i-halfWidth; j<numSamples; j++)
+			sum += input [j];
+
+		output [i] = sum / divisor;
+	}
+
+	int split = (timeSplit + 1 < numSamples) ? timeSplit + 1 : numSamples;
+
+	if (split < 0)
+		split = 0;
+
+	changed = KeepLevelChanges (input, output, pass.mChangeArray, 0, split, pass.mNoiseLevelStart);
+	changed += KeepLevelChanges (input, output, pass.mChangeArray, split, numSamples, pass.mNoiseLevel);
+	return changed;
+}
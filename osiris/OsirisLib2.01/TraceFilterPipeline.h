@@ -0,0 +1,88 @@
+/*
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+*  FileName: TraceFilterPipeline.h
+*  Author:   Robert Goor
+*
+*/
+//
+//  class TraceFilterPipeline applies a chain of smoothing passes to the samples of a trace.  Each pass is a plain loop over
+//  the whole trace, from the output of the previous pass into the next buffer, alternating between the caller's output array
+//  and one scratch array that the pipeline keeps for later traces, so that no intermediate trace is allocated.  Each pass
+//  computes exactly what the corresponding SampledData filter computed, in the same order, so the results are the same.
+//
+
+#ifndef _TRACEFILTERPIPELINE_H_
+#define _TRACEFILTERPIPELINE_H_
+
+#include <vector>
+
+
+struct TraceFilterPass {
+
+	enum { MovingAveragePass, LevelChangeAveragingPass };
+
+	int mType;
+	int mHalfWindow;
+	double mNoiseLevel;
+	double mNoiseLevelStart;
+	double mSplitTime;
+	bool* mChangeArray;	// may be NULL
+};
+
+
+class TraceFilterPipeline {
+
+public:
+	TraceFilterPipeline ();
+	~TraceFilterPipeline ();
+
+	void AppendMovingAverage (int window);	// even windows are increased by 1
+	void AppendTripleMovingAverage (int minWindow);	// three moving averages, with windows in the ratio 1.4303, largest first
+	void AppendLevelChangeAveraging (int halfWidth, double noiseLevel, double noiseLevelStart, double splitTime, bool* changeArray);
+	void Clear ();
+
+	int NumberOfPasses () const { return (int) mPasses.size (); }
+	int GetNumberOfChangedSamples () const { return mChanged; }	// by the last Filter
+
+	void Filter (const double* input, int numSamples, double* output);	// output may not be input
+
+	static int GetNextTripleWindow (int window);
+	static void MovingAverage (const double* input, int numSamples, int halfWindow, double* output);
+	static int LevelChangeAveraging (const double* input, int numSamples, const TraceFilterPass& pass, double* output);	// returns number changed
+
+protected:
+	std::vector<TraceFilterPass> mPasses;
+	double* mScratch;
+	int mScratchSize;
+	int mChanged;
+
+private:
+	TraceFilterPipeline (const TraceFilterPipeline&);
+	TraceFilterPipeline& operator= (const TraceFilterPipeline&);
+};
+
+
+#endif  /*  _TRACEFILTERPIPELINE_H_  */
@@ -41,17 +41,23 @@
 #include "DataInterval.h"
 #include "DataSignal.h"
 #include "RGTextOutput.h"
+#include "rgdlist.h"
 
+#if defined (_M_X64) || defined (__SSE2__) || (defined (_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define _TRACEPREQUALIFICATION_SSE2_
+#include <emmintrin.h>
+#endif
 
-double TracePrequalification::noiseThreshold = 400.0;
-int TracePrequalification::windowWidth = 9;
-double TracePrequalification::lowHeightThreshold = 0.1;
-double TracePrequalification::lowSlopeThreshold = 0.1;
-int TracePrequalification::minSamplesForSlopeRegression = 4;
-double TracePrequalification::defaultNoiseThreshold = 400.0;
-int TracePrequalification::defaultWindowWidth = 9;
-double TracePrequalification::lowHeightModifier = 100.0;
-double TracePrequalification::lowSlopeModifier = 100.0;
+
+RGThreadStatic<double> TracePrequalification::noiseThreshold (400.0);
+RGThreadStatic<int> TracePrequalification::windowWidth (9);
+RGThreadStatic<double> TracePrequalification::lowHeightThreshold (0.1);
+RGThreadStatic<double> TracePrequalification::lowSlopeThreshold (0.1);
+RGThreadStatic<int> TracePrequalification::minSamplesForSlopeRegression (4);
+RGThreadStatic<double> TracePrequalification::defaultNoiseThreshold (400.0);
+RGThreadStatic<int> TracePrequalification::defaultWindowWidth (9);
+RGThreadStatic<double> TracePrequalification::lowHeightModifier (100.0);
+RGThreadStatic<double> TracePrequalification::lowSlopeModifier (100.0);
 
 
 ABSTRACT_DEFINITION (TracePrequalification)
@@ -91,12 +97,109 @@ double LinearSlopeRegression (const double* y, double delt, int N1) {
 }
 
 
+void LinearSlopeRegressions (const double* y, double delt, int N1, int count, double* slopes) {
+
+	//
+	//  Consecutive windows are regressed two at a time, one in each SSE2 lane.  Each lane performs the operations of
+	//  LinearSlopeRegression in the same order, so the slopes are identical to those it returns.
+	//
+
+	int j = 0;
+
+#ifdef _TRACEPREQUALIFICATION_SSE2_
+	double eN1 = (double)N1;
+	double en = eN1 + 1.0;
+	double xbar = eN1 * 0.5;
+	double var = 0.0;
+	double temp;
+	int i;
+
+	for (i=0; i<=N1; i++) {
+
+		temp = (double) i - xbar;
+		var += temp * temp;
+	}
+
+	if (var == 0.0) {
+
+		for (j=0; j<count; j++)
+			slopes [j] = 0.0;
+
+		return;
+	}
+
+	const __m128d vEn = _mm_set1_pd (en);
+	const __m128d vDenominator = _mm_set1_pd (delt * var);
+	__m128d ybar;
+	__m128d r;
+	__m128d vTemp;
+
+	for (j=0; j+1<count; j+=2) {
+
+		ybar = _mm_setzero_pd ();
+
+		for (i=0; i<=N1; i++)
+			ybar = _mm_add_pd (ybar, _mm_loadu_pd (y + j + i));
+
+		ybar = _mm_div_pd (ybar, vEn);
+		r = _mm_setzero_pd ();
+
+		for (i=0; i<=N1; i++) {
+
+			vTemp = _mm_set1_pd ((double) i - xbar);
+			r = _mm_add_pd (r, _mm_mul_pd (vTemp, _mm_sub_pd (_mm_loadu_pd (y + j + i), ybar)));
+		}
+
+		_mm_storeu_pd (slopes + j, _mm_div_pd (r, vDenominator));
+	}
+#endif
+
+	for (; j<count; j++)
+		slopes [j] = LinearSlopeRegression (y + j, delt, N1);
+}
+
+
 enum SEARCHMODE {LookingForMax, LookingForMin, LookingForFinalMin, UnravelingFinalCurve};
 
 
 TracePrequalification :: ~TracePrequalification () {}
 
 
+int TracePrequalification :: GetDataIntervals (RGDList& dataIntervals, RGDList& noiseIntervals, RGTextOutput& text, double minRFU, double noiseRange,
+	bool keepNoiseAboveMinRFU, Boolean print) {
+
+	DataInterval* nextDataInterval;
+	NoiseInterval* nextNoiseInterval = NULL;
+	DataInterval* previousDataInterval = NULL;
+	double maxAtMode;
+	int n = 0;
+
+	while (nextDataInterval = GetNextDataIntervalWithPrecomputedConvolution (nextNoiseInterval, text, minRFU, previousDataInterval, print)) {
+
+		noiseIntervals.Append ((RGPersistent*)nextNoiseInterval);
+		maxAtMode = nextDataInterval->GetMaxAtMode ();
+
+		if ((maxAtMode - nextDataInterval->GetLeftMinimum () < noiseRange) && (maxAtMode - nextDataInterval->GetRightMinimum () < noiseRange)) {
+
+			if (!keepNoiseAboveMinRFU || (maxAtMode < minRFU)) {
+
+				delete nextDataInterval;
+				continue;
+			}
+		}
+
+		dataIntervals.Append (nextDataInterval);
+		previousDataInterval = nextDataInterval;
+		n++;
+	}
+
+	if (nextNoiseInterval != NULL)
+		noiseIntervals.Append ((RGPersistent*)nextNoiseInterval);
+
+	return n;
+}
+
+
 void TracePrequalification :: SetWindowWidth (int width) {
 
 //	if (2 * (width / 2) < width)		//  !!! Changed to accomodate odd-valued WindowWidth's
@@ -157,6 +260,8 @@ void STRTracePrequalification :: ResetSearch (const DataSignal* data, int size,
 	Spacing = DataSignal::GetSampleSpacing ();
 	HalfWindow = WindowWidth / 2;
 
+	delete[] mConvolution;
+	delete[] mSlopeFits;
 	mConvolution = new double [size];
 	mSlopeFits = new double [size];
 
@@ -198,25 +303,31 @@ void STRTracePrequalification :: ResetSearch (const DataSignal* data, int size,
 	double newCenter;
 	double NewConvolution;
 
+	//
+	//  The convolution is a running sum, so it is computed one sample at a time, from the data array rather than through Value.  The
+	//  slope fits are independent, so they are all computed at once afterwards.
+	//
+
 	for (i=CurrentIndex-1; i>0; i--) {
 
-		newL = Data->Value (i - HalfWindow);
-		newR = Data->Value (i + HalfWindow);
-		newCenter = Data->Value (i);
+		newL = (i - HalfWindow >= 0) ? dataArray [i - HalfWindow] : 0.0;
+		newR = (i + HalfWindow <= MaxIndex) ? dataArray [i + HalfWindow] : 0.0;
+		newCenter = dataArray [i];
 		NewConvolution = CurrentConvolution + 0.5 * (OldLeft + newL - OldRight - newR);
 		mConvolution [i] = NewConvolution;
-
-		if (i - halfHalfWindow >= 0)
-			mSlopeFits [i] = LinearSlopeRegression (dataArray + i - halfHalfWindow, delt, halfWindow1);
-
-		else
-			mSlopeFits [i] = 0.0;
-
 		CumulativeNorm += newCenter * newCenter;
 		OldLeft = newL;
 		OldRight = newR;
 		CurrentConvolution = NewConvolution;
 	}
+
+	int firstSlope = (halfHalfWindow > 1) ? halfHalfWindow : 1;
+
+	for (i=1; (i<firstSlope) && (i<CurrentIndex); i++)
+		mSlopeFits [i] = 0.0;
+
+	if (CurrentIndex - firstSlope > 0)
+		LinearSlopeRegressions (dataArray + firstSlope - halfHalfWindow, delt, halfWindow1, CurrentIndex - firstSlope, mSlopeFits + firstSlope);
 }
 
 
@@ -741,6 +852,10 @@ DataInterval* STRTracePrequalification :: GetNextDataInterval (NoiseInterval*& C
 		LocationOfLastMin = CurrentIndex;
 					
 		PeakLeft = CurrentIndex;
+
+		if (SearchMode == UnravelingFinalCurve)
+			delete dataInterval;	// replaced by the interval that ends with the data
+
 		dataInterval = new DataInterval (PeakLeft, PeakCenter, PeakRight);
 		dataInterval->SetHeight (PeakHeight);
 		dataInterval->SetMass (PeakMass);
@@ -1446,6 +1561,10 @@ DataInterval* STRTracePrequalification :: GetNextDataIntervalWithPrecomputedConv
 					
 		PeakLeft = CurrentIndex;
 		peakValueLeft = Data->Value (PeakLeft);
+
+		if (SearchMode == UnravelingFinalCurve)
+			delete dataInterval;	// replaced by the interval that ends with the data
+
 		dataInterval = new DataInterval (PeakLeft, PeakCenter, PeakRight);
 		dataInterval->SetHeight (PeakHeight);
 		dataInterval->SetMass (PeakMass);
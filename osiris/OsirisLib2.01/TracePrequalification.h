@@ -37,6 +37,7 @@
 #define _TRACEPREQUALIFICATION_H_
 
 #include "rgpersist.h"
+#include "rgthread.h"
 
 class RGFile;
 class RGVInStream;
@@ -45,6 +46,7 @@ class DataInterval;
 class NoiseInterval;
 class DataSignal;
 class RGTextOutput;
+class RGDList;
 
 //
 //    Required Parameters:
@@ -57,6 +59,7 @@ const int _STRTRACEPREQUALIFICATION_ = 1006;
 PERSISTENT_PREDECLARATION (STRTracePrequalification)
 
 double LinearSlopeRegression (const double* y, double delt, int N1);
+void LinearSlopeRegressions (const double* y, double delt, int N1, int count, double* slopes);	// slopes [j] is LinearSlopeRegression (y + j, delt, N1)
 
 
 class TracePrequalification : public RGPersistent {
@@ -72,6 +75,15 @@ public:
 	virtual DataInterval* GetNextDataIntervalWithPrecomputedConvolution (NoiseInterval*& noiseInterval, RGTextOutput& text, double minRFU, DataInterval* prevInterval, Boolean print = TRUE) = 0;
 	virtual double GetNorm () const = 0;
 
+	//
+	//  Appends all of the data intervals remaining in the search to dataIntervals, in search order, and the noise interval found with each
+	//  to noiseIntervals.  A data interval whose maximum is within noiseRange of both of its minima is noise and is deleted, unless
+	//  keepNoiseAboveMinRFU and its maximum is at least minRFU.  Returns the number of data intervals appended.
+	//
+
+	int GetDataIntervals (RGDList& dataIntervals, RGDList& noiseIntervals, RGTextOutput& text, double minRFU, double noiseRange,
+		bool keepNoiseAboveMinRFU, Boolean print = TRUE);
+
 	static void SetNoiseThreshold (double threshold) { noiseThreshold = threshold; }
 	static double GetNoiseThreshold () { return noiseThreshold; }
 
@@ -100,17 +112,17 @@ public:
 	static int GetMinSamplesForSlopeRegression () { return minSamplesForSlopeRegression; }
 
 private:
-	static double noiseThreshold;
-	static int windowWidth;
-	static double lowHeightThreshold;
-	static double lowSlopeThreshold;
-	static int minSamplesForSlopeRegression;
+	static RGThreadStatic<double> noiseThreshold;
+	static RGThreadStatic<int> windowWidth;
+	static RGThreadStatic<double> lowHeightThreshold;
+	static RGThreadStatic<double> lowSlopeThreshold;
+	static RGThreadStatic<int> minSamplesForSlopeRegression;
 
-	static double defaultNoiseThreshold;
-	static int defaultWindowWidth;
+	static RGThreadStatic<double> defaultNoiseThreshold;
+	static RGThreadStatic<int> defaultWindowWidth;
 
-	static double lowHeightModifier;
-	static double lowSlopeModifier;
+	static RGThreadStatic<double> lowHeightModifier;
+	static RGThreadStatic<double> lowSlopeModifier;
 };
 
 
@@ -42,6 +42,11 @@
 #include "ByteOrder.h"
 #include "Exception.h"
 
+#if defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define _FSADIRENTRY_SSE2_
+#include <emmintrin.h>
+#endif
+
 // #define __BUG
 
 #define _TYPE_UINT8 1
@@ -123,6 +128,8 @@ void fsaDirEntry::BuildIt
     memcpy(sName,_psName,4);
     sName[4] = 0;
     pString = NULL;
+    pView = NULL;
+    pDeferredReader = NULL;
     nJUNK = 0;
     nDataOffset = 0;
     nNumber = _nNumber;
@@ -162,6 +169,8 @@ void fsaDirEntry::_Setup(const UINT8	*pEntry, bool	bBig)
 	if(pEntry	!= NULL)
 	{
   	pData	=	NULL;
+	  pView = NULL;
+	  pDeferredReader = NULL;
 	  pString = NULL;
 		strncpy(sName,(const char *)pEntry,4);
     sName[4] = 0;
@@ -215,6 +224,8 @@ fsaDirEntry::fsaDirEntry
 fsaDirEntry::fsaDirEntry(const fsaDirEntry &entry)
 {
   pData = NULL;
+  pView = NULL;
+  pDeferredReader = NULL;
   pString = NULL;
   (*this) = entry;
 }
@@ -230,10 +241,25 @@ fsaDirEntry& fsaDirEntry::operator =(const fsaDirEntry &entry)
   nElementType = entry.nElementType;
   nElementSize = entry.nElementSize;
   pString = NULL;
-  AllocateData(false);
-  if(pData != NULL)
+  pView = NULL;
+  pDeferredReader = NULL;
+  const_cast<fsaDirEntry &>(entry).LoadDeferred();
+  if((entry.pData == NULL) && (entry.pView != NULL))
   {
-    memcpy(pData,entry.pData,(size_t) nDataSize);
+    // copy and convert the data referred to by the other entry
+    AllocateData(false, (void *)entry.pView);
+    if(pData != NULL)
+    {
+      SetupEndian(false);
+    }
+  }
+  else
+  {
+    AllocateData(false);
+    if(pData != NULL)
+    {
+      memcpy(pData,entry.pData,(size_t) nDataSize);
+    }
   }
   return (*this);
 }
@@ -398,15 +424,48 @@ void fsaDirEntry::SetupEndian(bool bThrow)
 		LoadDataBytes(nBytes);
 	}
 }
+void fsaDirEntry::LoadDeferred()
+{
+  if(pDeferredReader != NULL)
+  {
+    IReader *p = pDeferredReader;
+    pDeferredReader = NULL;
+    LoadData(false,p);
+  }
+}
+void fsaDirEntry::LoadPending()
+{
+  LoadDeferred();
+  if((pData == NULL) && (pView != NULL))
+  {
+    AllocateData(false, (void *)pView);
+    if(pData != NULL)
+    {
+      SetupEndian(false);
+    }
+  }
+}
 void fsaDirEntry::LoadData(bool bThrow, IReader *pReader)
 {
-  if(pData != NULL)
+  const UINT8 *pMapped = NULL;
+  pDeferredReader = NULL;
+  if((pData != NULL) || (pView != NULL))
   {
     if(bThrow)
     {
       throw new Exception("fsaDirEntry::LoadData() -- data already loaded");
     }
   }
+  else if(
+    ((nElementType == TYPE_INT16) || (nElementType == TYPE_UINT16)) &&
+    (BytesToRead() > 4) &&
+    ((pMapped = pReader->GetView(nDataOffset,BytesToRead())) != NULL)
+    )
+  {
+    // the arrays of short, e.g., DATA, are not copied
+    // until a pointer is needed, see GetDataINT16View()
+    pView = pMapped;
+  }
   else
   {
     size_t nToRead = BytesToRead();
@@ -578,6 +637,7 @@ void fsaDirEntry::InvalidType(bool bThrow, const char *psType)
 }
 const UINT8 *fsaDirEntry::GetDataUINT8(bool bThrow)
 {
+	LoadPending();
 	const UINT8 *pRtn = NULL;
 	switch (ElementTypeEnum())
 	{
@@ -596,6 +656,7 @@ const UINT8 *fsaDirEntry::GetDataUINT8(bool bThrow)
 
 const char *fsaDirEntry::GetDataString(bool bThrow)
 {
+	LoadPending();
 	const char *pRtn = (const char *)pData;
 	bool bP = false;
 	INT16 nType = ElementTypeEnum();
@@ -621,6 +682,7 @@ const UINT16 *fsaDirEntry::GetDataUINT16(bool bThrow)
 	UINT16 *pnRtn = NULL;
 	if(nElementType == TYPE_UINT16)
 	{
+		LoadPending();
 		pnRtn = (UINT16 *)pData;
 	}
 	else
@@ -635,6 +697,7 @@ const INT16 *fsaDirEntry::GetDataINT16(bool bThrow)
 	INT16 *pnRtn = NULL;
 	if(nElementType == TYPE_INT16)
 	{
+		LoadPending();
 		pnRtn = (INT16 *)pData;
 	}
 	else
@@ -644,8 +707,68 @@ const INT16 *fsaDirEntry::GetDataINT16(bool bThrow)
 	return pnRtn;
 }
 
+fsaINT16View fsaDirEntry::GetDataINT16View(bool bThrow)
+{
+	fsaINT16View vRtn;
+	if(nElementType != TYPE_INT16)
+	{
+		InvalidType(bThrow,"INT16");
+	}
+	else
+	{
+		LoadDeferred();
+		if(pData != NULL)
+		{
+			vRtn = fsaINT16View((const UINT8 *)pData, nNumElements, false);
+		}
+		else if(pView != NULL)
+		{
+			vRtn = fsaINT16View(pView, nNumElements, true);
+		}
+	}
+	return vRtn;
+}
+
+void fsaINT16View::CopyToDouble(double *pDest, UINT32 nCount) const
+{
+  // Eight elements at a time, the bytes are swapped if needed
+  // and the shorts are sign extended to int and converted to
+  // double in registers, so the data are read only once
+
+  UINT32 i = 0;
+  if(nCount > _n)
+  {
+    nCount = _n;
+  }
+#ifdef _FSADIRENTRY_SSE2_
+  UINT32 nBlock = nCount & ~((UINT32)7);
+  __m128i v;
+  __m128i vLo;
+  __m128i vHi;
+  for(i = 0; i < nBlock; i += 8)
+  {
+    v = _mm_loadu_si128((const __m128i *)(_p + (i << 1)));
+    if(_bBig)
+    {
+      v = _mm_or_si128(_mm_slli_epi16(v,8),_mm_srli_epi16(v,8));
+    }
+    vLo = _mm_srai_epi32(_mm_unpacklo_epi16(v,v),16);
+    vHi = _mm_srai_epi32(_mm_unpackhi_epi16(v,v),16);
+    _mm_storeu_pd(pDest + i,_mm_cvtepi32_pd(vLo));
+    _mm_storeu_pd(pDest + i + 2,_mm_cvtepi32_pd(_mm_unpackhi_epi64(vLo,vLo)));
+    _mm_storeu_pd(pDest + i + 4,_mm_cvtepi32_pd(vHi));
+    _mm_storeu_pd(pDest + i + 6,_mm_cvtepi32_pd(_mm_unpackhi_epi64(vHi,vHi)));
+  }
+#endif
+  for(; i < nCount; i++)
+  {
+    pDest[i] = (double)(*this)[i];
+  }
+}
+
 const INT32 *fsaDirEntry::GetDataINT32(bool bThrow)
 {
+	LoadPending();
 	INT32 *pnRtn = NULL;
 	if(nElementType == TYPE_INT32)
 	{
@@ -660,6 +783,7 @@ const INT32 *fsaDirEntry::GetDataINT32(bool bThrow)
 
 const float *fsaDirEntry::GetDataFloat(bool bThrow)
 {
+	LoadPending();
 	float *pfRtn = NULL;
 	if(nElementType == TYPE_FLOAT)
 	{
@@ -674,6 +798,7 @@ const float *fsaDirEntry::GetDataFloat(bool bThrow)
 
 const double *fsaDirEntry::GetDataDouble(bool bThrow)
 {
+	LoadPending();
 	double *pdRtn = NULL;
 	if(nElementType == TYPE_DOUBLE)
 	{
@@ -687,6 +812,7 @@ const double *fsaDirEntry::GetDataDouble(bool bThrow)
 }
 const fsaDate *fsaDirEntry::GetDataDate(bool bThrow)
 {
+	LoadPending();
 	fsaDate *pRtn = NULL;
 	if(nElementType == TYPE_DATE)
 	{
@@ -701,6 +827,7 @@ const fsaDate *fsaDirEntry::GetDataDate(bool bThrow)
 
 const fsaTime *fsaDirEntry::GetDataTime(bool bThrow)
 {
+	LoadPending();
 	const fsaTime *pRtn = NULL;
 	if(nElementType == TYPE_TIME)
 	{
@@ -715,6 +842,7 @@ const fsaTime *fsaDirEntry::GetDataTime(bool bThrow)
 
 const fsaThumb *fsaDirEntry::GetDataThumb(bool bThrow)
 {
+	LoadPending();
 	const fsaThumb *pRtn = NULL;
 	if(nElementType == TYPE_THUMB)
 	{
@@ -843,6 +971,7 @@ fsaPeak *fsaDirEntry::GetDataPeak(bool bThrow)
   fsaPeak *pRtn = NULL;
   if(isPeak())
   {
+    LoadPending();
     pRtn = BuildPeakData(pData,nDataSize);
   }
   if(bThrow && (pRtn != NULL))
@@ -856,6 +985,7 @@ fsaPeak *fsaDirEntry::GetDataPeak(bool bThrow)
 
 const void *fsaDirEntry::GetDataRaw(bool bThrow)
 {
+	LoadPending();
 	return pData;
 }
 
@@ -1305,6 +1435,10 @@ void fsaDirEntry::BuildStringUser()
 bool fsaDirEntry::CharByte() const
 {
 	bool bRtn = false;
+	if(ElementType() == TYPE_CHAR)
+	{
+		const_cast<fsaDirEntry *>(this)->LoadPending();
+	}
 	if( 
 		(pData != NULL) &&
 		(ElementType() == TYPE_CHAR)
@@ -1510,6 +1644,7 @@ const RGString &fsaDirEntry::DataToString(bool bThrow)
 {
 	if(pString == NULL)
 	{
+		LoadPending();
 		switch(ElementTypeEnum(nElementType))
 		{
 		case _TYPE_UINT8:
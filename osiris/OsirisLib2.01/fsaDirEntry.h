@@ -167,6 +167,14 @@ http://www.appliedbiosystems.com/support/software_community/ABIF_File_Format.pdf
         because the retrieved string is uppercase.  This shouldn't be 
         needed outside this class and fsaFileInput.
 
+      static UINT32 MakeTag(const char *psName)
+
+        *psName - name of entry, 4 characters
+
+        retrieves the name as a number, the first character in the 
+        high order byte, for storing and searching for a directory 
+        entry.  This is case sensitive.
+
       static INT16 ElementTypeEnum(INT16 n)
 
         retrieves the element type of this element, except for a user 
@@ -216,6 +224,8 @@ http://www.appliedbiosystems.com/support/software_community/ABIF_File_Format.pdf
     GET methods
       const char *Name() const - name of this entry
 
+      UINT32 Tag() const - name of this entry, see MakeTag()
+
       INT16 ElementType() const - data type of this entry, one of 
                     the public static const number described above
 
@@ -286,6 +296,18 @@ http://www.appliedbiosystems.com/support/software_community/ABIF_File_Format.pdf
       const INT16 *GetDataINT16(bool bThrow = false)
           pointer to an array of short
 
+      fsaINT16View GetDataINT16View(bool bThrow = false)
+          the array of short, without a copy if the entry refers
+          to data in a file mapped by fsaFileInput, where it is 
+          big endian.  The view converts each element as it is 
+          retrieved, view[i], and is valid as long as this entry.
+          The view is empty, IsEmpty(), where GetDataINT16() would
+          retrieve NULL.  This is preferred for large arrays, e.g., 
+          the DATA entries, which are only converted once.
+          view.CopyToDouble(pDest, nCount) converts the first
+          nCount elements (all, if omitted) to double in one pass,
+          swapping bytes as needed, into pDest.
+
       const INT32 *GetDataINT32(bool bThrow = false)
           pointer to an array of long
 
@@ -448,6 +470,46 @@ typedef struct
 
 class fsaFileInput;
 
+class fsaINT16View
+{
+public:
+  fsaINT16View() : _p(NULL), _n(0), _bBig(false) {}
+  fsaINT16View(const UINT8 *p, UINT32 n, bool bBig) : 
+    _p(p), _n(n), _bBig(bBig) {}
+
+  bool IsEmpty() const
+  {
+    return (_p == NULL);
+  }
+  UINT32 Size() const
+  {
+    return _n;
+  }
+  INT16 operator[](UINT32 i) const
+  {
+    const UINT8 *p = _p + (i << 1);
+    INT16 nRtn;
+    if(_bBig)
+    {
+      nRtn = (INT16)((p[0] << 8) | p[1]);
+    }
+    else
+    {
+      memcpy(&nRtn,p,sizeof(nRtn));
+    }
+    return nRtn;
+  }
+  void CopyToDouble(double *pDest) const
+  {
+    CopyToDouble(pDest,_n);
+  }
+  void CopyToDouble(double *pDest, UINT32 nCount) const;
+private:
+  const UINT8 *_p;
+  UINT32 _n;
+  bool _bBig; // otherwise, the data are in the byte order of this computer
+};
+
 
 class fsaDirEntry
 {
@@ -486,6 +548,20 @@ public:
 
   virtual ~fsaDirEntry();
   static RGString MakeKey(const char *ps, INT32 n);
+  static UINT32 MakeTag(const char *ps)
+  {
+    UINT32 nRtn = 0;
+    int i;
+    for(i = 0; (i < 4) && ps[i]; i++)
+    {
+      nRtn = (nRtn << 8) | (UINT8) ps[i];
+    }
+    for(; i < 4; i++)
+    {
+      nRtn <<= 8;
+    }
+    return nRtn;
+  }
   
   static bool ValidateName(const UINT8 *ps);
   bool ValidateName() const
@@ -503,6 +579,10 @@ public:
   {
     return sName;
   }
+  UINT32 Tag() const
+  {
+    return MakeTag(sName);
+  }
   INT16 ElementType() const
   {
     return nElementType;
@@ -586,6 +666,7 @@ public:
   const char *GetDataString(bool bThrow = false);
   const UINT16 *GetDataUINT16(bool bThrow = false);
   const INT16 *GetDataINT16(bool bThrow = false);
+  fsaINT16View GetDataINT16View(bool bThrow = false);
   const INT32 *GetDataINT32(bool bThrow = false);
   const float *GetDataFloat(bool bThrow = false);
   const double *GetDataDouble(bool bThrow = false);
@@ -620,6 +701,8 @@ public:
       free(pData);
       pData = NULL;
     }
+    pView = NULL;
+    pDeferredReader = NULL;
   }
   static const char *GetTypeString(INT16 nType);
   static INT16 GetTypeFromString(const RGString &s);
@@ -671,6 +754,12 @@ public:
   size_t BytesToRead();
   void LoadData(bool bThrow, void *pRawData, bool bLocalEndian = true, bool bCopy = false);
   void LoadData(bool bThrow, IReader *pReader);
+  void LoadDataDeferred(IReader *_pReader)
+  {
+    // the data are loaded from _pReader when first retrieved, 
+    // _pReader must remain valid until then
+    pDeferredReader = _pReader;
+  }
 
   void LoadNewData(
     void *_pRawData,  // the actual data
@@ -744,6 +833,8 @@ protected:
   void LoadDataUser(bool bThrow);
   void SetupEndian(bool bThrow);
   void InvalidType(bool bThrow,const char *psType);
+  void LoadDeferred(); // loads the data from pDeferredReader, if not already loaded
+  void LoadPending(); // and copies the data from pView, so that pData can be used
 
   //  BuildArray -- returns number of elements
   template<class T>
@@ -836,6 +927,8 @@ private:
   {
     memset(sName,0,sizeof(sName));
     pData = NULL;
+    pView = NULL;
+    pDeferredReader = NULL;
     pString = NULL;
     nNumber = 0;
     nNumElements = 0;
@@ -853,6 +946,8 @@ private:
   UINT32 nDataOffset;
   INT32  nJUNK;
   void *pData;
+  const UINT8 *pView; // big endian data in the file, used until pData is needed
+  IReader *pDeferredReader; // from which the data have not yet been loaded
   RGString *pString;
   INT16 nElementType;
   UINT16 nElementSize;
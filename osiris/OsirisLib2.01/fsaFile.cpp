@@ -50,6 +50,7 @@ http://www.appliedbiosystems.com/support/software_community/ABIF_File_Format.pdf
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <algorithm>
 #include "fsaFile.h"
 #include "ByteOrder.h"
 #include "Exception.h"
@@ -71,7 +72,7 @@ void fsaFile::ClearEntries()
 		}
 	}
 	_vecDirEntry.clear();
-	_mapDirEntry.clear();
+	_indexDirEntry.clear();
 }
 void fsaFile::cleanup()
 {
@@ -91,11 +92,19 @@ fsaFile::~fsaFile()
 
 fsaDirEntry *fsaFile::FindDirEntry(const char *ps, INT32 n)
 {
-  RGString s = fsaDirEntry::MakeKey(ps,n);
-  MapDirEntry::iterator itr = _mapDirEntry.find(s);
-  fsaDirEntry *pRtn = (itr == _mapDirEntry.end()) ? NULL : itr->second;
+  IndexItem x(fsaDirEntry::MakeTag(ps),n);
+  IndexDirEntry::iterator itr = 
+    std::lower_bound(_indexDirEntry.begin(),_indexDirEntry.end(),x);
+  fsaDirEntry *pRtn = 
+    ( (itr == _indexDirEntry.end()) || (x < *itr) ) 
+    ? NULL : itr->pEntry;
   return pRtn;
 }
+void fsaFile::SortIndex()
+{
+  // stable, so that the first of any duplicate entries is found
+  std::stable_sort(_indexDirEntry.begin(),_indexDirEntry.end());
+}
 
 static int CompareEntry(const void *pp1, const void *pp2)
 {
@@ -176,15 +185,16 @@ bool fsaFile::AddDirEntry(fsaDirEntry *pEntry)
   }
   else
   {
-    RGString sKey(pEntry->MakeKey());
-    MapDirEntry::iterator itr = _mapDirEntry.find(sKey);
-    if(itr != _mapDirEntry.end())
+    IndexItem x(pEntry->Tag(),pEntry->Number(),pEntry);
+    IndexDirEntry::iterator itr = 
+      std::lower_bound(_indexDirEntry.begin(),_indexDirEntry.end(),x);
+    if( (itr != _indexDirEntry.end()) && !(x < *itr) )
     {
       bRtn = false;
     }
     else
     {
-	    _mapDirEntry.insert(MapDirEntry::value_type(sKey,pEntry));
+	    _indexDirEntry.insert(itr,x);
 	    _vecDirEntry.push_back(pEntry);
     }
   }
@@ -80,7 +80,10 @@ http://www.appliedbiosystems.com/support/software_community/ABIF_File_Format.pdf
 
       fsaDirEntry *FindDirEntry(const char *psName, int nNumber);
         search for an instance of fsaDirEntry with the specified 
-        name and number.  The search is NOT case sensitive.
+        name and number.  The search is case sensitive and uses 
+        an index, sorted by fsaDirEntry::MakeTag(psName) and number,
+        so no key is built for the search.  If more than one entry 
+        has the name and number, the first one added is retrieved.
 
       INT16 version()
         retrieve the version of the fsa file (x100).  This has been 
@@ -222,12 +225,31 @@ public:
   void Sort();
   bool IsSorted();
 protected:
-  typedef map<RGString, fsaDirEntry *> MapDirEntry;
+  class IndexItem
+  {
+  public:
+    IndexItem(UINT32 _nTag, INT32 _nNumber, fsaDirEntry *_pEntry = NULL) :
+      nTag(_nTag), nNumber(_nNumber), pEntry(_pEntry) {}
+    bool operator < (const IndexItem &x) const
+    {
+      return (nTag < x.nTag) || ((nTag == x.nTag) && (nNumber < x.nNumber));
+    }
+    UINT32 nTag;
+    INT32 nNumber;
+    fsaDirEntry *pEntry;
+  };
+  typedef vector<IndexItem> IndexDirEntry;
   void cleanup();
   void BuildDirEntry();
+  void AppendIndex(fsaDirEntry *pEntry)
+  {
+    // the index must be sorted, SortIndex(), before it is searched
+    _indexDirEntry.push_back(IndexItem(pEntry->Tag(),pEntry->Number(),pEntry));
+  }
+  void SortIndex();
 
   bool _bFileBigEndian;
-  MapDirEntry _mapDirEntry;
+  IndexDirEntry _indexDirEntry;
   vector<fsaDirEntry *> _vecDirEntry;
   fsaDirEntry *_pDir;
   vector<fsaDirEntry *>::size_type _nNextEntry;
@@ -208,15 +208,14 @@ DataSignal* fsaFileData :: GetDataSignalForDataChannel (int channelNumber) {
 	if (N <= 1)
 		return NULL;
 
-	const INT16* intData = entry->GetDataINT16 ();
+	fsaINT16View intData = entry->GetDataINT16View ();
 
-	if (intData == NULL)
+	if (intData.IsEmpty ())
 		return NULL;
 
 	data = new double [N];
 
-	for (int i=0; i<N; i++)
-		data[i] = (double)intData [i];
+	intData.CopyToDouble (data);
 
 	double spacing = 1.0;
 	DataSignal* ds = new SampledData (N, 0.0, (N - 1) * spacing, data);
@@ -241,15 +240,14 @@ double* fsaFileData :: GetDataForDataChannel (int channelNumber) {
 		return NULL;
 
 	int N = (int)entry->NumElements ();
-	const INT16* intData = entry->GetDataINT16 ();
+	fsaINT16View intData = entry->GetDataINT16View ();
 
-	if (intData == NULL)
+	if (intData.IsEmpty ())
 		return NULL;
 
 	data = new double [N];
 
-	for (int i=0; i<N; i++)
-		data[i] = (double)intData [i];
+	intData.CopyToDouble (data);
 
 	return data;
 }
@@ -272,16 +270,15 @@ DataSignal* fsaFileData :: GetRawDataSignalForDataChannel (int channelNumber) {
 		return NULL;
 
 	int N = (int)entry->NumElements ();
-	const INT16* intData = entry->GetDataINT16 ();
+	fsaINT16View intData = entry->GetDataINT16View ();
 
-	if (intData == NULL)
+	if (intData.IsEmpty ())
 		return NULL;
 
 //	intData += GetDataOffset ();  //This skips the "bad" stuff but gives an array mismatch
 	data = new double [N];
 
-	for (int i=0; i<N; i++)
-		data[i] = (double)intData [i];
+	intData.CopyToDouble (data);
 
 	double spacing = 1.0;
 	DataSignal* ds = new SampledData (N, 0.0, (N - 1) * spacing, data);
@@ -306,21 +303,73 @@ double* fsaFileData :: GetRawDataForDataChannel (int channelNumber, int& numData
 		return NULL;
 
 	numDataPoints = (int)entry->NumElements ();
-	const INT16* intData = entry->GetDataINT16 ();
+	fsaINT16View intData = entry->GetDataINT16View ();
 
-	if (intData == NULL)
+	if (intData.IsEmpty ())
 		return NULL;
 
 //	intData += GetDataOffset ();  //This skips the "bad" stuff but gives an array mismatch
 	data = new double [numDataPoints];
 
-	for (int i=0; i<numDataPoints; i++)
-		data[i] = (double)intData [i];
+	intData.CopyToDouble (data);
 
 	return data;
 }
 
 
+double* fsaFileData :: GetRawDataForAllDataChannels (int numberOfChannels, int& numDataPoints) {
+
+	//
+	//  All of the channels are converted into one array, with channel i starting at (i - 1) * numDataPoints, where numDataPoints is the
+	//  fewest samples in any channel.  Returns NULL if any channel is missing.
+	//
+
+	fsaDirEntry** entries = new fsaDirEntry* [numberOfChannels];
+	fsaINT16View* views = new fsaINT16View [numberOfChannels];
+	double* data = NULL;
+	int ID;
+	int i;
+	int N;
+	numDataPoints = 0;
+
+	for (i=0; i<numberOfChannels; i++) {
+
+		if (i + 1 > RawDataLimit)
+			ID = RawDataSecondaryBase + i + 1;
+
+		else
+			ID = RawDataBase + i + 1;
+
+		entries [i] = fsaInput->FindDirEntry (RawDataTag, ID);
+
+		if (entries [i] == NULL)
+			break;
+
+		views [i] = entries [i]->GetDataINT16View ();
+
+		if (views [i].IsEmpty ())
+			break;
+
+		N = (int)entries [i]->NumElements ();
+
+		if ((i == 0) || (N < numDataPoints))
+			numDataPoints = N;
+	}
+
+	if ((i == numberOfChannels) && (numDataPoints > 0)) {
+
+		data = new double [numberOfChannels * numDataPoints];
+
+		for (i=0; i<numberOfChannels; i++)
+			views [i].CopyToDouble (data + i * numDataPoints, (UINT32)numDataPoints);
+	}
+
+	delete[] views;
+	delete[] entries;
+	return data;
+}
+
+
 int fsaFileData :: GetNumberOfDataElementsForAmbientChannel (int channelNumber) {
 
 	int ID;
@@ -356,15 +405,14 @@ double* fsaFileData :: GetDataForAmbientChannel (int channelNumber) {
 
 	int N = (int)entry->NumElements ();
 
-	const INT16* intData = entry->GetDataINT16 ();
+	fsaINT16View intData = entry->GetDataINT16View ();
 
-	if (intData == NULL)
+	if (intData.IsEmpty ())
 		return NULL;
 
 	data = new double [N];
 
-	for (int i=0; i<N; i++)
-		data[i] = (double)intData [i];
+	intData.CopyToDouble (data);
 
 	return data;
 }
@@ -70,6 +70,7 @@ public:
 
 	virtual DataSignal* GetRawDataSignalForDataChannel (int channelNumber);
 	virtual double* GetRawDataForDataChannel (int channelNumber, int& numDataPoints);
+	virtual double* GetRawDataForAllDataChannels (int numberOfChannels, int& numDataPoints);	// one array for all channels; delete[] when done
 
 	virtual int GetNumberOfDataElementsForAmbientChannel (int channelNumber);
 	virtual double* GetDataForAmbientChannel (int channelNumber);
@@ -43,18 +43,47 @@
 #include "ByteOrder.h"
 #include "Exception.h"
 
-#define MAX_FILE_SIZE 5000000
+#ifdef _WINDOWS
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 fsaFileInput::~fsaFileInput()
 {
   _CleanupBuffer();
 }
 
+void fsaFileInput::_CleanupBuffer()
+{
+  if(_pBuffer == NULL) {}
+  else if(_bMapped)
+  {
+#ifdef _WINDOWS
+    UnmapViewOfFile((LPCVOID)_pBuffer);
+#else
+    munmap((void *)_pBuffer,_nBufferSize);
+#endif
+  }
+  else
+  {
+    free((void *)_pBuffer);
+  }
+  _pBuffer = NULL;
+  _pBufferSeek = NULL;
+  _nBufferSize = 0;
+  _bMapped = false;
+}
+
 
 void fsaFileInput::Insert(UINT8 *pBuffer)
 {
 	fsaDirEntry *p = new fsaDirEntry(pBuffer);
-	_mapDirEntry.insert(MapDirEntry::value_type(p->MakeKey(),p));
+	AppendIndex(p);
 	_vecDirEntry.push_back(p);
 }
 bool fsaFileInput::_ReadBytes(void *pBuffer, size_t n)
@@ -301,7 +330,7 @@ bool fsaFileInput::_EntryOK(const UINT8 *pBufferMid, bool bCheckType) const
   bool bRtn = true;
   INT32 HIBYTE = 0xFF000000;
   if( (pBufferMid < _pBuffer) || // includes NULL
-      (pBufferMid > (_pBuffer + _nBufferSize))
+      (pBufferMid > (_pBuffer + _nBufferSize - 28)) // the entry is read from the buffer
     )
   {
     bRtn = false;
@@ -423,35 +452,83 @@ void fsaFileInput::_SetupHIDOffset()
 
 #endif
 
-bool fsaFileInput::_LoadFileBuffer(const char *psName)
+bool fsaFileInput::_MapFile(const char *psName)
 {
-  RGFile File(psName,"rb");
-  _nBufferSize = (size_t)File.GetSizeOfFile();
-  if(!File.Exists())
-  {
-    _bError = true;
-  }
-  else if((_nBufferSize = File.GetSizeOfFile()) < 100)
+  // map the file read only, so that the directory entries
+  // can refer to their data instead of copying it
+  bool bRtn = false;
+#ifdef _WINDOWS
+  RGString sName(psName);
+  HANDLE hFile = CreateFileW(
+    sName.GetWData(), GENERIC_READ, FILE_SHARE_READ, NULL,
+    OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if(hFile != INVALID_HANDLE_VALUE)
   {
-    _bError = true;
+    LARGE_INTEGER nSize;
+    HANDLE hMapping = NULL;
+    void *p = NULL;
+    if( GetFileSizeEx(hFile,&nSize) && 
+        (nSize.QuadPart > 0) &&
+        ((UINT64)nSize.QuadPart <= (UINT64)((size_t)-1)) )
+    {
+      hMapping = CreateFileMappingW(hFile,NULL,PAGE_READONLY,0,0,NULL);
+    }
+    if(hMapping != NULL)
+    {
+      p = MapViewOfFile(hMapping,FILE_MAP_READ,0,0,0);
+      CloseHandle(hMapping); // the view remains valid
+    }
+    if(p != NULL)
+    {
+      _pBuffer = (const UINT8 *)p;
+      _nBufferSize = (size_t)nSize.QuadPart;
+      _bMapped = true;
+      bRtn = true;
+    }
+    CloseHandle(hFile);
   }
-  else if (_nBufferSize > MAX_FILE_SIZE)
+#else
+  int fd = open(psName,O_RDONLY);
+  if(fd >= 0)
   {
-    _bError = true;
+    struct stat st;
+    if( (fstat(fd,&st) == 0) && 
+        (st.st_size > 0) &&
+        ((UINT64)st.st_size <= (UINT64)((size_t)-1)) )
+    {
+      void *p = mmap(NULL,(size_t)st.st_size,PROT_READ,MAP_PRIVATE,fd,0);
+      if(p != MAP_FAILED)
+      {
+        _pBuffer = (const UINT8 *)p;
+        _nBufferSize = (size_t)st.st_size;
+        _bMapped = true;
+        bRtn = true;
+      }
+    }
+    close(fd); // the mapping remains valid
   }
-  else if((_pBuffer = (UINT8 *)malloc((size_t)_nBufferSize)) == NULL)
+#endif
+  return bRtn;
+}
+
+bool fsaFileInput::_ReadFile(RGFile *pFile)
+{
+  // used if the file cannot be mapped
+  bool bRtn = true;
+  UINT8 *pBuffer = (UINT8 *)malloc(_nBufferSize);
+  if(pBuffer == NULL)
   {
-    _bError = true;
+    bRtn = false;
   }
-  else 
+  else
   {
-    FILE *pf = File.GetFile();
+    FILE *pf = pFile->GetFile();
     size_t nCHUNK = 8192;
     size_t nToRead = _nBufferSize;
     size_t nRead;
-    UINT8 *p = _pBuffer;
-    memset(_pBuffer,0,(size_t)_nBufferSize);
-    while((nToRead > 0) && (!_bError))
+    UINT8 *p = pBuffer;
+    _pBuffer = pBuffer;
+    while((nToRead > 0) && bRtn)
     {
       if(nToRead < nCHUNK)
       {
@@ -465,37 +542,60 @@ bool fsaFileInput::_LoadFileBuffer(const char *psName)
       }
       else
       {
-        _bError = true;
+        bRtn = false;
       }
     }
-    if(_bError) {}
-    else if(strncmp((char *)_pBuffer,"ABIF",4))
+  }
+  return bRtn;
+}
+
+bool fsaFileInput::_LoadFileBuffer(const char *psName)
+{
+  if(_MapFile(psName)) {}
+  else
+  {
+    RGFile File(psName,"rb");
+    if(!File.Exists())
     {
       _bError = true;
     }
-    else
+    else if((_nBufferSize = File.GetSizeOfFile()) < 100) {}
+    else if(!_ReadFile(&File))
     {
-      RGString sName(psName);
-      sName.ToLower();
-      const char *psNameLower = (const char *)sName;
-      size_t nLen = sName.Length();
-      _bHID = ((nLen > 4) && !strncmp(psNameLower + nLen - 4,".hid",4));
-      _pBufferSeek = _pBuffer;
-      UINT8 sType[34];
-      if(!_ReadBytes(sType,34))
-      {
-        _bError = true;
-      }
-      _nVersion = ByteOrder::localInt16(&sType[4]);
-      _pDir = new fsaDirEntry(&sType[6]);
-      if(_bHID)
-      {
-        _SetupHIDOffset();
-      }
-      if(!_SeekTo(_pDir->Offset()))
-      {
-        _bError = true;
-      }
+      _bError = true;
+    }
+  }
+  if(_bError) {}
+  else if(_nBufferSize < 100)
+  {
+    _bError = true;
+  }
+  else if(strncmp((const char *)_pBuffer,"ABIF",4))
+  {
+    _bError = true;
+  }
+  else
+  {
+    RGString sName(psName);
+    sName.ToLower();
+    const char *psNameLower = (const char *)sName;
+    size_t nLen = sName.Length();
+    _bHID = ((nLen > 4) && !strncmp(psNameLower + nLen - 4,".hid",4));
+    _pBufferSeek = _pBuffer;
+    UINT8 sType[34];
+    if(!_ReadBytes(sType,34))
+    {
+      _bError = true;
+    }
+    _nVersion = ByteOrder::localInt16(&sType[4]);
+    _pDir = new fsaDirEntry(&sType[6]);
+    if(_bHID)
+    {
+      _SetupHIDOffset();
+    }
+    if(!_SeekTo(_pDir->Offset()))
+    {
+      _bError = true;
     }
   }
   return !_bError;
@@ -507,6 +607,7 @@ fsaFileInput::fsaFileInput(const char *psName,bool bUseWarning) :
   _pBufferSeek(NULL),
   _nOffsets(0),
   _nBufferSize(0),
+  _bMapped(false),
   _bHID(false)
 {
 
@@ -538,14 +639,16 @@ fsaFileInput::fsaFileInput(const char *psName,bool bUseWarning) :
 				i = nMax; // loop exit
 			}
 		}
+    SortIndex();
     for(UINT32 i = _bError ? nMax : 0; i < nMax; i++)
     {
-      // do this loop after the previous because the previous is sequential reading
-      //  and this requires seeking for each read.
-      this->_vecDirEntry.at(i)->LoadData(false,this);
+      // the data of each entry are loaded when first retrieved, 
+      // most entries are never used
+      this->_vecDirEntry.at(i)->LoadDataDeferred(this);
     }
 	}
-  _CleanupBuffer();
+  // the buffer is kept because entries may refer to it,
+  // see GetView()
 }
 bool fsaFileInput::isValid()
 { 
@@ -53,7 +53,10 @@ http://www.appliedbiosystems.com/support/software_community/ABIF_File_Format.pdf
       fsaFileInput(const char *psFileName)
        psFileName - name of the file to be opened
        The constructor opens the file and reads all of the 
-       directory entries.
+       directory entries.  The file is mapped into memory, when 
+       possible, for the lifetime of the instance, and the large 
+       INT16 entries (e.g., DATA) refer to the mapped data instead 
+       of a copy.  See fsaDirEntry::GetDataINT16View()
 
  */
 
@@ -78,6 +81,17 @@ public:
     bool bRtn = _SeekTo(nOffset) && _ReadBytes(pData,nBytes);
     return bRtn;
   }
+  virtual const UINT8 *GetView(UINT32 nOffset, size_t nBytes)
+  {
+    const UINT8 *pRtn = NULL;
+    if( (_pBuffer != NULL) && 
+        (nOffset <= _nBufferSize) && 
+        (nBytes <= (_nBufferSize - nOffset)) )
+    {
+      pRtn = _pBuffer + nOffset;
+    }
+    return pRtn;
+  }
   bool IsHID() const
   {
     return _bHID;
@@ -87,16 +101,7 @@ private:
   {
      NADDRS = 12
   };
-  void _CleanupBuffer()
-  {
-    if(_pBuffer != NULL)
-    {
-      free(_pBuffer);
-      _pBuffer = NULL;
-    }
-    _pBufferSeek = NULL;
-    _nBufferSize = 0;
-  }
+  void _CleanupBuffer();
   bool _SeekTo(size_t nOffset);
   size_t _Tell()
   {
@@ -105,15 +110,18 @@ private:
   bool _ReadBytes(void *pBuffer, size_t n);
   void Insert(UINT8 *p);
   bool _LoadFileBuffer(const char *psName);
+  bool _MapFile(const char *psName);
+  bool _ReadFile(RGFile *pFile);
   bool _EntryOK(const UINT8 *p, bool bCheckType = false) const;
   const UINT8 *_FindEndEntry(const UINT8 *pMid, bool bFirst) const;
   void _SetupHIDOffset();
 
-  UINT8 *_pBuffer;
-  UINT8 *_pBufferSeek;
+  const UINT8 *_pBuffer;  // mapped file or, if it could not be mapped, malloc()ed copy
+  const UINT8 *_pBufferSeek;
   UINT32 _anHIDoffsets[NADDRS];
   size_t _nOffsets;
   size_t _nBufferSize;
+  bool _bMapped;
   bool _bHID;
 };
 
@@ -974,7 +974,13 @@ double CSplineTransform :: EvaluateWithExtrapolation (double abscissa) {
 	if (abscissa > Right)
 		return (abscissa - Right) * mRight + bRight;
 
-	return Evaluate (abscissa);
+	// does not update the cached last evaluation, so that samples analyzed concurrently can share a ladder's transforms
+	int Interval = SearchForInterval (abscissa);
+
+	if (Interval < 0)
+		return DOUBLEMAX;
+
+	return CalculateCubic (abscissa, Interval);
 }
 
 
@@ -39,6 +39,8 @@
 #else
 #define _tmain main
 #define _TCHAR char
+#define _tcscmp strcmp
+#define _T(x) x
 #endif
 
 //#include "fsaFileData.h"
@@ -69,15 +71,313 @@
 #include "OsirisInputFile.h"
 #include "IndividualGenotype.h"
 #include "rgparray.h"
+#include "rgexec.h"
+#include "BatchAnalysis.h"
+#include "GaussianKernels.h"
+#include "rgarena.h"
+
+#if !defined (_WINDOWS) && !defined (WIN32)
+#include "AnalysisServer.h"
+#include "rgclient.h"
+#include "rgcommdefs.h"
+#endif
 
 
 #include <string>
 #include <math.h>
 #include <list>
+#include <map>
+#include <vector>
+#include <stdio.h>
+#include <string.h>
 
 using namespace std;
 
 
+//
+//	The inputs of an analysis, but for its directories, which differ among the runs of a batch.  These are written to the reports
+//	of each run, and analyses with the same settings inputs can share the kit, message book and settings loaded by one of them
+//
+
+static RGString GetSettingsInputs (OsirisInputFile& inputFile) {
+
+	RGString settingsInputs;
+	RGString outputSubDirectory = inputFile.GetOutputSubDirectory ();
+
+	if (inputFile.IsLadderFreeAnalysis ())
+		settingsInputs << "LadderFree = true;\n";
+
+	if (outputSubDirectory.Length () > 0)
+		settingsInputs << "OutputSubdirectory = " << outputSubDirectory.GetData () << ";\n";
+
+	settingsInputs << "MarkerSetName = " << inputFile.GetMarkerSetName ().GetData () << ";\n";
+	settingsInputs << "LaneStandardName = " << inputFile.GetLaneStandardName ().GetData () << ";\n";
+	settingsInputs << "CriticalOutputLevel = " << inputFile.GetCriticalOutputLevel () << ";\n";
+
+	settingsInputs << "StandardSettings = " << inputFile.GetFinalStdSettingsName () << ";\n";
+	settingsInputs << "LabSettings = " << inputFile.GetFinalLabSettingsName () << ";\n";
+	settingsInputs << "MessageBook = " << inputFile.GetFinalMessageBookName () << ";\n";
+
+	settingsInputs << "MinSampleRFU = " << inputFile.GetMinSampleRFU () << ";\n";
+	settingsInputs << "MinLaneStandardRFU = " << inputFile.GetMinLaneStandardRFU () << ";\n";
+	settingsInputs << "MinLadderRFU = " << inputFile.GetMinLadderRFU () << ";\n";
+	settingsInputs << "MinInterlocusRFU = " << inputFile.GetMinInterlocusRFU () << ";\n";
+	settingsInputs << "MinLadderInterlocusRFU = " << inputFile.GetMinLadderInterlocusRFU () << ";\n";
+	settingsInputs << "SampleDetectionThreshold = " << inputFile.GetSampleDetectionThreshold () << ";\n";
+
+	inputFile.OutputAnalysisThresholdOverrides (settingsInputs);
+	inputFile.OutputDetectionThresholdOverrides (settingsInputs);
+
+	if (inputFile.UseRawData ())
+		settingsInputs << "RawDataString = R;\n\n\n";
+
+	else
+		settingsInputs << "RawDataString = A;\n\n\n";
+
+	return settingsInputs;
+}
+
+
+//
+//	Runs of a batch that use other lab settings than the batch are analyzed by one further invocation of this program for each
+//	lab settings file, because lab settings are loaded only once in a process.  programArgs are the program and the options
+//	that it was given, and the batch input is piped to it, so that nothing is written to the report directories
+//
+
+static int AnalyzeBatchInNewProcess (OsirisInputFile& inputFile, const char* const* programArgs, const RGString& labSettingsName, const list<batchRun*>& runs,
+AnalysisProgress* progress) {
+
+	RGDList lines;
+	RGString* line;
+	RGString inputText;
+
+	inputFile.GetInputLinesForBatch (labSettingsName, runs, lines);
+
+	while (line = (RGString*) lines.GetFirst ()) {
+
+		inputText << *line << "\n";
+		delete line;
+	}
+
+	cout << "Analyzing " << (int) runs.size () << " runs with lab settings " << labSettingsName.GetData () << "..." << endl;
+	int status = RGExec::RunWithInput (programArgs, inputText.GetData ());
+
+	if (status != 0) {
+
+		cout << "Could not complete analysis of runs with lab settings " << labSettingsName.GetData () << endl;
+		status = -1;
+	}
+
+	if (progress != NULL) {
+
+		list<batchRun*>::const_iterator runIterator;
+
+		for (runIterator = runs.begin (); runIterator != runs.end (); runIterator++)
+			progress->ReportRunComplete ((*runIterator)->mInputDirectory, (*runIterator)->mReportDirectory, status);
+	}
+
+	return status;
+}
+
+
+//
+//	Runs of a batch that use the lab settings of the batch share the kit, message book and settings already loaded by analysis.
+//	If analysis is NULL, the settings of the batch have not been loaded, and every run is analyzed by another invocation
+//
+
+static int AnalyzeBatch (OsirisInputFile& inputFile, STRLCAnalysis* analysis, const char* const* programArgs, const RGString& markerSetName, int outputLevel,
+bool isLadderFree, const RGString& ladderDirectory, const RGString& settingsInputs, AnalysisProgress* progress) {
+
+	list<batchRun*>* runs = inputFile.GetBatchRuns ();
+	list<batchRun*>::iterator runIterator;
+	map<string, list<batchRun*> > otherLabSettings;
+	map<string, list<batchRun*> >::iterator labIterator;
+	BatchAnalysis* batch = NULL;
+	batchRun* run;
+	RGString labSettingsName;
+	RGDList lines;
+	RGString* line;
+	RGString commandLine;
+	RGString commandInputs;
+	RGString pResult;
+	int status = 0;
+	int otherStatus;
+
+	for (runIterator = runs->begin (); runIterator != runs->end (); runIterator++) {
+
+		run = *runIterator;
+		labSettingsName = inputFile.GetFinalLabSettingsName ();
+
+		if (run->mLabSettingsName.Length () > 0)
+			labSettingsName = run->mLabSettingsName;
+
+		if ((analysis == NULL) || !(labSettingsName == inputFile.GetFinalLabSettingsName ())) {
+
+			otherLabSettings [labSettingsName.GetData ()].push_back (run);
+			continue;
+		}
+
+		if (batch == NULL) {
+
+			batch = new BatchAnalysis (*analysis, markerSetName, outputLevel, isLadderFree);
+			batch->SetProgress (progress);
+		}
+
+		inputFile.GetInputLinesForRun (*run, lines);
+		commandLine = "";
+
+		while (line = (RGString*) lines.GetFirst ()) {
+
+			commandLine << "\t\t\t<argv>" << xmlwriter::EscAscii (*line, &pResult) << "</argv>\n";
+			delete line;
+		}
+
+		commandInputs = "";
+		commandInputs << "InputDirectory = " << run->mInputDirectory << ";\n";
+		commandInputs << "LadderDirectory = " << ladderDirectory << ";\n";
+		commandInputs << "ReportDirectory = " << run->mReportDirectory << ";\n";
+		commandInputs << settingsInputs;
+		batch->Append (new BatchAnalysisRun (run->mInputDirectory, run->mReportDirectory, commandLine, commandInputs));
+	}
+
+	if (batch != NULL) {
+
+		status = batch->AnalyzeAll ();
+		delete batch;
+	}
+
+	for (labIterator = otherLabSettings.begin (); labIterator != otherLabSettings.end (); labIterator++) {
+
+		otherStatus = AnalyzeBatchInNewProcess (inputFile, programArgs, labIterator->first.c_str (), labIterator->second, progress);
+
+		if (status == 0)
+			status = otherStatus;
+	}
+
+	return status;
+}
+
+
+//
+//	As a resident analysis server, analyzes each job it is sent.  Jobs with the settings inputs of the server share the kit,
+//	message book and settings that the server loaded when it started; others are analyzed by another invocation
+//
+
+static int ServeAnalyses (OsirisInputFile& inputFile, STRLCAnalysis& analysis, const char* const* programArgs, const RGString& markerSetName, int outputLevel,
+bool isLadderFree, const RGString& ladderDirectory, const RGString& settingsInputs) {
+
+#if !defined (_WINDOWS) && !defined (WIN32)
+
+	AnalysisServer server (inputFile.GetServerSocketName ());
+	RGString inputs;
+	int status;
+
+	if (!server.IsActive ()) {
+
+		cout << "Could not start analysis server on socket " << inputFile.GetServerSocketName ().GetData () << ":  error " << server.GetLastError () << endl;
+		return -1;
+	}
+
+	cout << "Analysis server ready on socket " << inputFile.GetServerSocketName ().GetData () << endl;
+
+	while (server.ReceiveJob (inputs)) {
+
+		OsirisInputFile job (false);
+		cout << "Analysis server received job..." << endl;
+
+		if ((job.ReadAllInputsFromString (inputs) != 0) || (job.AssembleInputs () != 0)) {
+
+			cout << "Job input failed" << endl;
+			server.EndJob (-1);
+			continue;
+		}
+
+		if (!job.IsBatchAnalysis ())
+			job.GetBatchRuns ()->push_back (new batchRun (job.GetInputDirectory (), job.GetReportDirectory (), ""));
+
+		if ((GetSettingsInputs (job) == settingsInputs) && (job.GetLadderDirectory () == ladderDirectory) && (job.GetOverrideString () == inputFile.GetOverrideString ()))
+			status = AnalyzeBatch (job, &analysis, programArgs, markerSetName, outputLevel, isLadderFree, ladderDirectory, settingsInputs, &server);
+
+		else
+			status = AnalyzeBatch (job, NULL, programArgs, markerSetName, outputLevel, isLadderFree, ladderDirectory, settingsInputs, &server);
+
+		server.EndJob (status);
+	}
+
+	return 0;
+
+#else
+
+	cout << "Analysis servers are not available on this platform" << endl;
+	return -1;
+
+#endif
+}
+
+
+//
+//	Has a resident analysis server analyze the inputs, and reports the progress of the analysis
+//
+
+static int SubmitToServer (OsirisInputFile& inputFile) {
+
+#if !defined (_WINDOWS) && !defined (WIN32)
+
+	RGClient client ("OsirisAnalysisClient");
+	RGString inputs = inputFile.GetInputText ();
+	RGString reply;
+	unsigned char* replyBuffer;
+	int replyLength;
+	size_t equalsPosition = 0;
+	int serverId = client.LocateServer (inputFile.GetSubmitToServerName ());
+
+	if (serverId < 0) {
+
+		cout << "Could not reach analysis server on socket " << inputFile.GetSubmitToServerName ().GetData () << endl;
+		return -1;
+	}
+
+	int status = client.Send (serverId, (unsigned char*) inputs.GetData (), replyBuffer, (int) inputs.Length (), replyLength);
+
+	while (status == RGREPLYWITHCONTINUATION) {
+
+		cout << (char*) replyBuffer << endl;
+		status = client.ReceiveReply (serverId, replyBuffer, replyLength);
+	}
+
+	if (status < 0) {
+
+		cout << "Lost analysis server on socket " << inputFile.GetSubmitToServerName ().GetData () << endl;
+		return -1;
+	}
+
+	cout << (char*) replyBuffer << endl;
+	reply = (char*) replyBuffer;
+
+	if (!reply.FindNextSubstring (0, "=", equalsPosition))
+		return -1;
+
+	reply = reply.ExtractSubstring (equalsPosition + 1, reply.Length () - 1);
+	status = reply.ConvertToInteger ();
+
+	if (status < 0) {
+
+		cout << "Could not complete analysis...exiting with status:  " << status << endl;
+		return status;
+	}
+
+	cout << endl << "Analysis Complete" << endl;
+	return 0;
+
+#else
+
+	cout << "Analysis servers are not available on this platform" << endl;
+	return -1;
+
+#endif
+}
+
+
 
 int _tmain(int argc, _TCHAR* argv[]) {
 
@@ -123,6 +423,7 @@ int _tmain(int argc, _TCHAR* argv[]) {
 	RGPArray::ResetDefaultSize (20);
 	RGPArray::ResetDefaultIncrement (20);
 	bool isLadderFree = false;
+	bool poolStatistics = false;
 
 	//
 	//	OsirisInputFile is always started with a debug value of "false", even for debug runs, because the debugger
@@ -151,6 +452,9 @@ int _tmain(int argc, _TCHAR* argv[]) {
 		return -1;
 	}
 
+	if (inputFile.IsSubmitToServer ())
+		return SubmitToServer (inputFile);
+
 	inputStatus = inputFile.AssembleInputs ();
 
 	if (inputStatus != 0) {
@@ -173,6 +477,15 @@ int _tmain(int argc, _TCHAR* argv[]) {
 	OutputSubDirectory = inputFile.GetOutputSubDirectory ();
 	MarkerSetName = inputFile.GetMarkerSetName ();
 	UserLaneStandardName = inputFile.GetLaneStandardName ();
+
+	if (inputFile.IsBatchAnalysis () && (PrototypeInputDirectory.Length () == 0)) {
+
+		// the directories of the first run stand in for the batch until its runs are analyzed
+
+		PrototypeInputDirectory = inputFile.GetBatchRuns ()->front ()->mInputDirectory;
+		graphicsDirectory = ParentDirectoryForReports = inputFile.GetBatchRuns ()->front ()->mReportDirectory;
+	}
+
 	OutputLevel = inputFile.GetCriticalOutputLevel ();
 	Notice::SetSeverityTrigger (OutputLevel);
 	SmartMessage::SetSeverityTrigger (OutputLevel);
@@ -182,36 +495,66 @@ int _tmain(int argc, _TCHAR* argv[]) {
 		isLadderFree = true;
 
 	STRLCAnalysis::SetOutputSubDirectory (OutputSubDirectory);
+	STRLCAnalysis::SetNumberOfAnalysisThreads (inputFile.GetNumberOfAnalysisThreads ());
+	STRLCAnalysis::SetIncrementalAnalysis (inputFile.IsIncrementalAnalysis ());
+
+	//
+	//  With --resume, the result of each sample is saved as it is reported, and the samples whose results were saved by an
+	//  earlier analysis with --resume that did not finish are not analyzed again.  With --validate-kernels, the vectorized
+	//  Gaussian kernels are checked against the scalar kernels, and with --scalar-kernels, only the scalar kernels are used.
+	//  With --pool-statistics, the list allocations saved by pooling, and the sample objects allocated from arenas, are
+	//  reported at the end.  These options are passed on to any further invocation of this program for a batch
+	//
+
+	vector<const char*> programArgs;
+	programArgs.push_back (argv [0]);
+
+	for (int i=1; i<argc; i++) {
+
+		if ((_tcscmp (argv [i], _T("--resume")) == 0) || (_tcscmp (argv [i], _T("--validate-kernels")) == 0) ||
+			(_tcscmp (argv [i], _T("--scalar-kernels")) == 0) || (_tcscmp (argv [i], _T("--pool-statistics")) == 0))
+			programArgs.push_back (argv [i]);
+
+		if (_tcscmp (argv [i], _T("--resume")) == 0) {
+
+			STRLCAnalysis::SetResumeAnalysis (true);
+			cout << "Resuming analysis..." << endl;
+		}
+
+		else if (_tcscmp (argv [i], _T("--validate-kernels")) == 0) {
+
+			GaussianKernels::SetValidation (true);
+			cout << "Validating " << GaussianKernels::GetInstructionSetName (GaussianKernels::GetInstructionSet ()) << " Gaussian kernels..." << endl;
+		}
+
+		else if (_tcscmp (argv [i], _T("--scalar-kernels")) == 0)
+			GaussianKernels::SetInstructionSet (GaussianKernels::Scalar);
+
+		else if (_tcscmp (argv [i], _T("--pool-statistics")) == 0)
+			poolStatistics = true;
+	}
+
+	programArgs.push_back (NULL);
 	GenotypesForAMarkerSet::SetPathToStandardControlFile (ConfigDirectory);
 
 	if (!inputFile.OverrideStringIsEmpty ())
 		STRLCAnalysis::SetOverrideString (inputFile.GetOverrideString ());
 
 	RGString CommandInputs;
+	RGString SettingsInputs;
 
 	CommandInputs << "InputDirectory = " << PrototypeInputDirectory.GetData () << ";\n";
 	CommandInputs << "LadderDirectory = " << LadderInformationDirectory.GetData () << ";\n";
 	CommandInputs << "ReportDirectory = " << ParentDirectoryForReports.GetData () << ";\n";
 
-	if (isLadderFree)
-		CommandInputs << "LadderFree = true;\n";
-
-	if (OutputSubDirectory.Length () > 0)
-		CommandInputs << "OutputSubdirectory = " << OutputSubDirectory.GetData () << ";\n";
-
-	CommandInputs << "MarkerSetName = " << MarkerSetName.GetData () << ";\n";
-	CommandInputs << "LaneStandardName = " << UserLaneStandardName.GetData () << ";\n";
-	CommandInputs << "CriticalOutputLevel = " << OutputLevel << ";\n";
-	//cout << "MessageBook = " << MessageBookPath.GetData () << ";" << endl;
+	SettingsInputs = GetSettingsInputs (inputFile);
+	CommandInputs << SettingsInputs;
+	cout << CommandInputs.GetData ();
 
 	stdSettingsFileName = inputFile.GetFinalStdSettingsName ();
 	labSettingsFileName = inputFile.GetFinalLabSettingsName ();
 	RGString fullPathMessageBookName = inputFile.GetFinalMessageBookName ();
 
-	CommandInputs << "StandardSettings = " << stdSettingsFileName << ";\n";
-	CommandInputs << "LabSettings = " << labSettingsFileName << ";\n";
-	CommandInputs << "MessageBook = " << fullPathMessageBookName << ";\n";
-
 	minSampleRFU = inputFile.GetMinSampleRFU ();
 	minLaneStandardRFU = inputFile.GetMinLaneStandardRFU ();
 	minLadderRFU = inputFile.GetMinLadderRFU ();
@@ -219,13 +562,6 @@ int _tmain(int argc, _TCHAR* argv[]) {
 	minLadderInterlocusRFU = inputFile.GetMinLadderInterlocusRFU ();
 	sampleDetectionThreshold = inputFile.GetSampleDetectionThreshold ();
 
-	CommandInputs << "MinSampleRFU = " << minSampleRFU << ";\n";
-	CommandInputs << "MinLaneStandardRFU = " << minLaneStandardRFU << ";\n";
-	CommandInputs << "MinLadderRFU = " << minLadderRFU << ";\n";
-	CommandInputs << "MinInterlocusRFU = " << minInterlocusRFU << ";\n";
-	CommandInputs << "MinLadderInterlocusRFU = " << minLadderInterlocusRFU << ";\n";
-	CommandInputs << "SampleDetectionThreshold = " << sampleDetectionThreshold << ";\n";
-
 	size_t posn = 0;
 
 	if (MarkerSetName.FindSubstringCaseIndependent ("LaneStandardOnly", posn))
@@ -234,24 +570,17 @@ int _tmain(int argc, _TCHAR* argv[]) {
 	if (MarkerSetName.FindSubstringCaseIndependent ("LadderFree", posn))
 		isLadderFree = true;
 
-	inputFile.OutputAnalysisThresholdOverrides (CommandInputs);
-	inputFile.OutputDetectionThresholdOverrides (CommandInputs);
-
 	bool useRawData = inputFile.UseRawData ();
 
 	if (useRawData) {
 
 		CoreBioComponent::SetUseRawData ();
-		CommandInputs << "RawDataString = R;\n\n\n";
-		cout << CommandInputs.GetData ();
 		cout << "Use raw data...\n";
 	}
 
 	else {
 
 		CoreBioComponent::DontUseRawData ();
-		CommandInputs << "RawDataString = A;\n\n\n";
-		cout << CommandInputs.GetData ();
 		cout << "Don't use raw data...\n";
 	}
 
@@ -349,16 +678,25 @@ int _tmain(int argc, _TCHAR* argv[]) {
 	analysis.SetXMLCommandLineString (CommandLine);
 	int status = 0;
 
-	try {
-		if (!isLadderFree)
-			status = analysis.AnalyzeIncrementallySM (PrototypeInputDirectory, MarkerSetName, OutputLevel, graphicsDirectory, CommandInputs);
+	if (inputFile.IsServer ())
+		return ServeAnalyses (inputFile, analysis, &programArgs [0], MarkerSetName, OutputLevel, isLadderFree, LadderInformationDirectory, SettingsInputs);
 
-		else
-			status = analysis.AnalyzeIncrementallySMLF (PrototypeInputDirectory, MarkerSetName, OutputLevel, graphicsDirectory, CommandInputs);
-	}
+	if (inputFile.IsBatchAnalysis ())
+		status = AnalyzeBatch (inputFile, &analysis, &programArgs [0], MarkerSetName, OutputLevel, isLadderFree, LadderInformationDirectory, SettingsInputs, NULL);
+
+	else {
+
+		try {
+			if (!isLadderFree)
+				status = analysis.AnalyzeIncrementallySM (PrototypeInputDirectory, MarkerSetName, OutputLevel, graphicsDirectory, CommandInputs);
 
-	catch (...) {
-		status = -1170;
+			else
+				status = analysis.AnalyzeIncrementallySMLF (PrototypeInputDirectory, MarkerSetName, OutputLevel, graphicsDirectory, CommandInputs);
+		}
+
+		catch (...) {
+			status = -1170;
+		}
 	}
 
 	if (status < 0) {
@@ -367,6 +705,16 @@ int _tmain(int argc, _TCHAR* argv[]) {
 		return status;
 	}
 
+	if (GaussianKernels::GetValidation ())
+		cout << "Gaussian kernel validation failures:  " << GaussianKernels::GetNumberOfValidationFailures () << endl;
+
+	if (poolStatistics) {
+
+		cout << "List links allocated:  " << RGDList::GetNumberOfLinkRequests () << " from " << RGDList::GetNumberOfLinkBlocks () << " heap blocks" << endl;
+		cout << "Lists allocated:  " << RGDList::GetNumberOfListRequests () << " from " << RGDList::GetNumberOfListBlocks () << " heap blocks" << endl;
+		cout << "Sample objects allocated:  " << RGArena::GetNumberOfRequests () << " from " << RGArena::GetNumberOfBlocks () << " heap blocks in " << RGArena::GetNumberOfArenas () << " arenas" << endl;
+	}
+
 	cout << endl << "Analysis Complete" << endl;
 	return 0;
 
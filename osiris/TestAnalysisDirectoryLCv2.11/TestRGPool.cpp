@@ -0,0 +1,140 @@
+/*
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+*  FileName: TestRGPool.cpp
+*  Author:   Robert Goor
+*
+*/
+//
+//  Tests that the free objects of RGPool threads are returned to the depot when each thread finishes, so that threads started
+//  later reuse them instead of allocating new blocks
+//
+
+#include "rgpool.h"
+#include "rgthread.h"
+#include <iostream>
+
+using namespace std;
+
+
+struct PooledItem {
+
+	PooledItem* mNext;
+	double mValue;
+
+	void* operator new (size_t nbytes) { return RGPool<PooledItem>::Allocate (nbytes); }
+	void operator delete (void* p, size_t nbytes) { RGPool<PooledItem>::Free (p, nbytes); }
+};
+
+
+class PoolThread : public RGThread {
+
+public:
+	PoolThread (int n) : RGThread (), mNumberOfItems (n) {}
+	virtual ~PoolThread () { Join (); }
+
+protected:
+	int mNumberOfItems;
+
+	virtual void Run ();
+};
+
+
+void PoolThread :: Run () {
+
+	//  leaves a free list that is not a whole number of blocks
+
+	PooledItem* first = NULL;
+	PooledItem* next;
+	int i;
+
+	for (i=0; i<mNumberOfItems; i++) {
+
+		next = new PooledItem;
+		next->mNext = first;
+		first = next;
+	}
+
+	while (first != NULL) {
+
+		next = first->mNext;
+		delete first;
+		first = next;
+	}
+}
+
+
+static void RunThreads (int nThreads, int nItems) {
+
+	PoolThread** threads = new PoolThread* [nThreads];
+	int i;
+
+	for (i=0; i<nThreads; i++) {
+
+		threads [i] = new PoolThread (nItems);
+		threads [i]->Start ();
+	}
+
+	for (i=0; i<nThreads; i++)
+		delete threads [i];
+
+	delete[] threads;
+}
+
+
+int main (int argc, char* argv[]) {
+
+	const int nThreads = 4;
+	const int nItems = 3 * RGPool<PooledItem>::BlockSize + 37;
+	long firstBlocks;
+	long lastBlocks;
+	int round;
+
+	RunThreads (nThreads, nItems);
+	firstBlocks = RGPool<PooledItem>::GetNumberOfBlocks ();
+
+	for (round=0; round<20; round++)
+		RunThreads (nThreads, nItems);
+
+	lastBlocks = RGPool<PooledItem>::GetNumberOfBlocks ();
+	cout << "Blocks after the first round:  " << firstBlocks << ", after 21 rounds:  " << lastBlocks << endl;
+
+	//  Each round needs at most one more block for each thread, for the objects left in the partial list
+
+	if (lastBlocks > firstBlocks + nThreads) {
+
+		cout << "FAILED:  the free lists of finished threads were not reused" << endl;
+		return 1;
+	}
+
+	if (RGPool<PooledItem>::GetNumberOfRequests () != 21L * nThreads * nItems) {
+
+		cout << "FAILED:  the counts of finished threads were not added to the total" << endl;
+		return 1;
+	}
+
+	cout << "All tests passed" << endl;
+	return 0;
+}
@@ -0,0 +1,109 @@
+/*
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+*  FileName: TestSampleResultCache.cpp
+*  Author:   Robert Goor
+*
+*/
+//
+//  Tests that a sample result spooled as it is reported is renumbered without changing the numbers in its text, such as
+//  sample names and paths in the reserved ranges
+//
+
+#include "rgstring.h"
+#include "rgfile.h"
+#include "RGLogBook.h"
+#include "SampleResultCache.h"
+#include <iostream>
+
+using namespace std;
+
+
+static int failures = 0;
+
+
+static void Check (const RGString& actual, const char* expected, const char* test) {
+
+	if (actual == expected)
+		return;
+
+	failures++;
+	cout << "FAILED:  " << test << endl;
+	cout << "Expected:  " << expected << endl;
+	cout << "Actual:  " << actual.GetData () << endl;
+}
+
+
+static RGString SpoolReport (const RGString& sampleName) {
+
+	//  Writes as ReportSampleSM writes to a report spool, with the first reserved numbers of each kind
+
+	RGFile* file = RGFile::CreateTemporaryFile ();
+	RGLogBook* spool = new RGLogBook (file, 15, FALSE);
+	RGString contents;
+
+	spool->MarkNumbers (SampleResultCache::SignalIDBase + 1, SampleResultCache::MessageNumberBase + SampleResultCache::NumberRange);
+	*spool << CLevel (1);
+	*spool << "<Name>" << sampleName << "</Name>\n";
+	*spool << "<File>/data/" << sampleName << ".fsa</File>\n";
+	*spool << "<Id>" << (unsigned long) (SampleResultCache::SignalIDBase + 2) << "</Id>\n";
+	*spool << "&" + SampleResultCache::FormatLinkNumber (SampleResultCache::LinkNumberBase + 1) + "&" << sampleName << "\n";
+	*spool << "<MessageNumber>" << SampleResultCache::MessageNumberBase + 3 << "</MessageNumber>\n" << PLevel ();
+	delete spool;	// flushes spool
+
+	file->SeekToBegin ();
+	contents.ReadTextFile (*file);
+	delete file;
+	return contents;
+}
+
+
+int main (int argc, char* argv[]) {
+
+	const char* names [] = { "Case 2120000000", "2123000001", "S2133000002", "Sample 1" };
+	const char* expected [] = {
+		"<Name>Case 2120000000</Name>\n<File>/data/Case 2120000000.fsa</File>\n<Id>102</Id>\n&21&Case 2120000000\n<MessageNumber>33</MessageNumber>\n",
+		"<Name>2123000001</Name>\n<File>/data/2123000001.fsa</File>\n<Id>102</Id>\n&21&2123000001\n<MessageNumber>33</MessageNumber>\n",
+		"<Name>S2133000002</Name>\n<File>/data/S2133000002.fsa</File>\n<Id>102</Id>\n&21&S2133000002\n<MessageNumber>33</MessageNumber>\n",
+		"<Name>Sample 1</Name>\n<File>/data/Sample 1.fsa</File>\n<Id>102</Id>\n&21&Sample 1\n<MessageNumber>33</MessageNumber>\n" };
+	int i;
+
+	//  Numbers in the reserved ranges that were not written as reserved numbers are not marked, and are not renumbered
+
+	for (i=0; i<4; i++)
+		Check (SampleResultCache::Renumber (SpoolReport (names [i]), 100, 20, 30), expected [i], names [i]);
+
+	Check (SampleResultCache::Renumber ("Case 2120000000 2133000001 &2123000001&", 100, 20, 30), "Case 2120000000 2133000001 &2123000001&",
+		"unmarked text");
+
+	if (failures > 0) {
+
+		cout << failures << " test(s) failed" << endl;
+		return 1;
+	}
+
+	cout << "All tests passed" << endl;
+	return 0;
+}
@@ -0,0 +1,349 @@
+/*
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+*  FileName: TestTraceFilterPipeline.cpp
+*  Author:   Robert Goor
+*
+*/
+//
+//  Tests that TraceFilterPipeline computes exactly what the separate SampledData filter loops computed, and times both on the
+//  same traces, failing if the pipeline is much slower
+//
+
+#include "TraceFilterPipeline.h"
+#include <iostream>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+using namespace std;
+
+
+static int failures = 0;
+
+
+static double* ReferenceMovingAverage (int window, const double* inputArray, int NumberOfSamples) {
+
+	//  SampledData::CreateMovingAverageFilteredArray before the pipeline
+
+	double* newMeasurements = new double [NumberOfSamples];
+	int i;
+	double temp;
+	double factor;
+	int win = window;
+	int halfWindow;
+
+	if (window > 0) {
+
+		if (win%2 == 0)
+			win++;
+
+		factor = 1.0 / (double)win;
+	}
+
+	else {
+
+		win = 1;
+		factor = 1.0;
+	}
+
+	halfWindow = win / 2;
+	temp = 0.0;
+	double currentAve;
+
+	for (i=0; i<=halfWindow; i++)
+		temp += inputArray [i];
+
+	currentAve = newMeasurements [0] = temp * factor;
+	double oldValue;
+	double nextValue;
+	int indexNext = halfWindow;
+	int indexOld = -halfWindow - 1;
+
+	for (i=1; i<NumberOfSamples; i++) {
+
+		indexNext++;
+		indexOld++;
+
+		if (indexNext < NumberOfSamples)
+			nextValue = inputArray [indexNext];
+
+		else
+			nextValue = 0.0;
+
+		if (indexOld >= 0)
+			oldValue = inputArray [indexOld];
+
+		else
+			oldValue = 0.0;
+
+		currentAve += factor * (nextValue - oldValue);
+		newMeasurements [i] = currentAve;
+	}
+
+	return newMeasurements;
+}
+
+
+static double* ReferenceTripleMovingAverage (int minWindow, const double* Measurements, int NumberOfSamples) {
+
+	//  SampledData::CreateThreeMovingAverageFilteredSignal before the pipeline
+
+	if (minWindow == 1)
+		return ReferenceMovingAverage (minWindow, Measurements, NumberOfSamples);
+
+	int win3 = minWindow;
+
+	if (win3%2 == 0)
+		win3++;
+
+	int win2 = TraceFilterPipeline::GetNextTripleWindow (win3);
+	int win1 = TraceFilterPipeline::GetNextTripleWindow (win2);
+	double* filterOut1 = ReferenceMovingAverage (win1, Measurements, NumberOfSamples);
+	double* filterOut2 = ReferenceMovingAverage (win2, filterOut1, NumberOfSamples);
+	double* filterOut3 = ReferenceMovingAverage (win3, filterOut2, NumberOfSamples);
+	delete[] filterOut1;
+	delete[] filterOut2;
+	return filterOut3;
+}
+
+
+static double* ReferenceAveraging (int halfWidth, double noiseLevel, double noiseLevelStart, bool* changeArray, int& k, double splitTime,
+	const double* Measurements, int NumberOfSamples) {
+
+	//  SampledData::CreateAveragingFilteredSignal before the pipeline
+
+	double* smoothedData = new double [NumberOfSamples];
+	int startPt = halfWidth;
+	int endPt = NumberOfSamples - halfWidth - 1;
+	int i;
+	int j;
+	double divisor = (double) (2 * halfWidth + 1);
+	bool FirstTime = true;
+	double previous = 0.0;
+	int timeSplit = (int) floor (splitTime);
+	int upperLimit;
+	int lowerLimit = 0;
+	double sum;
+
+	for (i=0; i<startPt; i++) {
+
+		upperLimit = i + halfWidth;
+		sum = 0.0;
+
+		for (j=lowerLimit; j<=upperLimit; j++)
+			sum += Measurements[j];
+
+		smoothedData[i] = sum / divisor;
+	}
+
+	for (i=startPt; i<=endPt; i++) {
+
+		sum = 0.0;
+		upperLimit = i + halfWidth;
+		lowerLimit = i - halfWidth;
+
+		if (FirstTime) {
+
+			FirstTime = false;
+
+			for (j=lowerLimit; j<=upperLimit; j++)
+				sum += Measurements [j];
+
+			previous = sum;
+			smoothedData [i] = sum / divisor;
+		}
+
+		else {
+
+			previous = previous - Measurements [lowerLimit - 1] + Measurements [upperLimit];
+			smoothedData [i] = previous / divisor;
+		}
+	}
+
+	upperLimit = NumberOfSamples - 1;
+
+	for (i=endPt+1; i<NumberOfSamples; i++) {
+
+		sum = 0.0;
+		lowerLimit = i - halfWidth;
+
+		for (j=lowerLimit; j<=upperLimit; j++)
+			sum += Measurements[j];
+
+		smoothedData[i] = sum / divisor;
+	}
+
+	k = 0;
+
+	for (i=0; i<NumberOfSamples; i++) {
+
+		changeArray [i] = false;
+
+		if (fabs (smoothedData [i] - Measurements [i]) > ((i <= timeSplit) ? noiseLevelStart : noiseLevel)) {
+
+			smoothedData [i] = Measurements [i];
+			changeArray [i] = true;
+			k++;
+		}
+	}
+
+	return smoothedData;
+}
+
+
+static void Compare (const double* actual, const double* expected, int n, const char* test) {
+
+	if (memcmp (actual, expected, n * sizeof (double)) == 0)
+		return;
+
+	failures++;
+	cout << "FAILED:  " << test << " differs from the separate filter loops" << endl;
+}
+
+
+static void CompareTimes (double pipelineTime, double referenceTime, const char* test) {
+
+	cout << test << ":  pipeline " << pipelineTime << " ms, separate loops " << referenceTime << " ms per trace" << endl;
+
+	if (pipelineTime > 2.0 * referenceTime + 0.01) {
+
+		failures++;
+		cout << "FAILED:  " << test << " is slower than the separate filter loops" << endl;
+	}
+}
+
+
+static double MillisecondsPerTrace (clock_t start, int repeats) {
+
+	return 1000.0 * (double) (clock () - start) / ((double) CLOCKS_PER_SEC * (double) repeats);
+}
+
+
+int main (int argc, char* argv[]) {
+
+	//  a trace of baseline noise with peaks and a level change, and a few short traces for the end cases
+
+	const int numSamples = 8000;
+	const int repeats = 200;
+	const int lengths [] = { numSamples, 15, 16, 20, 57 };	// the separate loops need at least one full window
+	double* trace = new double [numSamples];
+	double* output = new double [numSamples];
+	double* expected;
+	bool* changes = new bool [numSamples];
+	bool* expectedChanges = new bool [numSamples];
+	TraceFilterPipeline triple;
+	TraceFilterPipeline averaging;
+	clock_t start;
+	double pipelineTime;
+	double referenceTime;
+	int k;
+	int i;
+	int n;
+
+	srand (12345);
+
+	for (i=0; i<numSamples; i++) {
+
+		trace [i] = 20.0 * ((double) rand () / (double) RAND_MAX - 0.5) + ((i > 4000) ? 150.0 : 0.0);
+
+		if (i % 500 == 250)
+			trace [i] += 2000.0;
+	}
+
+	triple.AppendTripleMovingAverage (5);
+	averaging.AppendLevelChangeAveraging (7, 12.0, 18.0, 1500.5, changes);
+
+	for (n=0; n<5; n++) {
+
+		triple.Filter (trace, lengths [n], output);
+		expected = ReferenceTripleMovingAverage (5, trace, lengths [n]);
+		Compare (output, expected, lengths [n], "triple moving average");
+		delete[] expected;
+
+		averaging.Filter (trace, lengths [n], output);
+		expected = ReferenceAveraging (7, 12.0, 18.0, expectedChanges, k, 1500.5, trace, lengths [n]);
+		Compare (output, expected, lengths [n], "level change averaging");
+		delete[] expected;
+
+		if ((k != averaging.GetNumberOfChangedSamples ()) || (memcmp (changes, expectedChanges, lengths [n] * sizeof (bool)) != 0)) {
+
+			failures++;
+			cout << "FAILED:  level change averaging changed different samples" << endl;
+		}
+	}
+
+	//  Each filter is timed as it is used, with a new pipeline for each trace
+
+	start = clock ();
+
+	for (i=0; i<repeats; i++) {
+
+		TraceFilterPipeline pipeline;
+		pipeline.AppendTripleMovingAverage (5);
+		pipeline.Filter (trace, numSamples, output);
+	}
+
+	pipelineTime = MillisecondsPerTrace (start, repeats);
+	start = clock ();
+
+	for (i=0; i<repeats; i++)
+		delete[] ReferenceTripleMovingAverage (5, trace, numSamples);
+
+	referenceTime = MillisecondsPerTrace (start, repeats);
+	CompareTimes (pipelineTime, referenceTime, "Triple moving average");
+	start = clock ();
+
+	for (i=0; i<repeats; i++) {
+
+		TraceFilterPipeline pipeline;
+		pipeline.AppendLevelChangeAveraging (7, 12.0, 18.0, 1500.5, changes);
+		pipeline.Filter (trace, numSamples, output);
+	}
+
+	pipelineTime = MillisecondsPerTrace (start, repeats);
+	start = clock ();
+
+	for (i=0; i<repeats; i++)
+		delete[] ReferenceAveraging (7, 12.0, 18.0, expectedChanges, k, 1500.5, trace, numSamples);
+
+	referenceTime = MillisecondsPerTrace (start, repeats);
+	CompareTimes (pipelineTime, referenceTime, "Level change averaging");
+
+	delete[] trace;
+	delete[] output;
+	delete[] changes;
+	delete[] expectedChanges;
+
+	if (failures > 0) {
+
+		cout << failures << " test(s) failed" << endl;
+		return 1;
+	}
+
+	cout << "All tests passed" << endl;
+	return 0;
+}